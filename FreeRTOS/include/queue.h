@@ -885,6 +885,123 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueSendMultiple(
+ *                                 QueueHandle_t xQueue,
+ *                                 const void * pvItemsToQueue,
+ *                                 UBaseType_t uxItemCount,
+ *                                 TickType_t xTicksToWait
+ *                               );
+ * @endcode
+ *
+ * Post up to uxItemCount items, stored contiguously at pvItemsToQueue, to the
+ * back of a queue.  All the items that fit are copied inside a single critical
+ * section rather than one per item, which is where the saving lies.  Tasks
+ * waiting to receive are still unblocked one per item posted, as if each item
+ * had been sent on its own.  Items that are one word in size and word aligned
+ * are copied without memcpy().
+ *
+ * The call only blocks while the queue is completely full.  As soon as there
+ * is room for at least one item, as many items as fit are posted and the
+ * call returns, so fewer than uxItemCount items may be sent.
+ *
+ * This function must not be used in an interrupt service routine, on a queue
+ * that is a member of a queue set, or on a semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to the first of the items to be placed on
+ * the queue.  Each item is the size defined when the queue was created.
+ *
+ * @param uxItemCount The number of items at pvItemsToQueue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it already be
+ * full.
+ *
+ * @return The number of items posted, which is zero if the queue stayed full
+ * for the whole block time.
+ *
+ * Example usage:
+ * @code{c}
+ * uint32_t ulSamples[ 4 ];
+ * UBaseType_t uxSent = 0;
+ *
+ *  // Post all four samples, blocking while the queue is full.
+ *  while( uxSent < 4 )
+ *  {
+ *      uxSent += xQueueSendMultiple( xQueue, &( ulSamples[ uxSent ] ), 4 - uxSent, portMAX_DELAY );
+ *  }
+ * @endcode
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                const void * const pvItemsToQueue,
+                                UBaseType_t uxItemCount,
+                                TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueReceiveMultiple(
+ *                                    QueueHandle_t xQueue,
+ *                                    void * pvBuffer,
+ *                                    UBaseType_t uxMaxItems,
+ *                                    TickType_t xTicksToWait
+ *                                  );
+ * @endcode
+ *
+ * Receive up to uxMaxItems items from a queue into consecutive slots of
+ * pvBuffer, oldest first.  All the items are removed inside a single critical
+ * section rather than one per item, which is where the saving lies.  Tasks
+ * waiting to send are still unblocked one per item removed, as if each item
+ * had been received on its own.  Items that are one word in size and word
+ * aligned are copied without memcpy().
+ *
+ * The call only blocks while the queue is empty.  As soon as at least one
+ * item is available, every available item up to uxMaxItems is received and
+ * the call returns.
+ *
+ * This function must not be used in an interrupt service routine, on a queue
+ * that is a member of a queue set, or on a semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer with room for uxMaxItems items.
+ *
+ * @param uxMaxItems The most items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty at the time of
+ * the call.
+ *
+ * @return The number of items received, which is zero if the queue stayed
+ * empty for the whole block time.
+ *
+ * Example usage:
+ * @code{c}
+ * int32_t lTargets[ 10 ];
+ * UBaseType_t uxReceived;
+ *
+ *  // Drain the queue without blocking and keep only the newest value.
+ *  uxReceived = xQueueReceiveMultiple( xQueue, lTargets, 10, 0 );
+ *  if( uxReceived > 0 )
+ *  {
+ *      lTarget = lTargets[ uxReceived - 1 ];
+ *  }
+ * @endcode
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                   void * const pvBuffer,
+                                   UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * @code{c}
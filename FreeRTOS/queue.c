@@ -203,6 +203,19 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Batch versions of the above for xQueueSendMultiple() and
+ * xQueueReceiveMultiple().  The caller has already checked that the queue
+ * holds, or has room for, uxCount items.  Must be called from a critical
+ * section.
+ */
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue,
+                                    const void * pvItems,
+                                    UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue,
+                                      void * pvBuffer,
+                                      UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -1518,6 +1531,301 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                const void * const pvItemsToQueue,
+                                UBaseType_t uxItemCount,
+                                TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t uxSpace;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItemsToQueue == NULL ) && ( uxItemCount != ( UBaseType_t ) 0U ) ) );
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        /* A queue set holds one entry per item, so it cannot be told about a
+         * batch at once. */
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    }
+    #endif
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxItemCount == ( UBaseType_t ) 0U )
+    {
+        return ( UBaseType_t ) 0U;
+    }
+
+    /*lint -save -e904 This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            uxSpace = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+            if( uxSpace > ( UBaseType_t ) 0U )
+            {
+                if( uxItemCount < uxSpace )
+                {
+                    uxSpace = uxItemCount;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvCopyMultipleToQueue( pxQueue, pvItemsToQueue, uxSpace );
+
+                /* Unblock one waiting receiver per item posted, stopping as
+                 * soon as the waiting list is empty.  Yielding from within
+                 * the critical section is ok - the kernel takes care of that. */
+                for( uxItemCount = uxSpace; uxItemCount > ( UBaseType_t ) 0U; uxItemCount-- )
+                {
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        break;
+                    }
+
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                taskEXIT_CRITICAL();
+                return uxSpace;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* The queue was full and no block time is specified (or
+                     * the block time has expired) so leave now. */
+                    taskEXIT_CRITICAL();
+                    traceQUEUE_SEND_FAILED( pxQueue );
+                    return ( UBaseType_t ) 0U;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    /* The queue was full and a block time was specified so
+                     * configure the timeout structure. */
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Interrupts and other tasks can send to and receive from the queue
+         * now the critical section has been exited. */
+
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        /* Update the timeout state to see if it has expired yet. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+            }
+            else
+            {
+                /* Try again. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* The timeout has expired. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+
+            traceQUEUE_SEND_FAILED( pxQueue );
+            return ( UBaseType_t ) 0U;
+        }
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                   void * const pvBuffer,
+                                   UBaseType_t uxMaxItems,
+                                   TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    UBaseType_t uxAvailable;
+    UBaseType_t uxWake;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    }
+    #endif
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxMaxItems == ( UBaseType_t ) 0U )
+    {
+        return ( UBaseType_t ) 0U;
+    }
+
+    /*lint -save -e904  This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            uxAvailable = pxQueue->uxMessagesWaiting;
+
+            if( uxAvailable > ( UBaseType_t ) 0U )
+            {
+                if( uxMaxItems < uxAvailable )
+                {
+                    uxAvailable = uxMaxItems;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvCopyMultipleFromQueue( pxQueue, pvBuffer, uxAvailable );
+
+                /* Unblock one waiting sender per slot freed, stopping as soon
+                 * as the waiting list is empty. */
+                for( uxWake = uxAvailable; uxWake > ( UBaseType_t ) 0U; uxWake-- )
+                {
+                    if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        break;
+                    }
+
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                taskEXIT_CRITICAL();
+                return uxAvailable;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* The queue was empty and no block time is specified (or
+                     * the block time has expired) so leave now. */
+                    taskEXIT_CRITICAL();
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    return ( UBaseType_t ) 0U;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    /* The queue was empty and a block time was specified so
+                     * configure the timeout structure. */
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Interrupts and other tasks can send to and receive from the queue
+         * now the critical section has been exited. */
+
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        /* Update the timeout state to see if it has expired yet. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* The queue contains data again.  Loop back to try and read the
+                 * data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* Timed out.  If there is no data in the queue exit, otherwise loop
+             * back and attempt to read the data. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                return ( UBaseType_t ) 0U;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                                 TickType_t xTicksToWait )
 {
@@ -2276,6 +2584,100 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
 }
 /*-----------------------------------------------------------*/
 
+static void prvCopyMultipleToQueue( Queue_t * const pxQueue,
+                                    const void * pvItems,
+                                    UBaseType_t uxCount )
+{
+    const size_t xItemSize = ( size_t ) pxQueue->uxItemSize;
+    const int8_t * pcSource = ( const int8_t * ) pvItems;
+    int8_t * pcWriteTo = pxQueue->pcWriteTo;
+
+    /* Word sized items can be moved as words when both ends are aligned,
+     * which avoids a memcpy() call per item. */
+    const BaseType_t xWordCopy = ( ( xItemSize == sizeof( uint32_t ) ) &&
+                                   ( ( ( ( portPOINTER_SIZE_TYPE ) pcSource | ( portPOINTER_SIZE_TYPE ) pxQueue->pcHead ) & ( portPOINTER_SIZE_TYPE ) ( sizeof( uint32_t ) - 1U ) ) == 0U ) ) ? pdTRUE : pdFALSE;
+
+    /* This function is called from a critical section. */
+
+    while( uxCount > ( UBaseType_t ) 0U )
+    {
+        traceQUEUE_SEND( pxQueue );
+
+        if( xWordCopy != pdFALSE )
+        {
+            *( ( uint32_t * ) pcWriteTo ) = *( ( const uint32_t * ) pcSource ); /*lint !e9087 !e826 Alignment checked above. */
+        }
+        else
+        {
+            ( void ) memcpy( ( void * ) pcWriteTo, ( const void * ) pcSource, xItemSize ); /*lint !e961 !e418 !e9087 Copy length specified in bytes. */
+        }
+
+        pcSource += xItemSize;
+        pcWriteTo += xItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+
+        if( pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+        {
+            pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->uxMessagesWaiting++;
+        uxCount--;
+    }
+
+    pxQueue->pcWriteTo = pcWriteTo;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleFromQueue( Queue_t * const pxQueue,
+                                      void * pvBuffer,
+                                      UBaseType_t uxCount )
+{
+    const size_t xItemSize = ( size_t ) pxQueue->uxItemSize;
+    int8_t * pcDest = ( int8_t * ) pvBuffer;
+    int8_t * pcReadFrom = pxQueue->u.xQueue.pcReadFrom;
+    const BaseType_t xWordCopy = ( ( xItemSize == sizeof( uint32_t ) ) &&
+                                   ( ( ( ( portPOINTER_SIZE_TYPE ) pcDest | ( portPOINTER_SIZE_TYPE ) pxQueue->pcHead ) & ( portPOINTER_SIZE_TYPE ) ( sizeof( uint32_t ) - 1U ) ) == 0U ) ) ? pdTRUE : pdFALSE;
+
+    /* This function is called from a critical section.  As in
+     * prvCopyDataFromQueue(), pcReadFrom points at the last item read. */
+
+    while( uxCount > ( UBaseType_t ) 0U )
+    {
+        traceQUEUE_RECEIVE( pxQueue );
+
+        pcReadFrom += xItemSize; /*lint !e9016 Pointer arithmetic on char types ok. */
+
+        if( pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+        {
+            pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xWordCopy != pdFALSE )
+        {
+            *( ( uint32_t * ) pcDest ) = *( ( const uint32_t * ) pcReadFrom ); /*lint !e9087 !e826 Alignment checked above. */
+        }
+        else
+        {
+            ( void ) memcpy( ( void * ) pcDest, ( const void * ) pcReadFrom, xItemSize ); /*lint !e961 !e418 !e9087 Copy length specified in bytes. */
+        }
+
+        pcDest += xItemSize;
+        pxQueue->uxMessagesWaiting--;
+        uxCount--;
+    }
+
+    pxQueue->u.xQueue.pcReadFrom = pcReadFrom;
+}
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
     /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -60,6 +60,35 @@
     #define tmrNO_DELAY                    ( ( TickType_t ) 0U )
     #define tmrMAX_TIME_BEFORE_OVERFLOW    ( ( TickType_t ) -1 )
 
+/* Set configUSE_TIMER_WHEEL to 1 in FreeRTOSConfig.h to keep active timers in
+ * a hierarchical timing wheel instead of a sorted list.  Starting, stopping or
+ * resetting a timer is then O(1) whatever the number of active timers, and all
+ * the timers due on a tick are expired as one batch.  The wheel has
+ * configTIMER_WHEEL_LEVELS levels of 2^configTIMER_WHEEL_BITS slots; level n
+ * slots are 2^(n * configTIMER_WHEEL_BITS) ticks wide.  Timers further out
+ * than the wheel spans wait in an unsorted list that is redistributed each
+ * time the top level wraps.  RAM cost is one List_t per slot plus one. */
+    #ifndef configUSE_TIMER_WHEEL
+        #define configUSE_TIMER_WHEEL    0
+    #endif
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+        #ifndef configTIMER_WHEEL_BITS
+            #define configTIMER_WHEEL_BITS    4
+        #endif
+        #ifndef configTIMER_WHEEL_LEVELS
+            #define configTIMER_WHEEL_LEVELS    3
+        #endif
+
+        #if ( configTIMER_WHEEL_BITS > 5 ) || ( ( configTIMER_WHEEL_BITS * configTIMER_WHEEL_LEVELS ) >= 31 ) || ( configUSE_16_BIT_TICKS == 1 )
+            #error Timer wheel needs 32-bit ticks, at most 5 bits per level and a span below 2^31 ticks.
+        #endif
+
+        #define tmrWHEEL_SLOTS    ( ( UBaseType_t ) 1U << configTIMER_WHEEL_BITS )
+        #define tmrWHEEL_MASK     ( ( TickType_t ) tmrWHEEL_SLOTS - 1U )
+        #define tmrWHEEL_SPAN     ( ( TickType_t ) 1U << ( configTIMER_WHEEL_BITS * configTIMER_WHEEL_LEVELS ) )
+    #endif /* configUSE_TIMER_WHEEL */
+
 /* The name assigned to the timer service task.  This can be overridden by
  * defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
     #ifndef configTIMER_SERVICE_TASK_NAME
@@ -134,10 +163,23 @@
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #else
+
+/* The timing wheel.  Each slot list is unordered.  ulTimerWheelOccupied holds
+ * one bit per non-empty slot so the next slot with work can be found without
+ * touching the lists.  xTimerWheelTime is the last tick the wheel has been
+ * advanced to; all timers due at or before it have been processed. */
+        PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_WHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+        PRIVILEGED_DATA static List_t xTimerWheelFar;
+        PRIVILEGED_DATA static uint32_t ulTimerWheelOccupied[ configTIMER_WHEEL_LEVELS ];
+        PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+        PRIVILEGED_DATA static UBaseType_t uxTimerWheelCount = ( UBaseType_t ) 0U;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -184,18 +226,21 @@
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -203,20 +248,49 @@
  */
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
 /*
  * If the timer list contains any active timers then return the expire time of
  * the timer that will expire first and set *pxListWasEmpty to false.  If the
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
  * to pdTRUE.
  */
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
 /*
  * If a timer has expired, process it.  Otherwise, block the timer service task
  * until either a timer does expire or a command is received.
  */
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
-                                            BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
+        static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                                BaseType_t xListWasEmpty ) PRIVILEGED_FUNCTION;
+    #else /* configUSE_TIMER_WHEEL */
+
+/*
+ * Place a timer, whose list item value already holds its expiry time, in the
+ * wheel slot for that time, or remove it from whichever slot it is in.
+ */
+        static void prvWheelInsert( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+        static void prvWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the number of ticks after xTimerWheelTime at which the wheel next
+ * has work to do (a level 0 slot to expire or a higher slot to cascade), or
+ * set *pxWheelWasEmpty to pdTRUE if no timer is active.
+ */
+        static TickType_t prvWheelTicksToNextEvent( BaseType_t * const pxWheelWasEmpty ) PRIVILEGED_FUNCTION;
+
+/*
+ * Advance the wheel to xTimeNow, cascading and expiring every slot with work
+ * on the way.
+ */
+        static void prvWheelAdvance( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Wheel counterpart of prvProcessTimerOrBlockTask().
+ */
+        static void prvWheelProcessOrBlockTask( void ) PRIVILEGED_FUNCTION;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Called after a Timer_t structure has been allocated either statically or
@@ -538,6 +612,8 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
@@ -563,12 +639,16 @@
         traceTIMER_EXPIRED( pxTimer );
         pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static portTASK_FUNCTION( prvTimerTask, pvParameters )
     {
-        TickType_t xNextExpireTime;
-        BaseType_t xListWasEmpty;
+        #if ( configUSE_TIMER_WHEEL == 0 )
+            TickType_t xNextExpireTime;
+            BaseType_t xListWasEmpty;
+        #endif
 
         /* Just to avoid compiler warnings. */
         ( void ) pvParameters;
@@ -587,13 +667,23 @@
 
         for( ; ; )
         {
-            /* Query the timers list to see if it contains any timers, and if so,
-             * obtain the time at which the next timer will expire. */
-            xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+            #if ( configUSE_TIMER_WHEEL == 0 )
+            {
+                /* Query the timers list to see if it contains any timers, and if so,
+                 * obtain the time at which the next timer will expire. */
+                xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
 
-            /* If a timer has expired, process it.  Otherwise, block this task
-             * until either a timer does expire, or a command is received. */
-            prvProcessTimerOrBlockTask( xNextExpireTime, xListWasEmpty );
+                /* If a timer has expired, process it.  Otherwise, block this task
+                 * until either a timer does expire, or a command is received. */
+                prvProcessTimerOrBlockTask( xNextExpireTime, xListWasEmpty );
+            }
+            #else
+            {
+                /* Expire every timer that is due, or block until one is or a
+                 * command is received. */
+                prvWheelProcessOrBlockTask();
+            }
+            #endif /* configUSE_TIMER_WHEEL */
 
             /* Empty the command queue. */
             prvProcessReceivedCommands();
@@ -601,6 +691,8 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
     static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
                                             BaseType_t xListWasEmpty )
     {
@@ -688,6 +780,246 @@
 
         return xNextExpireTime;
     }
+
+    #else /* configUSE_TIMER_WHEEL */
+
+    static void prvWheelInsert( Timer_t * const pxTimer )
+    {
+        const TickType_t xExpiry = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+        const TickType_t xDelta = xExpiry - xTimerWheelTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxSlot;
+
+        /* The level is the lowest one whose span covers the remaining time, so
+         * the slot is at most one revolution ahead of the level's current slot
+         * and is only reached again once the timer is (nearly) due. */
+        for( uxLevel = 0; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+        {
+            if( xDelta < ( ( TickType_t ) 1U << ( configTIMER_WHEEL_BITS * ( uxLevel + 1U ) ) ) )
+            {
+                uxSlot = ( UBaseType_t ) ( ( xExpiry >> ( configTIMER_WHEEL_BITS * uxLevel ) ) & tmrWHEEL_MASK );
+                vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+                ulTimerWheelOccupied[ uxLevel ] |= ( 1UL << uxSlot );
+                uxTimerWheelCount++;
+                return;
+            }
+        }
+
+        vListInsertEnd( &xTimerWheelFar, &( pxTimer->xTimerListItem ) );
+        uxTimerWheelCount++;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelRemove( Timer_t * const pxTimer )
+    {
+        List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+        UBaseType_t uxIndex;
+
+        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+        uxTimerWheelCount--;
+
+        if( ( pxList != &xTimerWheelFar ) && ( listLIST_IS_EMPTY( pxList ) != pdFALSE ) )
+        {
+            uxIndex = ( UBaseType_t ) ( pxList - &( xTimerWheel[ 0 ][ 0 ] ) );
+            ulTimerWheelOccupied[ uxIndex >> configTIMER_WHEEL_BITS ] &= ~( 1UL << ( uxIndex & tmrWHEEL_MASK ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvWheelTicksToNextEvent( BaseType_t * const pxWheelWasEmpty )
+    {
+        TickType_t xBest = portMAX_DELAY;
+        TickType_t xTicks;
+        TickType_t xLevelTime;
+        UBaseType_t uxLevel;
+        UBaseType_t uxDistance;
+        UBaseType_t uxCurrent;
+
+        *pxWheelWasEmpty = ( uxTimerWheelCount == ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE;
+
+        if( *pxWheelWasEmpty != pdFALSE )
+        {
+            return ( TickType_t ) 0U;
+        }
+
+        for( uxLevel = 0; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+        {
+            if( ulTimerWheelOccupied[ uxLevel ] == 0UL )
+            {
+                continue;
+            }
+
+            /* Nearest occupied slot ahead of the level's current slot.  A
+             * slot at distance tmrWHEEL_SLOTS is the current slot itself,
+             * which is next reached one revolution from now. */
+            xLevelTime = xTimerWheelTime >> ( configTIMER_WHEEL_BITS * uxLevel );
+            uxCurrent = ( UBaseType_t ) ( xLevelTime & tmrWHEEL_MASK );
+
+            for( uxDistance = 1; uxDistance < tmrWHEEL_SLOTS; uxDistance++ )
+            {
+                if( ( ulTimerWheelOccupied[ uxLevel ] & ( 1UL << ( ( uxCurrent + uxDistance ) & tmrWHEEL_MASK ) ) ) != 0UL )
+                {
+                    break;
+                }
+            }
+
+            /* The slot is processed when the lower levels roll over into it. */
+            xTicks = ( ( xLevelTime + uxDistance ) << ( configTIMER_WHEEL_BITS * uxLevel ) ) - xTimerWheelTime;
+
+            if( xTicks < xBest )
+            {
+                xBest = xTicks;
+            }
+        }
+
+        if( listLIST_IS_EMPTY( &xTimerWheelFar ) == pdFALSE )
+        {
+            /* Far timers are redistributed when the top level wraps. */
+            xTicks = tmrWHEEL_SPAN - ( xTimerWheelTime & ( tmrWHEEL_SPAN - 1U ) );
+
+            if( xTicks < xBest )
+            {
+                xBest = xTicks;
+            }
+        }
+
+        return xBest;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelCascade( List_t * const pxList )
+    {
+        UBaseType_t uxCount = listCURRENT_LIST_LENGTH( pxList );
+        Timer_t * pxTimer;
+
+        /* Re-file each timer by its remaining time.  Counting first stops a
+         * far timer that is still out of range from being visited twice. */
+        while( uxCount > ( UBaseType_t ) 0U )
+        {
+            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too. */
+            prvWheelRemove( pxTimer );
+            prvWheelInsert( pxTimer );
+            uxCount--;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelAdvance( const TickType_t xTimeNow )
+    {
+        BaseType_t xWheelWasEmpty;
+        TickType_t xTicks;
+        TickType_t xExpiredTime;
+        List_t * pxSlot;
+        Timer_t * pxTimer;
+        UBaseType_t uxLevel;
+        UBaseType_t uxCount;
+
+        for( ; ; )
+        {
+            xTicks = prvWheelTicksToNextEvent( &xWheelWasEmpty );
+
+            if( ( xWheelWasEmpty != pdFALSE ) || ( xTicks > ( TickType_t ) ( xTimeNow - xTimerWheelTime ) ) )
+            {
+                /* Nothing more is due, so the ticks up to now can be skipped. */
+                xTimerWheelTime = xTimeNow;
+                break;
+            }
+
+            xTimerWheelTime += xTicks;
+            xExpiredTime = xTimerWheelTime;
+
+            /* Cascade from the top down so timers moved out of a higher level
+             * can land in a lower level slot that is processed on this same
+             * tick. */
+            if( ( xExpiredTime & ( tmrWHEEL_SPAN - 1U ) ) == ( TickType_t ) 0U )
+            {
+                prvWheelCascade( &xTimerWheelFar );
+            }
+
+            for( uxLevel = ( UBaseType_t ) configTIMER_WHEEL_LEVELS - 1U; uxLevel > ( UBaseType_t ) 0U; uxLevel-- )
+            {
+                if( ( xExpiredTime & ( ( ( TickType_t ) 1U << ( configTIMER_WHEEL_BITS * uxLevel ) ) - 1U ) ) == ( TickType_t ) 0U )
+                {
+                    prvWheelCascade( &( xTimerWheel[ uxLevel ][ ( xExpiredTime >> ( configTIMER_WHEEL_BITS * uxLevel ) ) & tmrWHEEL_MASK ] ) );
+                }
+            }
+
+            /* Everything left in the level 0 slot is due now.  Counting first
+             * means a timer filed back into this slot is left for its next
+             * turn rather than fired again now. */
+            pxSlot = &( xTimerWheel[ 0 ][ xExpiredTime & tmrWHEEL_MASK ] );
+            uxCount = listCURRENT_LIST_LENGTH( pxSlot );
+
+            while( uxCount > ( UBaseType_t ) 0U )
+            {
+                uxCount--;
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too. */
+                prvWheelRemove( pxTimer );
+
+                if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                {
+                    prvReloadTimer( pxTimer, xExpiredTime, xTimeNow );
+                }
+                else
+                {
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+
+                traceTIMER_EXPIRED( pxTimer );
+                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvWheelProcessOrBlockTask( void )
+    {
+        TickType_t xTimeNow;
+        TickType_t xTicks;
+        BaseType_t xWheelWasEmpty;
+
+        vTaskSuspendAll();
+        {
+            xTimeNow = xTaskGetTickCount();
+            xTicks = prvWheelTicksToNextEvent( &xWheelWasEmpty );
+
+            if( ( xWheelWasEmpty == pdFALSE ) && ( xTicks <= ( TickType_t ) ( xTimeNow - xTimerWheelTime ) ) )
+            {
+                ( void ) xTaskResumeAll();
+                prvWheelAdvance( xTimeNow );
+            }
+            else
+            {
+                /* Tick wrap needs no special handling: all wheel arithmetic is
+                 * relative to xTimerWheelTime and modulo 2^32. */
+                if( xWheelWasEmpty == pdFALSE )
+                {
+                    xTicks -= ( TickType_t ) ( xTimeNow - xTimerWheelTime );
+                }
+                else
+                {
+                    xTicks = portMAX_DELAY;
+                }
+
+                vQueueWaitForMessageRestricted( xTimerQueue, xTicks, xWheelWasEmpty );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+    }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
@@ -697,15 +1029,24 @@
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
+        #if ( configUSE_TIMER_WHEEL == 0 )
         {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
+            if( xTimeNow < xLastTime )
+            {
+                prvSwitchTimerLists();
+                *pxTimerListsWereSwitched = pdTRUE;
+            }
+            else
+            {
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
         }
-        else
+        #else
         {
+            /* The wheel works modulo 2^32 and has no lists to switch. */
             *pxTimerListsWereSwitched = pdFALSE;
         }
+        #endif /* configUSE_TIMER_WHEEL */
 
         xLastTime = xTimeNow;
 
@@ -735,7 +1076,11 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #else
+                    prvWheelInsert( pxTimer );
+                #endif
             }
         }
         else
@@ -749,7 +1094,11 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #else
+                    prvWheelInsert( pxTimer );
+                #endif
             }
         }
 
@@ -799,7 +1148,11 @@
                 if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
                 {
                     /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    #if ( configUSE_TIMER_WHEEL == 0 )
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    #else
+                        prvWheelRemove( pxTimer );
+                    #endif
                 }
                 else
                 {
@@ -816,6 +1169,19 @@
                  *  pre-empted the timer daemon task after the xTimeNow value was set). */
                 xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    /* An idle wheel may be far behind; restart it from now so
+                     * the distance to the new expiry time stays within range.
+                     * Only here: a timer reloaded by prvWheelAdvance() must be
+                     * filed against the tick being processed, not a later one. */
+                    if( uxTimerWheelCount == ( UBaseType_t ) 0U )
+                    {
+                        xTimerWheelTime = xTimeNow;
+                    }
+                }
+                #endif
+
                 switch( xMessage.xMessageID )
                 {
                     case tmrCOMMAND_START:
@@ -905,6 +1271,8 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
     static void prvSwitchTimerLists( void )
     {
         TickType_t xNextExpireTime;
@@ -928,6 +1296,8 @@
         pxCurrentTimerList = pxOverflowTimerList;
         pxOverflowTimerList = pxTemp;
     }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -939,10 +1309,28 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #else
+                {
+                    UBaseType_t uxLevel, uxSlot;
+
+                    for( uxLevel = 0; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                        }
+                    }
+
+                    vListInitialise( &xTimerWheelFar );
+                }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -9,7 +9,7 @@
 #define configCPU_CLOCK_HZ                  ( ( unsigned long ) 50000000 )  // 【改】
 #define configTICK_RATE_HZ                  ( ( portTickType ) 1000 )  // 【改】
 #define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 200 )  // 【改】
-#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 28000 ) )   // 【改】
+//#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 24000 ) )   // unused: no heap, see configSUPPORT_DYNAMIC_ALLOCATION
 //#define configTICK_RATE_HZ                      1000
 #define configMAX_PRIORITIES                    5
 //#define configMINIMAL_STACK_SIZE                128
@@ -32,8 +32,8 @@
 #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
 
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION             0
-#define configSUPPORT_DYNAMIC_ALLOCATION            1
+#define configSUPPORT_STATIC_ALLOCATION             1   /* Every object is a static in its module */
+#define configSUPPORT_DYNAMIC_ALLOCATION            0   /* No heap_x.c is linked */
 //#define configTOTAL_HEAP_SIZE                       10240
 #define configAPPLICATION_ALLOCATED_HEAP            0
 #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP   0
@@ -41,13 +41,14 @@
 /* Hook function related definitions. */
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
-#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configCHECK_FOR_STACK_OVERFLOW          2   /* Checks the painted stack end too */
+#define configRECORD_STACK_HIGH_ADDRESS         1   /* Lets stack_monitor.c see each depth */
 #define configUSE_MALLOC_FAILED_HOOK            0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
-#define configUSE_TRACE_FACILITY                0
+#define configGENERATE_RUN_TIME_STATS           1   /* Timer and hooks in runtime_stats.h */
+#define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
 /* Co-routine related definitions. */
@@ -57,9 +58,12 @@
 
 /* Software timer related definitions. */
 #define configUSE_TIMERS                        1
-#define configTIMER_TASK_PRIORITY               3
+#define configTIMER_TASK_PRIORITY               2   /* Runs the button and pot callbacks below control */
 #define configTIMER_QUEUE_LENGTH                10
 #define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+#define configUSE_TIMER_WHEEL                   0   /* 1: O(1) timing wheel in timers.c */
+#define configTIMER_WHEEL_BITS                  4   /* 16 slots per level */
+#define configTIMER_WHEEL_LEVELS                3   /* Wheel spans 4096 ticks */
 
 /* Interrupt nesting behaviour configuration. */
 /* See https://www.freertos.org/RTOS-Cortex-M3-M4.html */
@@ -110,8 +114,8 @@ a .c file (e.g. main.c). */
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
-#define INCLUDE_xTaskGetIdleTaskHandle          0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
 #define INCLUDE_xTimerPendFunctionCall          0
@@ -120,5 +124,11 @@ a .c file (e.g. main.c). */
 #define INCLUDE_xTaskResumeFromISR              1
 
 /* A header file that defines trace macro can be included here. */
+#ifndef configUSE_TRACE_RECORDER
+#define configUSE_TRACE_RECORDER                0   /* 1 on the bench: see trace_recorder.h */
+#endif
+#include "runtime_stats.h"
+#include "stack_monitor.h"
+#include "trace_recorder.h"
 
 #endif /* FREERTOS_CONFIG_H */
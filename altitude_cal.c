@@ -0,0 +1,308 @@
+/******************************************************************************
+ *
+ * altitude_cal.c
+ *
+ * Purpose:
+ * Altitude sensor linearisation table, its calibration sweep and its EEPROM
+ * record. See altitude_cal.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "altitude_cal.h"    // Altitude linearisation
+#include "driverlib/sysctl.h"
+#include "driverlib/eeprom.h"
+#include "log_task.h"        // Deferred log
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define CAL_RECORD_ADDRESS  0           // Byte offset of the record in EEPROM
+#define CAL_RECORD_MAGIC    0x414C5431  // "ALT1"
+
+#define CAL_SEGMENT_MASK    ((1 << ALTITUDE_CAL_SEGMENT_BITS) - 1)
+#define CAL_MAX_DROP        ((1 << ALTITUDE_CAL_RANGE_BITS) - 1)
+
+/** @brief The EEPROM record. A whole number of words, as the EEPROM needs. */
+typedef struct {
+    uint32_t ui32Magic;
+    uint16_t pui16Table[ALTITUDE_CAL_TABLE_SIZE];
+    uint16_t pui16Pad[(ALTITUDE_CAL_TABLE_SIZE & 1) ? 1 : 2];
+    uint32_t ui32Check;         // Complement of the sum of the words above
+} calRecord_t;
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+/**
+ * @brief Two tables: the one in use, and the one a sweep builds into. A new
+ * table is published by switching the pointer, a single word store, so the
+ * control and display tasks never see half of one.
+ */
+static uint16_t g_ppui16Tables[2][ALTITUDE_CAL_TABLE_SIZE];
+static const uint16_t * volatile g_pui16Table = g_ppui16Tables[0];
+
+static volatile bool g_bSweepActive = false;
+static uint32_t g_ui32SweepPoint;
+static uint32_t g_ui32SweepGround;
+static uint32_t g_pui32SweepDrops[ALTITUDE_CAL_POINTS];
+
+static bool g_bEEPROMReady = false;
+
+// LOCAL FUNCTION PROTOTYPES---------------------------------------------------
+
+static uint32_t recordCheck(const calRecord_t *psRecord);
+static void identityTable(uint16_t *pui16Table);
+static bool saveTable(const uint16_t *pui16Table);
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Complement of the sum of every word before ui32Check, so an erased
+ * (all ones) record never passes.
+ */
+static uint32_t
+recordCheck(const calRecord_t *psRecord)
+{
+    const uint32_t *pui32Word = (const uint32_t *)psRecord;
+    uint32_t ui32Sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < (sizeof(calRecord_t) / 4) - 1; i++)
+    {
+        ui32Sum += pui32Word[i];
+    }
+
+    return ~ui32Sum;
+}
+
+/**
+ * @brief Height equal to drop: the conversion used before calibration.
+ */
+static void
+identityTable(uint16_t *pui16Table)
+{
+    uint32_t i;
+
+    for (i = 0; i < ALTITUDE_CAL_TABLE_SIZE; i++)
+    {
+        pui16Table[i] = (uint16_t)(i << ALTITUDE_CAL_SEGMENT_BITS);
+    }
+}
+
+/**
+ * @brief Writes the table to EEPROM. Returns false if programming failed.
+ */
+static bool
+saveTable(const uint16_t *pui16Table)
+{
+    calRecord_t sRecord;
+    uint32_t i;
+
+    if (!g_bEEPROMReady)
+    {
+        return false;
+    }
+
+    sRecord.ui32Magic = CAL_RECORD_MAGIC;
+    for (i = 0; i < ALTITUDE_CAL_TABLE_SIZE; i++)
+    {
+        sRecord.pui16Table[i] = pui16Table[i];
+    }
+    for (i = 0; i < sizeof(sRecord.pui16Pad) / 2; i++)
+    {
+        sRecord.pui16Pad[i] = 0;
+    }
+    sRecord.ui32Check = recordCheck(&sRecord);
+
+    return EEPROMProgram((uint32_t *)&sRecord, CAL_RECORD_ADDRESS,
+                         sizeof(sRecord)) == 0;
+}
+
+
+bool
+AltitudeCalBuild(const uint32_t *pui32Drops, uint16_t *pui16Table)
+{
+    uint32_t ui32Span = pui32Drops[ALTITUDE_CAL_POINTS - 1];
+    uint32_t ui32Segment = 0;
+    uint32_t i;
+
+    if (pui32Drops[0] != 0 || ui32Span < ALTITUDE_CAL_MIN_SPAN ||
+        ui32Span > CAL_MAX_DROP)
+    {
+        return false;
+    }
+    for (i = 1; i < ALTITUDE_CAL_POINTS; i++)
+    {
+        if (pui32Drops[i] <= pui32Drops[i - 1])
+        {
+            return false;
+        }
+    }
+
+    // Point k is at k / (points - 1) of the full height, which is scaled to
+    // the full drop so a linear rig gives back the identity table. Drops
+    // past the top point carry on along the last segment.
+    for (i = 0; i < ALTITUDE_CAL_TABLE_SIZE; i++)
+    {
+        uint32_t ui32Drop = i << ALTITUDE_CAL_SEGMENT_BITS;
+        uint32_t ui32D0, ui32D1, ui32H0, ui32H1, ui32Height;
+
+        while (ui32Segment < ALTITUDE_CAL_POINTS - 2 &&
+               ui32Drop > pui32Drops[ui32Segment + 1])
+        {
+            ui32Segment++;
+        }
+
+        ui32D0 = pui32Drops[ui32Segment];
+        ui32D1 = pui32Drops[ui32Segment + 1];
+        ui32H0 = ui32Segment * ui32Span / (ALTITUDE_CAL_POINTS - 1);
+        ui32H1 = (ui32Segment + 1) * ui32Span / (ALTITUDE_CAL_POINTS - 1);
+
+        // Rounded to nearest. Every term is below 2^12, so no overflow.
+        ui32Height = ui32H0 + ((ui32Drop - ui32D0) * (ui32H1 - ui32H0) +
+                               (ui32D1 - ui32D0) / 2) / (ui32D1 - ui32D0);
+        pui16Table[i] = ui32Height > UINT16_MAX ? UINT16_MAX :
+                                                  (uint16_t)ui32Height;
+    }
+
+    return true;
+}
+
+
+uint32_t
+AltitudeCalInit(void)
+{
+    calRecord_t sRecord;
+    uint32_t i;
+
+    identityTable(g_ppui16Tables[0]);
+    g_pui16Table = g_ppui16Tables[0];
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0))
+    {
+    }
+    if (EEPROMInit() != EEPROM_INIT_OK)
+    {
+        return(1);
+    }
+    g_bEEPROMReady = true;
+
+    EEPROMRead((uint32_t *)&sRecord, CAL_RECORD_ADDRESS, sizeof(sRecord));
+    if (sRecord.ui32Magic != CAL_RECORD_MAGIC ||
+        sRecord.ui32Check != recordCheck(&sRecord))
+    {
+        LOG1(LOG_ALT_CAL, "no table saved, using the linear conversion");
+        return(0);
+    }
+
+    for (i = 0; i < ALTITUDE_CAL_TABLE_SIZE; i++)
+    {
+        g_ppui16Tables[0][i] = sRecord.pui16Table[i];
+    }
+    LOG1(LOG_ALT_CAL, "table loaded");
+
+    return(0);
+}
+
+
+uint32_t
+AltitudeCalHeight(uint32_t ui32Drop)
+{
+    const uint16_t *pui16Table = g_pui16Table;
+    uint32_t ui32Index, ui32Frac;
+    int32_t i32Low, i32High;
+
+    if (ui32Drop > CAL_MAX_DROP)
+    {
+        ui32Drop = CAL_MAX_DROP;
+    }
+
+    // Top bits pick the segment, low bits interpolate along it.
+    ui32Index = ui32Drop >> ALTITUDE_CAL_SEGMENT_BITS;
+    ui32Frac = ui32Drop & CAL_SEGMENT_MASK;
+    i32Low = pui16Table[ui32Index];
+    i32High = pui16Table[ui32Index + 1];
+
+    return (uint32_t)(i32Low + (((i32High - i32Low) * (int32_t)ui32Frac) >>
+                                ALTITUDE_CAL_SEGMENT_BITS));
+}
+
+
+void
+AltitudeCalBegin(void)
+{
+    g_ui32SweepPoint = 0;
+    g_bSweepActive = true;
+    LOG1(LOG_ALT_CAL, "sweep started, land and press Up");
+}
+
+
+bool
+AltitudeCalActive(void)
+{
+    return g_bSweepActive;
+}
+
+
+bool
+AltitudeCalRecord(uint32_t ui32ADC)
+{
+    uint16_t *pui16New;
+
+    if (!g_bSweepActive)
+    {
+        return false;
+    }
+
+    // The ADC reading falls as the helicopter rises. A reading above the
+    // ground one is recorded as no drop, which the build then rejects.
+    if (g_ui32SweepPoint == 0)
+    {
+        g_ui32SweepGround = ui32ADC;
+    }
+    g_pui32SweepDrops[g_ui32SweepPoint] =
+        ui32ADC < g_ui32SweepGround ? g_ui32SweepGround - ui32ADC : 0;
+    LOG3(LOG_ALT_CAL_POINT, g_ui32SweepPoint + 1, ALTITUDE_CAL_POINTS,
+         g_pui32SweepDrops[g_ui32SweepPoint]);
+
+    if (++g_ui32SweepPoint < ALTITUDE_CAL_POINTS)
+    {
+        return false;
+    }
+    g_bSweepActive = false;
+
+    // Build into whichever table is not in use, then publish it.
+    pui16New = (g_pui16Table == g_ppui16Tables[0]) ? g_ppui16Tables[1] :
+                                                     g_ppui16Tables[0];
+    if (!AltitudeCalBuild(g_pui32SweepDrops, pui16New))
+    {
+        LOG1(LOG_ALT_CAL, "sweep rejected, heights must rise steadily");
+        return true;
+    }
+    g_pui16Table = pui16New;
+
+    if (!saveTable(pui16New))
+    {
+        LOG1(LOG_ALT_CAL, "table in use but not saved, EEPROM write failed");
+        return true;
+    }
+    LOG1(LOG_ALT_CAL, "table saved");
+
+    return true;
+}
+
+
+void
+AltitudeCalAbort(void)
+{
+    if (g_bSweepActive)
+    {
+        g_bSweepActive = false;
+        LOG1(LOG_ALT_CAL, "sweep abandoned");
+    }
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * altitude_cal.h
+ *
+ * Purpose:
+ * Per-rig linearisation of the altitude sensor.
+ *
+ * The altitude ADC falls as the helicopter rises, but not in proportion to
+ * the real height. A guided sweep records the ADC drop from the ground at
+ * ALTITUDE_CAL_POINTS evenly spaced heights, from landed to the top of the
+ * rig. The points are joined piecewise-linearly and resampled into a table
+ * indexed by the top bits of the drop, which is kept in the on-chip EEPROM.
+ * AltitudeCalHeight() then maps a drop to a height that is proportional to
+ * the real height, in the same counts as before: a linear rig gives the
+ * same figures as the plain drop did.
+ *
+ * The sweep is run from the buttons while disarmed (see switch_task.c):
+ * hold Left and Right together to start, lift the helicopter by hand to each
+ * point in turn and press Up, or press Down to abandon the sweep. Progress
+ * is written to the log.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __ALTITUDE_CAL_H__
+#define __ALTITUDE_CAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Heights captured by a sweep, including the ground and the top. */
+#define ALTITUDE_CAL_POINTS     6
+
+/** @brief Table covers drops of 0 .. 2^ALTITUDE_CAL_RANGE_BITS - 1 counts. */
+#define ALTITUDE_CAL_RANGE_BITS 12
+
+/** @brief 2^ALTITUDE_CAL_SEGMENT_BITS counts of drop per table segment. */
+#define ALTITUDE_CAL_SEGMENT_BITS 7
+
+#define ALTITUDE_CAL_TABLE_SIZE \
+    ((1 << (ALTITUDE_CAL_RANGE_BITS - ALTITUDE_CAL_SEGMENT_BITS)) + 1)
+
+/** @brief Smallest ground-to-top drop a sweep may have to be accepted. */
+#define ALTITUDE_CAL_MIN_SPAN   200
+
+/**
+ * @brief Loads the table from EEPROM. An empty or corrupt record leaves the
+ * identity table, which matches the old linear conversion. Returns 0 unless
+ * the EEPROM itself could not be started.
+ */
+uint32_t AltitudeCalInit(void);
+
+/** @brief Height for a drop of ui32Drop ADC counts below the ground reading. */
+uint32_t AltitudeCalHeight(uint32_t ui32Drop);
+
+/** @brief Starts a sweep. The current table stays in use until it ends. */
+void AltitudeCalBegin(void);
+
+/** @brief True while a sweep is in progress. */
+bool AltitudeCalActive(void);
+
+/**
+ * @brief Records the ADC reading at the next sweep point. After the last
+ * point the table is built, checked and saved. Returns true if this ended
+ * the sweep.
+ */
+bool AltitudeCalRecord(uint32_t ui32ADC);
+
+/** @brief Abandons a sweep, keeping the current table. */
+void AltitudeCalAbort(void);
+
+/**
+ * @brief Builds a table from ALTITUDE_CAL_POINTS drops, ground first.
+ * Returns false unless the drops strictly increase and span at least
+ * ALTITUDE_CAL_MIN_SPAN counts. Exposed for the host-side checks.
+ */
+bool AltitudeCalBuild(const uint32_t *pui32Drops, uint16_t *pui16Table);
+
+#endif /* __ALTITUDE_CAL_H__ */
@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ * boot_trace.c
+ *
+ * Purpose:
+ * Start-up milestone timing. See boot_trace.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include "inc/hw_types.h"
+#include "FreeRTOS.h"        // configCPU_CLOCK_HZ
+#include "dwt.h"             // Cycle counter
+#include "boot_trace.h"      // Boot milestones
+#include "log_task.h"        // Deferred log
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define CYCLES_PER_US           (configCPU_CLOCK_HZ / 1000000)
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static uint32_t g_pui32BootMarkUs[BOOT_NUM_MARKS];
+static bool g_pbBootMarkSeen[BOOT_NUM_MARKS];
+
+static const char * const g_ppcBootMarkNames[BOOT_NUM_MARKS] = {
+    "critical init done",
+    "scheduler start",
+    "first control cycle",
+    "display ready"
+};
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+BootTraceStart(void)
+{
+    // The one place the counter is zeroed: milestones count from here.
+    // The DWT ignores writes until TRCENA is set, so enable it first.
+    DWTCycleCounterEnable();
+    HWREG(DWT_CYCCNT) = 0;
+}
+
+
+void
+BootTraceMark(bootMark_t eMark)
+{
+    uint32_t ui32Us = DWT_CYCLES() / CYCLES_PER_US;
+
+    // Each milestone is reached by a single task, so no locking is needed.
+    if (eMark >= BOOT_NUM_MARKS || g_pbBootMarkSeen[eMark])
+    {
+        return;
+    }
+
+    g_pui32BootMarkUs[eMark] = ui32Us;
+    g_pbBootMarkSeen[eMark] = true;
+    LOG2(LOG_BOOT_MARK, g_ppcBootMarkNames[eMark], ui32Us);
+}
+
+
+uint32_t
+BootTraceMicroseconds(bootMark_t eMark)
+{
+    if (eMark >= BOOT_NUM_MARKS)
+    {
+        return 0;
+    }
+
+    return g_pui32BootMarkUs[eMark];
+}
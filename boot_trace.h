@@ -0,0 +1,43 @@
+/******************************************************************************
+ *
+ * boot_trace.h
+ *
+ * Purpose:
+ * Start-up milestones timed with the DWT cycle counter, from the clock being
+ * set in main() to the first control cycle and the display coming up.
+ *
+ * Each milestone is logged once, in microseconds since BootTraceStart(), as
+ * a LOG_BOOT_MARK record, e.g.
+ *   Boot: first control cycle at 1840 us.
+ * so a change to the start-up order shows up directly in the UART log.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __BOOT_TRACE_H__
+#define __BOOT_TRACE_H__
+
+#include <stdint.h>
+
+/** @brief Start-up milestones, in the order they normally occur. */
+typedef enum {
+    BOOT_MARK_CRITICAL_READY = 0,   // Sensors, motors and control created
+    BOOT_MARK_SCHEDULER_START,      // About to start the scheduler
+    BOOT_MARK_FIRST_CONTROL,        // Control task finished its first cycle
+    BOOT_MARK_DISPLAY_READY,        // OLED initialised by the display task
+    BOOT_NUM_MARKS
+} bootMark_t;
+
+/** @brief Starts the cycle counter. Call first thing after the clock is set. */
+void BootTraceStart(void);
+
+/**
+ * @brief Records and logs a milestone the first time it is reached; later
+ * calls for the same milestone are ignored.
+ */
+void BootTraceMark(bootMark_t eMark);
+
+/** @brief Microseconds from BootTraceStart() to a milestone, 0 if not reached. */
+uint32_t BootTraceMicroseconds(bootMark_t eMark);
+
+#endif /* __BOOT_TRACE_H__ */
@@ -41,9 +41,75 @@
 // 12 bit ADC maximum value
 #define ADC_MAX_VALUE 4095
 
+//  ******************************* Setpoints *********************************
+// Control targets are sent as height (0..HEIGHT_TARGET_MAX, in the same units
+// as the measured height) and yaw in degrees (-180..179).
+#define HEIGHT_TARGET_MAX 1000
+#define HEIGHT_TARGET_STEP 100      // Per Up/Down button press
+#define YAW_TARGET_STEP 15          // Per Left/Right button press, degrees
+
+// Which axis the potentiometer drives. The buttons keep the other axis. In
+// HEIGHT mode the pot is ignored until it has been turned down to zero, so
+// one left up at power-up cannot set a target.
+#define POT_SETPOINT_NONE 0
+#define POT_SETPOINT_HEIGHT 1
+#define POT_SETPOINT_YAW 2
+#define POT_SETPOINT_MODE POT_SETPOINT_NONE
+
 //  ******************************* CircBuf ***********************************
 #define BUF_SIZE 5      // Buffer size for Altitude
 
+//  ******************************* Altitude filter ***************************
+// How the height task smooths the altitude ADC readings.
+//  BOXCAR: mean of the last BUF_SIZE readings.
+//  BIQUAD: second-order Butterworth low-pass (dsp_filter.h), cut-off about
+//          20 Hz at the 500 Hz control rate (CONTROL_PERIOD_MS). Much
+//          better rejection of rotor vibration.
+#define ALTITUDE_FILTER_BOXCAR 0
+#define ALTITUDE_FILTER_BIQUAD 1
+#define ALTITUDE_FILTER ALTITUDE_FILTER_BOXCAR
+
+// Spike rejection in front of the filter above, so a single bad ADC sample
+// does not reach the PID.
+//  NONE:   readings go straight to the filter.
+//  MEDIAN: median of the last ALTITUDE_SPIKE_WINDOW readings.
+//  HAMPEL: a reading more than ALTITUDE_SPIKE_SIGMAS deviations from that
+//          median is replaced by it; others pass through without delay.
+#define ALTITUDE_SPIKE_NONE 0
+#define ALTITUDE_SPIKE_MEDIAN 1
+#define ALTITUDE_SPIKE_HAMPEL 2
+#define ALTITUDE_SPIKE_FILTER ALTITUDE_SPIKE_HAMPEL
+#define ALTITUDE_SPIKE_WINDOW 5     // 3, 5, 7 or 9
+#define ALTITUDE_SPIKE_SIGMAS 3
+
+//  ******************************* Control ***********************************
+// The height task samples the altitude every CONTROL_PERIOD_MS and hands each
+// reading to the control task, so this is the control period too. DT in
+// tools/heli_sim.py, and the gain and region tables built from it, assume it.
+#define CONTROL_PERIOD_MS 2
+
+// Which controller the control task runs. Compare them on the host with
+// tools/heli_sim.py before flying a change.
+//  SINGLE_LOOP: PI on the height and yaw errors straight to the duties.
+//  CASCADE:     position loops at 1/CONTROL_OUTER_DIVIDER of the control
+//               rate setting vertical speed and yaw rate targets for inner
+//               rate loops at the full rate.
+//  LQR:         both duties from the full height and yaw state through the
+//               gain table in lqr_gains.c (tools/lqr_gains.py).
+//  EMPC:        explicit MPC, the same state through the region table in
+//               empc_regions.c (tools/empc_gen.py), which knows the duty
+//               limits.
+#define CONTROL_MODE_SINGLE_LOOP 0
+#define CONTROL_MODE_CASCADE 1
+#define CONTROL_MODE_LQR 2
+#define CONTROL_MODE_EMPC 3
+#define CONTROL_MODE CONTROL_MODE_SINGLE_LOOP
+#define CONTROL_OUTER_DIVIDER 5
+// Set to 1 to identify the rig in flight (plant_id.h): its hover duty, tail
+// trim, main-to-tail coupling and rotor lag are fitted from the duties sent
+// and the height and yaw measured, and logged with the CPU stats.
+#define PLANT_ID_ENABLE 0
+
 //  ******************************* PWM GPIO **********************************
 //  ****** Main Motor 
 #define PWM_MAIN_BASE PWM0_BASE
@@ -88,6 +154,20 @@
 #define YAW_REF_PIN GPIO_PIN_4
 
 
+//*****************************************************************************
+
+//  ******************************* Telemetry ********************************
+// Set to 1 to stream binary control-loop records (telemetry.h) on UART0,
+// interleaved with the text log. Decode with tools/telemetry_decode.py.
+#define TELEMETRY_ENABLE 0
+
+//*****************************************************************************
+
+//  ***************************** Kernel benchmark *****************************
+// Set to 1 to build the FreeRTOS primitive benchmark (kernel_bench.h) instead
+// of the helicopter application. Results are printed on UART0 as CSV.
+#define KERNEL_BENCH_ENABLE 0
+
 //*****************************************************************************
 
 // Function declarations for UART config
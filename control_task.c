@@ -13,6 +13,7 @@
 #include "control_task.h"
 
 #include <stdio.h>
+#include <stdbool.h>
 
 #include "freeRTOS.h"
 #include "task.h"
@@ -22,7 +23,17 @@
 #include "driverlib/sysctl.h"
 #include "inc/hw_memmap.h"
 #include "semphr.h"
-#include "utils/uartstdio.h"
+#include "log_task.h"
+#include "trace_recorder.h"
+#include "telemetry.h"
+#include "system_state.h"
+#include "boot_trace.h"
+#include "altitude_cal.h"
+#include "config.h"
+#include "dsp_filter.h"
+#include "lqr_gains.h"
+#include "empc.h"
+#include "plant_id.h"
 
 //CONSTANTS----------------------------------------------------
 #define CONTROL_QUEUE_SIZE 10
@@ -38,89 +49,458 @@
 
 #define TIME_PER_TICK 12.5e-6 //ms
 
+//cascade gains, tuned in tools/heli_sim.py. Position loops output a speed
+//target (counts/s or deg/s), rate loops a duty offset (%) from the feed
+//forward. Each loop saturates at its own limits
+#define CASCADE_HEIGHT_POS_KP 4.0f
+#define CASCADE_HEIGHT_POS_KI 0.3f
+#define CASCADE_HEIGHT_RATE_MAX 600.0f
+#define CASCADE_HEIGHT_RATE_KP 0.08f
+#define CASCADE_HEIGHT_RATE_KI 0.3f
+#define CASCADE_YAW_POS_KP 6.0f
+#define CASCADE_YAW_POS_KI 0.0f
+#define CASCADE_YAW_RATE_MAX 360.0f
+#define CASCADE_YAW_RATE_KP 0.6f
+#define CASCADE_YAW_RATE_KI 0.5f
+#define MAIN_FEED_FORWARD 50
+#define TAIL_FEED_FORWARD 40
+#define TAIL_PWM_MAX 85
+
+#define RATE_FILTER_ALPHA 0.25f      //low pass on the differenced rates
+#define LQR_INTEGRAL_LIMIT 2047.0f   //count.s or deg.s, fits int16 in Q4
+
+//height above ground (ADC counts) at which the heli counts as airborne, and
+//below which it counts as landed again
+#define AIRBORNE_ENTER_HEIGHT 20
+#define AIRBORNE_EXIT_HEIGHT 10
+
+//ground calibration: the ground reference is the mean of the filtered
+//height readings over GROUND_CAL_MS, accepted only if their variance is at
+//most GROUND_MAX_VARIANCE counts squared, i.e. the rig has settled. An
+//unsettled window is thrown away and collection starts again
+#define GROUND_CAL_MS 128
+#define GROUND_CAL_SAMPLES (GROUND_CAL_MS / CONTROL_PERIOD_MS)
+#define GROUND_MAX_VARIANCE 9
+#if GROUND_CAL_SAMPLES > 256
+#error "GROUND_CAL_MS: the sum of squares would overflow 32 bits"
+#endif
+
 //STATICS AND GLOBALS------------------------------------------------------
 
+#if CONTROL_MODE == CONTROL_MODE_CASCADE
+//a PI loop with its own output limits. The integral is only advanced when
+//that would not drive a saturated output further into its limit
+typedef struct {
+    float kp;
+    float ki;
+    float out_min;
+    float out_max;
+    float integral;
+} pi_loop_t;
+#endif
+
+#if CONTROL_MODE != CONTROL_MODE_SINGLE_LOOP
+//rate estimated by differencing successive readings through a low pass
+typedef struct {
+    float prev;
+    float rate;
+    bool primed;
+} rate_est_t;
+#endif
+
 QueueHandle_t g_MeasHeightControlQueue;
 QueueHandle_t g_MeasYawControlQueue;
 QueueHandle_t g_TargHeightControlQueue;
 QueueHandle_t g_TargYawControlQueue;
 
-extern xSemaphoreHandle g_pUARTSemaphore;
+//statically allocated task and queue memory
+#define CONTROL_NUM_QUEUES 4
+static StaticTask_t g_ControlTaskTCB;
+static StackType_t g_ControlTaskStack[CONTROL_STACK_SIZE];
+static StaticQueue_t g_ControlQueueBufs[CONTROL_NUM_QUEUES];
+static uint32_t g_ControlQueueStorage[CONTROL_NUM_QUEUES][CONTROL_QUEUE_SIZE]; //word aligned for batch reads
+
+//set by the operator's arm action, taken by the control task at its next cycle
+static volatile bool arm_requested = false;
+
 extern xSemaphoreHandle g_ControlSemaphore;
 extern xSemaphoreHandle g_ADCSemaphore;
 
 extern QueueHandle_t Q_tailDuty;
 extern QueueHandle_t Q_mainDuty;
 
-static uint32_t heights_array[11] = {
-
-    0,
-    100,
-    200,
-    300,
-    400,
-    500,
-    600,
-    700,
-    800,
-    900,
-    1000
-};
-
-static int32_t yaws_array[24] = {
-
-0,
-15,
-30,
-45,
-60,
-75,
-90,
-105,
-120,
-135,
-150,
-165,
-179,
--165,
--150,
--135,
--120,
--105,
--90,
--75,
--60,
--45,
--30,
--15
-
-};
-
 //LOCAL FUNCTION PTs-------------------------------------------
 
 static void  control_task(void *pvParameters);
+#if CONTROL_MODE != CONTROL_MODE_SINGLE_LOOP
+static float rate_update(rate_est_t* est, float value, float dt, bool wrap);
+#endif
+#if CONTROL_MODE == CONTROL_MODE_CASCADE
+static float pi_update(pi_loop_t* loop, float error, float dt);
+static void cascade_update(int32_t height, int32_t yaw, int32_t targ_height,
+                           int32_t targ_yaw, float dt, int32_t* main_pwm,
+                           int32_t* tail_pwm);
+#elif (CONTROL_MODE == CONTROL_MODE_LQR) || (CONTROL_MODE == CONTROL_MODE_EMPC)
+static int16_t feedback_state(float value);
+static void feedback_update(int32_t height, int32_t yaw, int32_t targ_height,
+                            int32_t targ_yaw, float dt, int32_t* main_pwm,
+                            int32_t* tail_pwm);
+#else
 static int32_t calc_proportional_gain(int32_t error);
 static int32_t calc_derivative_gain(int32_t error, uint32_t time_step);
 static int32_t calc_intergral_gain(int32_t error, uint32_t time_step);
 static int32_t calc_proportional_gain_yaw(int32_t error);
 static int32_t calc_derivative_gain_yaw(int32_t error, uint32_t time_step);
 static int32_t calc_intergral_gain_yaw(int32_t error, uint32_t time_step);
+#endif
 static void check_valid_pwm(int32_t* height_pwm);
 static uint32_t convert_to_height(uint32_t adc_val, uint32_t ground);
+static void ground_cal_sample(uint32_t adc_val);
+static void arm_on_request(EventBits_t state, int32_t targ_height);
+static int32_t wrap_yaw(int32_t yaw);
 
 //FUNCTIONS----------------------------------------------------
 
-//used to calibrate the raw ADC values to something usable by the control system
+//used to calibrate the raw ADC values to something usable by the control system,
+//through the rig's linearisation table
 uint32_t convert_to_height(uint32_t adc_val, uint32_t ground)
 {
     if (adc_val > ground)
     {
         return 0;
     } else {
-        return (ground - adc_val) ;
+        return AltitudeCalHeight(ground - adc_val);
     }
 }
 
+//collects one reading towards the ground reference and publishes it through
+//SystemStateCalibrate() once a full window has settled. Deviations are taken
+//from the window's first reading so the sums stay small
+void ground_cal_sample(uint32_t adc_val)
+{
+    static uint32_t count = 0;
+    static uint32_t first;
+    static int32_t sum;
+    static uint32_t sum_sq;
+    int32_t dev;
+    int32_t mean_dev;
+    uint32_t variance;
+
+    if (count == 0) {
+
+        first = adc_val;
+        sum = 0;
+        sum_sq = 0;
+    }
+
+    //|dev| < 4096 so up to 256 squares fit in 32 bits
+    dev = (int32_t)adc_val - (int32_t)first;
+    sum += dev;
+    sum_sq += (uint32_t)(dev * dev);
+
+    if (++count < GROUND_CAL_SAMPLES) {
+
+        return;
+    }
+    count = 0;
+
+    //variance = E[dev^2] - E[dev]^2, rounded down
+    mean_dev = sum / GROUND_CAL_SAMPLES;
+    variance = sum_sq / GROUND_CAL_SAMPLES - (uint32_t)(mean_dev * mean_dev);
+
+    if (variance > GROUND_MAX_VARIANCE) {
+
+        LOG3(LOG_GROUND_CAL, first + mean_dev, variance, "unsettled, retrying");
+        return;
+    }
+
+    LOG3(LOG_GROUND_CAL, first + mean_dev, variance, "accepted");
+    SystemStateCalibrate(first + mean_dev);
+}
+
+//arms the motors if the operator asked since the last cycle. Only on the
+//ground with nothing asked for, so arming never moves the rotors by itself,
+//and never while someone is holding the helicopter for an altitude
+//calibration sweep
+void arm_on_request(EventBits_t state, int32_t targ_height)
+{
+    if (!arm_requested) {
+
+        return;
+    }
+    arm_requested = false;
+
+    if (state & (SYSTEM_STATE_ARMED | SYSTEM_STATE_FAULT)) {
+
+        return;
+    }
+    if (!(state & SYSTEM_STATE_CALIBRATED)) {
+
+        LOG1(LOG_ARM, "refused, ground not calibrated yet");
+    } else if (targ_height != 0) {
+
+        LOG1(LOG_ARM, "refused, height target not zero");
+    } else if (AltitudeCalActive()) {
+
+        LOG1(LOG_ARM, "refused, altitude calibration running");
+    } else {
+
+        SystemStateSet(SYSTEM_STATE_ARMED);
+    }
+}
+
+//asks the control task to arm the motors at its next cycle
+void control_request_arm(void)
+{
+    arm_requested = true;
+}
+
+//takes the shorter way around the circle: -180..179 degrees
+int32_t wrap_yaw(int32_t yaw)
+{
+    if (yaw >= 180) {
+
+        yaw -= 360;
+    } else if (yaw < -180) {
+
+        yaw += 360;
+    }
+    return yaw;
+}
+
+#if CONTROL_MODE != CONTROL_MODE_SINGLE_LOOP
+//updates a rate estimate from a new reading, yaw readings wrapping at 180
+float rate_update(rate_est_t* est, float value, float dt, bool wrap)
+{
+    float diff;
+
+    if (est->primed && (dt > 0)) {
+
+        diff = value - est->prev;
+        if (wrap) {
+            diff = wrap_yaw(diff);
+        }
+        est->rate += RATE_FILTER_ALPHA * (diff / dt - est->rate);
+    }
+    est->prev = value;
+    est->primed = true;
+    return est->rate;
+}
+#endif
+
+#if CONTROL_MODE == CONTROL_MODE_CASCADE
+//one step of a PI loop with output saturation and conditional integration
+float pi_update(pi_loop_t* loop, float error, float dt)
+{
+    float out = loop->kp * error + loop->integral;
+
+    if (out > loop->out_max) {
+
+        out = loop->out_max;
+        if (error < 0) {
+            loop->integral += loop->ki * error * dt;
+        }
+    } else if (out < loop->out_min) {
+
+        out = loop->out_min;
+        if (error > 0) {
+            loop->integral += loop->ki * error * dt;
+        }
+    } else {
+
+        loop->integral += loop->ki * error * dt;
+    }
+
+    //the integral alone must never hold the output past a limit either
+    if (loop->integral > loop->out_max) {
+
+        loop->integral = loop->out_max;
+    } else if (loop->integral < loop->out_min) {
+
+        loop->integral = loop->out_min;
+    }
+    return out;
+}
+
+//cascaded height and yaw control. The position loops run every
+//CONTROL_OUTER_DIVIDER calls and set the speed targets the rate loops track
+//at the full rate
+void cascade_update(int32_t height, int32_t yaw, int32_t targ_height,
+                    int32_t targ_yaw, float dt, int32_t* main_pwm,
+                    int32_t* tail_pwm)
+{
+    static pi_loop_t height_pos = {CASCADE_HEIGHT_POS_KP, CASCADE_HEIGHT_POS_KI,
+                                   -CASCADE_HEIGHT_RATE_MAX, CASCADE_HEIGHT_RATE_MAX, 0};
+    static pi_loop_t height_rate = {CASCADE_HEIGHT_RATE_KP, CASCADE_HEIGHT_RATE_KI,
+                                    -MAIN_FEED_FORWARD, 99 - MAIN_FEED_FORWARD, 0};
+    static pi_loop_t yaw_pos = {CASCADE_YAW_POS_KP, CASCADE_YAW_POS_KI,
+                                -CASCADE_YAW_RATE_MAX, CASCADE_YAW_RATE_MAX, 0};
+    static pi_loop_t yaw_rate = {CASCADE_YAW_RATE_KP, CASCADE_YAW_RATE_KI,
+                                 -TAIL_FEED_FORWARD, TAIL_PWM_MAX - TAIL_FEED_FORWARD, 0};
+    static rate_est_t height_est;
+    static rate_est_t yaw_est;
+    static uint32_t cycle = 0;
+    static float outer_dt = 0;
+    static float height_speed_cmd = 0;
+    static float yaw_speed_cmd = 0;
+    float speed = rate_update(&height_est, height, dt, false);
+    float yaw_speed = rate_update(&yaw_est, yaw, dt, true);
+
+    outer_dt += dt;
+    if (++cycle >= CONTROL_OUTER_DIVIDER) {
+
+        height_speed_cmd = pi_update(&height_pos, targ_height - height, outer_dt);
+        yaw_speed_cmd = pi_update(&yaw_pos, wrap_yaw(targ_yaw - yaw), outer_dt);
+        cycle = 0;
+        outer_dt = 0;
+    }
+
+    //on the ground with nothing asked for: motors off and nothing winding up
+    if ((targ_height == 0) && (targ_height - height < 10)) {
+
+        height_pos.integral = height_rate.integral = 0;
+        yaw_pos.integral = yaw_rate.integral = 0;
+        *main_pwm = 0;
+        *tail_pwm = 0;
+        return;
+    }
+
+    //more tail thrust turns towards negative yaw
+    *main_pwm = MAIN_FEED_FORWARD + pi_update(&height_rate, height_speed_cmd - speed, dt);
+    *tail_pwm = TAIL_FEED_FORWARD - pi_update(&yaw_rate, yaw_speed_cmd - yaw_speed, dt);
+
+    check_valid_pwm(main_pwm);
+    check_valid_pwm(tail_pwm);
+    if (*tail_pwm > TAIL_PWM_MAX) {
+
+        *tail_pwm = TAIL_PWM_MAX;
+    }
+}
+#elif (CONTROL_MODE == CONTROL_MODE_LQR) || (CONTROL_MODE == CONTROL_MODE_EMPC)
+//converts a state to int16 for the gain product, saturating
+int16_t feedback_state(float value)
+{
+    if (value > INT16_MAX) {
+
+        return INT16_MAX;
+    } else if (value < INT16_MIN) {
+
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+//state feedback on height and yaw together, see lqr_gains.h for the state.
+//LQR takes the gains from the row of its table for the target height; the
+//explicit MPC from the region of its table holding the state
+void feedback_update(int32_t height, int32_t yaw, int32_t targ_height,
+                     int32_t targ_yaw, float dt, int32_t* main_pwm,
+                     int32_t* tail_pwm)
+{
+    static rate_est_t height_est;
+    static rate_est_t yaw_est;
+    static float height_int = 0;
+    static float yaw_int = 0;
+    static float lag[LQR_DUTIES];
+    static bool saturated[LQR_DUTIES];
+    int16_t state[LQR_STATES];
+    int32_t duty[LQR_DUTIES];
+    float trim[LQR_DUTIES];
+    uint32_t tau_ms;
+    float speed = rate_update(&height_est, height, dt, false);
+    float yaw_speed = rate_update(&yaw_est, yaw, dt, true);
+    int32_t error = height - targ_height;
+    int32_t y_error = wrap_yaw(yaw - targ_yaw);
+    uint32_t i;
+#if CONTROL_MODE == CONTROL_MODE_LQR
+    const lqrGain_t* gain = &g_psLqrGains[0];
+    int32_t sum[LQR_DUTIES];
+
+    for (i = 1; i < LQR_OPERATING_POINTS; i++) {
+        if (targ_height >= (int32_t)g_psLqrGains[i].ui32Height) {
+            gain = &g_psLqrGains[i];
+        }
+    }
+    for (i = 0; i < LQR_DUTIES; i++) {
+        trim[i] = (float)gain->pi32Trim[i] / (1 << gain->pui32Shift[i]);
+    }
+    tau_ms = gain->ui32MotorTauMs;
+#else
+    for (i = 0; i < LQR_DUTIES; i++) {
+        trim[i] = (float)g_sEmpcTable.pi32Trim[i] / (1 << LQR_STATE_Q);
+    }
+    tau_ms = g_sEmpcTable.ui32MotorTauMs;
+#endif
+
+    //on the ground with nothing asked for: motors off and nothing winding up
+    if ((targ_height == 0) && (-error < 10)) {
+
+        height_int = yaw_int = 0;
+        lag[LQR_MAIN] = lag[LQR_TAIL] = 0;
+        *main_pwm = 0;
+        *tail_pwm = 0;
+        return;
+    }
+
+    //integrate only while the duty is free to act on the error
+    if (!saturated[LQR_MAIN]) {
+
+        height_int += error * dt;
+        if (height_int > LQR_INTEGRAL_LIMIT) {
+            height_int = LQR_INTEGRAL_LIMIT;
+        } else if (height_int < -LQR_INTEGRAL_LIMIT) {
+            height_int = -LQR_INTEGRAL_LIMIT;
+        }
+    }
+    if (!saturated[LQR_TAIL]) {
+
+        yaw_int += y_error * dt;
+        if (yaw_int > LQR_INTEGRAL_LIMIT) {
+            yaw_int = LQR_INTEGRAL_LIMIT;
+        } else if (yaw_int < -LQR_INTEGRAL_LIMIT) {
+            yaw_int = -LQR_INTEGRAL_LIMIT;
+        }
+    }
+
+    state[LQR_HEIGHT] = feedback_state(error);
+    state[LQR_SPEED] = feedback_state(speed);
+    state[LQR_YAW] = feedback_state(y_error);
+    state[LQR_YAW_RATE] = feedback_state(yaw_speed);
+    state[LQR_HEIGHT_INT] = feedback_state(height_int * (1 << LQR_STATE_Q));
+    state[LQR_YAW_INT] = feedback_state(yaw_int * (1 << LQR_STATE_Q));
+    for (i = 0; i < LQR_DUTIES; i++) {
+        state[LQR_MAIN_LAG + i] = feedback_state((lag[i] - trim[i]) * (1 << LQR_STATE_Q));
+    }
+
+#if CONTROL_MODE == CONTROL_MODE_LQR
+    DspMatVec(gain->pui32Gains, state, sum, LQR_DUTIES, LQR_STATES);
+
+    for (i = 0; i < LQR_DUTIES; i++) {
+
+        duty[i] = (gain->pi32Trim[i] - sum[i]) >> gain->pui32Shift[i];
+    }
+#else
+    EmpcEvaluate(state, duty);
+#endif
+    *main_pwm = duty[LQR_MAIN];
+    *tail_pwm = duty[LQR_TAIL];
+    check_valid_pwm(main_pwm);
+    check_valid_pwm(tail_pwm);
+    if (*tail_pwm > TAIL_PWM_MAX) {
+
+        *tail_pwm = TAIL_PWM_MAX;
+    }
+
+    //at a limit, whether clamped to it here or put there by the MPC law
+    saturated[LQR_MAIN] = (duty[LQR_MAIN] <= 0) || (duty[LQR_MAIN] >= 99);
+    saturated[LQR_TAIL] = (duty[LQR_TAIL] <= 0) || (duty[LQR_TAIL] >= TAIL_PWM_MAX);
+
+    //the rotors follow the duties with a lag, which the gains allow for
+    lag[LQR_MAIN] += (*main_pwm - lag[LQR_MAIN]) * dt * 1000 / tau_ms;
+    lag[LQR_TAIL] += (*tail_pwm - lag[LQR_TAIL]) * dt * 1000 / tau_ms;
+}
+#else
+
 //calculates the proportional gain for the controller
 int32_t calc_proportional_gain(int32_t error)
 {
@@ -188,6 +568,7 @@ int32_t calc_intergral_gain_yaw(int32_t error, uint32_t time_step)
     return INTERGRAL_GAIN_YAW * total_intergral;
 
 }
+#endif
 
 //checks that the pwm is between 0 and 99
 void check_valid_pwm(int32_t* height_pwm)
@@ -216,10 +597,13 @@ void control_task(void *pvParameters)
     static uint32_t curr_Meas_height;
     static uint32_t curr_Targ_height;
     static int32_t curr_Meas_yaw;
-    static uint32_t curr_Targ_yaw;
+    static int32_t curr_Targ_yaw;
     static int32_t height_pwm;
     uint32_t ground_ADC;
-    int first = 1;
+    uint32_t curr_height;
+    EventBits_t state;
+    uint32_t targets[CONTROL_QUEUE_SIZE];
+    UBaseType_t n_targets;
 
     while(1){
         
@@ -229,18 +613,54 @@ void control_task(void *pvParameters)
             //get current values
             xQueueReceive(g_MeasHeightControlQueue, &curr_Meas_height, 0);
             xQueueReceive(g_MeasYawControlQueue, &curr_Meas_yaw, 0);
-            xQueueReceive(g_TargHeightControlQueue, &curr_Targ_height, 0);
-            xQueueReceive(g_TargYawControlQueue, &curr_Targ_yaw, 0);
 
-            //calibrate the raw ADC values into something usable
-            if (first) {
+            //drain the setpoint queues so the newest target is used at once,
+            //one critical section per queue however many are waiting
+            n_targets = xQueueReceiveMultiple(g_TargHeightControlQueue, targets, CONTROL_QUEUE_SIZE, 0);
+            if (n_targets > 0) {
+                curr_Targ_height = targets[n_targets - 1];
+            }
+            n_targets = xQueueReceiveMultiple(g_TargYawControlQueue, targets, CONTROL_QUEUE_SIZE, 0);
+            if (n_targets > 0) {
+                curr_Targ_yaw = (int32_t)targets[n_targets - 1];
+            }
+
+            //calibrate the raw ADC values into something usable: the ground
+            //is measured from the moment the readings start. Arming is left
+            //to the operator
+            state = SystemStateGet();
+            if (!(state & SYSTEM_STATE_CALIBRATED)) {
+
+                if (curr_Meas_height > 0) {
+
+                    ground_cal_sample(curr_Meas_height);
+                }
+            }
+            arm_on_request(state, curr_Targ_height);
+
+            //reads zero until the ground is known, so nothing moves before
+            if (state & SYSTEM_STATE_CALIBRATED) {
 
-                if (curr_Targ_height > 0){
+                ground_ADC = SystemStateGround();
+            } else {
+
+                ground_ADC = 0;
+            }
+            curr_height = convert_to_height(curr_Meas_height, ground_ADC);
+
+            //track take off and landing
+            if (!(state & SYSTEM_STATE_AIRBORNE) && (curr_height >= AIRBORNE_ENTER_HEIGHT)) {
 
-                    first = 0;
-                } else {
+                SystemStateSet(SYSTEM_STATE_AIRBORNE);
+            } else if ((state & SYSTEM_STATE_AIRBORNE) && (curr_height < AIRBORNE_EXIT_HEIGHT)) {
 
-                    ground_ADC = curr_Meas_height;
+                SystemStateClear(SYSTEM_STATE_AIRBORNE);
+
+                //landed with nothing asked for: disarm until the operator
+                //arms again
+                if (curr_Targ_height == 0) {
+
+                    SystemStateClear(SYSTEM_STATE_ARMED);
                 }
             }
 
@@ -248,6 +668,9 @@ void control_task(void *pvParameters)
             uint32_t current_time;
             current_time = TimerValueGet(TIMER0_BASE, TIMER_A);
             uint32_t time_step = last_time - current_time;
+#if (CONTROL_MODE != CONTROL_MODE_SINGLE_LOOP) || PLANT_ID_ENABLE
+            float dt = (float)time_step / configCPU_CLOCK_HZ; //s
+#endif
             time_step = time_step * TIME_PER_TICK;
             last_time = current_time;
 
@@ -259,8 +682,17 @@ void control_task(void *pvParameters)
 
             }
 
+#if CONTROL_MODE == CONTROL_MODE_CASCADE
+            int32_t yaw_pwm;
+            cascade_update(curr_height, curr_Meas_yaw, curr_Targ_height,
+                           curr_Targ_yaw, dt, &height_pwm, &yaw_pwm);
+#elif (CONTROL_MODE == CONTROL_MODE_LQR) || (CONTROL_MODE == CONTROL_MODE_EMPC)
+            int32_t yaw_pwm;
+            feedback_update(curr_height, curr_Meas_yaw, curr_Targ_height,
+                            curr_Targ_yaw, dt, &height_pwm, &yaw_pwm);
+#else
             //calc error
-            int32_t error = heights_array[curr_Targ_height] - convert_to_height(curr_Meas_height, ground_ADC);
+            int32_t error = curr_Targ_height - curr_height;
 
             //add offset to the pwm
             height_pwm = 50;
@@ -275,43 +707,19 @@ void control_task(void *pvParameters)
             height_pwm += calc_intergral_gain(error, time_step);
 
             check_valid_pwm(&height_pwm);
+#endif
 
-            //semd pwm
-            if(xQueueSend(Q_mainDuty, &height_pwm, portMAX_DELAY) !=
-                   pdPASS)
-            {
-                //
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //
-                xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-                UARTprintf("\nQueue full. This should never happen.\n");
-                xSemaphoreGive(g_pUARTSemaphore);
-                while(1)
-                {
-                }
-            }
+            //semd pwm, replacing any duty the pwm task has not applied yet
+            //so this task never waits on it
+            xQueueOverwrite(Q_mainDuty, &height_pwm);
 
+#if CONTROL_MODE == CONTROL_MODE_SINGLE_LOOP
             //-------------------
             //yaw
             //-------------------
 
-            //calculate errors
-            int32_t y_error1 = 0;
-            int32_t y_error2 = 0;
-            int32_t y_error = 0;
-            y_error1 = yaws_array[curr_Targ_yaw] -curr_Meas_yaw;
-            y_error2 = yaws_array[curr_Targ_yaw] -(curr_Meas_yaw + 360);
-
-            //check which way around teh circle is smaller
-            if (abs(y_error1) < abs(y_error2) ) {
-
-                y_error = y_error1;
-            } else {
-
-                y_error = y_error2;
-            }
-            y_error = y_error * -1;
+            //calculate error, taking the shorter way around the circle
+            int32_t y_error = wrap_yaw(curr_Targ_yaw - curr_Meas_yaw) * -1;
 
             //add offset to pwm
             int32_t yaw_pwm = 40;
@@ -326,30 +734,35 @@ void control_task(void *pvParameters)
             yaw_pwm += calc_intergral_gain_yaw(y_error, time_step);
 
             check_valid_pwm(&yaw_pwm);
-            if (yaw_pwm > 85) {
-                yaw_pwm = 85;
+            if (yaw_pwm > TAIL_PWM_MAX) {
+                yaw_pwm = TAIL_PWM_MAX;
             }
+#endif
             
             //send pwm
-            if(xQueueSend(Q_tailDuty, &yaw_pwm, portMAX_DELAY) !=
-                               pdPASS)
-            {
-                //
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //
-                xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-                UARTprintf("\nQueue full. This should never happen.\n");
-                xSemaphoreGive(g_pUARTSemaphore);
-
-                while(1)
-                {
-                }
-            }
-
-            //allow adc to run again
+            xQueueOverwrite(Q_tailDuty, &yaw_pwm);
+
+#if PLANT_ID_ENABLE
+            //fit the rig to what was just measured and sent
+            PlantIdUpdate(curr_height, curr_Meas_yaw, height_pwm, yaw_pwm, dt,
+                          (state & SYSTEM_STATE_AIRBORNE) != 0);
+#endif
+
+            //record this cycle for the host
+            telemetryRecord_t record;
+            record.ui32Tick = xTaskGetTickCount();
+            record.pi32Values[TELEMETRY_HEIGHT_ADC] = curr_Meas_height;
+            record.pi32Values[TELEMETRY_YAW] = curr_Meas_yaw;
+            record.pi32Values[TELEMETRY_MAIN_DUTY] = height_pwm;
+            record.pi32Values[TELEMETRY_TAIL_DUTY] = yaw_pwm;
+            record.pi32Values[TELEMETRY_TARG_HEIGHT] = curr_Targ_height;
+            record.pi32Values[TELEMETRY_TARG_YAW] = curr_Targ_yaw;
+            TelemetryPush(&record);
+
+            BootTraceMark(BOOT_MARK_FIRST_CONTROL);
+
+            //allow adc to run again, the height task sets the pace
             xSemaphoreGive(g_ADCSemaphore);
-            vTaskDelay(1);
 
         }
 
@@ -370,14 +783,19 @@ uint32_t init_control(void)
     TimerEnable(TIMER0_BASE, TIMER_A);
 
     //setup queues
-    g_MeasHeightControlQueue = xQueueCreate(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE);
-    g_MeasYawControlQueue = xQueueCreate(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE);
-    g_TargHeightControlQueue = xQueueCreate(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE);
-    g_TargYawControlQueue = xQueueCreate(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE);
+    g_MeasHeightControlQueue = xQueueCreateStatic(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE,
+                                                  (uint8_t *)g_ControlQueueStorage[0], &g_ControlQueueBufs[0]);
+    g_MeasYawControlQueue = xQueueCreateStatic(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE,
+                                               (uint8_t *)g_ControlQueueStorage[1], &g_ControlQueueBufs[1]);
+    g_TargHeightControlQueue = xQueueCreateStatic(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE,
+                                                  (uint8_t *)g_ControlQueueStorage[2], &g_ControlQueueBufs[2]);
+    g_TargYawControlQueue = xQueueCreateStatic(CONTROL_QUEUE_SIZE, CONTROL_ITEM_SIZE,
+                                               (uint8_t *)g_ControlQueueStorage[3], &g_ControlQueueBufs[3]);
 
     //create task
-    if(xTaskCreate(control_task, (const portCHAR *)"CONTROL", CONTROL_STACK_SIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_CONTROL_TASK, NULL) != pdTRUE) {
+    if(xTaskCreateStatic(control_task, (const portCHAR *)"CONTROL", CONTROL_STACK_SIZE, NULL,
+                         tskIDLE_PRIORITY + PRIORITY_CONTROL_TASK,
+                         g_ControlTaskStack, &g_ControlTaskTCB) == NULL) {
 
         return 1;
     }
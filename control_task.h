@@ -14,5 +14,9 @@
 
 extern uint32_t init_control(void);
 
+//asks the control task to arm the motors at its next cycle. Refused (and
+//logged) unless the ground is calibrated and the height target is zero
+extern void control_request_arm(void);
+
 
 #endif /* CONTROL_TASK_H_ */
@@ -18,11 +18,15 @@
 #include "task.h"
 #include "priorities.h"
 #include "queue.h"
+#include "system_state.h"
+#include "boot_trace.h"
+#include "altitude_cal.h"
 
 //CONSTANTS----------------------------------------------------
 #define DISPLAY_QUEUE_SIZE 10
 #define DISPLAY_ITEM_SIZE sizeof(uint32_t)
 #define DISPLAY_STACK_SIZE 200
+#define DISPLAY_TASK_DELAY 10 //ms, lets the log task (same priority) run
 
 //STATICS AND GLOBALS------------------------------------------------------
 
@@ -31,6 +35,13 @@ QueueHandle_t g_MeasYawDisplayQueue;
 QueueHandle_t g_TargHeightDisplayQueue;
 QueueHandle_t g_TargYawDisplayQueue;
 
+//statically allocated task and queue memory
+#define DISPLAY_NUM_QUEUES 4
+static StaticTask_t g_DisplayTaskTCB;
+static StackType_t g_DisplayTaskStack[DISPLAY_STACK_SIZE];
+static StaticQueue_t g_DisplayQueueBufs[DISPLAY_NUM_QUEUES];
+static uint8_t g_DisplayQueueStorage[DISPLAY_NUM_QUEUES][DISPLAY_QUEUE_SIZE * DISPLAY_ITEM_SIZE];
+
 //LOCAL FUNCTION PTs-------------------------------------------
 
 static void display_task(void *pvParameters);
@@ -49,14 +60,15 @@ void clear_display(void)
     OLEDStringDraw("                    ",1,3);
 }
 
-//calibrates the display to display the raw ADC values in a more readable way
+//calibrates the display to display the raw ADC values in a more readable way,
+//through the rig's linearisation table
 uint32_t convert_to_height(uint32_t adc_val, uint32_t ground)
 {
     if (adc_val > ground)
     {
         return 0;
     } else {
-        return (ground - adc_val) ;
+        return AltitudeCalHeight(ground - adc_val);
     }
 }
 
@@ -74,6 +86,16 @@ void display_task(void *pvParameters)
     static int32_t curr_Meas_yaw = 0;
     static int32_t curr_Targ_yaw = 0;
 
+    //shared with the control task; until it is captured the heli is on the
+    //ground, so the height reads as zero
+    uint32_t ground_ADC;
+
+    //bring up the OLED here rather than in init_display(): its power-up
+    //sequence busy-waits for over 100 ms, and at this priority that no
+    //longer holds up the control loop starting
+    OLEDInitialise();
+    BootTraceMark(BOOT_MARK_DISPLAY_READY);
+
     //send initial display message
     clear_display();
     OLEDStringDraw("     Meas  Targ",1,0);
@@ -83,27 +105,19 @@ void display_task(void *pvParameters)
     //main loop for task
     while(1)
     {
-        int first = 1;
-        uint32_t ground_ADC;
+        if (SystemStateGet() & SYSTEM_STATE_CALIBRATED) {
+
+            ground_ADC = SystemStateGround();
+        } else {
+
+            ground_ADC = 0; //convert_to_height() reads zero against this
+        }
 
         //update measured height
         if (xQueueReceive(g_MeasHeightDisplayQueue, &recieved_message, 0) == pdPASS) {
 
             curr_Meas_height = recieved_message;
 
-            //calibrate the raw ADC values
-            if (first) {
-
-                if (curr_Targ_height > 0){
-
-                    first = 0;
-                } else {
-
-                    ground_ADC = curr_Meas_height;
-                    ground_ADC += 30;
-                }
-            }
-
             //TODO figure out why these two functions five a weird warning
             snprintf(&display_output, sizeof(display_output), "H:   %.4lu  %.3lu ", convert_to_height(curr_Meas_height, ground_ADC), curr_Targ_height);
             OLEDStringDraw(&display_output,1,1);
@@ -146,6 +160,8 @@ void display_task(void *pvParameters)
             }
             OLEDStringDraw(&display_output,1,2);
         }
+
+        vTaskDelay(DISPLAY_TASK_DELAY / portTICK_RATE_MS);
     }
 }
 
@@ -154,22 +170,22 @@ void display_task(void *pvParameters)
 uint32_t init_display(void)
 {
 
-    //initialise the display peripheral
-    OLEDInitialise();
-
-    //send inital message
-    clear_display();
-    OLEDStringDraw("Display Initialised",1,0);
+    //the OLED itself is initialised by the task once the scheduler runs
 
     //setup queues
-    g_MeasHeightDisplayQueue = xQueueCreate(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE);
-    g_MeasYawDisplayQueue = xQueueCreate(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE);
-    g_TargHeightDisplayQueue = xQueueCreate(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE);
-    g_TargYawDisplayQueue = xQueueCreate(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE);
+    g_MeasHeightDisplayQueue = xQueueCreateStatic(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE,
+                                                  g_DisplayQueueStorage[0], &g_DisplayQueueBufs[0]);
+    g_MeasYawDisplayQueue = xQueueCreateStatic(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE,
+                                               g_DisplayQueueStorage[1], &g_DisplayQueueBufs[1]);
+    g_TargHeightDisplayQueue = xQueueCreateStatic(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE,
+                                                  g_DisplayQueueStorage[2], &g_DisplayQueueBufs[2]);
+    g_TargYawDisplayQueue = xQueueCreateStatic(DISPLAY_QUEUE_SIZE, DISPLAY_ITEM_SIZE,
+                                               g_DisplayQueueStorage[3], &g_DisplayQueueBufs[3]);
 
     //create the task
-    if(xTaskCreate(display_task, (const portCHAR *)"LED", DISPLAY_STACK_SIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_DISPLAY_TASK, NULL) != pdTRUE)
+    if(xTaskCreateStatic(display_task, (const portCHAR *)"Display", DISPLAY_STACK_SIZE, NULL,
+                         tskIDLE_PRIORITY + PRIORITY_DISPLAY_TASK,
+                         g_DisplayTaskStack, &g_DisplayTaskTCB) == NULL)
     {
         return(1);
     }
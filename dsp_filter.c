@@ -0,0 +1,502 @@
+/******************************************************************************
+ *
+ * dsp_filter.c
+ *
+ * Purpose:
+ * Fixed-point FIR, biquad cascade and CIC decimator kernels, median and
+ * Hampel stages and a matrix-vector product. See dsp_filter.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "dsp_filter.h"      // Filter kernels
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define FIR_SHIFT       15          // Q15 coefficients
+#define BIQUAD_SHIFT    14          // Q14 coefficients
+
+//
+// SMLAD: acc + lo(x) * lo(y) + hi(x) * hi(y), each half signed, the sum
+// wrapping at 32 bits. armcl provides it as an intrinsic when building for
+// the M4 (-mv7M4), and GCC/Clang through ACLE when the DSP extension is on.
+//
+#if !defined(DSP_FILTER_FORCE_REFERENCE) && \
+    defined(__TI_COMPILER_VERSION__) && defined(__TI_TMS470_V7M4__)
+#define SMLAD(x, y, acc)    ((int32_t)_smlad((int)(x), (int)(y), (int)(acc)))
+#elif !defined(DSP_FILTER_FORCE_REFERENCE) && defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#define SMLAD(x, y, acc)    ((int32_t)__smlad((x), (y), (acc)))
+#else
+#define SMLAD(x, y, acc)    smladReference((x), (y), (acc))
+#endif
+
+//
+// Orders a and b so a <= b without a branch. The difference is formed in 32
+// bits, which cannot overflow for 16-bit samples.
+//
+#define SORT2(a, b)                                                         \
+    do {                                                                    \
+        int32_t i32Diff = (b) - (a);                                        \
+        int32_t i32Mask = i32Diff >> 31;    /* all ones if b < a */         \
+        (a) += i32Diff & i32Mask;                                           \
+        (b) -= i32Diff & i32Mask;                                           \
+    } while (0)
+
+// LOCAL FUNCTION PROTOTYPES---------------------------------------------------
+
+static inline int32_t smladReference(uint32_t ui32X, uint32_t ui32Y,
+                                     int32_t i32Acc);
+static inline uint32_t pack(int16_t i16Lo, int16_t i16Hi);
+static inline int16_t saturate(int32_t i32Value);
+static int32_t median(const int16_t *pi16In, uint32_t ui32Size);
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief C version of SMLAD. Unsigned arithmetic gives the instruction's
+ * wrap-around without signed overflow.
+ */
+static inline int32_t
+smladReference(uint32_t ui32X, uint32_t ui32Y, int32_t i32Acc)
+{
+    int32_t i32Lo = (int32_t)(int16_t)ui32X * (int16_t)ui32Y;
+    int32_t i32Hi = (int32_t)(int16_t)(ui32X >> 16) * (int16_t)(ui32Y >> 16);
+
+    return (int32_t)((uint32_t)i32Acc + (uint32_t)i32Lo + (uint32_t)i32Hi);
+}
+
+/**
+ * @brief Packs two samples into one word, the first in the low half. Written
+ * so the compiler can emit a single PKHBT.
+ */
+static inline uint32_t
+pack(int16_t i16Lo, int16_t i16Hi)
+{
+    return (uint32_t)(uint16_t)i16Lo | ((uint32_t)(uint16_t)i16Hi << 16);
+}
+
+/**
+ * @brief Clamps to the int16_t range.
+ */
+static inline int16_t
+saturate(int32_t i32Value)
+{
+    if (i32Value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (i32Value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)i32Value;
+}
+
+
+/**
+ * @brief Median of 3, 5, 7 or 9 values by a median-selection network
+ * (Paeth / Devillard). Only the compare-exchanges that can move the middle
+ * element are done: 3, 7, 13 and 19 of them.
+ */
+static int32_t
+median(const int16_t *pi16In, uint32_t ui32Size)
+{
+    int32_t p0 = pi16In[0], p1 = pi16In[1], p2 = pi16In[2];
+    int32_t p3, p4, p5, p6, p7, p8;
+
+    switch (ui32Size)
+    {
+    case 3:
+        SORT2(p0, p1); SORT2(p1, p2); SORT2(p0, p1);
+        return p1;
+
+    case 5:
+        p3 = pi16In[3]; p4 = pi16In[4];
+        SORT2(p0, p1); SORT2(p3, p4); SORT2(p0, p3);
+        SORT2(p1, p4); SORT2(p1, p2); SORT2(p2, p3);
+        SORT2(p1, p2);
+        return p2;
+
+    case 7:
+        p3 = pi16In[3]; p4 = pi16In[4]; p5 = pi16In[5]; p6 = pi16In[6];
+        SORT2(p0, p5); SORT2(p0, p3); SORT2(p1, p6);
+        SORT2(p2, p4); SORT2(p0, p1); SORT2(p3, p5);
+        SORT2(p2, p6); SORT2(p2, p3); SORT2(p3, p6);
+        SORT2(p4, p5); SORT2(p1, p4); SORT2(p1, p3);
+        SORT2(p3, p4);
+        return p3;
+
+    default:
+        p3 = pi16In[3]; p4 = pi16In[4]; p5 = pi16In[5]; p6 = pi16In[6];
+        p7 = pi16In[7]; p8 = pi16In[8];
+        SORT2(p1, p2); SORT2(p4, p5); SORT2(p7, p8);
+        SORT2(p0, p1); SORT2(p3, p4); SORT2(p6, p7);
+        SORT2(p1, p2); SORT2(p4, p5); SORT2(p7, p8);
+        SORT2(p0, p3); SORT2(p5, p8); SORT2(p4, p7);
+        SORT2(p3, p6); SORT2(p1, p4); SORT2(p2, p5);
+        SORT2(p4, p7); SORT2(p4, p2); SORT2(p6, p4);
+        SORT2(p4, p2);
+        return p4;
+    }
+}
+
+
+bool
+DspFirInit(dspFir_t *psFir, const uint32_t *pui32Coeffs, int16_t *pi16State,
+           uint32_t ui32NumTaps)
+{
+    if (ui32NumTaps == 0 || (ui32NumTaps & 1))
+    {
+        return false;
+    }
+
+    psFir->pui32Coeffs = pui32Coeffs;
+    psFir->pi16State = pi16State;
+    psFir->ui32NumTaps = ui32NumTaps;
+    DspFirReset(psFir, 0);
+
+    return true;
+}
+
+
+void
+DspFirReset(dspFir_t *psFir, int16_t i16Value)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2 * psFir->ui32NumTaps; i++)
+    {
+        psFir->pi16State[i] = i16Value;
+    }
+    psFir->ui32Index = 0;
+}
+
+
+int16_t
+DspFirProcess(dspFir_t *psFir, int16_t i16In)
+{
+    const uint32_t *pui32Coeffs = psFir->pui32Coeffs;
+    const int16_t *pi16Window;
+    uint32_t ui32Taps = psFir->ui32NumTaps;
+    int32_t i32Acc = 1 << (FIR_SHIFT - 1);  // Round to nearest
+    uint32_t i;
+
+    // The window runs newest to oldest from the write position. Writing the
+    // sample at both copies keeps state[index .. index + taps - 1] valid.
+    psFir->ui32Index = (psFir->ui32Index == 0 ? ui32Taps : psFir->ui32Index) - 1;
+    psFir->pi16State[psFir->ui32Index] = i16In;
+    psFir->pi16State[psFir->ui32Index + ui32Taps] = i16In;
+    pi16Window = &psFir->pi16State[psFir->ui32Index];
+
+    // Two taps per SMLAD. The window can start on a half word, so its pairs
+    // are packed rather than loaded as words.
+    for (i = 0; i < ui32Taps / 2; i++)
+    {
+        i32Acc = SMLAD(pack(pi16Window[2 * i], pi16Window[2 * i + 1]),
+                       pui32Coeffs[i], i32Acc);
+    }
+
+    return saturate(i32Acc >> FIR_SHIFT);
+}
+
+
+void
+DspFirBlock(dspFir_t *psFir, const int16_t *pi16In, int16_t *pi16Out,
+            uint32_t ui32Count)
+{
+    uint32_t i;
+
+    for (i = 0; i < ui32Count; i++)
+    {
+        pi16Out[i] = DspFirProcess(psFir, pi16In[i]);
+    }
+}
+
+
+bool
+DspBiquadInit(dspBiquad_t *psBiquad, const int16_t (*ppi16Coeffs)[5],
+              uint32_t ui32NumStages)
+{
+    uint32_t i;
+
+    if (ui32NumStages > DSP_BIQUAD_MAX_STAGES)
+    {
+        return false;
+    }
+
+    for (i = 0; i < ui32NumStages; i++)
+    {
+        dspBiquadStage_t *psStage = &psBiquad->psStages[i];
+
+        psStage->ui32B0B1 = pack(ppi16Coeffs[i][0], ppi16Coeffs[i][1]);
+        psStage->ui32B2NegA1 = pack(ppi16Coeffs[i][2], -ppi16Coeffs[i][3]);
+        psStage->ui32NegA2 = pack(0, -ppi16Coeffs[i][4]);
+    }
+    psBiquad->ui32NumStages = ui32NumStages;
+    DspBiquadReset(psBiquad, 0);
+
+    return true;
+}
+
+
+void
+DspBiquadReset(dspBiquad_t *psBiquad, int16_t i16Value)
+{
+    uint32_t i;
+
+    for (i = 0; i < psBiquad->ui32NumStages; i++)
+    {
+        psBiquad->psStages[i].ui32X = pack(i16Value, i16Value);
+        psBiquad->psStages[i].ui32Y = pack(i16Value, i16Value);
+        psBiquad->psStages[i].i32Residue = 0;
+    }
+}
+
+
+int16_t
+DspBiquadProcess(dspBiquad_t *psBiquad, int16_t i16In)
+{
+    uint32_t i;
+
+    for (i = 0; i < psBiquad->ui32NumStages; i++)
+    {
+        dspBiquadStage_t *psStage = &psBiquad->psStages[i];
+        uint32_t ui32X = psStage->ui32X;
+        uint32_t ui32Y = psStage->ui32Y;
+        uint32_t ui32XX1 = (uint16_t)i16In | (ui32X << 16);     // x0 | x1
+        int32_t i32Acc = psStage->i32Residue;
+
+        // Five taps in three SMLADs. The last pairs y[n-2] with -a2 and
+        // y[n-1] with the zero in the low half of ui32NegA2.
+        i32Acc = SMLAD(ui32XX1, psStage->ui32B0B1, i32Acc);
+        i32Acc = SMLAD((ui32X >> 16) | (ui32Y << 16), psStage->ui32B2NegA1,
+                       i32Acc);
+        i32Acc = SMLAD(ui32Y, psStage->ui32NegA2, i32Acc);
+
+        psStage->i32Residue = i32Acc & ((1 << BIQUAD_SHIFT) - 1);
+        i16In = saturate(i32Acc >> BIQUAD_SHIFT);
+
+        psStage->ui32X = ui32XX1;
+        psStage->ui32Y = (uint16_t)i16In | (ui32Y << 16);
+    }
+
+    return i16In;
+}
+
+
+void
+DspBiquadBlock(dspBiquad_t *psBiquad, const int16_t *pi16In, int16_t *pi16Out,
+               uint32_t ui32Count)
+{
+    uint32_t i;
+
+    for (i = 0; i < ui32Count; i++)
+    {
+        pi16Out[i] = DspBiquadProcess(psBiquad, pi16In[i]);
+    }
+}
+
+
+bool
+DspCicInit(dspCic_t *psCic, uint32_t ui32Order, uint32_t ui32Ratio)
+{
+    uint32_t i;
+
+    if (ui32Order == 0 || ui32Order > DSP_CIC_MAX_ORDER ||
+        ui32Ratio == 0 || (ui32Ratio & (ui32Ratio - 1)))
+    {
+        return false;
+    }
+
+    psCic->ui32Order = ui32Order;
+    psCic->ui32Ratio = ui32Ratio;
+    psCic->ui32Shift = 0;
+    for (i = 1; i < ui32Ratio; i <<= 1)
+    {
+        psCic->ui32Shift += ui32Order;
+    }
+    for (i = 0; i < DSP_CIC_MAX_ORDER; i++)
+    {
+        psCic->pi32Integrators[i] = 0;
+        psCic->pi32Combs[i] = 0;
+    }
+    psCic->ui32Phase = 0;
+
+    return true;
+}
+
+
+uint32_t
+DspCicBlock(dspCic_t *psCic, const int16_t *pi16In, int16_t *pi16Out,
+            uint32_t ui32Count)
+{
+    uint32_t ui32Order = psCic->ui32Order;
+    uint32_t ui32Outputs = 0;
+    uint32_t i, j;
+
+    // No multiplies, so nothing for SMLAD: the integrators are adds that
+    // must wrap, done unsigned to keep that defined in C.
+    for (i = 0; i < ui32Count; i++)
+    {
+        uint32_t ui32Value = (uint32_t)(int32_t)pi16In[i];
+
+        for (j = 0; j < ui32Order; j++)
+        {
+            ui32Value += (uint32_t)psCic->pi32Integrators[j];
+            psCic->pi32Integrators[j] = (int32_t)ui32Value;
+        }
+
+        if (++psCic->ui32Phase < psCic->ui32Ratio)
+        {
+            continue;
+        }
+        psCic->ui32Phase = 0;
+
+        // Combs at the decimated rate, differential delay of one.
+        for (j = 0; j < ui32Order; j++)
+        {
+            uint32_t ui32Prev = (uint32_t)psCic->pi32Combs[j];
+
+            psCic->pi32Combs[j] = (int32_t)ui32Value;
+            ui32Value -= ui32Prev;
+        }
+
+        pi16Out[ui32Outputs++] = saturate((int32_t)ui32Value >>
+                                          psCic->ui32Shift);
+    }
+
+    return ui32Outputs;
+}
+
+
+bool
+DspMedianInit(dspMedian_t *psMedian, uint32_t ui32Size)
+{
+    if (ui32Size < 3 || ui32Size > DSP_MEDIAN_MAX_WINDOW || !(ui32Size & 1))
+    {
+        return false;
+    }
+
+    psMedian->ui32Size = ui32Size;
+    DspMedianReset(psMedian, 0);
+
+    return true;
+}
+
+
+void
+DspMedianReset(dspMedian_t *psMedian, int16_t i16Value)
+{
+    uint32_t i;
+
+    for (i = 0; i < DSP_MEDIAN_MAX_WINDOW; i++)
+    {
+        psMedian->pi16Window[i] = i16Value;
+    }
+    psMedian->ui32Index = 0;
+}
+
+
+int16_t
+DspMedianProcess(dspMedian_t *psMedian, int16_t i16In)
+{
+    // The network does not care about order, so the window is a plain ring.
+    psMedian->pi16Window[psMedian->ui32Index] = i16In;
+    if (++psMedian->ui32Index == psMedian->ui32Size)
+    {
+        psMedian->ui32Index = 0;
+    }
+
+    return (int16_t)median(psMedian->pi16Window, psMedian->ui32Size);
+}
+
+
+bool
+DspHampelInit(dspHampel_t *psHampel, uint32_t ui32Size,
+              uint32_t ui32ThresholdQ8)
+{
+    psHampel->ui32ThresholdQ8 = ui32ThresholdQ8;
+    psHampel->ui32Replaced = 0;
+
+    return DspMedianInit(&psHampel->sMedian, ui32Size);
+}
+
+
+void
+DspHampelReset(dspHampel_t *psHampel, int16_t i16Value)
+{
+    DspMedianReset(&psHampel->sMedian, i16Value);
+}
+
+
+int16_t
+DspHampelProcess(dspHampel_t *psHampel, int16_t i16In)
+{
+    dspMedian_t *psMedian = &psHampel->sMedian;
+    int16_t pi16Deviation[DSP_MEDIAN_MAX_WINDOW];
+    int32_t i32Median, i32Mad, i32Offset;
+    uint32_t i;
+
+    i32Median = DspMedianProcess(psMedian, i16In);
+
+    // Median absolute deviation. Deviations beyond INT16_MAX are clamped,
+    // which cannot happen for ADC counts.
+    for (i = 0; i < psMedian->ui32Size; i++)
+    {
+        int32_t i32Dev = psMedian->pi16Window[i] - i32Median;
+
+        pi16Deviation[i] = saturate(i32Dev < 0 ? -i32Dev : i32Dev);
+    }
+    i32Mad = median(pi16Deviation, psMedian->ui32Size);
+    if (i32Mad < DSP_HAMPEL_MAD_FLOOR)
+    {
+        i32Mad = DSP_HAMPEL_MAD_FLOOR;
+    }
+
+    i32Offset = i16In - i32Median;
+    if (i32Offset < 0)
+    {
+        i32Offset = -i32Offset;
+    }
+
+    if (((uint32_t)i32Offset << 8) > (uint32_t)i32Mad * psHampel->ui32ThresholdQ8)
+    {
+        psHampel->ui32Replaced++;
+        return (int16_t)i32Median;
+    }
+
+    return i16In;
+}
+
+
+void
+DspMatVec(const uint32_t *pui32Matrix, const int16_t *pi16Vector,
+          int32_t *pi32Out, uint32_t ui32Rows, uint32_t ui32Cols)
+{
+    uint32_t pui32Pairs[DSP_MAT_MAX_COLS / 2];
+    uint32_t ui32Pairs = ui32Cols / 2;
+    uint32_t i, j;
+
+    // The vector is packed once and reused by every row.
+    for (j = 0; j < ui32Pairs; j++)
+    {
+        pui32Pairs[j] = pack(pi16Vector[2 * j], pi16Vector[2 * j + 1]);
+    }
+
+    for (i = 0; i < ui32Rows; i++)
+    {
+        int32_t i32Acc = 0;
+
+        for (j = 0; j < ui32Pairs; j++)
+        {
+            i32Acc = SMLAD(pui32Pairs[j], *pui32Matrix++, i32Acc);
+        }
+        pi32Out[i] = i32Acc;
+    }
+}
@@ -0,0 +1,226 @@
+/******************************************************************************
+ *
+ * dsp_filter.h
+ *
+ * Purpose:
+ * Fixed-point FIR, biquad cascade and CIC decimator kernels for the altitude
+ * ADC stream, and median and Hampel stages to put in front of them so a
+ * single-sample ADC spike never reaches the averaging. A small matrix-vector
+ * product for state feedback uses the same packed arithmetic.
+ *
+ * Samples are int16_t (12-bit ADC counts fit with headroom). The FIR and
+ * biquad inner loops multiply two packed 16-bit pairs per instruction with
+ * the Cortex-M4 SMLAD instruction. On any other compiler or core the same
+ * loops use a C version of SMLAD that adds the two products in the same
+ * order with the same 32-bit wrap-around, so a host build produces
+ * bit-identical output to the target. Define DSP_FILTER_FORCE_REFERENCE to
+ * use the C version on the target too.
+ *
+ * The median of 3, 5, 7 or 9 samples is found with a fixed sorting network of
+ * branchless compare-exchanges, so it takes the same time whatever the data.
+ *
+ * Every filter keeps its state in caller-provided static storage and has no
+ * dependency on FreeRTOS. A filter instance must only be used by one task.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __DSP_FILTER_H__
+#define __DSP_FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Most stages in a biquad cascade. */
+#define DSP_BIQUAD_MAX_STAGES   4
+
+/** @brief Highest CIC order (number of integrator and comb pairs). */
+#define DSP_CIC_MAX_ORDER       4
+
+/** @brief Packs two Q15 FIR taps, c0 weighting the newer sample. */
+#define DSP_FIR_PAIR(c0, c1)    ((uint32_t)(uint16_t)(c0) | \
+                                 ((uint32_t)(uint16_t)(c1) << 16))
+
+/** @brief Most columns in a DspMatVec() matrix. */
+#define DSP_MAT_MAX_COLS        16
+
+/** @brief Packs two int16 matrix entries, a from the lower column. */
+#define DSP_MAT_PAIR(a, b)      DSP_FIR_PAIR(a, b)
+
+/** @brief Largest median or Hampel window. */
+#define DSP_MEDIAN_MAX_WINDOW   9
+
+/**
+ * @brief Hampel threshold for a number of standard deviations, in Q8. The
+ * median absolute deviation is scaled by 1.4826 to estimate one.
+ */
+#define DSP_HAMPEL_SIGMAS_Q8(n) ((uint32_t)(n) * 380)
+
+/**
+ * @brief Smallest median absolute deviation the Hampel threshold is taken
+ * from, in sample units. Without it a flat window has a MAD of zero and
+ * every sample that differs by a single count is replaced.
+ */
+#define DSP_HAMPEL_MAD_FLOOR    2
+
+/**
+ * @brief FIR filter with Q15 coefficients.
+ *
+ * The coefficients are given in pairs built with DSP_FIR_PAIR, the first
+ * pair weighting the two newest samples, so the tap count is always even
+ * (pad with a zero tap). pi16State must hold 2 * ui32NumTaps samples: each
+ * sample is written twice so the window is always contiguous and the inner
+ * loop never wraps.
+ */
+typedef struct {
+    const uint32_t *pui32Coeffs;
+    int16_t *pi16State;
+    uint32_t ui32NumTaps;
+    uint32_t ui32Index;         // Position of the newest sample
+} dspFir_t;
+
+/**
+ * @brief One Direct Form I biquad section, coefficients in Q14.
+ *
+ *   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ *
+ * a0 is taken as 1 and a1 must lie in (-2, 2). The coefficients are kept as
+ * packed pairs ready for SMLAD. The bits lost when the output is shifted
+ * down are fed into the next sample, so a low cut-off does not leave a dead
+ * band around the true output.
+ */
+typedef struct {
+    uint32_t ui32B0B1;          // b0 | b1 << 16
+    uint32_t ui32B2NegA1;       // b2 | -a1 << 16
+    uint32_t ui32NegA2;         //  0 | -a2 << 16
+    uint32_t ui32X;             // x[n-1] | x[n-2] << 16
+    uint32_t ui32Y;             // y[n-1] | y[n-2] << 16
+    int32_t i32Residue;         // Bits shifted off the last output
+} dspBiquadStage_t;
+
+/** @brief A cascade of biquad sections run in series. */
+typedef struct {
+    dspBiquadStage_t psStages[DSP_BIQUAD_MAX_STAGES];
+    uint32_t ui32NumStages;
+} dspBiquad_t;
+
+/**
+ * @brief CIC decimator of order ui32Order and power-of-two decimation ratio.
+ *
+ * The gain of R^M is divided back out by a shift, so a DC input gives the
+ * same DC output. The integrators rely on two's complement wrap-around.
+ */
+typedef struct {
+    int32_t pi32Integrators[DSP_CIC_MAX_ORDER];
+    int32_t pi32Combs[DSP_CIC_MAX_ORDER];   // Previous input to each comb
+    uint32_t ui32Order;
+    uint32_t ui32Ratio;
+    uint32_t ui32Shift;         // Order * log2(Ratio)
+    uint32_t ui32Phase;         // Inputs since the last output
+} dspCic_t;
+
+/** @brief Running median over the last ui32Size samples. */
+typedef struct {
+    int16_t pi16Window[DSP_MEDIAN_MAX_WINDOW];
+    uint32_t ui32Size;
+    uint32_t ui32Index;         // Slot the next sample overwrites
+} dspMedian_t;
+
+/**
+ * @brief Hampel identifier: the newest sample is replaced by the window
+ * median when it is further from it than the threshold times the median
+ * absolute deviation. Otherwise it passes through unchanged, without the lag
+ * of a plain median.
+ */
+typedef struct {
+    dspMedian_t sMedian;
+    uint32_t ui32ThresholdQ8;   // DSP_HAMPEL_SIGMAS_Q8(n)
+    uint32_t ui32Replaced;      // Samples rejected so far
+} dspHampel_t;
+
+/**
+ * @brief Attaches ui32NumTaps / 2 coefficient pairs and the state storage and
+ * clears the state. Returns false if the tap count is odd or zero.
+ */
+bool DspFirInit(dspFir_t *psFir, const uint32_t *pui32Coeffs,
+                int16_t *pi16State, uint32_t ui32NumTaps);
+
+/** @brief Fills the window with one value, e.g. the first reading. */
+void DspFirReset(dspFir_t *psFir, int16_t i16Value);
+
+/** @brief Filters one sample. */
+int16_t DspFirProcess(dspFir_t *psFir, int16_t i16In);
+
+/** @brief Filters ui32Count samples. pi16In and pi16Out may be the same. */
+void DspFirBlock(dspFir_t *psFir, const int16_t *pi16In, int16_t *pi16Out,
+                 uint32_t ui32Count);
+
+/**
+ * @brief Loads a cascade from ui32NumStages rows of { b0, b1, b2, a1, a2 } in
+ * Q14 and clears the state. Returns false if there are too many stages.
+ */
+bool DspBiquadInit(dspBiquad_t *psBiquad, const int16_t (*ppi16Coeffs)[5],
+                   uint32_t ui32NumStages);
+
+/**
+ * @brief Sets every stage to the steady state for a constant input. Exact
+ * for stages with unity DC gain, which avoids a start-up transient when
+ * primed with the first reading.
+ */
+void DspBiquadReset(dspBiquad_t *psBiquad, int16_t i16Value);
+
+/** @brief Filters one sample through every stage. */
+int16_t DspBiquadProcess(dspBiquad_t *psBiquad, int16_t i16In);
+
+/** @brief Filters ui32Count samples. pi16In and pi16Out may be the same. */
+void DspBiquadBlock(dspBiquad_t *psBiquad, const int16_t *pi16In,
+                    int16_t *pi16Out, uint32_t ui32Count);
+
+/**
+ * @brief Sets the order and decimation ratio and clears the state. Returns
+ * false if the order is out of range or the ratio is not a power of two.
+ */
+bool DspCicInit(dspCic_t *psCic, uint32_t ui32Order, uint32_t ui32Ratio);
+
+/**
+ * @brief Decimates ui32Count samples into pi16Out and returns the number of
+ * outputs written, at most ui32Count / ratio + 1.
+ */
+uint32_t DspCicBlock(dspCic_t *psCic, const int16_t *pi16In, int16_t *pi16Out,
+                     uint32_t ui32Count);
+
+/**
+ * @brief Sets the window size and fills the window with zeros. Returns false
+ * unless the size is 3, 5, 7 or 9.
+ */
+bool DspMedianInit(dspMedian_t *psMedian, uint32_t ui32Size);
+
+/** @brief Fills the window with one value, e.g. the first reading. */
+void DspMedianReset(dspMedian_t *psMedian, int16_t i16Value);
+
+/** @brief Adds a sample and returns the median of the window. */
+int16_t DspMedianProcess(dspMedian_t *psMedian, int16_t i16In);
+
+/**
+ * @brief Sets the window size (3, 5, 7 or 9) and threshold. Returns false if
+ * the size is not supported.
+ */
+bool DspHampelInit(dspHampel_t *psHampel, uint32_t ui32Size,
+                   uint32_t ui32ThresholdQ8);
+
+/** @brief Fills the window with one value, e.g. the first reading. */
+void DspHampelReset(dspHampel_t *psHampel, int16_t i16Value);
+
+/** @brief Adds a sample and returns it, or the median if it is an outlier. */
+int16_t DspHampelProcess(dspHampel_t *psHampel, int16_t i16In);
+
+/**
+ * @brief pi32Out = M x for a ui32Rows by ui32Cols int16 matrix, row-major in
+ * DSP_MAT_PAIR pairs, and an int16 vector. ui32Cols must be even and at most DSP_MAT_MAX_COLS. The sums
+ * are left at full precision and wrap at 32 bits, so the caller chooses the
+ * scaling that keeps them in range.
+ */
+void DspMatVec(const uint32_t *pui32Matrix, const int16_t *pi16Vector,
+               int32_t *pi32Out, uint32_t ui32Rows, uint32_t ui32Cols);
+
+#endif /* __DSP_FILTER_H__ */
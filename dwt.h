@@ -0,0 +1,38 @@
+/******************************************************************************
+ *
+ * dwt.h
+ *
+ * Purpose:
+ * The Cortex-M4 DWT cycle counter, shared by the boot trace and the kernel
+ * benchmark. The counter is free-running at the core clock; only
+ * BootTraceStart() zeroes it, so the boot milestones stay measured from the
+ * clock being set. Other users enable it and take differences.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __DWT_H__
+#define __DWT_H__
+
+#include <stdint.h>
+#include "inc/hw_types.h"
+
+// Debug registers for the free-running cycle counter.
+#define DEM_CR                  0xE000EDFC
+#define DEM_CR_TRCENA           0x01000000
+#define DWT_CTRL                0xE0001000
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define DWT_CYCCNT              0xE0001004
+
+/** @brief Current cycle count. */
+#define DWT_CYCLES()            HWREG(DWT_CYCCNT)
+
+/** @brief Starts the counter if it is not already running, without resetting it. */
+static inline void
+DWTCycleCounterEnable(void)
+{
+    HWREG(DEM_CR) |= DEM_CR_TRCENA;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+}
+
+#endif /* __DWT_H__ */
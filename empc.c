@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * empc.c
+ *
+ * Purpose:
+ * Point location in the explicit MPC region table. See empc.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "empc.h"            // Explicit MPC
+#include "dsp_filter.h"      // DspMatVec
+
+// FUNCTIONS-------------------------------------------------------------------
+
+uint32_t
+EmpcLocate(const int16_t *pi16State, uint32_t ui32Regions)
+{
+    const empcTable_t *psTable = &g_sEmpcTable;
+    int32_t pi32Sums[EMPC_MAX_HALFSPACES];
+    int32_t i32BestExcess = INT32_MAX;
+    uint32_t ui32Best = 0;
+    uint32_t r, i;
+
+    for (r = 0; r < ui32Regions; r++)
+    {
+        const empcRegion_t *psRegion = &psTable->psRegions[r];
+        const int32_t *pi32Bounds = &psTable->pi32Bounds[psRegion->ui16First];
+        int32_t i32Excess = INT32_MIN;
+
+        DspMatVec(&psTable->pui32Halfspaces[psRegion->ui16First * LQR_STATES / 2],
+                  pi16State, pi32Sums, psRegion->ui16Count, LQR_STATES);
+
+        // Bounds are kept within +/-2^30 by the generator and the sums are
+        // smaller, so the difference cannot overflow.
+        for (i = 0; i < psRegion->ui16Count; i++)
+        {
+            if (pi32Sums[i] - pi32Bounds[i] > i32Excess)
+            {
+                i32Excess = pi32Sums[i] - pi32Bounds[i];
+            }
+        }
+
+        if (i32Excess <= 0)
+        {
+            return r;
+        }
+        if (i32Excess < i32BestExcess)
+        {
+            i32BestExcess = i32Excess;
+            ui32Best = r;
+        }
+    }
+
+    return ui32Best;
+}
+
+
+void
+EmpcEvaluate(const int16_t *pi16State, int32_t *pi32Duty)
+{
+    const empcRegion_t *psRegion =
+        &g_sEmpcTable.psRegions[EmpcLocate(pi16State, g_sEmpcTable.ui32Regions)];
+    int32_t pi32Sums[LQR_DUTIES];
+    uint32_t i;
+
+    DspMatVec(psRegion->pui32Gains, pi16State, pi32Sums, LQR_DUTIES,
+              LQR_STATES);
+    for (i = 0; i < LQR_DUTIES; i++)
+    {
+        pi32Duty[i] = (psRegion->pi32Trim[i] - pi32Sums[i]) >>
+                      psRegion->pui32Shift[i];
+    }
+}
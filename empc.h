@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * empc.h
+ *
+ * Purpose:
+ * Explicit model-predictive control for CONTROL_MODE_EMPC.
+ *
+ * The MPC problem, the duties that minimise the predicted cost without
+ * breaking the duty limits of control_task.c, is solved offline for every
+ * state by tools/empc_gen.py. Its solution is piecewise affine: the state
+ * space is cut into polyhedral regions, each with its own affine law. Near
+ * hover that law is the LQR one; in the other regions one or more duties
+ * are at a limit and the others are chosen knowing it, so an integrator
+ * cannot wind up behind a saturated duty and the tail is not asked for
+ * thrust beyond its cap.
+ *
+ * Each cycle EmpcLocate() finds the region holding the state by testing
+ * each region's half-spaces in turn with DspMatVec(), in the order the
+ * table was written: unconstrained first, so the usual case is found at
+ * once. A state just outside every region through rounding gets the law of
+ * the region it is least outside, which is close as the solution is
+ * continuous.
+ *
+ * The state is that of lqr_gains.h, with the rotor lag states taken about
+ * the table's trims.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __EMPC_H__
+#define __EMPC_H__
+
+#include <stdint.h>
+#include "lqr_gains.h"       // State layout
+
+/** @brief Most half-spaces in one region. */
+#define EMPC_MAX_HALFSPACES     16
+
+/** @brief Fraction bits of a half-space row. */
+#define EMPC_HALFSPACE_Q        12
+
+/**
+ * @brief One region: ui16Count half-spaces from ui16First, each
+ * row . state <= bound, and the law used inside, each duty being
+ * (trim - gains . state) >> shift as for lqrGain_t.
+ */
+typedef struct {
+    uint16_t ui16First;
+    uint16_t ui16Count;
+    int32_t pi32Trim[LQR_DUTIES];
+    uint32_t pui32Shift[LQR_DUTIES];
+    uint32_t pui32Gains[LQR_DUTIES * LQR_STATES / 2];   // DSP_MAT_PAIR pairs
+} empcRegion_t;
+
+/** @brief The whole solution, generated into empc_regions.c. */
+typedef struct {
+    uint32_t ui32Regions;
+    uint32_t ui32MotorTauMs;    // Rotor time constant for the lag states
+    int32_t pi32Trim[LQR_DUTIES];   // Lag state origin, duty in Q LQR_STATE_Q
+    const empcRegion_t *psRegions;
+    const uint32_t *pui32Halfspaces;    // LQR_STATES / 2 pairs per row
+    const int32_t *pi32Bounds;
+} empcTable_t;
+
+extern const empcTable_t g_sEmpcTable;
+
+/**
+ * @brief Index of the region holding the state, searching only the first
+ * ui32Regions (at most g_sEmpcTable.ui32Regions).
+ */
+uint32_t EmpcLocate(const int16_t *pi16State, uint32_t ui32Regions);
+
+/** @brief Duties for the state from its region's law, before clamping. */
+void EmpcEvaluate(const int16_t *pi16State, int32_t *pi32Duty);
+
+#endif /* __EMPC_H__ */
@@ -0,0 +1,1340 @@
+/******************************************************************************
+ *
+ * empc_regions.c
+ *
+ * Purpose:
+ * Explicit MPC region table for CONTROL_MODE_EMPC. See empc.h.
+ *
+ * Generated by tools/empc_gen.py (horizon 2 blocks of 10 periods) from the
+ * model and weights of tools/lqr_gains.py. Edit those and regenerate rather
+ * than editing this file.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // CONTROL_PERIOD_MS
+#include "empc.h"            // Explicit MPC
+#include "dsp_filter.h"      // DSP_MAT_PAIR
+
+#if CONTROL_PERIOD_MS != 2
+#error "empc_regions.c was generated for another CONTROL_PERIOD_MS"
+#endif
+
+#if EMPC_MAX_HALFSPACES < 8
+#error "EMPC_MAX_HALFSPACES in empc.h is too small for this table"
+#endif
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static const uint32_t g_pui32Halfspaces[296 * LQR_STATES / 2] =
+{
+    DSP_MAT_PAIR(-2987, -433), DSP_MAT_PAIR(-4096, -369),
+    DSP_MAT_PAIR(-99, -176), DSP_MAT_PAIR(-183, 19),
+    DSP_MAT_PAIR(2987, 433), DSP_MAT_PAIR(4096, 369),
+    DSP_MAT_PAIR(99, 176), DSP_MAT_PAIR(183, -19),
+    DSP_MAT_PAIR(-269, -45), DSP_MAT_PAIR(4096, 461),
+    DSP_MAT_PAIR(-9, 166), DSP_MAT_PAIR(5, -33),
+    DSP_MAT_PAIR(269, 45), DSP_MAT_PAIR(-4096, -461),
+    DSP_MAT_PAIR(9, -166), DSP_MAT_PAIR(-5, 33),
+    DSP_MAT_PAIR(-3752, -581), DSP_MAT_PAIR(-4096, -402),
+    DSP_MAT_PAIR(-123, -174), DSP_MAT_PAIR(-267, 23),
+    DSP_MAT_PAIR(3752, 581), DSP_MAT_PAIR(4096, 402),
+    DSP_MAT_PAIR(123, 174), DSP_MAT_PAIR(267, -23),
+    DSP_MAT_PAIR(-305, -52), DSP_MAT_PAIR(4096, 487),
+    DSP_MAT_PAIR(-10, 163), DSP_MAT_PAIR(4, -36),
+    DSP_MAT_PAIR(305, 52), DSP_MAT_PAIR(-4096, -487),
+    DSP_MAT_PAIR(10, -163), DSP_MAT_PAIR(-4, 36),
+    DSP_MAT_PAIR(-2772, -402), DSP_MAT_PAIR(-4096, -377),
+    DSP_MAT_PAIR(-92, -175), DSP_MAT_PAIR(-171, 20),
+    DSP_MAT_PAIR(2772, 402), DSP_MAT_PAIR(4096, 377),
+    DSP_MAT_PAIR(92, 175), DSP_MAT_PAIR(171, -20),
+    DSP_MAT_PAIR(-274, -46), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-9, 165), DSP_MAT_PAIR(5, -33),
+    DSP_MAT_PAIR(274, 46), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(9, -165), DSP_MAT_PAIR(-5, 33),
+    DSP_MAT_PAIR(-3399, -526), DSP_MAT_PAIR(-4096, -410),
+    DSP_MAT_PAIR(-111, -173), DSP_MAT_PAIR(-244, 24),
+    DSP_MAT_PAIR(3399, 526), DSP_MAT_PAIR(4096, 410),
+    DSP_MAT_PAIR(111, 173), DSP_MAT_PAIR(244, -24),
+    DSP_MAT_PAIR(305, 52), DSP_MAT_PAIR(-4096, -487),
+    DSP_MAT_PAIR(10, -163), DSP_MAT_PAIR(-4, 36),
+    DSP_MAT_PAIR(-2772, -402), DSP_MAT_PAIR(-4096, -377),
+    DSP_MAT_PAIR(-92, -175), DSP_MAT_PAIR(-171, 20),
+    DSP_MAT_PAIR(2772, 402), DSP_MAT_PAIR(4096, 377),
+    DSP_MAT_PAIR(92, 175), DSP_MAT_PAIR(171, -20),
+    DSP_MAT_PAIR(-274, -46), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-9, 165), DSP_MAT_PAIR(5, -33),
+    DSP_MAT_PAIR(274, 46), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(9, -165), DSP_MAT_PAIR(-5, 33),
+    DSP_MAT_PAIR(-3399, -526), DSP_MAT_PAIR(-4096, -410),
+    DSP_MAT_PAIR(-111, -173), DSP_MAT_PAIR(-244, 24),
+    DSP_MAT_PAIR(3399, 526), DSP_MAT_PAIR(4096, 410),
+    DSP_MAT_PAIR(111, 173), DSP_MAT_PAIR(244, -24),
+    DSP_MAT_PAIR(-305, -52), DSP_MAT_PAIR(4096, 487),
+    DSP_MAT_PAIR(-10, 163), DSP_MAT_PAIR(4, -36),
+    DSP_MAT_PAIR(-3093, -454), DSP_MAT_PAIR(-4096, -374),
+    DSP_MAT_PAIR(-103, -176), DSP_MAT_PAIR(-194, 19),
+    DSP_MAT_PAIR(3093, 454), DSP_MAT_PAIR(4096, 374),
+    DSP_MAT_PAIR(103, 176), DSP_MAT_PAIR(194, -19),
+    DSP_MAT_PAIR(-255, -43), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(255, 43), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(3752, 581), DSP_MAT_PAIR(4096, 402),
+    DSP_MAT_PAIR(123, 174), DSP_MAT_PAIR(267, -23),
+    DSP_MAT_PAIR(-291, -50), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(5, -36),
+    DSP_MAT_PAIR(291, 50), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-5, 36),
+    DSP_MAT_PAIR(-3093, -454), DSP_MAT_PAIR(-4096, -374),
+    DSP_MAT_PAIR(-103, -176), DSP_MAT_PAIR(-194, 19),
+    DSP_MAT_PAIR(3093, 454), DSP_MAT_PAIR(4096, 374),
+    DSP_MAT_PAIR(103, 176), DSP_MAT_PAIR(194, -19),
+    DSP_MAT_PAIR(-255, -43), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(255, 43), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-3752, -581), DSP_MAT_PAIR(-4096, -402),
+    DSP_MAT_PAIR(-123, -174), DSP_MAT_PAIR(-267, 23),
+    DSP_MAT_PAIR(-291, -50), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(5, -36),
+    DSP_MAT_PAIR(291, 50), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-5, 36),
+    DSP_MAT_PAIR(-2611, -378), DSP_MAT_PAIR(-4096, -379),
+    DSP_MAT_PAIR(-87, -175), DSP_MAT_PAIR(-162, 20),
+    DSP_MAT_PAIR(2611, 378), DSP_MAT_PAIR(4096, 379),
+    DSP_MAT_PAIR(87, 175), DSP_MAT_PAIR(162, -20),
+    DSP_MAT_PAIR(269, 45), DSP_MAT_PAIR(-4096, -461),
+    DSP_MAT_PAIR(9, -166), DSP_MAT_PAIR(-5, 33),
+    DSP_MAT_PAIR(-3183, -493), DSP_MAT_PAIR(-4096, -411),
+    DSP_MAT_PAIR(-104, -173), DSP_MAT_PAIR(-230, 24),
+    DSP_MAT_PAIR(3183, 493), DSP_MAT_PAIR(4096, 411),
+    DSP_MAT_PAIR(104, 173), DSP_MAT_PAIR(230, -24),
+    DSP_MAT_PAIR(-297, -51), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(4, -36),
+    DSP_MAT_PAIR(297, 51), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-4, 36),
+    DSP_MAT_PAIR(-2611, -378), DSP_MAT_PAIR(-4096, -379),
+    DSP_MAT_PAIR(-87, -175), DSP_MAT_PAIR(-162, 20),
+    DSP_MAT_PAIR(2611, 378), DSP_MAT_PAIR(4096, 379),
+    DSP_MAT_PAIR(87, 175), DSP_MAT_PAIR(162, -20),
+    DSP_MAT_PAIR(-269, -45), DSP_MAT_PAIR(4096, 461),
+    DSP_MAT_PAIR(-9, 166), DSP_MAT_PAIR(5, -33),
+    DSP_MAT_PAIR(-3183, -493), DSP_MAT_PAIR(-4096, -411),
+    DSP_MAT_PAIR(-104, -173), DSP_MAT_PAIR(-230, 24),
+    DSP_MAT_PAIR(3183, 493), DSP_MAT_PAIR(4096, 411),
+    DSP_MAT_PAIR(104, 173), DSP_MAT_PAIR(230, -24),
+    DSP_MAT_PAIR(-297, -51), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(4, -36),
+    DSP_MAT_PAIR(297, 51), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-4, 36),
+    DSP_MAT_PAIR(2987, 433), DSP_MAT_PAIR(4096, 369),
+    DSP_MAT_PAIR(99, 176), DSP_MAT_PAIR(183, -19),
+    DSP_MAT_PAIR(-238, -41), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(238, 41), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-3472, -527), DSP_MAT_PAIR(-4096, -390),
+    DSP_MAT_PAIR(-114, -175), DSP_MAT_PAIR(-236, 21),
+    DSP_MAT_PAIR(3472, 527), DSP_MAT_PAIR(4096, 390),
+    DSP_MAT_PAIR(114, 175), DSP_MAT_PAIR(236, -21),
+    DSP_MAT_PAIR(-277, -48), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(6, -36),
+    DSP_MAT_PAIR(277, 48), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-6, 36),
+    DSP_MAT_PAIR(-2987, -433), DSP_MAT_PAIR(-4096, -369),
+    DSP_MAT_PAIR(-99, -176), DSP_MAT_PAIR(-183, 19),
+    DSP_MAT_PAIR(-238, -41), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(238, 41), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-3472, -527), DSP_MAT_PAIR(-4096, -390),
+    DSP_MAT_PAIR(-114, -175), DSP_MAT_PAIR(-236, 21),
+    DSP_MAT_PAIR(3472, 527), DSP_MAT_PAIR(4096, 390),
+    DSP_MAT_PAIR(114, 175), DSP_MAT_PAIR(236, -21),
+    DSP_MAT_PAIR(-277, -48), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(6, -36),
+    DSP_MAT_PAIR(277, 48), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-6, 36),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(3399, 526), DSP_MAT_PAIR(4096, 410),
+    DSP_MAT_PAIR(111, 173), DSP_MAT_PAIR(244, -24),
+    DSP_MAT_PAIR(291, 50), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-5, 36),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(3399, 526), DSP_MAT_PAIR(4096, 410),
+    DSP_MAT_PAIR(111, 173), DSP_MAT_PAIR(244, -24),
+    DSP_MAT_PAIR(-291, -50), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(5, -36),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3399, -526), DSP_MAT_PAIR(-4096, -410),
+    DSP_MAT_PAIR(-111, -173), DSP_MAT_PAIR(-244, 24),
+    DSP_MAT_PAIR(291, 50), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-5, 36),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3399, -526), DSP_MAT_PAIR(-4096, -410),
+    DSP_MAT_PAIR(-111, -173), DSP_MAT_PAIR(-244, 24),
+    DSP_MAT_PAIR(-291, -50), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(5, -36),
+    DSP_MAT_PAIR(-2328, -336), DSP_MAT_PAIR(-4096, -389),
+    DSP_MAT_PAIR(-77, -174), DSP_MAT_PAIR(-147, 22),
+    DSP_MAT_PAIR(2328, 336), DSP_MAT_PAIR(4096, 389),
+    DSP_MAT_PAIR(77, 174), DSP_MAT_PAIR(147, -22),
+    DSP_MAT_PAIR(274, 46), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(9, -165), DSP_MAT_PAIR(-5, 33),
+    DSP_MAT_PAIR(-2753, -426), DSP_MAT_PAIR(-4096, -419),
+    DSP_MAT_PAIR(-90, -172), DSP_MAT_PAIR(-202, 26),
+    DSP_MAT_PAIR(2753, 426), DSP_MAT_PAIR(4096, 419),
+    DSP_MAT_PAIR(90, 172), DSP_MAT_PAIR(202, -26),
+    DSP_MAT_PAIR(297, 51), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-4, 36),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(255, 43), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(3183, 493), DSP_MAT_PAIR(4096, 411),
+    DSP_MAT_PAIR(104, 173), DSP_MAT_PAIR(230, -24),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(255, 43), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-3183, -493), DSP_MAT_PAIR(-4096, -411),
+    DSP_MAT_PAIR(-104, -173), DSP_MAT_PAIR(-230, 24),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(-2328, -336), DSP_MAT_PAIR(-4096, -389),
+    DSP_MAT_PAIR(-77, -174), DSP_MAT_PAIR(-147, 22),
+    DSP_MAT_PAIR(2328, 336), DSP_MAT_PAIR(4096, 389),
+    DSP_MAT_PAIR(77, 174), DSP_MAT_PAIR(147, -22),
+    DSP_MAT_PAIR(-274, -46), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-9, 165), DSP_MAT_PAIR(5, -33),
+    DSP_MAT_PAIR(-2753, -426), DSP_MAT_PAIR(-4096, -419),
+    DSP_MAT_PAIR(-90, -172), DSP_MAT_PAIR(-202, 26),
+    DSP_MAT_PAIR(2753, 426), DSP_MAT_PAIR(4096, 419),
+    DSP_MAT_PAIR(90, 172), DSP_MAT_PAIR(202, -26),
+    DSP_MAT_PAIR(-297, -51), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(4, -36),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(-255, -43), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(3183, 493), DSP_MAT_PAIR(4096, 411),
+    DSP_MAT_PAIR(104, 173), DSP_MAT_PAIR(230, -24),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(-255, -43), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(-3183, -493), DSP_MAT_PAIR(-4096, -411),
+    DSP_MAT_PAIR(-104, -173), DSP_MAT_PAIR(-230, 24),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(2772, 402), DSP_MAT_PAIR(4096, 377),
+    DSP_MAT_PAIR(92, 175), DSP_MAT_PAIR(171, -20),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(277, 48), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-6, 36),
+    DSP_MAT_PAIR(2772, 402), DSP_MAT_PAIR(4096, 377),
+    DSP_MAT_PAIR(92, 175), DSP_MAT_PAIR(171, -20),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(-277, -48), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(6, -36),
+    DSP_MAT_PAIR(3093, 454), DSP_MAT_PAIR(4096, 374),
+    DSP_MAT_PAIR(103, 176), DSP_MAT_PAIR(194, -19),
+    DSP_MAT_PAIR(-207, -36), DSP_MAT_PAIR(4096, 459),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -32),
+    DSP_MAT_PAIR(207, 36), DSP_MAT_PAIR(-4096, -459),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 32),
+    DSP_MAT_PAIR(3472, 527), DSP_MAT_PAIR(4096, 390),
+    DSP_MAT_PAIR(114, 175), DSP_MAT_PAIR(236, -21),
+    DSP_MAT_PAIR(-246, -43), DSP_MAT_PAIR(4096, 485),
+    DSP_MAT_PAIR(-8, 163), DSP_MAT_PAIR(8, -36),
+    DSP_MAT_PAIR(246, 43), DSP_MAT_PAIR(-4096, -485),
+    DSP_MAT_PAIR(8, -163), DSP_MAT_PAIR(-8, 36),
+    DSP_MAT_PAIR(2611, 378), DSP_MAT_PAIR(4096, 379),
+    DSP_MAT_PAIR(87, 175), DSP_MAT_PAIR(162, -20),
+    DSP_MAT_PAIR(238, 41), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(2611, 378), DSP_MAT_PAIR(4096, 379),
+    DSP_MAT_PAIR(87, 175), DSP_MAT_PAIR(162, -20),
+    DSP_MAT_PAIR(-238, -41), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(-2772, -402), DSP_MAT_PAIR(-4096, -377),
+    DSP_MAT_PAIR(-92, -175), DSP_MAT_PAIR(-171, 20),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(277, 48), DSP_MAT_PAIR(-4096, -486),
+    DSP_MAT_PAIR(9, -163), DSP_MAT_PAIR(-6, 36),
+    DSP_MAT_PAIR(-2772, -402), DSP_MAT_PAIR(-4096, -377),
+    DSP_MAT_PAIR(-92, -175), DSP_MAT_PAIR(-171, 20),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(-277, -48), DSP_MAT_PAIR(4096, 486),
+    DSP_MAT_PAIR(-9, 163), DSP_MAT_PAIR(6, -36),
+    DSP_MAT_PAIR(-3093, -454), DSP_MAT_PAIR(-4096, -374),
+    DSP_MAT_PAIR(-103, -176), DSP_MAT_PAIR(-194, 19),
+    DSP_MAT_PAIR(-207, -36), DSP_MAT_PAIR(4096, 459),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -32),
+    DSP_MAT_PAIR(207, 36), DSP_MAT_PAIR(-4096, -459),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 32),
+    DSP_MAT_PAIR(-3472, -527), DSP_MAT_PAIR(-4096, -390),
+    DSP_MAT_PAIR(-114, -175), DSP_MAT_PAIR(-236, 21),
+    DSP_MAT_PAIR(-246, -43), DSP_MAT_PAIR(4096, 485),
+    DSP_MAT_PAIR(-8, 163), DSP_MAT_PAIR(8, -36),
+    DSP_MAT_PAIR(246, 43), DSP_MAT_PAIR(-4096, -485),
+    DSP_MAT_PAIR(8, -163), DSP_MAT_PAIR(-8, 36),
+    DSP_MAT_PAIR(-2611, -378), DSP_MAT_PAIR(-4096, -379),
+    DSP_MAT_PAIR(-87, -175), DSP_MAT_PAIR(-162, 20),
+    DSP_MAT_PAIR(238, 41), DSP_MAT_PAIR(-4096, -460),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(-2611, -378), DSP_MAT_PAIR(-4096, -379),
+    DSP_MAT_PAIR(-87, -175), DSP_MAT_PAIR(-162, 20),
+    DSP_MAT_PAIR(-238, -41), DSP_MAT_PAIR(4096, 460),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(2753, 426), DSP_MAT_PAIR(4096, 419),
+    DSP_MAT_PAIR(90, 172), DSP_MAT_PAIR(202, -26),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(260, 44), DSP_MAT_PAIR(-4096, -464),
+    DSP_MAT_PAIR(8, -165), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-2753, -426), DSP_MAT_PAIR(-4096, -419),
+    DSP_MAT_PAIR(-90, -172), DSP_MAT_PAIR(-202, 26),
+    DSP_MAT_PAIR(283, 48), DSP_MAT_PAIR(-4096, -481),
+    DSP_MAT_PAIR(9, -164), DSP_MAT_PAIR(-5, 35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(2753, 426), DSP_MAT_PAIR(4096, 419),
+    DSP_MAT_PAIR(90, 172), DSP_MAT_PAIR(202, -26),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(-260, -44), DSP_MAT_PAIR(4096, 464),
+    DSP_MAT_PAIR(-8, 165), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(-2753, -426), DSP_MAT_PAIR(-4096, -419),
+    DSP_MAT_PAIR(-90, -172), DSP_MAT_PAIR(-202, 26),
+    DSP_MAT_PAIR(-283, -48), DSP_MAT_PAIR(4096, 481),
+    DSP_MAT_PAIR(-9, 164), DSP_MAT_PAIR(5, -35),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(246, 43), DSP_MAT_PAIR(-4096, -485),
+    DSP_MAT_PAIR(8, -163), DSP_MAT_PAIR(-8, 36),
+    DSP_MAT_PAIR(2861, 419), DSP_MAT_PAIR(4096, 381),
+    DSP_MAT_PAIR(95, 175), DSP_MAT_PAIR(181, -20),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(3173, 481), DSP_MAT_PAIR(4096, 398),
+    DSP_MAT_PAIR(104, 174), DSP_MAT_PAIR(218, -22),
+    DSP_MAT_PAIR(-246, -43), DSP_MAT_PAIR(4096, 485),
+    DSP_MAT_PAIR(-8, 163), DSP_MAT_PAIR(8, -36),
+    DSP_MAT_PAIR(2328, 336), DSP_MAT_PAIR(4096, 389),
+    DSP_MAT_PAIR(77, 174), DSP_MAT_PAIR(147, -22),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(207, 36), DSP_MAT_PAIR(-4096, -459),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 32),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(2328, 336), DSP_MAT_PAIR(4096, 389),
+    DSP_MAT_PAIR(77, 174), DSP_MAT_PAIR(147, -22),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(2693, 395), DSP_MAT_PAIR(4096, 384),
+    DSP_MAT_PAIR(89, 175), DSP_MAT_PAIR(172, -21),
+    DSP_MAT_PAIR(-207, -36), DSP_MAT_PAIR(4096, 459),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -32),
+    DSP_MAT_PAIR(2977, 451), DSP_MAT_PAIR(4096, 399),
+    DSP_MAT_PAIR(98, 174), DSP_MAT_PAIR(206, -23),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(246, 43), DSP_MAT_PAIR(-4096, -485),
+    DSP_MAT_PAIR(8, -163), DSP_MAT_PAIR(-8, 36),
+    DSP_MAT_PAIR(-2861, -419), DSP_MAT_PAIR(-4096, -381),
+    DSP_MAT_PAIR(-95, -175), DSP_MAT_PAIR(-181, 20),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(-3173, -481), DSP_MAT_PAIR(-4096, -398),
+    DSP_MAT_PAIR(-104, -174), DSP_MAT_PAIR(-218, 22),
+    DSP_MAT_PAIR(-246, -43), DSP_MAT_PAIR(4096, 485),
+    DSP_MAT_PAIR(-8, 163), DSP_MAT_PAIR(8, -36),
+    DSP_MAT_PAIR(-2328, -336), DSP_MAT_PAIR(-4096, -389),
+    DSP_MAT_PAIR(-77, -174), DSP_MAT_PAIR(-147, 22),
+    DSP_MAT_PAIR(244, 42), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(8, -166), DSP_MAT_PAIR(-6, 33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(268, 46), DSP_MAT_PAIR(-4096, -480),
+    DSP_MAT_PAIR(8, -164), DSP_MAT_PAIR(-6, 35),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(207, 36), DSP_MAT_PAIR(-4096, -459),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(-2328, -336), DSP_MAT_PAIR(-4096, -389),
+    DSP_MAT_PAIR(-77, -174), DSP_MAT_PAIR(-147, 22),
+    DSP_MAT_PAIR(-244, -42), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-8, 166), DSP_MAT_PAIR(6, -33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(-268, -46), DSP_MAT_PAIR(4096, 480),
+    DSP_MAT_PAIR(-8, 164), DSP_MAT_PAIR(6, -35),
+    DSP_MAT_PAIR(-2693, -395), DSP_MAT_PAIR(-4096, -384),
+    DSP_MAT_PAIR(-89, -175), DSP_MAT_PAIR(-172, 21),
+    DSP_MAT_PAIR(-207, -36), DSP_MAT_PAIR(4096, 459),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -32),
+    DSP_MAT_PAIR(-2977, -451), DSP_MAT_PAIR(-4096, -399),
+    DSP_MAT_PAIR(-98, -174), DSP_MAT_PAIR(-206, 23),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(2390, 350), DSP_MAT_PAIR(4096, 394),
+    DSP_MAT_PAIR(79, 174), DSP_MAT_PAIR(155, -22),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(2603, 394), DSP_MAT_PAIR(4096, 409),
+    DSP_MAT_PAIR(86, 173), DSP_MAT_PAIR(182, -24),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(237, 42), DSP_MAT_PAIR(-4096, -479),
+    DSP_MAT_PAIR(7, -164), DSP_MAT_PAIR(-8, 35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(212, 37), DSP_MAT_PAIR(-4096, -463),
+    DSP_MAT_PAIR(7, -166), DSP_MAT_PAIR(-8, 33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35),
+    DSP_MAT_PAIR(-2390, -350), DSP_MAT_PAIR(-4096, -394),
+    DSP_MAT_PAIR(-79, -174), DSP_MAT_PAIR(-155, 22),
+    DSP_MAT_PAIR(-212, -37), DSP_MAT_PAIR(4096, 463),
+    DSP_MAT_PAIR(-7, 166), DSP_MAT_PAIR(8, -33),
+    DSP_MAT_PAIR(-2603, -394), DSP_MAT_PAIR(-4096, -409),
+    DSP_MAT_PAIR(-86, -173), DSP_MAT_PAIR(-182, 24),
+    DSP_MAT_PAIR(-237, -42), DSP_MAT_PAIR(4096, 479),
+    DSP_MAT_PAIR(-7, 164), DSP_MAT_PAIR(8, -35)
+};
+
+static const int32_t g_pi32Bounds[296] =
+{
+    126296, 114153, 29264, 23660, 226542, 204760,
+    37304, 30161,
+    115634, 109144, 30393, 15098, 203543, 190163,
+    -37304,
+    120031, 104748, 20918, 24573, 209424, 184282,
+    -30161,
+    140275, 66644, 28399, 24346, -226542, 36425,
+    30816,
+    80132, 126787, 29857, 22888, -204760, 37863,
+    29378,
+    108341, 104354, -29264, 190321, 179910, 35553,
+    17218,
+    114450, 98246, -23660, 197815, 172416, 24026,
+    28745,
+    -126296, 27795, 24629, 189913, 83795, 35897,
+    30988,
+    -114153, 30065, 22359, 102056, 171653, 37966,
+    28919,
+    128165, 64573, 29529, 15795, -203543, -36425,
+    132774, 59964, 20067, 25256, -209424, -30816,
+    72045, 120693, 30983, 14340, -190163, -37863,
+    76653, 116085, 21522, 23801, -184282, -29378,
+    94332, 97656, -30393, 162447, 162096, -35553,
+    120105, 62070, -28399, -190321, 34673, 17892,
+    66979, 115196, -29857, -179910, 36115, 16450,
+    106106, 85882, -24573, 176951, 147592, -28745,
+    126412, 55763, -24346, -197815, 23162, 29404,
+    73286, 108889, -22888, -172416, 24604, 27961,
+    -115634, 28937, 16101, 171865, 79966, -35897,
+    -120031, 19513, 25525, 177211, 74620, -30988,
+    -140275, 25961, 26021, -189913, 34063, 32279,
+    -108341, -27795, 160860, 76322, 34124, 18123,
+    -114450, -24629, 167856, 69325, 22651, 29596,
+    -109144, 31178, 13859, 90864, 160967, -37966,
+    -104748, 21754, 23283, 96210, 155621, -28919,
+    -126787, 31258, 20725, -171653, 39051, 27291,
+    -104354, -30065, 84424, 152758, 36237, 16010,
+    -98246, -22359, 91420, 145762, 24763, 27484,
+    104380, 59287, -29529, -162447, -34673,
+    56505, 107162, -30983, -162096, -36115,
+    116557, 47111, -25256, -176951, -29404,
+    68682, 94985, -23801, -147592, -27961,
+    -128165, 27108, 17520, -171865, -34063,
+    -132774, 17721, 26907, -177211, -32279,
+    -94332, -28937, 138370, 71454, -34124,
+    -120105, -25961, -160860, 32282, 19472,
+    -106106, -25525, 151909, 57916, -29596,
+    -126412, -26021, -167856, 20851, 30903,
+    -120693, 32361, 12267, -160967, -39051,
+    -116085, 22974, 21654, -155621, -27291,
+    -97656, -31178, 70507, 139318, -36237,
+    -115196, -31258, -152758, 37337, 14416,
+    -85882, -23283, 84045, 125779, -27484,
+    -108889, -20725, -145762, 25906, 25847,
+    -104380, -27108, -138370, -32282,
+    -111216, -17520, -145883, -20851,
+    -116557, -26907, -151909, -30903,
+    -68682, -24613, -57916, -28662,
+    -59287, -30067, -70507, -35096,
+    -107162, -32361, -139318, -37337,
+    -101822, -22974, -133292, -14416,
+    -94985, -21654, -125779, -25847
+};
+
+static const empcRegion_t g_psRegions[53] =
+{
+    // unconstrained
+    {
+        0, 8,
+        { 770048, 155648 },
+        { 14, 12 },
+        {
+            DSP_MAT_PAIR(20146, 2923), DSP_MAT_PAIR(27631, 2489),
+            DSP_MAT_PAIR(669, 1189), DSP_MAT_PAIR(1232, -126),
+            DSP_MAT_PAIR(1769, 297), DSP_MAT_PAIR(-26946, -3030),
+            DSP_MAT_PAIR(56, -1091), DSP_MAT_PAIR(-32, 214)
+        }
+    },
+    // next tail max
+    {
+        8, 7,
+        { 787591, 115553 },
+        { 14, 12 },
+        {
+            DSP_MAT_PAIR(20003, 2899), DSP_MAT_PAIR(29557, 2718),
+            DSP_MAT_PAIR(665, 1266), DSP_MAT_PAIR(1234, -143),
+            DSP_MAT_PAIR(2096, 353), DSP_MAT_PAIR(-31348, -3553),
+            DSP_MAT_PAIR(67, -1266), DSP_MAT_PAIR(-36, 253)
+        }
+    },
+    // next tail min
+    {
+        15, 7,
+        { 755864, 188065 },
+        { 14, 12 },
+        {
+            DSP_MAT_PAIR(20003, 2899), DSP_MAT_PAIR(29557, 2718),
+            DSP_MAT_PAIR(665, 1266), DSP_MAT_PAIR(1234, -143),
+            DSP_MAT_PAIR(2096, 353), DSP_MAT_PAIR(-31348, -3553),
+            DSP_MAT_PAIR(67, -1266), DSP_MAT_PAIR(-36, 253)
+        }
+    },
+    // next main max
+    {
+        22, 7,
+        { 261207, 160701 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12124, 1779), DSP_MAT_PAIR(16054, 1464),
+            DSP_MAT_PAIR(402, 690), DSP_MAT_PAIR(762, -75),
+            DSP_MAT_PAIR(1685, 284), DSP_MAT_PAIR(-27037, -3039),
+            DSP_MAT_PAIR(54, -1095), DSP_MAT_PAIR(-38, 214)
+        }
+    },
+    // next main min
+    {
+        29, 7,
+        { 496936, 151081 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12124, 1779), DSP_MAT_PAIR(16054, 1464),
+            DSP_MAT_PAIR(402, 690), DSP_MAT_PAIR(762, -75),
+            DSP_MAT_PAIR(1685, 284), DSP_MAT_PAIR(-27037, -3039),
+            DSP_MAT_PAIR(54, -1095), DSP_MAT_PAIR(-38, 214)
+        }
+    },
+    // now tail max
+    {
+        36, 7,
+        { 795807, 2785280 },
+        { 14, 15 },
+        {
+            DSP_MAT_PAIR(19910, 2883), DSP_MAT_PAIR(31236, 2894),
+            DSP_MAT_PAIR(662, 1335), DSP_MAT_PAIR(1237, -154),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min
+    {
+        43, 7,
+        { 749222, 0 },
+        { 14, 15 },
+        {
+            DSP_MAT_PAIR(19910, 2883), DSP_MAT_PAIR(31236, 2894),
+            DSP_MAT_PAIR(662, 1335), DSP_MAT_PAIR(1237, -154),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max
+    {
+        50, 7,
+        { 3244032, 163566 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1582, 270), DSP_MAT_PAIR(-27202, -3053),
+            DSP_MAT_PAIR(50, -1102), DSP_MAT_PAIR(-43, 215)
+        }
+    },
+    // now main min
+    {
+        57, 7,
+        { 0, 148491 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1582, 270), DSP_MAT_PAIR(-27202, -3053),
+            DSP_MAT_PAIR(50, -1102), DSP_MAT_PAIR(-43, 215)
+        }
+    },
+    // next main max, tail max
+    {
+        64, 6,
+        { 271711, 121330 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12040, 1765), DSP_MAT_PAIR(17235, 1605),
+            DSP_MAT_PAIR(399, 737), DSP_MAT_PAIR(764, -86),
+            DSP_MAT_PAIR(2000, 339), DSP_MAT_PAIR(-31464, -3564),
+            DSP_MAT_PAIR(64, -1271), DSP_MAT_PAIR(-43, 254)
+        }
+    },
+    // next main max, tail min
+    {
+        70, 6,
+        { 252320, 194009 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12040, 1765), DSP_MAT_PAIR(17235, 1605),
+            DSP_MAT_PAIR(399, 737), DSP_MAT_PAIR(764, -86),
+            DSP_MAT_PAIR(2000, 339), DSP_MAT_PAIR(-31464, -3564),
+            DSP_MAT_PAIR(64, -1271), DSP_MAT_PAIR(-43, 254)
+        }
+    },
+    // next main min, tail max
+    {
+        76, 6,
+        { 507855, 110156 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12040, 1765), DSP_MAT_PAIR(17235, 1605),
+            DSP_MAT_PAIR(399, 737), DSP_MAT_PAIR(764, -86),
+            DSP_MAT_PAIR(2000, 339), DSP_MAT_PAIR(-31464, -3564),
+            DSP_MAT_PAIR(64, -1271), DSP_MAT_PAIR(-43, 254)
+        }
+    },
+    // next main min, tail min
+    {
+        82, 6,
+        { 488464, 182835 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(12040, 1765), DSP_MAT_PAIR(17235, 1605),
+            DSP_MAT_PAIR(399, 737), DSP_MAT_PAIR(764, -86),
+            DSP_MAT_PAIR(2000, 339), DSP_MAT_PAIR(-31464, -3564),
+            DSP_MAT_PAIR(64, -1271), DSP_MAT_PAIR(-43, 254)
+        }
+    },
+    // now tail max; next tail max
+    {
+        88, 6,
+        { 412525, 2785280 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(9833, 1421), DSP_MAT_PAIR(17303, 1645),
+            DSP_MAT_PAIR(327, 735), DSP_MAT_PAIR(620, -92),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail max; next main max
+    {
+        94, 6,
+        { 276326, 2785280 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11988, 1756), DSP_MAT_PAIR(18235, 1709),
+            DSP_MAT_PAIR(397, 778), DSP_MAT_PAIR(765, -93),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail max; next main min
+    {
+        100, 6,
+        { 512831, 2785280 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11988, 1756), DSP_MAT_PAIR(18235, 1709),
+            DSP_MAT_PAIR(397, 778), DSP_MAT_PAIR(765, -93),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min; next tail min
+    {
+        106, 6,
+        { 362789, 0 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(9833, 1421), DSP_MAT_PAIR(17303, 1645),
+            DSP_MAT_PAIR(327, 735), DSP_MAT_PAIR(620, -92),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min; next main max
+    {
+        112, 6,
+        { 248246, 0 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11988, 1756), DSP_MAT_PAIR(18235, 1709),
+            DSP_MAT_PAIR(397, 778), DSP_MAT_PAIR(765, -93),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min; next main min
+    {
+        118, 6,
+        { 484751, 0 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11988, 1756), DSP_MAT_PAIR(18235, 1709),
+            DSP_MAT_PAIR(397, 778), DSP_MAT_PAIR(765, -93),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max; next tail max
+    {
+        124, 6,
+        { 3244032, 124467 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1883, 322), DSP_MAT_PAIR(-31664, -3582),
+            DSP_MAT_PAIR(60, -1280), DSP_MAT_PAIR(-49, 255)
+        }
+    },
+    // now main max; next tail min
+    {
+        130, 6,
+        { 3244032, 197318 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1883, 322), DSP_MAT_PAIR(-31664, -3582),
+            DSP_MAT_PAIR(60, -1280), DSP_MAT_PAIR(-49, 255)
+        }
+    },
+    // now main max; next main max
+    {
+        136, 6,
+        { 3244032, 174282 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1386, 241), DSP_MAT_PAIR(-27433, -3075),
+            DSP_MAT_PAIR(44, -1112), DSP_MAT_PAIR(-56, 216)
+        }
+    },
+    // now main max, tail max
+    {
+        142, 6,
+        { 3244032, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min
+    {
+        148, 6,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min; next tail max
+    {
+        154, 6,
+        { 0, 107139 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1883, 322), DSP_MAT_PAIR(-31664, -3582),
+            DSP_MAT_PAIR(60, -1280), DSP_MAT_PAIR(-49, 255)
+        }
+    },
+    // now main min; next tail min
+    {
+        160, 6,
+        { 0, 179990 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1883, 322), DSP_MAT_PAIR(-31664, -3582),
+            DSP_MAT_PAIR(60, -1280), DSP_MAT_PAIR(-49, 255)
+        }
+    },
+    // now main min; next main min
+    {
+        166, 6,
+        { 0, 138806 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1386, 241), DSP_MAT_PAIR(-27433, -3075),
+            DSP_MAT_PAIR(44, -1112), DSP_MAT_PAIR(-56, 216)
+        }
+    },
+    // now main min, tail max
+    {
+        172, 6,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail min
+    {
+        178, 6,
+        { 0, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail max; next main max, tail max
+    {
+        184, 5,
+        { 293781, 2785280 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11845, 1732), DSP_MAT_PAIR(20297, 1951),
+            DSP_MAT_PAIR(393, 861), DSP_MAT_PAIR(768, -110),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail max; next main min, tail max
+    {
+        189, 5,
+        { 531012, 2785280 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11845, 1732), DSP_MAT_PAIR(20297, 1951),
+            DSP_MAT_PAIR(393, 861), DSP_MAT_PAIR(768, -110),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min; next main max, tail min
+    {
+        194, 5,
+        { 233444, 0 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11845, 1732), DSP_MAT_PAIR(20297, 1951),
+            DSP_MAT_PAIR(393, 861), DSP_MAT_PAIR(768, -110),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now tail min; next main min, tail min
+    {
+        199, 5,
+        { 470675, 0 },
+        { 13, 15 },
+        {
+            DSP_MAT_PAIR(11845, 1732), DSP_MAT_PAIR(20297, 1951),
+            DSP_MAT_PAIR(393, 861), DSP_MAT_PAIR(768, -110),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max; next main max, tail max
+    {
+        204, 5,
+        { 3244032, 136681 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1657, 288), DSP_MAT_PAIR(-31955, -3610),
+            DSP_MAT_PAIR(52, -1292), DSP_MAT_PAIR(-65, 256)
+        }
+    },
+    // now main max; next main max, tail min
+    {
+        209, 5,
+        { 3244032, 209912 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1657, 288), DSP_MAT_PAIR(-31955, -3610),
+            DSP_MAT_PAIR(52, -1292), DSP_MAT_PAIR(-65, 256)
+        }
+    },
+    // now main max, tail max; next tail max
+    {
+        214, 5,
+        { 3244032, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail max; next main max
+    {
+        219, 5,
+        { 3244032, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min; next tail min
+    {
+        224, 5,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min; next main max
+    {
+        229, 5,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min; next main min, tail max
+    {
+        234, 5,
+        { 0, 95700 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1657, 288), DSP_MAT_PAIR(-31955, -3610),
+            DSP_MAT_PAIR(52, -1292), DSP_MAT_PAIR(-65, 256)
+        }
+    },
+    // now main min; next main min, tail min
+    {
+        239, 5,
+        { 0, 168931 },
+        { 15, 12 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(1657, 288), DSP_MAT_PAIR(-31955, -3610),
+            DSP_MAT_PAIR(52, -1292), DSP_MAT_PAIR(-65, 256)
+        }
+    },
+    // now main min, tail max; next tail max
+    {
+        244, 5,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail max; next main min
+    {
+        249, 5,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail min; next tail min
+    {
+        254, 5,
+        { 0, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail min; next main min
+    {
+        259, 5,
+        { 0, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail max; next main max, tail max
+    {
+        264, 4,
+        { 3244032, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min; next main max, tail max
+    {
+        268, 4,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min; next main max, tail min
+    {
+        272, 4,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main max, tail min; next main min, tail min
+    {
+        276, 4,
+        { 3244032, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail max; next main max, tail max
+    {
+        280, 4,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail max; next main min, tail max
+    {
+        284, 4,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail max; next main min, tail min
+    {
+        288, 4,
+        { 0, 2785280 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    },
+    // now main min, tail min; next main min, tail min
+    {
+        292, 4,
+        { 0, 0 },
+        { 15, 15 },
+        {
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0),
+            DSP_MAT_PAIR(0, 0), DSP_MAT_PAIR(0, 0)
+        }
+    }
+};
+
+const empcTable_t g_sEmpcTable =
+{
+    53, 80,
+    { 752, 608 },
+    g_psRegions, g_pui32Halfspaces, g_pi32Bounds
+};
@@ -14,7 +14,8 @@
 
 #include <stdint.h>               // Standard integer types
 #include "config.h"               // Configuration parameters for the system
-#include "circBufT.h"             // Circular Buffer Type Definitions and functions
+#include "ringBuf.h"              // Ring buffer over static storage
+#include "dsp_filter.h"           // Fixed-point filter kernels
 
 // FreeRTOS includes
 #include "priorities.h"           // Task priorities definitions
@@ -22,14 +23,41 @@
 #include "task.h"                 // FreeRTOS task utilities
 #include "semphr.h"               // FreeRTOS semaphore utilities
 #include "yaw_task.h"
+#include "log_task.h"               // Deferred log
+#include "system_state.h"           // Fatal error path
 
 // CONSTANTS ----------------------------------------------------------------------
 // The stack size is defined for the rig task, setting its memory allocation.
 #define RIGTASKSTACKSIZE        128         // Stack size (in words) allocated for the rigTask
 
 // STATICS AND GLOBAL VARIABLES ---------------------------------------------------
-// altitude_Buf is a circular buffer that holds altitude data from the ADC readings.
-static circBuf_t altitude_Buf;              // Circular buffer for storing altitude data
+// altitude_Buf is a ring buffer that holds the last BUF_SIZE altitude ADC readings.
+// Its storage is static (the linker sets --heap_size=0) and rounded up to a power of two.
+#define ALTITUDE_BUF_CAPACITY   8           // Smallest power of two >= BUF_SIZE
+static uint32_t altitude_Storage[ALTITUDE_BUF_CAPACITY];
+static ringBuf_t altitude_Buf;              // Ring buffer for storing altitude data
+
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_BIQUAD
+// Butterworth low-pass, fc/fs = 0.04, as { b0, b1, b2, a1, a2 } in Q14. b1 is
+// rounded down by one so the DC gain is exactly 1.
+static const int16_t altitude_FilterCoeffs[1][5] = {
+    { 219, 437, 219, -26992, 11483 }
+};
+static dspBiquad_t altitude_Filter;
+#endif
+
+#if ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_MEDIAN
+static dspMedian_t altitude_Spike;
+#elif ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_HAMPEL
+static dspHampel_t altitude_Spike;
+#endif
+
+// The filter stages start from the first reading rather than from zero.
+static bool altitude_Primed = false;
+
+// Statically allocated TCB and stack for the rig task.
+static StaticTask_t rigTask_TCB;
+static StackType_t rigTask_Stack[RIGTASKSTACKSIZE];
 
 // g_pUARTSemaphore is a semaphore used to synchronize UART operations. 
 // It's declared externally, probably in a header file or another source file.
@@ -50,10 +78,10 @@ uint32_t EXT_VAL;                           // Global variable to store the mean
 /**
  * Function to calculate the mean altitude from ADC readings stored in the buffer.
  *
- * @param adder Pointer to the circular buffer holding ADC values.
+ * @param adder Pointer to the ring buffer holding ADC values.
  * @return Mean altitude value calculated from the ADC readings.
  */
-uint32_t meanAltiduteADC(circBuf_t *adder);
+uint32_t meanAltiduteADC(ringBuf_t *adder);
 
 /**
  * Task function to continuously read altitude values from ADC 
@@ -72,12 +100,18 @@ void sendMeasHeightToBOTH(void);
  * Task function to continuously read altitude values from the ADC 
  * and store them in a circular buffer. This task also calculates the 
  * average altitude value and makes it available via the EXT_VAL global variable.
+ * A reading is taken every CONTROL_PERIOD_MS, once the control task has used
+ * the last one, and that period paces the whole control loop.
  * 
  * @param pvParameters Pointer to task-specific data (unused in this context).
  */
 static void rigTask(void *pvParameters)
 {
     uint32_t altitude_Val;  // Variable to store the current altitude value
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_BIQUAD
+    int16_t altitude_Filtered;
+#endif
+    TickType_t xLastWake = xTaskGetTickCount();
 
     // Infinite loop to keep the task running
     while(1){
@@ -92,12 +126,43 @@ static void rigTask(void *pvParameters)
             // Retrieve the converted value from ADC and store in altitude_Val
             ADCSequenceDataGet(ADC0_BASE, 3, &altitude_Val);
 
-            // Write the retrieved value to the circular buffer
-            writeCircBuf(&altitude_Buf, altitude_Val);
+            if (!altitude_Primed) {
+#if ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_MEDIAN
+                DspMedianReset(&altitude_Spike, (int16_t)altitude_Val);
+#elif ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_HAMPEL
+                DspHampelReset(&altitude_Spike, (int16_t)altitude_Val);
+#endif
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_BIQUAD
+                DspBiquadReset(&altitude_Filter, (int16_t)altitude_Val);
+#endif
+                altitude_Primed = true;
+            }
+
+            // Drop single-sample spikes before they reach the average
+#if ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_MEDIAN
+            altitude_Val = (uint16_t)DspMedianProcess(&altitude_Spike,
+                                                      (int16_t)altitude_Val);
+#elif ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_HAMPEL
+            altitude_Val = (uint16_t)DspHampelProcess(&altitude_Spike,
+                                                      (int16_t)altitude_Val);
+#endif
+
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_BIQUAD
+            altitude_Filtered = DspBiquadProcess(&altitude_Filter,
+                                                 (int16_t)altitude_Val);
+            // Overshoot on a step down to 0 V must not wrap
+            EXT_VAL = altitude_Filtered > 0 ? (uint32_t)altitude_Filtered : 0;
+#else
+            // Keep a sliding window of the last BUF_SIZE readings
+            if (ringBufCount(&altitude_Buf) >= BUF_SIZE) {
+                discardRingBuf(&altitude_Buf, 1);
+            }
+            writeRingBuf(&altitude_Buf, &altitude_Val);
 
-            // Calculate the average altitude value using values in the circular buffer
+            // Calculate the average altitude value using values in the ring buffer
             // and store the result in the global variable EXT_VAL
             EXT_VAL = meanAltiduteADC(&altitude_Buf);
+#endif
 
             int32_t current_yaw = get_current_yaw();
 
@@ -105,16 +170,17 @@ static void rigTask(void *pvParameters)
 
             {
                 // This section is triggered if the queue overflows.
-                while(1)  // Never-ending loop
-                {
-                }
+                LOG1(LOG_QUEUE_FULL, "Height");
+                SystemStateFatal();
             }
 
             sendMeasHeightToBOTH();
 
             xSemaphoreGive(g_ControlSemaphore);
 
-            vTaskDelay(1);
+            // Fixed period from one reading to the next, whatever the
+            // control task took
+            vTaskDelayUntil(&xLastWake, CONTROL_PERIOD_MS / portTICK_RATE_MS);
 
         }
 
@@ -130,16 +196,34 @@ static void rigTask(void *pvParameters)
  */
 uint32_t HEIGHTTaskInit(void)
 {
-    // Initialize the circular buffer to store altitude data
-    initCircBuf(&altitude_Buf, BUF_SIZE);
+    // Attach the static storage to the altitude ring buffer
+    initRingBuf(&altitude_Buf, altitude_Storage, sizeof(uint32_t),
+                ALTITUDE_BUF_CAPACITY);
+
+#if ALTITUDE_FILTER == ALTITUDE_FILTER_BIQUAD
+    if (!DspBiquadInit(&altitude_Filter, altitude_FilterCoeffs, 1)) {
+        return(1);
+    }
+#endif
+#if ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_MEDIAN
+    if (!DspMedianInit(&altitude_Spike, ALTITUDE_SPIKE_WINDOW)) {
+        return(1);
+    }
+#elif ALTITUDE_SPIKE_FILTER == ALTITUDE_SPIKE_HAMPEL
+    if (!DspHampelInit(&altitude_Spike, ALTITUDE_SPIKE_WINDOW,
+                       DSP_HAMPEL_SIGMAS_Q8(ALTITUDE_SPIKE_SIGMAS))) {
+        return(1);
+    }
+#endif
 
     // Create a FreeRTOS task for updating the altitude data
-    if (xTaskCreate(rigTask,                 // Task function
+    if (xTaskCreateStatic(rigTask,           // Task function
                     (const portCHAR *)"RIG", // Task name for debugging purposes
                     RIGTASKSTACKSIZE,        // Stack size
                     NULL,                    // Task parameters
                     tskIDLE_PRIORITY + PRIORITY_HEIGHT_TASK, // Task priority
-                    NULL) != pdTRUE) {      // Task handle
+                    rigTask_Stack,           // Stack memory
+                    &rigTask_TCB) == NULL) { // TCB memory
         return(1);  // Return 1 if task creation failed
     }
 
@@ -149,23 +233,31 @@ uint32_t HEIGHTTaskInit(void)
 
 
 /**
- * Calculates the mean value of the altitude ADC readings from a circular buffer.
+ * Calculates the mean value of the altitude ADC readings in a ring buffer,
+ * rounded to the nearest integer. The readings are peeked, not consumed.
  * 
- * @param adder  Pointer to the circular buffer containing ADC values.
+ * @param adder  Pointer to the ring buffer containing ADC values.
  * 
- * @return       The calculated mean value.
+ * @return       The calculated mean value, or 0 if the buffer is empty.
  */
-uint32_t meanAltiduteADC(circBuf_t *adder)
+uint32_t meanAltiduteADC(ringBuf_t *adder)
 {
+    uint32_t sample;
     int32_t sum = 0;         // Initialize sum to store the total of all readings
-    int i;                   // Index for the loop
-    
-    // Iterate over the buffer to sum up all the readings
-    for (i = 0; i < adder->size; i++)
-        sum = sum + readCircBuf(adder);
+    uint32_t count = ringBufCount(adder);
+    uint32_t i;              // Index for the loop
 
-    // Compute the mean value. The formula seems to be averaging the sum in a specific way.
-    sum = (2 * sum + adder->size) / 2 / adder->size;
+    if (count == 0)
+        return 0;
+
+    // Sum every reading currently in the window
+    for (i = 0; i < count; i++) {
+        peekRingBuf(adder, i, &sample);
+        sum = sum + sample;
+    }
+
+    // Round to nearest: (sum + count / 2) / count
+    sum = (2 * sum + count) / 2 / count;
     
     return sum;              // Return the calculated mean value
 }
@@ -224,19 +316,13 @@ void sendMeasHeightToBOTH(void)
 {
     static int count = 0;
 
-    // Dispatch the transformed value to the message queue. In the event that the dispatch fails (owing to a full queue),
-    // an error is triggered.
+    // Dispatch the transformed value to the display queue without blocking. The
+    // display task runs at low priority and spends its first 100 ms bringing
+    // up the OLED, so a full queue just means this reading is not shown.
     if (count > 3) {
 
         count = 0;
-        if(xQueueSend(g_MeasHeightDisplayQueue, &EXT_VAL, 10) != pdPASS)
-
-        {
-            // This section is triggered if the queue overflows.
-            while(1)  // Never-ending loop
-            {
-            }
-        }
+        (void)xQueueSend(g_MeasHeightDisplayQueue, &EXT_VAL, 0);
     } else {
 
         count++;
@@ -246,9 +332,8 @@ void sendMeasHeightToBOTH(void)
 
     {
         // This section is triggered if the queue overflows.
-        while(1)  // Never-ending loop
-        {
-        }
+        LOG1(LOG_QUEUE_FULL, "Height");
+        SystemStateFatal();
     }
 
 
@@ -14,8 +14,7 @@
 #ifndef __HEIGHT_TASK_H__
 #define __HEIGHT_TASK_H__
 
-// Include the header for circular buffer type definitions and functions.
-#include "circBufT.h"
+#include <stdint.h>
 
 // Function prototypes.
 
@@ -0,0 +1,716 @@
+/******************************************************************************
+ *
+ * kernel_bench.c
+ *
+ * Purpose:
+ * Latency of queue, semaphore, mutex, task notification, stream buffer,
+ * message buffer and event group operations, measured in CPU cycles.
+ *
+ * Two kinds of case are run for each primitive:
+ *  - uncontended: the operation succeeds immediately and nothing is waiting
+ *    (e.g. a send into a queue with room, a take of a given semaphore).
+ *  - wake: a higher priority partner task is blocked on the primitive and
+ *    the figure is from just before the bench task's give/send until the
+ *    partner is running again, i.e. the full unblock and context switch.
+ *
+ * Each case prints one CSV row:
+ *   primitive,case,samples,min,median,p99,max,mean
+ * with the cost of reading the cycle counter already subtracted. The
+ * dsp_filter.h kernels are timed the same way, per sample, as a check that
+ * the SMLAD paths are in use, and the telemetry encoder per record. Any trace
+ * or run-time stats hooks enabled in FreeRTOSConfig.h are included in the
+ * figures, and the header line records which ones were on.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // System-wide configurations (KERNEL_BENCH_ENABLE)
+
+#if KERNEL_BENCH_ENABLE
+
+#include "kernel_bench.h"    // Kernel benchmark
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "task.h"            // FreeRTOS task functionalities
+#include "queue.h"           // FreeRTOS queue functionalities
+#include "semphr.h"          // FreeRTOS semaphore functionalities
+#include "event_groups.h"    // FreeRTOS event group functionalities
+#include "stream_buffer.h"   // FreeRTOS stream buffer functionalities
+#include "message_buffer.h"  // FreeRTOS message buffer functionalities
+#include "dsp_filter.h"      // Filter kernels
+#include "lqr_gains.h"       // LQR gain table
+#include "empc.h"            // Explicit MPC
+#include "plant_id.h"        // Plant identification
+#include "telemetry.h"       // Telemetry encoder
+#include "dwt.h"             // Cycle counter
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define CYCLES()                DWT_CYCLES()
+
+#define BENCHTASKSTACKSIZE      256     // UARTprintf needs the room
+#define PARTNERTASKSTACKSIZE    128
+#define BENCH_PRIORITY          1
+#define PARTNER_PRIORITY        2       // Above the bench task so a wake
+                                        // switches to it immediately
+
+#define BENCH_ITEM_BYTES        16      // Payload for the buffer cases
+#define BENCH_QUEUE_LENGTH      4       // Also the batch size for the
+                                        // multiple-item queue cases
+#define BENCH_STREAM_SIZE       64
+#define BENCH_EVENT_BIT         0x01
+#define BENCH_ARM_INDEX         1       // Notification index used to arm
+                                        // the partner; index 0 is measured
+#define BENCH_FIR_TAPS          16
+#define BENCH_BIQUAD_STAGES     2
+#define BENCH_CIC_ORDER         3
+#define BENCH_CIC_RATIO         16      // Also the block timed per sample
+
+/** @brief What the partner blocks on in the next round. */
+typedef enum {
+    PARTNER_QUEUE,
+    PARTNER_SEMAPHORE,
+    PARTNER_MUTEX,
+    PARTNER_NOTIFY,
+    PARTNER_EVENT,
+    PARTNER_STREAM,
+    PARTNER_MESSAGE
+} partnerCase_t;
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static StaticTask_t g_xBenchTaskTCB;
+static StackType_t g_pxBenchTaskStack[BENCHTASKSTACKSIZE];
+static StaticTask_t g_xPartnerTaskTCB;
+static StackType_t g_pxPartnerTaskStack[PARTNERTASKSTACKSIZE];
+static TaskHandle_t g_xPartnerTask;
+
+static QueueHandle_t g_xQueue;
+static StaticQueue_t g_xQueueBuf;
+static uint32_t g_pui32QueueStorage[BENCH_QUEUE_LENGTH]; // Word aligned for
+                                                         // the batch fast path
+static SemaphoreHandle_t g_xSemaphore;
+static StaticSemaphore_t g_xSemaphoreBuf;
+static SemaphoreHandle_t g_xMutex;
+static StaticSemaphore_t g_xMutexBuf;
+static EventGroupHandle_t g_xEvent;
+static StaticEventGroup_t g_xEventBuf;
+static StreamBufferHandle_t g_xStream;
+static StaticStreamBuffer_t g_xStreamBuf;
+static uint8_t g_pui8StreamStorage[BENCH_STREAM_SIZE];
+static MessageBufferHandle_t g_xMessage;
+static StaticMessageBuffer_t g_xMessageBuf;
+static uint8_t g_pui8MessageStorage[BENCH_STREAM_SIZE];
+
+static volatile partnerCase_t g_ePartnerCase;
+static volatile uint32_t g_ui32WakeCycles;
+
+// Any coefficients will do for timing; the loops do not depend on them.
+static const uint32_t g_pui32FirCoeffs[BENCH_FIR_TAPS / 2] = {
+    DSP_FIR_PAIR(2048, 2048), DSP_FIR_PAIR(2048, 2048),
+    DSP_FIR_PAIR(2048, 2048), DSP_FIR_PAIR(2048, 2048),
+    DSP_FIR_PAIR(2048, 2048), DSP_FIR_PAIR(2048, 2048),
+    DSP_FIR_PAIR(2048, 2048), DSP_FIR_PAIR(2048, 2048)
+};
+static const int16_t g_ppi16BiquadCoeffs[BENCH_BIQUAD_STAGES][5] = {
+    { 219, 437, 219, -26992, 11483 },
+    { 219, 437, 219, -26992, 11483 }
+};
+static int16_t g_pi16FirState[2 * BENCH_FIR_TAPS];
+static dspFir_t g_sFir;
+static dspBiquad_t g_sBiquad;
+static dspCic_t g_sCic;
+static dspMedian_t g_sMedian;
+static dspHampel_t g_sHampel;
+static telemetryEncoder_t g_sTelemetryEncoder;
+static uint8_t g_pui8TelemetryFrame[TELEMETRY_MAX_RECORD_SIZE];
+
+static uint32_t g_pui32Samples[KERNEL_BENCH_SAMPLES];
+static uint32_t g_ui32Overhead;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Sorts the samples and prints one CSV row.
+ */
+static void
+report(const char *pcPrimitive, const char *pcCase)
+{
+    uint32_t i, j;
+    uint32_t ui32Sum = 0;
+
+    // Insertion sort: 256 samples, and only between measurements.
+    for (i = 1; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        uint32_t ui32Value = g_pui32Samples[i];
+
+        for (j = i; j > 0 && g_pui32Samples[j - 1] > ui32Value; j--)
+        {
+            g_pui32Samples[j] = g_pui32Samples[j - 1];
+        }
+        g_pui32Samples[j] = ui32Value;
+        ui32Sum += ui32Value;
+    }
+    ui32Sum += g_pui32Samples[0];
+
+    UARTprintf("%s,%s,%u,%u,%u,%u,%u,%u\n", pcPrimitive, pcCase,
+               KERNEL_BENCH_SAMPLES, g_pui32Samples[0],
+               g_pui32Samples[KERNEL_BENCH_SAMPLES / 2],
+               g_pui32Samples[KERNEL_BENCH_SAMPLES * 99 / 100],
+               g_pui32Samples[KERNEL_BENCH_SAMPLES - 1],
+               ui32Sum / KERNEL_BENCH_SAMPLES);
+}
+
+/**
+ * @brief Stores one sample, net of the cycle counter read cost.
+ */
+static void
+sample(uint32_t i, uint32_t ui32Start, uint32_t ui32End)
+{
+    uint32_t ui32Delta = ui32End - ui32Start;
+
+    g_pui32Samples[i] = ui32Delta > g_ui32Overhead ? ui32Delta - g_ui32Overhead : 0;
+}
+
+/**
+ * @brief Lets the partner run until it is blocked on the given primitive.
+ */
+static void
+armPartner(partnerCase_t eCase)
+{
+    g_ePartnerCase = eCase;
+    xTaskNotifyGiveIndexed(g_xPartnerTask, BENCH_ARM_INDEX);
+}
+
+/**
+ * @brief Higher priority task that blocks on one primitive per round and
+ * timestamps the moment it runs again.
+ */
+static void
+PartnerTask(void *pvParameters)
+{
+    uint8_t pui8Item[BENCH_ITEM_BYTES];
+    uint32_t ui32Item;
+
+    while(1)
+    {
+        ulTaskNotifyTakeIndexed(BENCH_ARM_INDEX, pdTRUE, portMAX_DELAY);
+
+        switch (g_ePartnerCase)
+        {
+        case PARTNER_QUEUE:
+            xQueueReceive(g_xQueue, &ui32Item, portMAX_DELAY);
+            break;
+        case PARTNER_SEMAPHORE:
+            xSemaphoreTake(g_xSemaphore, portMAX_DELAY);
+            break;
+        case PARTNER_MUTEX:
+            xSemaphoreTake(g_xMutex, portMAX_DELAY);
+            break;
+        case PARTNER_NOTIFY:
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            break;
+        case PARTNER_EVENT:
+            xEventGroupWaitBits(g_xEvent, BENCH_EVENT_BIT, pdTRUE, pdFALSE,
+                                portMAX_DELAY);
+            break;
+        case PARTNER_STREAM:
+            xStreamBufferReceive(g_xStream, pui8Item, sizeof(pui8Item),
+                                 portMAX_DELAY);
+            break;
+        case PARTNER_MESSAGE:
+            xMessageBufferReceive(g_xMessage, pui8Item, sizeof(pui8Item),
+                                  portMAX_DELAY);
+            break;
+        }
+        g_ui32WakeCycles = CYCLES();
+
+        if (g_ePartnerCase == PARTNER_MUTEX)
+        {
+            xSemaphoreGive(g_xMutex);
+        }
+    }
+}
+
+/**
+ * @brief Runs every case once and prints the results.
+ */
+static void
+BenchTask(void *pvParameters)
+{
+    uint8_t pui8Item[BENCH_ITEM_BYTES] = { 0 };
+    uint32_t ui32Item = 0;
+    uint32_t pui32Batch[BENCH_QUEUE_LENGTH] = { 0 };
+    uint32_t ui32Start, ui32End;
+    uint32_t ui32Window;
+    uint32_t ui32Case;
+    uint32_t i;
+
+    // Cost of two back-to-back counter reads, subtracted from every sample.
+    g_ui32Overhead = 0;
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    g_ui32Overhead = g_pui32Samples[0];
+    for (i = 1; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        if (g_pui32Samples[i] < g_ui32Overhead)
+        {
+            g_ui32Overhead = g_pui32Samples[i];
+        }
+    }
+
+    UARTprintf("# kernel_bench cpu_hz=%u overhead=%u trace_recorder=%u "
+               "run_time_stats=%u stack_check=%u\n",
+               configCPU_CLOCK_HZ, g_ui32Overhead, configUSE_TRACE_RECORDER,
+               configGENERATE_RUN_TIME_STATS, configCHECK_FOR_STACK_OVERFLOW);
+    UARTprintf("primitive,case,samples,min,median,p99,max,mean\n");
+
+    // Uncontended.
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xQueueSend(g_xQueue, &ui32Item, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+        xQueueReceive(g_xQueue, &ui32Item, 0);
+    }
+    report("queue", "send");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        xQueueSend(g_xQueue, &ui32Item, 0);
+        ui32Start = CYCLES();
+        xQueueReceive(g_xQueue, &ui32Item, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("queue", "receive");
+
+    // A full queue's worth of items, one call per item and then one call
+    // for the batch. Divide by BENCH_QUEUE_LENGTH for the per-item cost.
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        uint32_t j;
+
+        ui32Start = CYCLES();
+        for (j = 0; j < BENCH_QUEUE_LENGTH; j++)
+        {
+            xQueueSend(g_xQueue, &pui32Batch[j], 0);
+        }
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+        xQueueReceiveMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+    }
+    report("queue", "send_x4");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xQueueSendMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+        xQueueReceiveMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+    }
+    report("queue", "send_multiple_x4");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        uint32_t j;
+
+        xQueueSendMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+        ui32Start = CYCLES();
+        for (j = 0; j < BENCH_QUEUE_LENGTH; j++)
+        {
+            xQueueReceive(g_xQueue, &pui32Batch[j], 0);
+        }
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("queue", "receive_x4");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        xQueueSendMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+        ui32Start = CYCLES();
+        xQueueReceiveMultiple(g_xQueue, pui32Batch, BENCH_QUEUE_LENGTH, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("queue", "receive_multiple_x4");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xSemaphoreGive(g_xSemaphore);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+        xSemaphoreTake(g_xSemaphore, 0);
+    }
+    report("semaphore", "give");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        xSemaphoreGive(g_xSemaphore);
+        ui32Start = CYCLES();
+        xSemaphoreTake(g_xSemaphore, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("semaphore", "take");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xSemaphoreTake(g_xMutex, 0);
+        xSemaphoreGive(g_xMutex);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("mutex", "take_give");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+        ulTaskNotifyTake(pdTRUE, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("notify", "give_take");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xEventGroupSetBits(g_xEvent, BENCH_EVENT_BIT);
+        xEventGroupWaitBits(g_xEvent, BENCH_EVENT_BIT, pdTRUE, pdFALSE, 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("event_group", "set_wait");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xStreamBufferSend(g_xStream, pui8Item, sizeof(pui8Item), 0);
+        xStreamBufferReceive(g_xStream, pui8Item, sizeof(pui8Item), 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("stream_buffer", "send_receive_16");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        ui32Start = CYCLES();
+        xMessageBufferSend(g_xMessage, pui8Item, sizeof(pui8Item), 0);
+        xMessageBufferReceive(g_xMessage, pui8Item, sizeof(pui8Item), 0);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("message_buffer", "send_receive_16");
+
+    // Wake a blocked higher priority task.
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_QUEUE);
+        ui32Start = CYCLES();
+        xQueueSend(g_xQueue, &ui32Item, 0);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("queue", "wake");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_SEMAPHORE);
+        ui32Start = CYCLES();
+        xSemaphoreGive(g_xSemaphore);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("semaphore", "wake");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        // Hold the mutex so the partner blocks on it (and, being higher
+        // priority, lends us its priority until we give it).
+        xSemaphoreTake(g_xMutex, 0);
+        armPartner(PARTNER_MUTEX);
+        ui32Start = CYCLES();
+        xSemaphoreGive(g_xMutex);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("mutex", "handoff");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_NOTIFY);
+        ui32Start = CYCLES();
+        xTaskNotifyGive(g_xPartnerTask);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("notify", "wake");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_EVENT);
+        ui32Start = CYCLES();
+        xEventGroupSetBits(g_xEvent, BENCH_EVENT_BIT);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("event_group", "wake");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_STREAM);
+        ui32Start = CYCLES();
+        xStreamBufferSend(g_xStream, pui8Item, sizeof(pui8Item), 0);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("stream_buffer", "wake");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        armPartner(PARTNER_MESSAGE);
+        ui32Start = CYCLES();
+        xMessageBufferSend(g_xMessage, pui8Item, sizeof(pui8Item), 0);
+        sample(i, ui32Start, g_ui32WakeCycles);
+    }
+    report("message_buffer", "wake");
+
+    // Filter kernels, cycles per sample. The CIC figure is for a block of
+    // BENCH_CIC_RATIO inputs giving one output; divide by the ratio.
+    DspFirInit(&g_sFir, g_pui32FirCoeffs, g_pi16FirState, BENCH_FIR_TAPS);
+    DspBiquadInit(&g_sBiquad, g_ppi16BiquadCoeffs, BENCH_BIQUAD_STAGES);
+    DspCicInit(&g_sCic, BENCH_CIC_ORDER, BENCH_CIC_RATIO);
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        int16_t i16In = (int16_t)(i * 16);
+
+        ui32Start = CYCLES();
+        pui8Item[0] = (uint8_t)DspFirProcess(&g_sFir, i16In);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("dsp", "fir_16_taps");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        int16_t i16In = (int16_t)(i * 16);
+
+        ui32Start = CYCLES();
+        pui8Item[0] = (uint8_t)DspBiquadProcess(&g_sBiquad, i16In);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("dsp", "biquad_2_stages");
+
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        int16_t pi16In[BENCH_CIC_RATIO] = { 0 };
+        int16_t i16Out;
+
+        pi16In[0] = (int16_t)(i * 16);
+        ui32Start = CYCLES();
+        DspCicBlock(&g_sCic, pi16In, &i16Out, BENCH_CIC_RATIO);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("dsp", "cic_3_order_x16");
+
+    // Median and Hampel for each window size. Pseudo-random input so the
+    // figures show the networks really are data independent.
+    for (ui32Window = 3; ui32Window <= DSP_MEDIAN_MAX_WINDOW; ui32Window += 2)
+    {
+        static const char * const ppcMedianCases[] = {
+            "median_3", "median_5", "median_7", "median_9"
+        };
+        static const char * const ppcHampelCases[] = {
+            "hampel_3", "hampel_5", "hampel_7", "hampel_9"
+        };
+
+        DspMedianInit(&g_sMedian, ui32Window);
+        for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+        {
+            int16_t i16In = (int16_t)((i * 2654435761u) >> 20);
+
+            ui32Start = CYCLES();
+            pui8Item[0] = (uint8_t)DspMedianProcess(&g_sMedian, i16In);
+            ui32End = CYCLES();
+            sample(i, ui32Start, ui32End);
+        }
+        report("dsp", ppcMedianCases[ui32Window / 2 - 1]);
+
+        DspHampelInit(&g_sHampel, ui32Window, DSP_HAMPEL_SIGMAS_Q8(3));
+        for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+        {
+            int16_t i16In = (int16_t)((i * 2654435761u) >> 20);
+
+            ui32Start = CYCLES();
+            pui8Item[0] = (uint8_t)DspHampelProcess(&g_sHampel, i16In);
+            ui32End = CYCLES();
+            sample(i, ui32Start, ui32End);
+        }
+        report("dsp", ppcHampelCases[ui32Window / 2 - 1]);
+    }
+
+    // The LQR gain product run by the control task each cycle.
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        int16_t pi16State[LQR_STATES];
+        int32_t pi32Sum[LQR_DUTIES];
+        uint32_t j;
+
+        for (j = 0; j < LQR_STATES; j++)
+        {
+            pi16State[j] = (int16_t)(((i + j) * 2654435761u) >> 20);
+        }
+        ui32Start = CYCLES();
+        DspMatVec(g_psLqrGains[0].pui32Gains, pi16State, pi32Sum, LQR_DUTIES,
+                  LQR_STATES);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+        pui8Item[0] = (uint8_t)pi32Sum[0];
+    }
+    report("dsp", "matvec_2x8");
+
+    // Explicit MPC point location against the number of regions searched.
+    // At hover the state is in the first region. A state with every entry at
+    // INT16_MAX is in one of the last regions, where both duties are held at
+    // limits, so searching the first n regions tests all n.
+    for (ui32Case = 0; ui32Case < 5; ui32Case++)
+    {
+        static const char * const ppcEmpcCases[] = {
+            "empc_hover", "empc_search_8", "empc_search_16", "empc_search_32",
+            "empc_search_all"
+        };
+        static const uint32_t pui32Regions[] = { 0, 8, 16, 32, 0 };
+        int16_t pi16State[LQR_STATES];
+        uint32_t ui32Regions = pui32Regions[ui32Case];
+        uint32_t j;
+
+        if (ui32Regions == 0 || ui32Regions > g_sEmpcTable.ui32Regions)
+        {
+            ui32Regions = g_sEmpcTable.ui32Regions;
+        }
+        for (j = 0; j < LQR_STATES; j++)
+        {
+            pi16State[j] = (ui32Case == 0) ? 0 : INT16_MAX;
+        }
+
+        for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+        {
+            ui32Start = CYCLES();
+            pui8Item[0] = (uint8_t)EmpcLocate(pi16State, ui32Regions);
+            ui32End = CYCLES();
+            sample(i, ui32Start, ui32End);
+        }
+        report("dsp", ppcEmpcCases[ui32Case]);
+    }
+
+    // Plant identification, one control cycle per sample. Most cycles only
+    // run the filters; one in PLANT_ID_DIVIDER / 2 adds a least-squares
+    // update, which is the max. Warmed up past the settling period first.
+    for (i = 0; i < PLANT_ID_SETTLE_CYCLES + PLANT_ID_DIVIDER; i++)
+    {
+        PlantIdUpdate(300, 0, 50, 40, 0.002f, true);
+    }
+    for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+    {
+        int32_t i32Noise = (int32_t)((i * 2654435761u) >> 28);
+
+        ui32Start = CYCLES();
+        PlantIdUpdate(300 + i32Noise, i32Noise, 50 + i32Noise, 40 - i32Noise,
+                      0.002f, true);
+        ui32End = CYCLES();
+        sample(i, ui32Start, ui32End);
+    }
+    report("control", "plant_id_update");
+
+    // Telemetry encoding, one control-cycle record per sample, as a delta
+    // with every channel changed and as a keyframe. The control task pays
+    // this every cycle with TELEMETRY_ENABLE set.
+    for (ui32Case = 0; ui32Case < 2; ui32Case++)
+    {
+        static const char * const ppcTelemetryCases[] = {
+            "encode_delta", "encode_keyframe"
+        };
+        telemetryRecord_t sRecord;
+        uint32_t j;
+
+        TelemetryEncoderReset(&g_sTelemetryEncoder);
+        for (i = 0; i < KERNEL_BENCH_SAMPLES; i++)
+        {
+            sRecord.ui32Tick = i * 10;
+            for (j = 0; j < TELEMETRY_NUM_CHANNELS; j++)
+            {
+                sRecord.pi32Values[j] = (int32_t)(((i + j) * 2654435761u) >> 22);
+            }
+            g_sTelemetryEncoder.ui32SinceKeyframe = 0;
+            g_sTelemetryEncoder.bNeedKeyframe = (ui32Case == 1);
+
+            ui32Start = CYCLES();
+            pui8Item[0] = (uint8_t)TelemetryEncode(&g_sTelemetryEncoder,
+                                                   &sRecord,
+                                                   g_pui8TelemetryFrame);
+            ui32End = CYCLES();
+            sample(i, ui32Start, ui32End);
+        }
+        report("telemetry", ppcTelemetryCases[ui32Case]);
+    }
+
+    UARTprintf("# done\n");
+    while(1)
+    {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+
+uint32_t
+KernelBenchInit(void)
+{
+    // Start the cycle counter, if the boot trace has not. Samples are
+    // differences, so leave its count alone.
+    DWTCycleCounterEnable();
+
+    g_xQueue = xQueueCreateStatic(BENCH_QUEUE_LENGTH, sizeof(uint32_t),
+                                  (uint8_t *)g_pui32QueueStorage,
+                                  &g_xQueueBuf);
+    g_xSemaphore = xSemaphoreCreateBinaryStatic(&g_xSemaphoreBuf);
+    g_xMutex = xSemaphoreCreateMutexStatic(&g_xMutexBuf);
+    g_xEvent = xEventGroupCreateStatic(&g_xEventBuf);
+    // Trigger level 1 so a receiver wakes on the first byte.
+    g_xStream = xStreamBufferCreateStatic(BENCH_STREAM_SIZE, 1,
+                                          g_pui8StreamStorage, &g_xStreamBuf);
+    g_xMessage = xMessageBufferCreateStatic(BENCH_STREAM_SIZE,
+                                            g_pui8MessageStorage,
+                                            &g_xMessageBuf);
+
+    g_xPartnerTask = xTaskCreateStatic(PartnerTask, (const portCHAR *)"Partner",
+                                       PARTNERTASKSTACKSIZE, NULL,
+                                       tskIDLE_PRIORITY + PARTNER_PRIORITY,
+                                       g_pxPartnerTaskStack, &g_xPartnerTaskTCB);
+    if (g_xPartnerTask == NULL)
+    {
+        return(1);
+    }
+
+    if (xTaskCreateStatic(BenchTask, (const portCHAR *)"Bench",
+                          BENCHTASKSTACKSIZE, NULL,
+                          tskIDLE_PRIORITY + BENCH_PRIORITY,
+                          g_pxBenchTaskStack, &g_xBenchTaskTCB) == NULL)
+    {
+        return(1);
+    }
+
+    return(0);
+}
+
+#endif /* KERNEL_BENCH_ENABLE */
@@ -0,0 +1,28 @@
+/******************************************************************************
+ *
+ * kernel_bench.h
+ *
+ * Purpose:
+ * On-target micro-benchmarks of the FreeRTOS primitives in this kernel
+ * configuration, built only when KERNEL_BENCH_ENABLE is set in config.h.
+ *
+ * The benchmark replaces the application: main() starts only the bench task
+ * and its partner, and results are printed on UART0 as CSV, timed in CPU
+ * cycles with the DWT cycle counter. Compare two captures with
+ * tools/bench_compare.py to catch regressions.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __KERNEL_BENCH_H__
+#define __KERNEL_BENCH_H__
+
+#include <stdint.h>
+
+/** @brief Timed repetitions of each case. */
+#define KERNEL_BENCH_SAMPLES    256
+
+/** @brief Creates the bench and partner tasks. Returns 0 on success. */
+uint32_t KernelBenchInit(void);
+
+#endif /* __KERNEL_BENCH_H__ */
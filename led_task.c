@@ -1,6 +1,6 @@
 //*****************************************************************************
 //
-// led_task.c - A simple flashing LED task.
+// led_task.c - A simple flashing LED, run as a software-timer callback.
 //
 // Copyright (c) 2012-2016 Texas Instruments Incorporated.  All rights reserved.
 // Software License Agreement
@@ -36,17 +36,10 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "semphr.h"
+#include "timers.h"
 
 #include "all_buttons.h"
 
-//*****************************************************************************
-//
-// The stack size for the LED toggle task.
-//
-//*****************************************************************************
-#define LEDTASKSTACKSIZE        128         // Stack size in words
-
 //*****************************************************************************
 //
 // The item size and queue size for the LED message queue.
@@ -64,137 +57,117 @@
 
 //*****************************************************************************
 //
-// The queue that holds messages sent to the LED task.
+// The queue that holds messages sent to the LED timer.
 //
 //*****************************************************************************
 xQueueHandle g_pLEDQueue;
 
+//*****************************************************************************
+//
+// Statically allocated memory for the LED timer and its queue. The toggle
+// runs on the timer service task, so the LED needs no task or stack of its
+// own.
+//
+//*****************************************************************************
+static TimerHandle_t g_xLEDTimer;
+static StaticTimer_t g_xLEDTimerBuf;
+static StaticQueue_t g_xLEDQueueBuf;
+static uint8_t g_pui8LEDQueueStorage[LED_QUEUE_SIZE * LED_ITEM_SIZE];
+
 //
 // [G, R, B] range is 0 to 0xFFFF per color.
 //
 static uint32_t g_pui32Colors[3] = { 0x0000, 0x0000, 0x0000 };
 static uint8_t g_ui8ColorsIndx;
 
-extern xSemaphoreHandle g_pUARTSemaphore;
+//
+// Delay between toggles, and whether the LED is currently on.
+//
+static uint32_t g_ui32LEDToggleDelay = LED_TOGGLE_DELAY;
+static bool g_bLEDOn = false;
 
 
 //*****************************************************************************
 //
-// This task toggles the user selected LED at a user selected frequency. User
-// can make the selections by pressing the left and right buttons.
+// This timer callback toggles the user selected LED at a user selected
+// frequency. User can make the selections by pressing the left and right
+// buttons.
 //
 //*****************************************************************************
 static void
-LEDTask(void *pvParameters)
+LEDToggle(TimerHandle_t xTimer)
 {
-    portTickType ui32WakeTime;
-    uint32_t ui32LEDToggleDelay;
     uint8_t i8Message;
 
     //
-    // Initialize the LED Toggle Delay to default value.
-    //
-    ui32LEDToggleDelay = LED_TOGGLE_DELAY;
-
-    //
-    // Get the current tick count.
-    //
-    ui32WakeTime = xTaskGetTickCount();
-
+    // Read the next message, if available on queue.
     //
-    // Loop forever.
-    //
-    while(1)
+    if(xQueueReceive(g_pLEDQueue, &i8Message, 0) == pdPASS)
     {
         //
-        // Read the next message, if available on queue.
+        // If left button, update to next LED.
         //
-        if(xQueueReceive(g_pLEDQueue, &i8Message, 0) == pdPASS)
+        if(i8Message == LEFT_BUTTON)
         {
             //
-            // If left button, update to next LED.
+            // Update the LED buffer to turn off the currently working.
+            //
+            g_pui32Colors[g_ui8ColorsIndx] = 0x0000;
+
             //
-            if(i8Message == LEFT_BUTTON)
+            // Update the index to next LED
+            g_ui8ColorsIndx++;
+            if(g_ui8ColorsIndx > 2)
             {
-                //
-                // Update the LED buffer to turn off the currently working.
-                //
-                g_pui32Colors[g_ui8ColorsIndx] = 0x0000;
-
-                //
-                // Update the index to next LED
-                g_ui8ColorsIndx++;
-                if(g_ui8ColorsIndx > 2)
-                {
-                    g_ui8ColorsIndx = 0;
-                }
-
-                //
-                // Update the LED buffer to turn on the newly selected LED.
-                //
-                g_pui32Colors[g_ui8ColorsIndx] = 0x8000;
-
-                //
-                // Configure the new LED settings.
-                //
-                RGBColorSet(g_pui32Colors);
-
-                //
-                // Guard UART from concurrent access. Print the currently
-                // blinking LED.
-                //
-                xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-                //UARTprintf("Led %d is blinking. [R, G, B]\n", g_ui8ColorsIndx);
-                xSemaphoreGive(g_pUARTSemaphore);
+                g_ui8ColorsIndx = 0;
             }
 
             //
-            // If right button, update delay time between toggles of led.
+            // Update the LED buffer to turn on the newly selected LED.
             //
-            if(i8Message == RIGHT_BUTTON)
-            {
-                ui32LEDToggleDelay *= 2;
-                if(ui32LEDToggleDelay > 1000)
-                {
-                    ui32LEDToggleDelay = LED_TOGGLE_DELAY / 2;
-                }
-
-                //
-                // Guard UART from concurrent access. Print the currently
-                // blinking frequency.
-                //
-                xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-                //UARTprintf("Led blinking frequency is %d ms.\n",
-//                           (ui32LEDToggleDelay * 2));
-                xSemaphoreGive(g_pUARTSemaphore);
-            }
+            g_pui32Colors[g_ui8ColorsIndx] = 0x8000;
+
+            //
+            // Configure the new LED settings.
+            //
+            RGBColorSet(g_pui32Colors);
         }
 
         //
-        // Turn on the LED.
+        // If right button, update delay time between toggles of led. The
+        // new period takes effect from this toggle; a callback must not
+        // block, so the command is sent without waiting.
         //
-        RGBEnable();
+        if(i8Message == RIGHT_BUTTON)
+        {
+            g_ui32LEDToggleDelay *= 2;
+            if(g_ui32LEDToggleDelay > 1000)
+            {
+                g_ui32LEDToggleDelay = LED_TOGGLE_DELAY / 2;
+            }
 
-        //
-        // Wait for the required amount of time.
-        //
-        vTaskDelayUntil(&ui32WakeTime, ui32LEDToggleDelay / portTICK_RATE_MS);
+            xTimerChangePeriod(xTimer, g_ui32LEDToggleDelay / portTICK_RATE_MS,
+                               0);
+        }
+    }
 
-        //
-        // Turn off the LED.
-        //
+    //
+    // Toggle the LED.
+    //
+    g_bLEDOn = !g_bLEDOn;
+    if(g_bLEDOn)
+    {
+        RGBEnable();
+    }
+    else
+    {
         RGBDisable();
-
-        //
-        // Wait for the required amount of time.
-        //
-        vTaskDelayUntil(&ui32WakeTime, ui32LEDToggleDelay / portTICK_RATE_MS);
     }
 }
 
 //*****************************************************************************
 //
-// Initializes the LED task.
+// Initializes the LED and starts its toggle timer.
 //
 //*****************************************************************************
 uint32_t
@@ -220,15 +193,18 @@ LEDTaskInit(void)
     //UARTprintf("Led blinking frequency is %d ms.\n", (LED_TOGGLE_DELAY * 2));
 
     //
-    // Create a queue for sending messages to the LED task.
+    // Create a queue for sending messages to the LED timer.
     //
-    g_pLEDQueue = xQueueCreate(LED_QUEUE_SIZE, LED_ITEM_SIZE);
+    g_pLEDQueue = xQueueCreateStatic(LED_QUEUE_SIZE, LED_ITEM_SIZE,
+                                     g_pui8LEDQueueStorage, &g_xLEDQueueBuf);
 
     //
-    // Create the LED task.
+    // Create the toggle timer. The start command is queued until the
+    // scheduler starts the timer service task.
     //
-    if(xTaskCreate(LEDTask, (const portCHAR *)"LED", LEDTASKSTACKSIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_LED_TASK, NULL) != pdTRUE)
+    g_xLEDTimer = xTimerCreateStatic("LED", LED_TOGGLE_DELAY / portTICK_RATE_MS,
+                                     pdTRUE, NULL, LEDToggle, &g_xLEDTimerBuf);
+    if(g_xLEDTimer == NULL || xTimerStart(g_xLEDTimer, 0) != pdPASS)
     {
         return(1);
     }
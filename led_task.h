@@ -1,6 +1,6 @@
 //*****************************************************************************
 //
-// led_task.h - Prototypes for the LED task.
+// led_task.h - Prototypes for the LED toggle timer.
 //
 // Copyright (c) 2012-2016 Texas Instruments Incorporated.  All rights reserved.
 // Software License Agreement
@@ -27,7 +27,7 @@
 
 //*****************************************************************************
 //
-// Prototypes for the LED task.
+// Prototypes for the LED toggle timer.
 //
 //*****************************************************************************
 extern uint32_t LEDTaskInit(void);
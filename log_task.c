@@ -0,0 +1,247 @@
+//*****************************************************************************
+//
+// log_task.c - Deferred-format, lock-free log ring and its drain task.
+//
+// Producers reserve a slot with a compare-and-swap on the head index, fill
+// in the format ID, tick time and raw arguments, then publish the slot by
+// writing its sequence number last. The drain task consumes slots in order,
+// stopping at the first one that has been reserved but not yet published,
+// so a producer pre-empted mid-write never produces a torn record.
+//
+// Only LogTask (or LogFlush on a fatal path) calls UARTprintf, so the time
+// critical tasks never wait on the UART.
+//
+// Group 9
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "utils/uartstdio.h"
+#include "config.h"
+#include "priorities.h"
+#include "FreeRTOS.h"
+#include "atomic.h"
+#include "task.h"
+#include "semphr.h"
+#include "log_task.h"
+#include "telemetry.h"
+
+//CONSTANTS--------------------------------------------------------------------
+// The stack size for the log drain task.
+#define LOGTASKSTACKSIZE        128         // Stack size in words
+
+// Number of records in the ring. Must be a power of two.
+#define LOG_RING_SIZE           32
+#define LOG_RING_MASK           (LOG_RING_SIZE - 1)
+
+// How long the drain task sleeps when the ring is empty.
+#define LOGTASKDELAY            10
+
+//STATICS AND GLOBALS----------------------------------------------------------
+// UART Semaphore for protecting UART cardinality.
+extern xSemaphoreHandle g_pUARTSemaphore;
+
+//
+// A single log record. ui32Seq is written last and holds the head index the
+// slot was reserved with plus one, so zero always means "never written". The
+// ring is volatile so the compiler keeps that store after the payload.
+//
+typedef struct {
+    uint32_t ui32Seq;
+    uint32_t ui32Time;
+    uint32_t ui32Id;
+    uint32_t pui32Args[LOG_MAX_ARGS];
+} logRecord_t;
+
+static volatile logRecord_t g_psLogRing[LOG_RING_SIZE];
+static volatile uint32_t g_ui32LogHead = 0;     // Next slot to reserve
+static volatile uint32_t g_ui32LogTail = 0;     // Next slot to drain
+static volatile uint32_t g_ui32LogDropped = 0;  // Records lost to overflow
+static uint32_t g_ui32LogDroppedReported = 0;
+#if TELEMETRY_ENABLE
+static uint32_t g_ui32TelemetryDroppedReported = 0;
+#endif
+
+// Statically allocated TCB and stack for the drain task.
+static StaticTask_t g_xLogTaskTCB;
+static StackType_t g_pxLogTaskStack[LOGTASKSTACKSIZE];
+
+//
+// Format strings, indexed by logId_t. Each is passed all LOG_MAX_ARGS
+// arguments; UARTprintf ignores any the format does not consume.
+//
+static const char * const g_ppcLogFormats[LOG_NUM_IDS] = {
+    "%s Button is pressed.\n",                  // LOG_BUTTON_PRESSED
+    "Potentiometer changed, Value: '%d', Setpoint: %d.\n", // LOG_POT_CHANGED
+    "\n%s: Queue full. This should never happen.\n", // LOG_QUEUE_FULL
+    "Log overflow, %u records dropped.\n",      // LOG_DROPPED
+    "  %s: %u.%u%% cpu, %u switches\n",          // LOG_TASK_STATS
+    "CPU: idle %u.%u%%, %u switches/s over %u ms\n", // LOG_CPU_SUMMARY
+    "  %s: stack %u/%u words, recommend %u\n",  // LOG_STACK_REPORT
+    "  pool %u B: peak %u/%u blocks, %u failures\n", // LOG_POOL_STATS
+    "State %s %s.\n",                          // LOG_STATE_CHANGE
+    "Boot: %s at %u us.\n",                    // LOG_BOOT_MARK
+    "Altitude cal: %s.\n",                     // LOG_ALT_CAL
+    "Altitude cal: point %u of %u, drop %u.\n", // LOG_ALT_CAL_POINT
+    "Ground: ADC %u, variance %u, %s.\n",      // LOG_GROUND_CAL
+    "Plant ID: hover %u.%u%%, tail trim %u.%u%%.\n", // LOG_PLANT_ID_TRIM
+    "Plant ID: rotor lag %u ms, coupling %d%%, %u updates.\n", // LOG_PLANT_ID_LAG
+    "Plant ID %s: residual %u%%, trace %u.%03u.\n", // LOG_PLANT_ID_FIT
+    "Arm: %s.\n",                              // LOG_ARM
+    "%s queue full, target dropped.\n",       // LOG_TARGET_DROPPED
+    "Telemetry overflow, %u records dropped.\n", // LOG_TELEMETRY_DROPPED
+};
+
+//LOCAL FUNCTION PROTOTYPES ---------------------------------------------------
+static bool LogDrainOne(void);
+
+//FUNCTIONS--------------------------------------------------------------------
+//*****************************************************************************
+//
+// Reserves a slot, fills it and publishes it. Returns 0 if the ring was full.
+//
+//*****************************************************************************
+uint32_t
+LogWrite(logId_t eId, uint32_t ui32Arg0, uint32_t ui32Arg1, uint32_t ui32Arg2,
+         uint32_t ui32Arg3)
+{
+    uint32_t ui32Head;
+    volatile logRecord_t *psRecord;
+
+    // Claim the head slot, retrying if another producer got there first.
+    do {
+        ui32Head = g_ui32LogHead;
+        if ((ui32Head - g_ui32LogTail) >= LOG_RING_SIZE) {
+            Atomic_Increment_u32(&g_ui32LogDropped);
+            return 0;
+        }
+    } while (Atomic_CompareAndSwap_u32(&g_ui32LogHead, ui32Head + 1, ui32Head)
+             != ATOMIC_COMPARE_AND_SWAP_SUCCESS);
+
+    psRecord = &g_psLogRing[ui32Head & LOG_RING_MASK];
+    psRecord->ui32Time = xTaskGetTickCount();
+    psRecord->ui32Id = eId;
+    psRecord->pui32Args[0] = ui32Arg0;
+    psRecord->pui32Args[1] = ui32Arg1;
+    psRecord->pui32Args[2] = ui32Arg2;
+    psRecord->pui32Args[3] = ui32Arg3;
+
+    // Publish.
+    psRecord->ui32Seq = ui32Head + 1;
+
+    return 1;
+}
+
+//*****************************************************************************
+//
+// Formats and prints the record at the tail, if it has been published.
+// Returns true if a record was consumed.
+//
+//*****************************************************************************
+static bool
+LogDrainOne(void)
+{
+    uint32_t ui32Tail = g_ui32LogTail;
+    volatile logRecord_t *psRecord = &g_psLogRing[ui32Tail & LOG_RING_MASK];
+
+    if (ui32Tail == g_ui32LogHead || psRecord->ui32Seq != ui32Tail + 1) {
+        return false;
+    }
+
+    if (psRecord->ui32Id < LOG_NUM_IDS) {
+        UARTprintf("[%u] ", psRecord->ui32Time);
+        UARTprintf(g_ppcLogFormats[psRecord->ui32Id], psRecord->pui32Args[0],
+                   psRecord->pui32Args[1], psRecord->pui32Args[2],
+                   psRecord->pui32Args[3]);
+    }
+
+    // Only now hand the slot back to the producers.
+    g_ui32LogTail = ui32Tail + 1;
+
+    return true;
+}
+
+//*****************************************************************************
+//
+// Drains the ring in the caller's context. Used on fatal paths where the
+// caller is about to spin and LogTask would never run again.
+//
+//*****************************************************************************
+void
+LogFlush(void)
+{
+    while (LogDrainOne())
+    {
+    }
+}
+
+//*****************************************************************************
+//
+// Returns the total number of records dropped because the ring was full.
+//
+//*****************************************************************************
+uint32_t
+LogDroppedCount(void)
+{
+    return g_ui32LogDropped;
+}
+
+//*****************************************************************************
+//
+// Low-priority task that formats the queued records and sends them to UART.
+//
+//*****************************************************************************
+static void
+LogTask(void *pvParameters)
+{
+    uint32_t ui32Dropped;
+
+    while(1)
+    {
+        // Text lines and binary telemetry frames are each sent whole.
+        xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+        LogFlush();
+        TelemetryFlush();
+        xSemaphoreGive(g_pUARTSemaphore);
+
+        // Report any loss as a record of its own so it lands in order.
+        ui32Dropped = g_ui32LogDropped;
+        if (ui32Dropped != g_ui32LogDroppedReported &&
+            LOG1(LOG_DROPPED, ui32Dropped - g_ui32LogDroppedReported))
+        {
+            g_ui32LogDroppedReported = ui32Dropped;
+        }
+#if TELEMETRY_ENABLE
+        ui32Dropped = g_ui32TelemetryDropped;
+        if (ui32Dropped != g_ui32TelemetryDroppedReported &&
+            LOG1(LOG_TELEMETRY_DROPPED,
+                 ui32Dropped - g_ui32TelemetryDroppedReported))
+        {
+            g_ui32TelemetryDroppedReported = ui32Dropped;
+        }
+#endif
+
+        vTaskDelay(LOGTASKDELAY / portTICK_RATE_MS);
+    }
+}
+
+//*****************************************************************************
+//
+// Initializes the log drain task.
+//
+//*****************************************************************************
+uint32_t
+LogTaskInit(void)
+{
+    // Create the log task.
+    if(xTaskCreateStatic(LogTask, (const portCHAR *)"Log", LOGTASKSTACKSIZE,
+                         NULL, tskIDLE_PRIORITY + PRIORITY_LOG_TASK,
+                         g_pxLogTaskStack, &g_xLogTaskTCB) == NULL)
+    {
+        return(1);
+    }
+
+    // Success.
+    return(0);
+}
@@ -0,0 +1,93 @@
+//*****************************************************************************
+//
+// log_task.h - Deferred-format logging API and the low-priority drain task.
+//
+// Tasks and ISRs record a format ID plus up to LOG_MAX_ARGS raw 32-bit
+// arguments into a lock-free ring. Formatting and UART transmission happen
+// later in LogTask, so logging costs a handful of cycles in the caller.
+//
+// Group 9
+//
+//*****************************************************************************
+
+#ifndef __LOG_TASK_H__
+#define __LOG_TASK_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Number of raw arguments stored with each record.
+//
+//*****************************************************************************
+#define LOG_MAX_ARGS 4
+
+//*****************************************************************************
+//
+// Format IDs. The order must match g_ppcLogFormats[] in log_task.c.
+//
+//*****************************************************************************
+typedef enum {
+    LOG_BUTTON_PRESSED = 0,     // arg0: (const char *) button name
+    LOG_POT_CHANGED,            // arg0: potentiometer value, arg1: setpoint
+    LOG_QUEUE_FULL,             // arg0: (const char *) task name
+    LOG_DROPPED,                // arg0: records dropped since last report
+    LOG_TASK_STATS,             // arg0: name, arg1: cpu %, arg2: 0.1 %s,
+                                // arg3: context switches in the period
+    LOG_CPU_SUMMARY,            // arg0: idle %, arg1: 0.1 %s,
+                                // arg2: switches/s, arg3: period in ms
+    LOG_STACK_REPORT,           // arg0: name, arg1: words used,
+                                // arg2: words allocated, arg3: recommended
+    LOG_POOL_STATS,             // arg0: block size, arg1: peak blocks used,
+                                // arg2: blocks in pool, arg3: failures
+    LOG_STATE_CHANGE,           // arg0: (const char *) state name,
+                                // arg1: (const char *) "set" or "cleared"
+    LOG_BOOT_MARK,              // arg0: (const char *) milestone name,
+                                // arg1: microseconds since the clock was set
+    LOG_ALT_CAL,                // arg0: (const char *) message
+    LOG_ALT_CAL_POINT,          // arg0: point, arg1: points in the sweep,
+                                // arg2: ADC drop from the ground point
+    LOG_GROUND_CAL,             // arg0: ground ADC, arg1: variance,
+                                // arg2: (const char *) outcome
+    LOG_PLANT_ID_TRIM,          // arg0: hover duty %, arg1: tenths,
+                                // arg2: tail trim %, arg3: tenths
+    LOG_PLANT_ID_LAG,           // arg0: rotor lag ms, arg1: coupling %,
+                                // arg2: height updates
+    LOG_PLANT_ID_FIT,           // arg0: (const char *) axis, arg1: residual %,
+                                // arg2: covariance trace, arg3: thousandths
+    LOG_ARM,                    // arg0: (const char *) outcome
+    LOG_TARGET_DROPPED,         // arg0: (const char *) queue name
+    LOG_TELEMETRY_DROPPED,      // arg0: records dropped since last report
+    LOG_NUM_IDS
+} logId_t;
+
+//*****************************************************************************
+//
+// Prototypes for the log API and task.
+//
+//*****************************************************************************
+extern uint32_t LogTaskInit(void);
+
+// Records a log entry. Safe to call from tasks and from ISRs running at or
+// below configMAX_SYSCALL_INTERRUPT_PRIORITY. Returns 0 if the ring was full
+// and the record was dropped.
+extern uint32_t LogWrite(logId_t eId, uint32_t ui32Arg0, uint32_t ui32Arg1,
+                         uint32_t ui32Arg2, uint32_t ui32Arg3);
+
+// Formats and transmits every committed record in the caller's context.
+// Intended for fatal error paths that are about to spin forever.
+extern void LogFlush(void);
+
+// Total number of records dropped because the ring was full.
+extern uint32_t LogDroppedCount(void);
+
+#define LOG0(id)            LogWrite((id), 0, 0, 0, 0)
+#define LOG1(id, a)         LogWrite((id), (uint32_t)(a), 0, 0, 0)
+#define LOG2(id, a, b)      LogWrite((id), (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define LOG3(id, a, b, c)   LogWrite((id), (uint32_t)(a), (uint32_t)(b), \
+                                     (uint32_t)(c), 0)
+#define LOG4(id, a, b, c, d) \
+                            LogWrite((id), (uint32_t)(a), (uint32_t)(b), \
+                                     (uint32_t)(c), (uint32_t)(d))
+
+#endif // __LOG_TASK_H__
@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * lqr_gains.c
+ *
+ * Purpose:
+ * LQR gain table for CONTROL_MODE_LQR, one row per operating point. See
+ * lqr_gains.h.
+ *
+ * Generated by tools/lqr_gains.py from the model and weights there. Edit
+ * those and regenerate rather than editing this file.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // CONTROL_PERIOD_MS
+#include "lqr_gains.h"       // LQR gain table
+#include "dsp_filter.h"      // DSP_MAT_PAIR
+
+#if CONTROL_PERIOD_MS != 2
+#error "lqr_gains.c was generated for another CONTROL_PERIOD_MS"
+#endif
+
+#if LQR_OPERATING_POINTS != 2
+#error "LQR_OPERATING_POINTS in lqr_gains.h does not match this table"
+#endif
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+const lqrGain_t g_psLqrGains[LQR_OPERATING_POINTS] =
+{
+    {
+        0, 80,
+        { 192512, 155648 },
+        { 12, 12 },
+        {
+            DSP_MAT_PAIR(4895, 872), DSP_MAT_PAIR(17470, 1530),
+            DSP_MAT_PAIR(276, 754), DSP_MAT_PAIR(372, -74),   // main
+            DSP_MAT_PAIR(1568, 294), DSP_MAT_PAIR(-28469, -3136),
+            DSP_MAT_PAIR(82, -1158), DSP_MAT_PAIR(-33, 217)   // tail
+        }
+    },
+    {
+        250, 80,
+        { 385024, 155648 },
+        { 13, 12 },
+        {
+            DSP_MAT_PAIR(11549, 1636), DSP_MAT_PAIR(16859, 1476),
+            DSP_MAT_PAIR(386, 728), DSP_MAT_PAIR(665, -71),   // main
+            DSP_MAT_PAIR(1855, 310), DSP_MAT_PAIR(-29712, -3266),
+            DSP_MAT_PAIR(59, -1211), DSP_MAT_PAIR(-36, 225)   // tail
+        }
+    }
+};
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * lqr_gains.h
+ *
+ * Purpose:
+ * LQR state-feedback gains for CONTROL_MODE_LQR, scheduled on the target
+ * height.
+ *
+ * Each row of g_psLqrGains is the gain for the rig linearised about hover
+ * at one operating point, and is used from its height up to the next row's.
+ * Both duties are computed from the whole state, so the main rotor's torque
+ * on the yaw axis is cancelled by the tail as it happens instead of being
+ * corrected after it has turned the helicopter. The state, as int16 in the
+ * units given, is
+ *
+ *   LQR_HEIGHT      height - target, ADC counts
+ *   LQR_SPEED       vertical speed, counts/s
+ *   LQR_YAW         yaw - target, degrees, the short way round
+ *   LQR_YAW_RATE    deg/s
+ *   LQR_HEIGHT_INT  integral of the height error, count.s in Q4
+ *   LQR_YAW_INT     integral of the yaw error, deg.s in Q4
+ *   LQR_MAIN_LAG    modelled main rotor response - trim, % duty in Q4
+ *   LQR_TAIL_LAG    modelled tail rotor response - trim, % duty in Q4
+ *
+ * and each duty is (trim - gains . state) >> shift. The table is
+ * generated by tools/lqr_gains.py, which picks each shift so the sum cannot
+ * overflow for any state within its clamp.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __LQR_GAINS_H__
+#define __LQR_GAINS_H__
+
+#include <stdint.h>
+
+/** @brief Length of the state vector, see above. */
+#define LQR_STATES              8
+
+/** @brief Rows in the gain table. */
+#define LQR_OPERATING_POINTS    2
+
+/** @brief Fraction bits of the integral and rotor lag states. */
+#define LQR_STATE_Q             4
+
+/** @brief State vector indices. */
+enum
+{
+    LQR_HEIGHT,
+    LQR_SPEED,
+    LQR_YAW,
+    LQR_YAW_RATE,
+    LQR_HEIGHT_INT,
+    LQR_YAW_INT,
+    LQR_MAIN_LAG,
+    LQR_TAIL_LAG
+};
+
+/** @brief Duty indices: rows of the gain matrix. */
+#define LQR_MAIN                0
+#define LQR_TAIL                1
+#define LQR_DUTIES              2
+
+/** @brief One operating point. */
+typedef struct {
+    uint32_t ui32Height;        // Lowest target height the row is used for
+    uint32_t ui32MotorTauMs;    // Rotor time constant for the lag states
+    int32_t pi32Trim[LQR_DUTIES];       // Duty at the point, Q pui32Shift
+    uint32_t pui32Shift[LQR_DUTIES];
+    uint32_t pui32Gains[LQR_DUTIES * LQR_STATES / 2];   // DSP_MAT_PAIR pairs
+} lqrGain_t;
+
+/** @brief The gain table, in increasing ui32Height from 0. */
+extern const lqrGain_t g_psLqrGains[LQR_OPERATING_POINTS];
+
+#endif /* __LQR_GAINS_H__ */
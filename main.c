@@ -25,10 +25,20 @@
 #include "all_buttons.h"
 #include "yaw_task.h"
 #include "control_task.h"
+#include "log_task.h"
+#include "telemetry.h"
+#include "runtime_stats.h"
+#include "trace_recorder.h"
+#include "mem_pool.h"
+#include "kernel_bench.h"
+#include "system_state.h"
+#include "boot_trace.h"
+#include "altitude_cal.h"
 
 //*****************************************************************************
 //
-// The mutex that protects concurrent access of UART from multiple tasks.
+// The mutex that protects concurrent access of UART from multiple tasks
+// (in practice the log drain task and fatal-path LogFlush calls).
 // Also semaphores used to protect the queues from overflowing between
 // the control task (control_task) and the ADC task (height_task).
 //
@@ -40,6 +50,27 @@ xSemaphoreHandle g_ADCSemaphore;
 QueueHandle_t Q_tailDuty;
 QueueHandle_t Q_mainDuty;
 
+//*****************************************************************************
+//
+// Statically allocated memory for the objects above and for the kernel's own
+// idle and timer service tasks. Nothing is allocated at run time
+// (configSUPPORT_DYNAMIC_ALLOCATION is 0 and no heap is linked).
+//
+//*****************************************************************************
+static StaticSemaphore_t g_xUARTSemaphoreBuf;
+static StaticSemaphore_t g_xControlSemaphoreBuf;
+static StaticSemaphore_t g_xADCSemaphoreBuf;
+
+static StaticQueue_t g_xTailDutyQueueBuf;
+static StaticQueue_t g_xMainDutyQueueBuf;
+static uint8_t g_pui8TailDutyStorage[sizeof(uint32_t)];
+static uint8_t g_pui8MainDutyStorage[sizeof(uint32_t)];
+
+static StaticTask_t g_xIdleTaskTCB;
+static StackType_t g_pxIdleTaskStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t g_xTimerTaskTCB;
+static StackType_t g_pxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
 
 //*****************************************************************************
 //
@@ -54,19 +85,61 @@ __error__(char *pcFilename, uint32_t ui32Line)
 
 #endif
 
+//*****************************************************************************
+//
+// These hooks supply the memory for the idle and timer service tasks, which
+// the kernel creates itself when configSUPPORT_STATIC_ALLOCATION is 1.
+//
+//*****************************************************************************
+void
+vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                              StackType_t **ppxIdleTaskStackBuffer,
+                              uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &g_xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = g_pxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void
+vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                               StackType_t **ppxTimerTaskStackBuffer,
+                               uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &g_xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = g_pxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
 //*****************************************************************************
 //
 // This hook is called by FreeRTOS when an stack overflow error is detected.
 //
 //*****************************************************************************
 void
-vApplicationStackOverflowHook(xTaskHandle *pxTask, char *pcTaskName)
+vApplicationStackOverflowHook(xTaskHandle xTask, char *pcTaskName)
 {
     //
     // This function can not return, so loop forever.  Interrupts are disabled
     // on entry to this function, so no processor interrupts will interrupt
-    // this loop.
+    // this loop. The overflowed stack may have corrupted anything, so only
+    // the rotors are stopped, the trace frozen for a dump, and the task named
+    // a character at a time straight to UART0, before spinning.
     //
+    const char *pcMessage = ": stack overflow\n";
+
+    (void)xTask;
+    PWMMotorsOff();
+    TraceStop();
+    UARTCharPut(UART0_BASE, '\n');
+    while(*pcTaskName)
+    {
+        UARTCharPut(UART0_BASE, *pcTaskName++);
+    }
+    while(*pcMessage)
+    {
+        UARTCharPut(UART0_BASE, *pcMessage++);
+    }
     while(1)
     {
     }
@@ -87,9 +160,23 @@ main(void)
     SysCtlClockSet(SYSCTL_SYSDIV_4 | SYSCTL_USE_PLL | SYSCTL_XTAL_16MHZ |
                        SYSCTL_OSC_MAIN);
 
+    // Time the start-up from here to the first control cycle.
+    BootTraceStart();
+
     // Initialize the UART and configure it for 115,200, 8-N-1 operation.
     ConfigureUART();
 
+#if KERNEL_BENCH_ENABLE
+    // Benchmark build: run only the kernel benchmark, not the helicopter.
+    if(KernelBenchInit() != 0)
+    {
+        while(1)
+        {
+        }
+    }
+    vTaskStartScheduler();
+#endif
+
     initADC();
     initialiseYaw();
     initYawRef();
@@ -97,34 +184,62 @@ main(void)
     initTailMotorPWM();
 
     // Create a mutex to guard the UART.
-    g_pUARTSemaphore = xSemaphoreCreateMutex();
+    g_pUARTSemaphore = xSemaphoreCreateMutexStatic(&g_xUARTSemaphoreBuf);
 
-    // Initialise queues for tail and main motor PWM signals
-    Q_tailDuty = xQueueCreate(1,sizeof(uint32_t));
-    Q_mainDuty = xQueueCreate(1,sizeof(uint32_t));
+    // Build the block pool free lists before any task can allocate.
+    MemPoolInit();
 
-    g_ControlSemaphore = xSemaphoreCreateBinary();
-    g_ADCSemaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(g_ADCSemaphore);
-    int test = uxSemaphoreGetCount(g_ControlSemaphore);
-    
+    // Create the shared system state before any task can set or wait on it.
+    if(SystemStateInit() != 0)
+    {
 
-    // Create the button control task
-     if(SwitchTaskInit() != 0)
-     {
+        while(1)
+        {
+        }
+    }
 
-         while(1)
-         {
-         }
-     }
+    // Load the altitude linearisation table before anything converts heights.
+    if(AltitudeCalInit() != 0)
+    {
 
+        while(1)
+        {
+        }
+    }
 
-    // Create the display task
-    if (init_display() != 0){
+#if TELEMETRY_ENABLE
+    // Create the telemetry frame queue drained by the log task.
+    if(TelemetryInit() != 0)
+    {
 
-        while(1){}
+        while(1)
+        {
+        }
+    }
+#endif
+
+    // Create the log drain task. It is the only task that writes to the UART.
+    if(LogTaskInit() != 0)
+    {
+
+        while(1)
+        {
+        }
     }
 
+    // Initialise queues for tail and main motor PWM signals. They stay one
+    // deep: the control task overwrites the duty rather than waiting.
+    Q_tailDuty = xQueueCreateStatic(1, sizeof(uint32_t), g_pui8TailDutyStorage,
+                                    &g_xTailDutyQueueBuf);
+    Q_mainDuty = xQueueCreateStatic(1, sizeof(uint32_t), g_pui8MainDutyStorage,
+                                    &g_xMainDutyQueueBuf);
+
+    g_ControlSemaphore = xSemaphoreCreateBinaryStatic(&g_xControlSemaphoreBuf);
+    g_ADCSemaphore = xSemaphoreCreateBinaryStatic(&g_xADCSemaphoreBuf);
+    xSemaphoreGive(g_ADCSemaphore);
+    int test = uxSemaphoreGetCount(g_ControlSemaphore);
+    
+
     // Create the control task
     if (init_control() != 0){
 
@@ -161,7 +276,48 @@ main(void)
     }
 
 
+    BootTraceMark(BOOT_MARK_CRITICAL_READY);
+
+    // The user interface comes up after everything the control loop needs.
+    // The display task initialises the OLED itself once the scheduler is
+    // running, at a priority below every control task.
+    if (init_display() != 0){
+
+        while(1){}
+    }
+
+    // Start the button polling timer
+    if(SwitchTaskInit() != 0)
+    {
+
+        while(1)
+        {
+        }
+    }
+
+
+    // Start the potentiometer setpoint timer
+    if(PotentiometerTaskInit() != 0)
+    {
+
+        while(1)
+        {
+        }
+    }
+
+
+    // Create the CPU usage reporter
+    if(RunTimeStatsTaskInit() != 0)
+    {
+
+        while(1)
+        {
+        }
+    }
+
+
     // Start the scheduler.  This should not return.
+    BootTraceMark(BOOT_MARK_SCHEDULER_START);
     vTaskStartScheduler();
 
     // In case the scheduler returns for some reason, print an error and loop
@@ -177,5 +333,6 @@ main(void)
 void vAssertCalled( const char * pcFile, unsigned long ulLine ) {
     (void)pcFile; // unused
     (void)ulLine; // unused
+    PWMMotorsOff();
     while (1);
 }
@@ -0,0 +1,236 @@
+/******************************************************************************
+ *
+ * mem_pool.c
+ *
+ * Purpose:
+ * Fixed-size block pools with O(1) allocate and free. See mem_pool.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "mem_pool.h"        // Block pools
+#include "log_task.h"        // Deferred log
+
+// CONSTANTS-------------------------------------------------------------------
+
+/** @brief Block sizes (bytes, multiples of 8) and counts per class. */
+#define MEM_POOL_16_COUNT       16
+#define MEM_POOL_32_COUNT       8
+#define MEM_POOL_64_COUNT       8
+#define MEM_POOL_128_COUNT      4
+
+// TYPES-----------------------------------------------------------------------
+
+/** @brief A free block holds the link to the next free block. */
+typedef struct memPoolBlock {
+    struct memPoolBlock *psNext;
+} memPoolBlock_t;
+
+typedef struct {
+    uint8_t *pui8Base;
+    uint32_t ui32BlockSize;
+    uint32_t ui32BlockCount;
+    memPoolBlock_t *psFree;
+    uint32_t ui32Used;
+    uint32_t ui32HighWater;
+    uint32_t ui32Failures;
+    uint32_t ui32Reported;      // High water + failures at the last report
+} memPool_t;
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+// Backing storage, uint64_t so every block is 8-byte aligned.
+static uint64_t g_pui64Pool16[MEM_POOL_16_COUNT * 16 / 8];
+static uint64_t g_pui64Pool32[MEM_POOL_32_COUNT * 32 / 8];
+static uint64_t g_pui64Pool64[MEM_POOL_64_COUNT * 64 / 8];
+static uint64_t g_pui64Pool128[MEM_POOL_128_COUNT * 128 / 8];
+
+/** @brief Size classes, smallest first. */
+static memPool_t g_psMemPools[MEM_POOL_NUM_CLASSES] = {
+    { (uint8_t *)g_pui64Pool16, 16, MEM_POOL_16_COUNT },
+    { (uint8_t *)g_pui64Pool32, 32, MEM_POOL_32_COUNT },
+    { (uint8_t *)g_pui64Pool64, 64, MEM_POOL_64_COUNT },
+    { (uint8_t *)g_pui64Pool128, 128, MEM_POOL_128_COUNT },
+};
+
+static uint32_t g_ui32OversizeFailures = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+MemPoolInit(void)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        memPool_t *psPool = &g_psMemPools[i];
+
+        // Link the blocks in address order so early allocations are adjacent.
+        psPool->psFree = NULL;
+        for (j = psPool->ui32BlockCount; j > 0; j--)
+        {
+            memPoolBlock_t *psBlock = (memPoolBlock_t *)
+                (psPool->pui8Base + (j - 1) * psPool->ui32BlockSize);
+
+            psBlock->psNext = psPool->psFree;
+            psPool->psFree = psBlock;
+        }
+        psPool->ui32Used = 0;
+    }
+}
+
+
+void *
+MemPoolAlloc(size_t ui32Size)
+{
+    UBaseType_t uxSaved;
+    memPool_t *psPool;
+    memPoolBlock_t *psBlock;
+    uint32_t i;
+
+    // Smallest class that fits; the loop bound is the constant class count.
+    for (i = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        if (ui32Size <= g_psMemPools[i].ui32BlockSize)
+        {
+            break;
+        }
+    }
+
+    if (i == MEM_POOL_NUM_CLASSES)
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+        void *pvBlock = pvPortMalloc(ui32Size);
+
+        if (pvBlock != NULL)
+        {
+            return pvBlock;
+        }
+#endif
+        uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+        g_ui32OversizeFailures++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+        return NULL;
+    }
+
+    psPool = &g_psMemPools[i];
+
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    psBlock = psPool->psFree;
+    if (psBlock != NULL)
+    {
+        psPool->psFree = psBlock->psNext;
+        psPool->ui32Used++;
+        if (psPool->ui32Used > psPool->ui32HighWater)
+        {
+            psPool->ui32HighWater = psPool->ui32Used;
+        }
+    }
+    else
+    {
+        // No spilling into a larger class: that would hide an undersized
+        // pool and make the worst case depend on the other classes.
+        psPool->ui32Failures++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+
+    return psBlock;
+}
+
+
+void
+MemPoolFree(void *pvBlock)
+{
+    UBaseType_t uxSaved;
+    uint8_t *pui8Block = pvBlock;
+    uint32_t i;
+
+    if (pvBlock == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        memPool_t *psPool = &g_psMemPools[i];
+
+        if (pui8Block >= psPool->pui8Base &&
+            pui8Block < psPool->pui8Base +
+                        psPool->ui32BlockSize * psPool->ui32BlockCount)
+        {
+            memPoolBlock_t *psBlock = pvBlock;
+
+            configASSERT(((pui8Block - psPool->pui8Base) %
+                          psPool->ui32BlockSize) == 0);
+
+            uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+            psBlock->psNext = psPool->psFree;
+            psPool->psFree = psBlock;
+            psPool->ui32Used--;
+            portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+            return;
+        }
+    }
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+    vPortFree(pvBlock);
+#else
+    // Not from any pool, and there is no heap it could have come from.
+    configASSERT(0);
+#endif
+}
+
+
+bool
+MemPoolGetStats(uint32_t ui32Class, memPoolStats_t *psStats)
+{
+    memPool_t *psPool;
+
+    if (ui32Class >= MEM_POOL_NUM_CLASSES)
+    {
+        return false;
+    }
+
+    psPool = &g_psMemPools[ui32Class];
+    psStats->ui32BlockSize = psPool->ui32BlockSize;
+    psStats->ui32BlockCount = psPool->ui32BlockCount;
+    psStats->ui32Used = psPool->ui32Used;
+    psStats->ui32HighWater = psPool->ui32HighWater;
+    psStats->ui32Failures = psPool->ui32Failures;
+
+    return true;
+}
+
+
+uint32_t
+MemPoolOversizeFailures(void)
+{
+    return g_ui32OversizeFailures;
+}
+
+
+void
+MemPoolReport(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        memPool_t *psPool = &g_psMemPools[i];
+        uint32_t ui32Mark = psPool->ui32HighWater + psPool->ui32Failures;
+
+        if (ui32Mark != psPool->ui32Reported)
+        {
+            psPool->ui32Reported = ui32Mark;
+            LOG4(LOG_POOL_STATS, psPool->ui32BlockSize, psPool->ui32HighWater,
+                 psPool->ui32BlockCount, psPool->ui32Failures);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ * mem_pool.h
+ *
+ * Purpose:
+ * Deterministic fixed-size block pools in a few size classes.
+ *
+ * Each class is a static array of equal blocks threaded onto a singly linked
+ * free list, so allocation pops the head and freeing pushes it back: O(1),
+ * no searching, no coalescing and no fragmentation. A request is served by
+ * the smallest class that fits. Larger requests fall back to pvPortMalloc()
+ * only when configSUPPORT_DYNAMIC_ALLOCATION is set; the current build has
+ * no heap, so they fail and are counted instead.
+ *
+ * Safe to call from tasks and from ISRs at or below
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __MEM_POOL_H__
+#define __MEM_POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/** @brief Number of size classes, see g_psMemPools in mem_pool.c. */
+#define MEM_POOL_NUM_CLASSES    4
+
+/** @brief Usage figures for one size class. */
+typedef struct {
+    uint32_t ui32BlockSize;     // Bytes per block
+    uint32_t ui32BlockCount;    // Blocks in the class
+    uint32_t ui32Used;          // Blocks currently allocated
+    uint32_t ui32HighWater;     // Most blocks ever allocated at once
+    uint32_t ui32Failures;      // Requests for this class that found it empty
+} memPoolStats_t;
+
+/** @brief Threads every block onto its free list. Call once before use. */
+void MemPoolInit(void);
+
+/** @brief Returns a block of at least ui32Size bytes, or NULL. */
+void *MemPoolAlloc(size_t ui32Size);
+
+/** @brief Returns a block to its pool. NULL is ignored. */
+void MemPoolFree(void *pvBlock);
+
+/** @brief Copies the statistics for a class. Returns false if out of range. */
+bool MemPoolGetStats(uint32_t ui32Class, memPoolStats_t *psStats);
+
+/** @brief Requests too large for any class (and not served by a heap). */
+uint32_t MemPoolOversizeFailures(void);
+
+/**
+ * @brief Logs each class whose high-water mark or failure count changed since
+ * the last call. Called periodically by the stats task.
+ */
+void MemPoolReport(void);
+
+#endif /* __MEM_POOL_H__ */
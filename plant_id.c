@@ -0,0 +1,498 @@
+/******************************************************************************
+ *
+ * plant_id.c
+ *
+ * Purpose:
+ * Recursive least-squares identification of the rig. See plant_id.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include <math.h>
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "task.h"            // Critical sections
+#include "plant_id.h"        // Plant identification
+#include "log_task.h"        // Deferred log
+
+// CONSTANTS-------------------------------------------------------------------
+
+#if PLANT_ID_INPUT_DELAY < 1
+#error "PLANT_ID_INPUT_DELAY must be at least one cycle"
+#endif
+
+/** @brief Parameters fitted per axis. */
+#define PLANT_ID_HEIGHT_PARAMS  4
+#define PLANT_ID_YAW_PARAMS     5
+
+/**
+ * @brief Regressor scaling, so every term is of order one and the float
+ * covariance stays well conditioned: rates are in hundreds of counts (or
+ * degrees) per second, duties in tens of % about the control task's feed
+ * forwards.
+ */
+#define PLANT_ID_RATE_SCALE     0.01f
+#define PLANT_ID_DUTY_SCALE     0.1f
+#define PLANT_ID_MAIN_CENTRE    50
+#define PLANT_ID_TAIL_CENTRE    40
+
+/** @brief Weight of each new squared error in the residual averages. */
+#define PLANT_ID_RESIDUAL_ALPHA 0.005f
+
+/** @brief Filter slots: the measurements, then the duties. */
+#define PLANT_ID_FILTERS        4
+#define PLANT_ID_FILTER_MAIN    2
+#define PLANT_ID_FILTER_TAIL    3
+
+// TYPES-----------------------------------------------------------------------
+
+/** @brief One axis's least-squares fit. */
+typedef struct {
+    uint32_t ui32Params;
+    float pfTheta[PLANT_ID_MAX_PARAMS];
+    float ppfP[PLANT_ID_MAX_PARAMS][PLANT_ID_MAX_PARAMS];
+    float fErrorSq;             // Running means of the squared prediction
+    float fOutputSq;            // error and of the squared output
+    uint32_t ui32Updates;
+} plantIdRls_t;
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static plantIdRls_t g_psPlantIdRls[PLANT_ID_AXES] = {
+    { PLANT_ID_HEIGHT_PARAMS },
+    { PLANT_ID_YAW_PARAMS },
+};
+
+/** @brief The three poles of each filter, in PLANT_ID_FILTERS order. */
+static float g_ppfPlantIdFilter[PLANT_ID_FILTERS][3];
+
+/** @brief Duties sent, waiting out PLANT_ID_INPUT_DELAY. */
+static int32_t g_pi32PlantIdMain[PLANT_ID_INPUT_DELAY];
+static int32_t g_pi32PlantIdTail[PLANT_ID_INPUT_DELAY];
+static uint32_t g_ui32PlantIdDelayIndex = 0;
+
+/** @brief Yaw unwrapped into -180..180, the filter following its shifts. */
+static float g_fPlantIdYaw;
+static int32_t g_i32PlantIdLastYaw;
+
+static uint32_t g_ui32PlantIdSettle = 0;
+static uint32_t g_ui32PlantIdCycle = 0;
+static bool g_bPlantIdStarted = false;
+
+// LOCAL FUNCTION PROTOTYPES---------------------------------------------------
+
+static void PlantIdRlsReset(plantIdRls_t *psRls);
+static void PlantIdRlsUpdate(plantIdRls_t *psRls, const float *pfPhi,
+                             float fOutput);
+static void PlantIdFilterPrime(float *pfFilter, float fInput);
+static void PlantIdFilterStep(float *pfFilter, float fInput, float fGain);
+static void PlantIdFilterDerivatives(const float *pfFilter, float fInput,
+                                     float *pfOut);
+static void PlantIdPrime(int32_t i32Height, int32_t i32Yaw,
+                         int32_t i32MainDuty, int32_t i32TailDuty);
+static uint32_t PlantIdTenths(float fDuty);
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Starts a fit from no knowledge: zero parameters, large covariance.
+ */
+static void
+PlantIdRlsReset(plantIdRls_t *psRls)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < PLANT_ID_MAX_PARAMS; i++)
+    {
+        psRls->pfTheta[i] = 0.0f;
+        for (j = 0; j < PLANT_ID_MAX_PARAMS; j++)
+        {
+            psRls->ppfP[i][j] = (i == j) ? PLANT_ID_INITIAL_P : 0.0f;
+        }
+    }
+    psRls->fErrorSq = 0.0f;
+    psRls->fOutputSq = 0.0f;
+    psRls->ui32Updates = 0;
+}
+
+
+/**
+ * @brief One least-squares step with forgetting. Only the upper triangle of
+ * P is computed and mirrored, so rounding cannot make it unsymmetric.
+ */
+static void
+PlantIdRlsUpdate(plantIdRls_t *psRls, const float *pfPhi, float fOutput)
+{
+    uint32_t ui32N = psRls->ui32Params;
+    float pfPPhi[PLANT_ID_MAX_PARAMS];
+    float pfGain[PLANT_ID_MAX_PARAMS];
+    float fDenom = PLANT_ID_FORGETTING;
+    float fError = fOutput;
+    float fTrace = 0.0f;
+    float fScale;
+    uint32_t i, j;
+
+    for (i = 0; i < ui32N; i++)
+    {
+        pfPPhi[i] = 0.0f;
+        for (j = 0; j < ui32N; j++)
+        {
+            pfPPhi[i] += psRls->ppfP[i][j] * pfPhi[j];
+        }
+        fDenom += pfPhi[i] * pfPPhi[i];
+        fError -= psRls->pfTheta[i] * pfPhi[i];
+    }
+
+    for (i = 0; i < ui32N; i++)
+    {
+        pfGain[i] = pfPPhi[i] / fDenom;
+        psRls->pfTheta[i] += pfGain[i] * fError;
+        fTrace += psRls->ppfP[i][i] - pfGain[i] * pfPPhi[i];
+    }
+
+    // Forget only while there is room: with nothing new in the data P would
+    // otherwise grow until one sample could throw the estimate anywhere.
+    fScale = (fTrace < PLANT_ID_TRACE_MAX) ? 1.0f / PLANT_ID_FORGETTING : 1.0f;
+    for (i = 0; i < ui32N; i++)
+    {
+        for (j = i; j < ui32N; j++)
+        {
+            psRls->ppfP[i][j] = (psRls->ppfP[i][j] - pfGain[i] * pfPPhi[j]) *
+                                fScale;
+            psRls->ppfP[j][i] = psRls->ppfP[i][j];
+        }
+    }
+
+    psRls->fErrorSq += PLANT_ID_RESIDUAL_ALPHA *
+                       (fError * fError - psRls->fErrorSq);
+    psRls->fOutputSq += PLANT_ID_RESIDUAL_ALPHA *
+                        (fOutput * fOutput - psRls->fOutputSq);
+    psRls->ui32Updates++;
+}
+
+
+static void
+PlantIdFilterPrime(float *pfFilter, float fInput)
+{
+    pfFilter[0] = fInput;
+    pfFilter[1] = fInput;
+    pfFilter[2] = fInput;
+}
+
+
+/**
+ * @brief Advances the three poles by one cycle. fGain is the pole rate times
+ * the cycle length.
+ */
+static void
+PlantIdFilterStep(float *pfFilter, float fInput, float fGain)
+{
+    pfFilter[0] += fGain * (fInput - pfFilter[0]);
+    pfFilter[1] += fGain * (pfFilter[0] - pfFilter[1]);
+    pfFilter[2] += fGain * (pfFilter[1] - pfFilter[2]);
+}
+
+
+/**
+ * @brief The filtered signal and its first three derivatives. Each pole is
+ * r / (s + r), so s times its output is r times (its input - its output),
+ * and the higher derivatives follow from the lower ones the same way.
+ */
+static void
+PlantIdFilterDerivatives(const float *pfFilter, float fInput, float *pfOut)
+{
+    const float r = PLANT_ID_FILTER_RATE;
+    float fD1a = r * (fInput - pfFilter[0]);
+    float fD1b = r * (pfFilter[0] - pfFilter[1]);
+    float fD1c = r * (pfFilter[1] - pfFilter[2]);
+    float fD2b = r * (fD1a - fD1b);
+    float fD2c = r * (fD1b - fD1c);
+
+    pfOut[0] = pfFilter[2];
+    pfOut[1] = fD1c;
+    pfOut[2] = fD2c;
+    pfOut[3] = r * (fD2b - fD2c);
+}
+
+
+/**
+ * @brief Restarts the filters and the delay line from the present, so
+ * nothing from before it (the ground, in practice) is fitted.
+ */
+static void
+PlantIdPrime(int32_t i32Height, int32_t i32Yaw, int32_t i32MainDuty,
+             int32_t i32TailDuty)
+{
+    uint32_t i;
+
+    g_fPlantIdYaw = (float)i32Yaw;
+    g_i32PlantIdLastYaw = i32Yaw;
+    PlantIdFilterPrime(g_ppfPlantIdFilter[PLANT_ID_HEIGHT], (float)i32Height);
+    PlantIdFilterPrime(g_ppfPlantIdFilter[PLANT_ID_YAW], g_fPlantIdYaw);
+    PlantIdFilterPrime(g_ppfPlantIdFilter[PLANT_ID_FILTER_MAIN],
+                       (float)i32MainDuty);
+    PlantIdFilterPrime(g_ppfPlantIdFilter[PLANT_ID_FILTER_TAIL],
+                       (float)i32TailDuty);
+    for (i = 0; i < PLANT_ID_INPUT_DELAY; i++)
+    {
+        g_pi32PlantIdMain[i] = i32MainDuty;
+        g_pi32PlantIdTail[i] = i32TailDuty;
+    }
+    g_ui32PlantIdSettle = PLANT_ID_SETTLE_CYCLES;
+}
+
+
+void
+PlantIdUpdate(int32_t i32Height, int32_t i32Yaw, int32_t i32MainDuty,
+              int32_t i32TailDuty, float fDt, bool bAirborne)
+{
+    float fGain = PLANT_ID_FILTER_RATE * fDt;
+    float pfHeight[4];
+    float pfYaw[4];
+    float pfPhi[PLANT_ID_MAX_PARAMS];
+    float fMain, fTail;
+    int32_t i32Diff;
+    uint32_t i;
+
+    if (!g_bPlantIdStarted)
+    {
+        for (i = 0; i < PLANT_ID_AXES; i++)
+        {
+            PlantIdRlsReset(&g_psPlantIdRls[i]);
+        }
+        PlantIdPrime(i32Height, i32Yaw, i32MainDuty, i32TailDuty);
+        g_bPlantIdStarted = true;
+    }
+    if (!bAirborne)
+    {
+        PlantIdPrime(i32Height, i32Yaw, i32MainDuty, i32TailDuty);
+        return;
+    }
+
+    // A stalled cycle would make the Euler step unstable; treat it as one
+    // pole's worth, which only costs accuracy for that cycle.
+    if (fGain > 1.0f)
+    {
+        fGain = 1.0f;
+    }
+
+    // Yaw is unwrapped by the short way round and kept within a turn by
+    // moving it and the filter together, which changes no derivative.
+    i32Diff = i32Yaw - g_i32PlantIdLastYaw;
+    if (i32Diff >= 180)
+    {
+        i32Diff -= 360;
+    }
+    else if (i32Diff < -180)
+    {
+        i32Diff += 360;
+    }
+    g_i32PlantIdLastYaw = i32Yaw;
+    g_fPlantIdYaw += (float)i32Diff;
+    if ((g_fPlantIdYaw >= 180.0f) || (g_fPlantIdYaw < -180.0f))
+    {
+        float fShift = (g_fPlantIdYaw >= 180.0f) ? -360.0f : 360.0f;
+
+        g_fPlantIdYaw += fShift;
+        for (i = 0; i < 3; i++)
+        {
+            g_ppfPlantIdFilter[PLANT_ID_YAW][i] += fShift;
+        }
+    }
+
+    fMain = (float)g_pi32PlantIdMain[g_ui32PlantIdDelayIndex];
+    fTail = (float)g_pi32PlantIdTail[g_ui32PlantIdDelayIndex];
+    g_pi32PlantIdMain[g_ui32PlantIdDelayIndex] = i32MainDuty;
+    g_pi32PlantIdTail[g_ui32PlantIdDelayIndex] = i32TailDuty;
+    if (++g_ui32PlantIdDelayIndex >= PLANT_ID_INPUT_DELAY)
+    {
+        g_ui32PlantIdDelayIndex = 0;
+    }
+
+    PlantIdFilterStep(g_ppfPlantIdFilter[PLANT_ID_HEIGHT], (float)i32Height,
+                      fGain);
+    PlantIdFilterStep(g_ppfPlantIdFilter[PLANT_ID_YAW], g_fPlantIdYaw, fGain);
+    PlantIdFilterStep(g_ppfPlantIdFilter[PLANT_ID_FILTER_MAIN], fMain, fGain);
+    PlantIdFilterStep(g_ppfPlantIdFilter[PLANT_ID_FILTER_TAIL], fTail, fGain);
+
+    if (g_ui32PlantIdSettle > 0)
+    {
+        g_ui32PlantIdSettle--;
+        return;
+    }
+
+    // One axis per call at most, so no cycle pays for both.
+    if (++g_ui32PlantIdCycle >= PLANT_ID_DIVIDER)
+    {
+        g_ui32PlantIdCycle = 0;
+    }
+    pfPhi[PLANT_ID_BM] = PLANT_ID_DUTY_SCALE *
+        (g_ppfPlantIdFilter[PLANT_ID_FILTER_MAIN][2] - PLANT_ID_MAIN_CENTRE);
+    pfPhi[PLANT_ID_C] = 1.0f;
+    if (g_ui32PlantIdCycle == 0)
+    {
+        PlantIdFilterDerivatives(g_ppfPlantIdFilter[PLANT_ID_HEIGHT],
+                                 (float)i32Height, pfHeight);
+        pfPhi[PLANT_ID_A1] = PLANT_ID_RATE_SCALE * pfHeight[2];
+        pfPhi[PLANT_ID_A0] = PLANT_ID_RATE_SCALE * pfHeight[1];
+        PlantIdRlsUpdate(&g_psPlantIdRls[PLANT_ID_HEIGHT], pfPhi,
+                         PLANT_ID_RATE_SCALE * pfHeight[3]);
+    }
+    else if (g_ui32PlantIdCycle == PLANT_ID_DIVIDER / 2)
+    {
+        PlantIdFilterDerivatives(g_ppfPlantIdFilter[PLANT_ID_YAW],
+                                 g_fPlantIdYaw, pfYaw);
+        pfPhi[PLANT_ID_A1] = PLANT_ID_RATE_SCALE * pfYaw[2];
+        pfPhi[PLANT_ID_A0] = PLANT_ID_RATE_SCALE * pfYaw[1];
+        pfPhi[PLANT_ID_BT] = PLANT_ID_DUTY_SCALE *
+            (g_ppfPlantIdFilter[PLANT_ID_FILTER_TAIL][2] - PLANT_ID_TAIL_CENTRE);
+        PlantIdRlsUpdate(&g_psPlantIdRls[PLANT_ID_YAW], pfPhi,
+                         PLANT_ID_RATE_SCALE * pfYaw[3]);
+    }
+}
+
+
+void
+PlantIdGet(plantIdEstimate_t *psEstimate)
+{
+    // Unscaled, parameter i multiplies a regressor that was scaled by this.
+    static const float pfUnscale[PLANT_ID_MAX_PARAMS] = {
+        1.0f, 1.0f, PLANT_ID_DUTY_SCALE / PLANT_ID_RATE_SCALE,
+        1.0f / PLANT_ID_RATE_SCALE, PLANT_ID_DUTY_SCALE / PLANT_ID_RATE_SCALE
+    };
+    const float *pfH = psEstimate->ppfTheta[PLANT_ID_HEIGHT];
+    const float *pfY = psEstimate->ppfTheta[PLANT_ID_YAW];
+    float pfErrorSq[PLANT_ID_AXES];
+    float pfOutputSq[PLANT_ID_AXES];
+    float fRoot, fFast, fSlow;
+    uint32_t i, j;
+
+    // Copied in a critical section so both axes come from the same cycle.
+    taskENTER_CRITICAL();
+    for (i = 0; i < PLANT_ID_AXES; i++)
+    {
+        const plantIdRls_t *psRls = &g_psPlantIdRls[i];
+
+        psEstimate->psFit[i].fTrace = 0.0f;
+        for (j = 0; j < PLANT_ID_MAX_PARAMS; j++)
+        {
+            psEstimate->ppfTheta[i][j] = (j < psRls->ui32Params) ?
+                                         psRls->pfTheta[j] : 0.0f;
+            if (j < psRls->ui32Params)
+            {
+                psEstimate->psFit[i].fTrace += psRls->ppfP[j][j];
+            }
+        }
+        pfErrorSq[i] = psRls->fErrorSq;
+        pfOutputSq[i] = psRls->fOutputSq;
+        psEstimate->psFit[i].ui32Updates = psRls->ui32Updates;
+    }
+    taskEXIT_CRITICAL();
+
+    for (i = 0; i < PLANT_ID_AXES; i++)
+    {
+        for (j = 0; j < PLANT_ID_MAX_PARAMS; j++)
+        {
+            psEstimate->ppfTheta[i][j] *= pfUnscale[j];
+        }
+        psEstimate->psFit[i].fResidual = (pfOutputSq[i] > 0.0f) ?
+            sqrtf(pfErrorSq[i] / pfOutputSq[i]) : 1.0f;
+    }
+
+    // Steady state, all derivatives zero: the duties that cancel c.
+    psEstimate->fHoverDuty = 0.0f;
+    psEstimate->fTailTrim = 0.0f;
+    psEstimate->fCoupling = 0.0f;
+    if (pfH[PLANT_ID_BM] != 0.0f)
+    {
+        psEstimate->fHoverDuty = PLANT_ID_MAIN_CENTRE -
+                                 pfH[PLANT_ID_C] / pfH[PLANT_ID_BM];
+    }
+    if (pfY[PLANT_ID_BT] != 0.0f)
+    {
+        psEstimate->fCoupling = -pfY[PLANT_ID_BM] / pfY[PLANT_ID_BT];
+        psEstimate->fTailTrim = PLANT_ID_TAIL_CENTRE -
+            (pfY[PLANT_ID_C] + pfY[PLANT_ID_BM] *
+             (psEstimate->fHoverDuty - PLANT_ID_MAIN_CENTRE)) /
+            pfY[PLANT_ID_BT];
+    }
+
+    // The height roots are the rotor and the damping. The yaw axis shares
+    // the rotor, whose rate divides out of its a0 = -damping / tau.
+    psEstimate->fMotorTau = 0.0f;
+    psEstimate->fHeightGain = 0.0f;
+    psEstimate->fHeightDamping = 0.0f;
+    psEstimate->fYawGain = 0.0f;
+    psEstimate->fYawDamping = 0.0f;
+    fRoot = pfH[PLANT_ID_A1] * pfH[PLANT_ID_A1] + 4.0f * pfH[PLANT_ID_A0];
+    if (fRoot > 0.0f)
+    {
+        fRoot = sqrtf(fRoot);
+        fFast = 0.5f * (fRoot - pfH[PLANT_ID_A1]);
+        fSlow = 0.5f * (-fRoot - pfH[PLANT_ID_A1]);
+        if (fSlow > 0.0f)
+        {
+            psEstimate->fMotorTau = 1.0f / fFast;
+            psEstimate->fHeightDamping = fSlow;
+            psEstimate->fHeightGain = pfH[PLANT_ID_BM] / fFast;
+            psEstimate->fYawDamping = -pfY[PLANT_ID_A0] / fFast;
+            psEstimate->fYawGain = -pfY[PLANT_ID_BT] / fFast;
+        }
+    }
+}
+
+
+/**
+ * @brief Whole and tenths of a duty for the log, clamped to 0..99.9 % so an
+ * unconverged estimate cannot print as nonsense.
+ */
+static uint32_t
+PlantIdTenths(float fDuty)
+{
+    if (fDuty < 0.0f)
+    {
+        return 0;
+    }
+    if (fDuty > 99.9f)
+    {
+        return 999;
+    }
+    return (uint32_t)(fDuty * 10.0f + 0.5f);
+}
+
+
+void
+PlantIdReport(void)
+{
+    static const char * const ppcAxis[PLANT_ID_AXES] = { "height", "yaw" };
+    static uint32_t ui32Periods = 0;
+    static plantIdEstimate_t sEstimate;     // Off the stats task's stack
+    uint32_t ui32Hover, ui32Trim, ui32Milli;
+    uint32_t i;
+
+    if (++ui32Periods < PLANT_ID_REPORT_PERIODS)
+    {
+        return;
+    }
+    ui32Periods = 0;
+
+    PlantIdGet(&sEstimate);
+    ui32Hover = PlantIdTenths(sEstimate.fHoverDuty);
+    ui32Trim = PlantIdTenths(sEstimate.fTailTrim);
+    LOG4(LOG_PLANT_ID_TRIM, ui32Hover / 10, ui32Hover % 10, ui32Trim / 10,
+         ui32Trim % 10);
+    LOG3(LOG_PLANT_ID_LAG, (uint32_t)(sEstimate.fMotorTau * 1000.0f + 0.5f),
+         (int32_t)(sEstimate.fCoupling * 100.0f),
+         sEstimate.psFit[PLANT_ID_HEIGHT].ui32Updates);
+    for (i = 0; i < PLANT_ID_AXES; i++)
+    {
+        ui32Milli = (uint32_t)(sEstimate.psFit[i].fTrace * 1000.0f);
+        LOG4(LOG_PLANT_ID_FIT, ppcAxis[i],
+             (uint32_t)(sEstimate.psFit[i].fResidual * 100.0f + 0.5f),
+             ui32Milli / 1000, ui32Milli % 1000);
+    }
+}
@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ * plant_id.h
+ *
+ * Purpose:
+ * Online identification of the rig from the control task's own inputs and
+ * outputs, so its hover duty, tail trim, main-to-tail coupling and rotor
+ * lag can be read off a rig in normal flight instead of being tuned by hand.
+ *
+ * The model is the one in tools/heli_sim.py, written per axis as a linear
+ * differential equation with the rotor lag folded in:
+ *
+ *   h''' = a1 h'' + a0 h' + bm (main - 50) + c
+ *   y''' = a1 y'' + a0 y' + bt (tail - 40) + bm (main - 50) + c
+ *
+ * where s^2 - a1 s - a0 has one root at the rotor's 1/tau and the other at
+ * the axis damping. The derivatives are never formed from the raw readings:
+ * height, yaw and both duties pass through the same three-pole low-pass
+ * (a state-variable filter), whose states give the filtered signal and its
+ * first three derivatives exactly. Filtering both sides alike leaves the
+ * equation unchanged while the ADC noise and encoder steps are removed.
+ *
+ * Each axis is then fitted by recursive least squares with a forgetting
+ * factor once every PLANT_ID_DIVIDER cycles, the yaw half a period after the
+ * height, so the cost of a call is bounded: the filters plus at most one
+ * update of at most five parameters. The covariance is kept from growing
+ * without bound while the rig hovers and nothing is being learned by
+ * forgetting only while its trace is below PLANT_ID_TRACE_MAX.
+ *
+ * Samples are only used while the rig is airborne, and not until the filters
+ * have settled after take-off, so the ground stop is never fitted. The duties
+ * are delayed by PLANT_ID_INPUT_DELAY cycles to line them up with the
+ * measurements they produce.
+ *
+ * tools/plant_id_check.py runs a port of this file against simulated rigs
+ * with known parameters.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __PLANT_ID_H__
+#define __PLANT_ID_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+/** @brief Fitted axes. */
+#define PLANT_ID_HEIGHT         0
+#define PLANT_ID_YAW            1
+#define PLANT_ID_AXES           2
+
+/** @brief Most parameters in one axis's model. */
+#define PLANT_ID_MAX_PARAMS     5
+
+/** @brief Control cycles per update of each axis. */
+#define PLANT_ID_DIVIDER        10
+
+/** @brief Corner of each of the three filter poles, rad/s. */
+#define PLANT_ID_FILTER_RATE    3.0f
+
+/** @brief Forgetting factor: about 1 / (1 - f) updates are remembered. */
+#define PLANT_ID_FORGETTING     0.998f
+
+/** @brief Covariance at power-up (per parameter) and its bound. */
+#define PLANT_ID_INITIAL_P      1000.0f
+#define PLANT_ID_TRACE_MAX      10000.0f
+
+/**
+ * @brief Time from take-off until the filters have forgotten the ground:
+ * 5 s, as a hard climb leaves a third-derivative error that takes the
+ * 3 rad/s poles that long to die away. In control cycles below.
+ */
+#define PLANT_ID_SETTLE_MS      5000
+#define PLANT_ID_SETTLE_CYCLES  (PLANT_ID_SETTLE_MS / CONTROL_PERIOD_MS)
+
+/** @brief Cycles the duties are delayed by: the height filter's lag plus one. */
+#define PLANT_ID_INPUT_DELAY    3
+
+/** @brief A report is logged every this many calls to PlantIdReport(). */
+#define PLANT_ID_REPORT_PERIODS 5
+
+/** @brief Parameter indices, as in the equations above. */
+enum
+{
+    PLANT_ID_A1,
+    PLANT_ID_A0,
+    PLANT_ID_BM,
+    PLANT_ID_C,
+    PLANT_ID_BT
+};
+
+/** @brief Convergence of one axis. */
+typedef struct {
+    float fTrace;               // Covariance trace; falls as the fit settles
+    float fResidual;            // RMS prediction error, fraction of the RMS output
+    uint32_t ui32Updates;       // Least-squares updates since power-up
+} plantIdFit_t;
+
+/**
+ * @brief The current estimate. The physical figures assume the faster
+ * height root is the rotor; fMotorTau and the figures that need it read 0
+ * while the roots are not real and positive yet.
+ */
+typedef struct {
+    float fHoverDuty;           // Main duty that holds height, %
+    float fTailTrim;            // Tail duty that holds yaw at that hover, %
+    float fCoupling;            // Tail % needed per main % of rotor torque
+    float fMotorTau;            // Rotor time constant, s
+    float fHeightGain;          // counts/s^2 per % main duty
+    float fHeightDamping;       // 1/s
+    float fYawGain;             // deg/s^2 per % tail duty
+    float fYawDamping;          // 1/s
+    float ppfTheta[PLANT_ID_AXES][PLANT_ID_MAX_PARAMS];  // Raw, see above
+    plantIdFit_t psFit[PLANT_ID_AXES];
+} plantIdEstimate_t;
+
+/**
+ * @brief Feeds one control cycle: the readings the duties were computed
+ * from, the duties sent, the cycle's length in seconds and whether the rig
+ * is airborne. Called from the control task only.
+ */
+void PlantIdUpdate(int32_t i32Height, int32_t i32Yaw, int32_t i32MainDuty,
+                   int32_t i32TailDuty, float fDt, bool bAirborne);
+
+/** @brief Copies out the current estimate. Safe from any task. */
+void PlantIdGet(plantIdEstimate_t *psEstimate);
+
+/** @brief Logs the estimate every PLANT_ID_REPORT_PERIODS calls. */
+void PlantIdReport(void);
+
+#endif /* __PLANT_ID_H__ */
@@ -19,24 +19,33 @@
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/adc.h"
-#include "circBufT.h"
+#include "config.h"
+#include "ringBuf.h"
 #include "potentiometer.h"
 
 //CONSTANTS--------------------------------------------------------------------
-#define BUF_SIZE 10  // Size of circular buffer
-#define SAMPLE_SEQUENCE 3  // Which sequence to read ADC0 using
+#define POT_BUF_SIZE 10  // Number of samples averaged
+#define POT_BUF_CAPACITY 16  // Ring buffer capacity, power of two >= POT_BUF_SIZE
+#define SAMPLE_SEQUENCE 3  // Which sequence to read ADC1 using
+#define POT_ADC_BASE ADC1_BASE
+#define POT_ADC_PERIPH SYSCTL_PERIPH_ADC1
 
 //STATICS AND GLOBALS----------------------------------------------------------
-static circBuf_t g_inBuffer; // Buffer of size BUF_SIZE integers (sample values)
+static uint32_t g_pui32InStorage[POT_BUF_CAPACITY];
+static ringBuf_t g_inBuffer; // Window of the last POT_BUF_SIZE sample values
+static bool g_bFirstSample = true; // Seed the window on the first sample only
 
 //LOCAL FUNCTION PROTOTYPES ---------------------------------------------------
-static uint32_t readAverageCircBuf(circBuf_t *buffer);
+static uint32_t readAverageRingBuf(ringBuf_t *buffer);
+static void writeWindow(ringBuf_t *buffer, uint32_t ui32Value);
 
 //FUNCTIONS--------------------------------------------------------------------
 //*****************************************************************************
 //
-// Polls the potentiometer and returns a boolean as to whether the ADC
-// was polled. Returns the ADC value between 0 and 4095 through ui32Out.
+// Samples the potentiometer and returns a boolean as to whether the ADC
+// was read. Returns the windowed average, between 0 and 4095, through
+// ui32Out. The ADC is configured once in PotentiometerInit(), so this only
+// triggers a conversion and waits for it.
 //
 //*****************************************************************************
 bool
@@ -44,48 +53,37 @@ PotentiometerPoll(uint32_t* ui32Out)
 {
 
     uint32_t ui32ADCData;
-    uint8_t firstTime = 1;
 
+    // Trigger the sample sequence.
+    ADCProcessorTrigger(POT_ADC_BASE, SAMPLE_SEQUENCE);
 
-    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0))
+    // Wait until the sample sequence has completed.
+    while(!ADCIntStatus(POT_ADC_BASE, SAMPLE_SEQUENCE, false))
     {
     }
-    if (SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0))
-    {
-        ADCSequenceConfigure(ADC0_BASE, SAMPLE_SEQUENCE, ADC_TRIGGER_PROCESSOR, 0);
-        ADCSequenceStepConfigure(ADC0_BASE, SAMPLE_SEQUENCE, 0,
-        ADC_CTL_IE | ADC_CTL_END | ADC_CTL_CH0);
-        ADCSequenceEnable(ADC0_BASE, SAMPLE_SEQUENCE);
-
-        // Trigger the sample sequence.
-        ADCProcessorTrigger(ADC0_BASE, SAMPLE_SEQUENCE);
+    ADCIntClear(POT_ADC_BASE, SAMPLE_SEQUENCE);
 
-        // Wait until the sample sequence has completed.
-        while(!ADCIntStatus(ADC0_BASE, SAMPLE_SEQUENCE, false))
-        {
-        }
+    // Read the value from the ADC.
+    if (ADCSequenceDataGet(POT_ADC_BASE, SAMPLE_SEQUENCE, &ui32ADCData) == 0)
+    {
+        return 0;
+    }
 
-        // Read the value from the ADC.
-        ADCSequenceDataGet(ADC0_BASE, SAMPLE_SEQUENCE, &ui32ADCData);
-
-        // To make sure the buffer is initialised with
-        // valid values so it doesn't ramp up from 0.
-        if (firstTime) {
-            firstTime = 0;
-            uint8_t i;
-            for (i = 0; i < BUF_SIZE + BUF_SIZE; ++i) {
-                writeCircBuf(&g_inBuffer, ui32ADCData);
-            }
+    // To make sure the buffer is initialised with
+    // valid values so it doesn't ramp up from 0.
+    if (g_bFirstSample) {
+        g_bFirstSample = false;
+        uint8_t i;
+        for (i = 0; i < POT_BUF_SIZE; ++i) {
+            writeWindow(&g_inBuffer, ui32ADCData);
         }
+    }
 
-        writeCircBuf(&g_inBuffer, ui32ADCData);
-
-        *ui32Out = readAverageCircBuf(&g_inBuffer);
+    writeWindow(&g_inBuffer, ui32ADCData);
 
-        return 1;
-    }
+    *ui32Out = readAverageRingBuf(&g_inBuffer);
 
-    return 0;
+    return 1;
 
 }
 
@@ -94,46 +92,74 @@ PotentiometerPoll(uint32_t* ui32Out)
 //! Initializes the components used by the board's potentiometer.
 //!
 //! This function must be called during application initialization to
-//! configure the circular buffer to which the potentiometer writes to.
+//! configure the ring buffer the potentiometer writes to and the ADC
+//! sequence it is sampled with.
 //
 //*****************************************************************************
 void
 PotentiometerInit(void)
 {
 
-    if (initCircBuf(&g_inBuffer, BUF_SIZE) == NULL)
+    // Storage is static, so this only fails if POT_BUF_CAPACITY is not a
+    // power of two.
+    if (!initRingBuf(&g_inBuffer, g_pui32InStorage, sizeof(uint32_t),
+                     POT_BUF_CAPACITY))
     {
-        // Failed to initialize the buffer. Check heap size is set to
-        // heap_size > 0 (say, 128) in CCS.
         while(1) {}
     }
 
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+    // The potentiometer has ADC1 to itself; the altitude sensor uses ADC0.
+    SysCtlPeripheralEnable(POT_ADC_PERIPH);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    while(!SysCtlPeripheralReady(POT_ADC_PERIPH))
+    {
+    }
+    GPIOPinTypeADC(GPIO_PORTE_BASE, potentialMeterPin);
 
+    ADCSequenceConfigure(POT_ADC_BASE, SAMPLE_SEQUENCE, ADC_TRIGGER_PROCESSOR, 0);
+    ADCSequenceStepConfigure(POT_ADC_BASE, SAMPLE_SEQUENCE, 0,
+    ADC_CTL_IE | ADC_CTL_END | potentialMeterChannel);
+    ADCSequenceEnable(POT_ADC_BASE, SAMPLE_SEQUENCE);
+    ADCIntClear(POT_ADC_BASE, SAMPLE_SEQUENCE);
 
 }
 
 
 //*****************************************************************************
 //
-// Function to calculate the mean value of samples within a circular buffer
+// Appends a sample, dropping the oldest once the window holds POT_BUF_SIZE.
+//
+//*****************************************************************************
+void writeWindow(ringBuf_t *buffer, uint32_t ui32Value)
+{
+    if (ringBufCount(buffer) >= POT_BUF_SIZE) {
+        discardRingBuf(buffer, 1);
+    }
+    writeRingBuf(buffer, &ui32Value);
+}
+
+//*****************************************************************************
+//
+// Function to calculate the mean value of samples within the window
 //
 // Function used from ADCdemo1.c
 //
 //*****************************************************************************
-uint32_t readAverageCircBuf(circBuf_t *buffer)
+uint32_t readAverageRingBuf(ringBuf_t *buffer)
 {
     // Initialize variables
     uint32_t sum = 0;
+    uint32_t sample;
     uint8_t i;
 
     // Sum buffer values
-    for (i = 0; i < BUF_SIZE; i++) {
-        sum = sum + readCircBuf(buffer);
+    for (i = 0; i < POT_BUF_SIZE; i++) {
+        peekRingBuf(buffer, i, &sample);
+        sum = sum + sample;
     }
 
     // return the average of the values
-    return (2 * sum + BUF_SIZE) / 2 / BUF_SIZE;
+    return (2 * sum + POT_BUF_SIZE) / 2 / POT_BUF_SIZE;
 }
 
 
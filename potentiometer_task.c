@@ -1,8 +1,9 @@
 /*
  * potentiometer_task.c
  *
- * Reads the potentiometer using potentiometer.c and displays the value
- * on UART.
+ * Reads the potentiometer using potentiometer.c and turns it into a
+ * continuous height or yaw setpoint for the control task. The sampling runs
+ * as a software-timer callback on the FreeRTOS timer service task.
  *
  *  Created on: 2/08/2023
  *      Author: Jamie Thomas
@@ -11,6 +12,7 @@
 //INCLUDES ----------------------------------------------------
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
@@ -18,87 +20,166 @@
 #include "driverlib/gpio.h"
 #include "driverlib/rom.h"
 #include "utils/uartstdio.h"
+#include "config.h"
 #include "priorities.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "semphr.h"
+#include "timers.h"
 #include "potentiometer_task.h"
 #include "potentiometer.h"
+#include "log_task.h"
 
 //CONSTANTS--------------------------------------------------------------------
-// The stack size for the display task.
-#define POTENTIOTASKSTACKSIZE        128         // Stack size in words
+// The ADC is sampled every POT_SAMPLE_PERIOD ms into a moving average, and
+// every POT_DECIMATION samples the average is turned into a setpoint.
+#define POT_SAMPLE_PERIOD 2
+#define POT_DECIMATION 5
 
-// Variance of the ADC value to help display the value smoothly
-#define VARIANCE 5
+// ADC counts at each end of travel that snap to the end value, so the
+// minimum and maximum setpoints are reachable despite ADC noise.
+#define POT_DEADBAND 40
+
+// A new setpoint is only published when it moves at least this far (in
+// setpoint units) from the last published one.
+#define POT_HEIGHT_HYSTERESIS 8
+#define POT_YAW_HYSTERESIS 2
 
 //STATICS AND GLOBALS----------------------------------------------------------
-// UART Semaphore for protecting UART cardinality.
-extern xSemaphoreHandle g_pUARTSemaphore;
+// Setpoint queues, externally defined.
+extern QueueHandle_t g_TargHeightDisplayQueue;
+extern QueueHandle_t g_TargYawDisplayQueue;
+extern QueueHandle_t g_TargYawControlQueue;
+extern QueueHandle_t g_TargHeightControlQueue;
+
+// The sampling timer. Its callback runs on the timer service task, so the
+// potentiometer no longer needs a task and stack of its own.
+static TimerHandle_t g_xPotentiometerTimer;
+static StaticTimer_t g_xPotentiometerTimerBuf;
+
+// Moving average, decimation count and last published setpoint, kept
+// between samples.
+static uint32_t g_ui32CurPotentioState = 0;
+static uint32_t g_ui32Decimate = 0;
+static int32_t g_i32Published = 0;
+static bool g_bFirst = true;
+
+// Whether the height setpoint has read zero since power-up. Until it has,
+// nothing is published, so a pot left turned up cannot ask for a climb.
+static bool g_bZeroSeen = false;
+
+//LOCAL FUNCTION PROTOTYPES ---------------------------------------------------
+static int32_t PotentiometerToSetpoint(uint32_t ui32Value);
+static void PotentiometerPublish(int32_t i32Setpoint);
 
 //FUNCTIONS--------------------------------------------------------------------
 //*****************************************************************************
 //
-// This task reads the potentiometer's state and displays its change (if it's
-// changed) on UART COM.
+// Maps an averaged ADC reading onto the setpoint range of the axis the
+// potentiometer drives, applying the end-of-travel deadband.
+//
+//*****************************************************************************
+static int32_t
+PotentiometerToSetpoint(uint32_t ui32Value)
+{
+    if (ui32Value < POT_DEADBAND) {
+        ui32Value = 0;
+    } else if (ui32Value > ADC_MAX_VALUE - POT_DEADBAND) {
+        ui32Value = ADC_MAX_VALUE;
+    }
+
+#if POT_SETPOINT_MODE == POT_SETPOINT_YAW
+    int32_t i32Yaw = (ui32Value * 360 + ADC_MAX_VALUE / 2) / ADC_MAX_VALUE;
+    i32Yaw -= 180;
+    if (i32Yaw > 179) {
+        i32Yaw = 179;
+    }
+    return i32Yaw;
+#else
+    return (ui32Value * HEIGHT_TARGET_MAX + ADC_MAX_VALUE / 2) / ADC_MAX_VALUE;
+#endif
+}
+
+//*****************************************************************************
+//
+// Pushes a setpoint change to the control and display tasks. Sends never
+// block: the control task drains its queue every cycle, and a dropped
+// display update is corrected by the next change.
 //
 //*****************************************************************************
 static void
-PotentiometerTask(void *pvParameters)
+PotentiometerPublish(int32_t i32Setpoint)
 {
-    // Used for task delay timing
-    portTickType ui16LastTime;
-    uint32_t ui32SwitchDelay = 25;
+#if POT_SETPOINT_MODE == POT_SETPOINT_YAW
+    xQueueSend(g_TargYawControlQueue, &i32Setpoint, 0);
+    xQueueSend(g_TargYawDisplayQueue, &i32Setpoint, 0);
+#elif POT_SETPOINT_MODE == POT_SETPOINT_HEIGHT
+    xQueueSend(g_TargHeightControlQueue, &i32Setpoint, 0);
+    xQueueSend(g_TargHeightDisplayQueue, &i32Setpoint, 0);
+#else
+    (void)i32Setpoint;
+#endif
+}
 
-    // Initialise states of buttons
-    uint32_t ui32CurPotentioState, ui32PrevPotentioState;
-    ui32CurPotentioState = ui32PrevPotentioState = 0;
+//*****************************************************************************
+//
+// Timer callback that samples the potentiometer, decimates the averaged
+// stream and turns it into a continuous height or yaw setpoint
+// (POT_SETPOINT_MODE in config.h). Changes beyond the hysteresis are pushed
+// straight into the control setpoint queues and logged. A height setpoint
+// is only published once the pot has been turned down to zero.
+//
+//*****************************************************************************
+static void
+PotentiometerSample(TimerHandle_t xTimer)
+{
+    int32_t i32Setpoint;
 
-    // Initialise variable for if the polling of the potentiometer
-    // gave back a new value.
-    bool pollSuccess = false;
+#if POT_SETPOINT_MODE == POT_SETPOINT_YAW
+    const int32_t i32Hysteresis = POT_YAW_HYSTERESIS;
+#else
+    const int32_t i32Hysteresis = POT_HEIGHT_HYSTERESIS;
+#endif
 
-    // Get the current tick count.
-    ui16LastTime = xTaskGetTickCount();
+    (void)xTimer;
 
-    while(1)
+    // Sample the potentiometer into the moving average.
+    if (PotentiometerPoll(&g_ui32CurPotentioState) &&
+        ++g_ui32Decimate >= POT_DECIMATION)
     {
-        // Poll the state of the potentiometer.
-        pollSuccess = PotentiometerPoll(&ui32CurPotentioState);
+        g_ui32Decimate = 0;
+        i32Setpoint = PotentiometerToSetpoint(g_ui32CurPotentioState);
 
-        // Check that the function returned something. (Actually polled the ADC)
-        if (pollSuccess)
-        {
-            // Check if previous state is equal to the current state.
-            if( !(ui32PrevPotentioState <= ui32CurPotentioState + VARIANCE &&
-                    ui32CurPotentioState <= ui32PrevPotentioState + VARIANCE))
-            {
-                ui32PrevPotentioState = ui32CurPotentioState;
-
-                // Display that potentiometer has changed.
-
-                // Guard UART from concurrent access.
-                xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-                UARTprintf(
-                        "Potentiometer changed, Value: '%d'.\n",
-                        ui32CurPotentioState
-                );
-                xSemaphoreGive(g_pUARTSemaphore);
+#if POT_SETPOINT_MODE == POT_SETPOINT_HEIGHT
+        if (!g_bZeroSeen) {
+            if (i32Setpoint != 0) {
+                return;
             }
+            g_bZeroSeen = true;
         }
+#endif
+
+        // Publish the first value, any move past the hysteresis band,
+        // and always the exact end values so they are not lost in it.
+        if (g_bFirst ||
+            abs(i32Setpoint - g_i32Published) >= i32Hysteresis ||
+            (i32Setpoint != g_i32Published &&
+             (g_ui32CurPotentioState < POT_DEADBAND ||
+              g_ui32CurPotentioState > ADC_MAX_VALUE - POT_DEADBAND)))
+        {
+            g_bFirst = false;
+            g_i32Published = i32Setpoint;
+            PotentiometerPublish(i32Setpoint);
 
-        pollSuccess = false;
-
-        // Wait for the required amount of time to check back.
-        vTaskDelayUntil(&ui16LastTime, ui32SwitchDelay / portTICK_RATE_MS);
+            // Log that potentiometer has changed.
+            LOG2(LOG_POT_CHANGED, g_ui32CurPotentioState, i32Setpoint);
+        }
     }
-
 }
 
 //*****************************************************************************
 //
-// Initializes the potentiometer task.
+// Initializes the potentiometer and starts the sampling timer.
 //
 //*****************************************************************************
 uint32_t
@@ -108,10 +189,14 @@ PotentiometerTaskInit(void)
     // Initialize the potentiometer
     PotentiometerInit();
 
-    // Create the potentiometer task.
-    if(xTaskCreate(PotentiometerTask, (const portCHAR *)"Potentiometer",
-                   POTENTIOTASKSTACKSIZE, NULL, tskIDLE_PRIORITY +
-                   PRIORITY_POTENTIOMETER_TASK, NULL) != pdTRUE)
+    // Create the sampling timer. The start command is queued until the
+    // scheduler starts the timer service task.
+    g_xPotentiometerTimer = xTimerCreateStatic("Potentiometer",
+                                               POT_SAMPLE_PERIOD / portTICK_RATE_MS,
+                                               pdTRUE, NULL, PotentiometerSample,
+                                               &g_xPotentiometerTimerBuf);
+    if(g_xPotentiometerTimer == NULL ||
+       xTimerStart(g_xPotentiometerTimer, 0) != pdPASS)
     {
         return(1);
     }
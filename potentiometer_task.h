@@ -10,7 +10,7 @@
 
 //*****************************************************************************
 //
-// Prototypes for the potentiometer task.
+// Prototypes for the potentiometer sampling timer.
 //
 //*****************************************************************************
 extern uint32_t PotentiometerTaskInit(void);
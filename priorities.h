@@ -36,12 +36,16 @@
 #define PRIORITY_PWM_TASK               2
 #define PRIORITY_HEIGHT_TASK            3
 
-#define PRIORITY_POTENTIOMETER_TASK     1
-#define PRIORITY_SWITCH_TASK            2
-#define PRIORITY_LED_TASK               1
 #define PRIORITY_DISPLAY_TASK           1
 #define PRIORITY_YAW_TASK               3
 #define PRIORITY_CONTROL_TASK           3
+#define PRIORITY_LOG_TASK               1
+#define PRIORITY_STATS_TASK             1
 
 
+//
+// The button, potentiometer and LED jobs run as software-timer callbacks on
+// the timer service task, at configTIMER_TASK_PRIORITY (FreeRTOSConfig.h).
+//
+
 #endif // __PRIORITIES_H__
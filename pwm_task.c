@@ -21,12 +21,19 @@
 #include "queue.h"           // FreeRTOS queue functionalities
 #include "semphr.h"          // FreeRTOS semaphore functionalities
 #include "height_task.h"     // Helicopter data acquisition functionalities
+#include "system_state.h"    // Shared system state (ARMED)
 
 // CONSTANTS-------------------------------------------------------------------
 
 /** @brief Stack size (in words) for the PWM task. */
 #define PWMTASKSTACKSIZE        128         
 
+/**
+ * @brief Longest wait for arming or for a new main duty, in ticks, so a
+ * change of the armed state is still acted on if the control task stops.
+ */
+#define PWM_DUTY_TIMEOUT        100
+
 // GLOBAL VARIABLES------------------------------------------------------------
 
 /** @brief Semaphore for UART operations. */
@@ -40,6 +47,10 @@ extern QueueHandle_t Q_mainDuty;
 /** @brief Altitude value used in PWM adjustments. */
 extern uint32_t EXT_VAL;                          
 
+/** @brief Statically allocated TCB and stack for the PWM task. */
+static StaticTask_t g_xPWMTaskTCB;
+static StackType_t g_pxPWMTaskStack[PWMTASKSTACKSIZE];
+
 // LOCAL FUNCTION PROTOTYPES---------------------------------------------------
 
 void setMainPWM(uint32_t ui32Freq, uint32_t ui32Duty);
@@ -67,15 +78,22 @@ PWM_Task(void *pvParameters)
     uint32_t ui32Freq = PWM_START_RATE_HZ;
     uint32_t recieved_message;
 
-    // Activate the PWM output for both the main and tail motors
-    PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, true);
-    PWMOutputState(PWM1_BASE, PWM_OUT_5_BIT, true);
+    bool bArmed = false;
 
     // Infinite loop to continuously update the PWM settings
     while(1)
     {
+        // Disarmed, the outputs are off and there is nothing to drive, so
+        // wait to be armed rather than waking for every control cycle.
+        if (!bArmed)
+        {
+            SystemStateWait(SYSTEM_STATE_ARMED, PWM_DUTY_TIMEOUT);
+        }
 
-        if (xQueueReceive(Q_mainDuty, &recieved_message, 0) == pdPASS) {
+        // Apply each control cycle's duties as soon as they are sent. The
+        // control task overwrites the one-deep queues, so it never waits
+        // here and the newest duty is always the one applied.
+        if (xQueueReceive(Q_mainDuty, &recieved_message, PWM_DUTY_TIMEOUT) == pdPASS) {
 
             setMainPWM(ui32Freq, recieved_message);
 
@@ -87,11 +105,30 @@ PWM_Task(void *pvParameters)
 
         }
 
-        vTaskDelay(100);
+        // The outputs stay off until the operator arms the system, and go
+        // off again when it lands disarmed or on a fault. Checked after the
+        // duties, so on arming they come on with the latest one applied.
+        if (bArmed != ((SystemStateGet() & (SYSTEM_STATE_ARMED | SYSTEM_STATE_FAULT))
+                       == SYSTEM_STATE_ARMED))
+        {
+            bArmed = !bArmed;
+            PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, bArmed);
+            PWMOutputState(PWM1_BASE, PWM_OUT_5_BIT, bArmed);
+        }
     }
 }
 
 
+void
+PWMMotorsOff(void)
+{
+    // Straight to the generators: the caller may be about to spin at a
+    // priority that keeps the PWM task from ever running again.
+    PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, false);
+    PWMOutputState(PWM_TAIL_BASE, PWM_TAIL_OUTBIT, false);
+}
+
+
 /**
  * @brief Initialize the PWM settings for the main motor.
  */
@@ -180,8 +217,9 @@ uint32_t PWMTaskInit(void)
     // Create the PWM task in FreeRTOS. The task will be named "pwmtask" and will run
     // at a priority level determined by `tskIDLE_PRIORITY + PRIORITY_PWM_TASK`.
     // If the task creation is not successful, return an error code.
-    if (xTaskCreate(PWM_Task, (const portCHAR *)"pwmtask", PWMTASKSTACKSIZE, NULL,
-                    tskIDLE_PRIORITY + PRIORITY_PWM_TASK, NULL) != pdTRUE) {
+    if (xTaskCreateStatic(PWM_Task, (const portCHAR *)"pwmtask", PWMTASKSTACKSIZE,
+                          NULL, tskIDLE_PRIORITY + PRIORITY_PWM_TASK,
+                          g_pxPWMTaskStack, &g_xPWMTaskTCB) == NULL) {
         return(1);  // Return 1 to indicate task creation error
     }
 
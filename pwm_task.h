@@ -16,6 +16,12 @@
 
 uint32_t PWMTaskInit(void);
 
+/**
+ * @brief Turns both motor outputs off at once, from any context. For fatal
+ * paths, which cannot rely on the PWM task running again.
+ */
+void PWMMotorsOff(void);
+
 void initTailMotorPWM(void);
 
 #endif /* __PWM_TASK_H__ */
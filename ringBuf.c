@@ -0,0 +1,160 @@
+// *******************************************************
+// 
+// ringBuf.c
+//
+// Generic power-of-two ring buffer over static storage.
+// See ringBuf.h.
+//
+// Group 9
+// 
+// *******************************************************
+
+#include <stdint.h>
+#include <string.h>
+#include "ringBuf.h"
+
+// *******************************************************
+// copyElem: copy one element. Word elements, which every
+// user has, get a fixed-size copy the compiler turns into a
+// single load and store instead of a call to memcpy.
+static inline void
+copyElem (const ringBuf_t *buffer, void *dst, const void *src)
+{
+	if (buffer->elemSize == sizeof (uint32_t))
+		memcpy (dst, src, sizeof (uint32_t));
+	else
+		memcpy (dst, src, buffer->elemSize);
+}
+
+// *******************************************************
+// copyIn / copyOut: move n elements between a linear array and
+// the ring starting at free-running index idx, splitting the
+// copy where the ring wraps.
+static void
+copyIn (ringBuf_t *buffer, uint32_t idx, const uint8_t *src, uint32_t n)
+{
+	uint32_t start = idx & buffer->mask;
+	uint32_t first = buffer->mask + 1 - start;
+
+	if (first > n)
+		first = n;
+	memcpy (buffer->data + start * buffer->elemSize, src,
+	        first * buffer->elemSize);
+	memcpy (buffer->data, src + first * buffer->elemSize,
+	        (n - first) * buffer->elemSize);
+}
+
+static void
+copyOut (const ringBuf_t *buffer, uint32_t idx, uint8_t *dst, uint32_t n)
+{
+	uint32_t start = idx & buffer->mask;
+	uint32_t first = buffer->mask + 1 - start;
+
+	if (first > n)
+		first = n;
+	memcpy (dst, buffer->data + start * buffer->elemSize,
+	        first * buffer->elemSize);
+	memcpy (dst + first * buffer->elemSize, buffer->data,
+	        (n - first) * buffer->elemSize);
+}
+
+// *******************************************************
+// initRingBuf: attach storage and reset both indices.
+bool
+initRingBuf (ringBuf_t *buffer, void *storage, uint32_t elemSize,
+             uint32_t capacity)
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+		return false;
+
+	buffer->data = (uint8_t *) storage;
+	buffer->elemSize = elemSize;
+	buffer->mask = capacity - 1;
+	buffer->windex = 0;
+	buffer->rindex = 0;
+	return true;
+}
+
+// *******************************************************
+// writeRingBuf: insert one entry at windex if there is room.
+bool
+writeRingBuf (ringBuf_t *buffer, const void *entry)
+{
+	if (ringBufFree (buffer) == 0)
+		return false;
+
+	copyElem (buffer,
+	          buffer->data + (buffer->windex & buffer->mask) * buffer->elemSize,
+	          entry);
+	buffer->windex++;
+	return true;
+}
+
+// *******************************************************
+// readRingBuf: remove the oldest entry if there is one.
+bool
+readRingBuf (ringBuf_t *buffer, void *entry)
+{
+	if (ringBufCount (buffer) == 0)
+		return false;
+
+	copyElem (buffer, entry,
+	          buffer->data + (buffer->rindex & buffer->mask) * buffer->elemSize);
+	buffer->rindex++;
+	return true;
+}
+
+// *******************************************************
+// peekRingBuf: copy out an entry without consuming it.
+bool
+peekRingBuf (const ringBuf_t *buffer, uint32_t offset, void *entry)
+{
+	if (offset >= ringBufCount (buffer))
+		return false;
+
+	copyElem (buffer, entry,
+	          buffer->data +
+	              ((buffer->rindex + offset) & buffer->mask) * buffer->elemSize);
+	return true;
+}
+
+// *******************************************************
+// writeRingBufN: insert as many of n entries as fit.
+uint32_t
+writeRingBufN (ringBuf_t *buffer, const void *entries, uint32_t n)
+{
+	uint32_t space = ringBufFree (buffer);
+
+	if (n > space)
+		n = space;
+	copyIn (buffer, buffer->windex, (const uint8_t *) entries, n);
+	buffer->windex += n;
+	return n;
+}
+
+// *******************************************************
+// readRingBufN: remove up to n of the oldest entries.
+uint32_t
+readRingBufN (ringBuf_t *buffer, void *entries, uint32_t n)
+{
+	uint32_t count = ringBufCount (buffer);
+
+	if (n > count)
+		n = count;
+	copyOut (buffer, buffer->rindex, (uint8_t *) entries, n);
+	buffer->rindex += n;
+	return n;
+}
+
+// *******************************************************
+// discardRingBuf: advance rindex past up to n entries.
+uint32_t
+discardRingBuf (ringBuf_t *buffer, uint32_t n)
+{
+	uint32_t count = ringBufCount (buffer);
+
+	if (n > count)
+		n = count;
+	buffer->rindex += n;
+	return n;
+}
@@ -0,0 +1,83 @@
+#ifndef RINGBUF_H_
+#define RINGBUF_H_
+
+// *******************************************************
+// 
+// ringBuf.h
+//
+// Generic FIFO ring buffer over caller-provided (static)
+// storage. Elements may be any size; the capacity must be a
+// power of two so indices wrap with a mask instead of a
+// compare-and-reset. The indices are free-running counts, so
+// count = windex - rindex even after they wrap.
+//
+// Group 9
+// 
+// *******************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+// *******************************************************
+// Buffer structure
+typedef struct {
+	uint8_t *data;				// caller-provided storage
+	uint32_t elemSize;			// bytes per element
+	uint32_t mask;				// capacity - 1
+	volatile uint32_t windex;	// elements written, free-running
+	volatile uint32_t rindex;	// elements read, free-running
+} ringBuf_t;
+
+// *******************************************************
+// initRingBuf: Attach storage of capacity elements of elemSize
+// bytes and empty the buffer. Returns false if capacity is not
+// a power of two.
+bool
+initRingBuf (ringBuf_t *buffer, void *storage, uint32_t elemSize,
+             uint32_t capacity);
+
+// *******************************************************
+// ringBufCount / ringBufFree: number of stored elements and
+// number of free slots.
+static inline uint32_t
+ringBufCount (const ringBuf_t *buffer)
+{
+	return buffer->windex - buffer->rindex;
+}
+
+static inline uint32_t
+ringBufFree (const ringBuf_t *buffer)
+{
+	return (buffer->mask + 1) - (buffer->windex - buffer->rindex);
+}
+
+// *******************************************************
+// writeRingBuf / readRingBuf: copy one element in or out.
+// Return false if the buffer is full / empty.
+bool
+writeRingBuf (ringBuf_t *buffer, const void *entry);
+
+bool
+readRingBuf (ringBuf_t *buffer, void *entry);
+
+// *******************************************************
+// peekRingBuf: copy the element offset places from the oldest
+// without removing it. Returns false if offset >= count.
+bool
+peekRingBuf (const ringBuf_t *buffer, uint32_t offset, void *entry);
+
+// *******************************************************
+// writeRingBufN / readRingBufN: copy up to n elements as at
+// most two contiguous spans. Return the number copied.
+uint32_t
+writeRingBufN (ringBuf_t *buffer, const void *entries, uint32_t n);
+
+uint32_t
+readRingBufN (ringBuf_t *buffer, void *entries, uint32_t n);
+
+// *******************************************************
+// discardRingBuf: drop up to n of the oldest elements and
+// return the number dropped.
+uint32_t
+discardRingBuf (ringBuf_t *buffer, uint32_t n);
+
+#endif /*RINGBUF_H_*/
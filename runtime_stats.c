@@ -0,0 +1,175 @@
+/******************************************************************************
+ *
+ * runtime_stats.c
+ *
+ * Purpose:
+ * Free-running run-time counter on TIMER2 for the FreeRTOS run-time stats,
+ * and a low-priority task that reports per-task CPU percentage, context
+ * switches and idle time through the deferred log every period.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // System-wide configurations
+#include "priorities.h"      // Task priority definitions
+#include "runtime_stats.h"   // Run-time stats hooks
+#include "log_task.h"        // Deferred log
+#include "stack_monitor.h"   // Stack high-water marks
+#include "mem_pool.h"        // Block pool usage
+#include "plant_id.h"        // Plant identification
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "task.h"            // FreeRTOS task functionalities
+#include "driverlib/timer.h"
+
+// CONSTANTS-------------------------------------------------------------------
+
+/** @brief Stack size (in words) for the stats task. */
+#define STATSTASKSTACKSIZE      128
+
+#define STATS_TIMER_PERIPH      SYSCTL_PERIPH_TIMER2
+#define STATS_TIMER_BASE        TIMER2_BASE
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+volatile uint32_t g_pui32RunTimeSwitches[RUNTIME_STATS_MAX_TASKS];
+
+/** @brief Snapshot buffer, static to keep it off the task stack. */
+static TaskStatus_t g_psTaskStatus[RUNTIME_STATS_MAX_TASKS];
+
+/** @brief Values at the previous report, indexed by task number. */
+static uint32_t g_pui32PrevRunTime[RUNTIME_STATS_MAX_TASKS];
+static uint32_t g_pui32PrevSwitches[RUNTIME_STATS_MAX_TASKS];
+
+/** @brief Statically allocated TCB and stack for the stats task. */
+static StaticTask_t g_xStatsTaskTCB;
+static StackType_t g_pxStatsTaskStack[STATSTASKSTACKSIZE];
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+vRunTimeStatsTimerInit(void)
+{
+    SysCtlPeripheralEnable(STATS_TIMER_PERIPH);
+    while(!SysCtlPeripheralReady(STATS_TIMER_PERIPH))
+    {
+    }
+
+    // Full-width 32-bit up counter at the system clock.
+    TimerConfigure(STATS_TIMER_BASE, TIMER_CFG_PERIODIC_UP);
+    TimerLoadSet(STATS_TIMER_BASE, TIMER_A, 0xFFFFFFFF);
+    TimerEnable(STATS_TIMER_BASE, TIMER_A);
+}
+
+
+uint32_t
+ulRunTimeStatsTimerGet(void)
+{
+    return TimerValueGet(STATS_TIMER_BASE, TIMER_A);
+}
+
+
+/**
+ * @brief Splits part/whole into a whole percentage and tenths.
+ */
+static void
+toPercent(uint32_t ui32Part, uint32_t ui32Whole, uint32_t *pui32Pct,
+          uint32_t *pui32Tenths)
+{
+    // Scale the divisor rather than the dividend so 50 MHz periods of
+    // several seconds cannot overflow 32 bits.
+    uint32_t ui32Permille = ui32Whole >= 1000 ? ui32Part / (ui32Whole / 1000) : 0;
+
+    *pui32Pct = ui32Permille / 10;
+    *pui32Tenths = ui32Permille % 10;
+}
+
+
+/**
+ * @brief FreeRTOS task that logs CPU usage for every task once per period.
+ *
+ * All figures are deltas over the period, so the 32-bit counters wrapping
+ * does not matter as long as the period is well under 86 s.
+ */
+static void
+RunTimeStatsTask(void *pvParameters)
+{
+    portTickType xLastWake = xTaskGetTickCount();
+    uint32_t ui32PrevTotal = ulRunTimeStatsTimerGet();
+    TaskHandle_t xIdle = xTaskGetIdleTaskHandle();
+
+    while(1)
+    {
+        uint32_t ui32Total;
+        uint32_t ui32Period;
+        uint32_t ui32Idle = 0;
+        uint32_t ui32AllSwitches = 0;
+        uint32_t ui32Pct, ui32Tenths;
+        UBaseType_t uxCount, i;
+
+        vTaskDelayUntil(&xLastWake, RUNTIME_STATS_PERIOD_MS / portTICK_RATE_MS);
+
+        uxCount = uxTaskGetSystemState(g_psTaskStatus, RUNTIME_STATS_MAX_TASKS,
+                                       NULL);
+        ui32Total = ulRunTimeStatsTimerGet();
+        ui32Period = ui32Total - ui32PrevTotal;
+        ui32PrevTotal = ui32Total;
+
+        for (i = 0; i < uxCount; i++)
+        {
+            TaskStatus_t *psTask = &g_psTaskStatus[i];
+            UBaseType_t uxNum = psTask->xTaskNumber;
+            uint32_t ui32Run, ui32Switches;
+
+            if (uxNum >= RUNTIME_STATS_MAX_TASKS)
+            {
+                continue;
+            }
+
+            ui32Run = psTask->ulRunTimeCounter - g_pui32PrevRunTime[uxNum];
+            ui32Switches = g_pui32RunTimeSwitches[uxNum] - g_pui32PrevSwitches[uxNum];
+            g_pui32PrevRunTime[uxNum] = psTask->ulRunTimeCounter;
+            g_pui32PrevSwitches[uxNum] += ui32Switches;
+            ui32AllSwitches += ui32Switches;
+
+            if (psTask->xHandle == xIdle)
+            {
+                ui32Idle = ui32Run;
+            }
+
+            toPercent(ui32Run, ui32Period, &ui32Pct, &ui32Tenths);
+            LOG4(LOG_TASK_STATS, psTask->pcTaskName, ui32Pct, ui32Tenths,
+                 ui32Switches);
+        }
+
+        toPercent(ui32Idle, ui32Period, &ui32Pct, &ui32Tenths);
+        LOG4(LOG_CPU_SUMMARY, ui32Pct, ui32Tenths,
+             ui32AllSwitches * 1000 / RUNTIME_STATS_PERIOD_MS,
+             RUNTIME_STATS_PERIOD_MS);
+
+        // The same snapshot carries every task's stack high-water mark.
+        StackMonitorUpdate(g_psTaskStatus, uxCount);
+        MemPoolReport();
+#if PLANT_ID_ENABLE
+        PlantIdReport();
+#endif
+    }
+}
+
+
+uint32_t
+RunTimeStatsTaskInit(void)
+{
+    if (xTaskCreateStatic(RunTimeStatsTask, (const portCHAR *)"Stats",
+                          STATSTASKSTACKSIZE, NULL,
+                          tskIDLE_PRIORITY + PRIORITY_STATS_TASK,
+                          g_pxStatsTaskStack, &g_xStatsTaskTCB) == NULL) {
+        return(1);
+    }
+
+    return(0);
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * runtime_stats.h
+ *
+ * Purpose:
+ * Run-time statistics backend for FreeRTOS and a periodic CPU usage reporter.
+ *
+ * This header is included at the end of FreeRTOSConfig.h, so it must not
+ * include any FreeRTOS header. It maps the kernel's run-time stats hooks
+ * onto a free-running 32-bit timer clocked at the full 50 MHz CPU clock and
+ * counts context switches per task through traceTASK_SWITCHED_IN().
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __RUNTIME_STATS_H__
+#define __RUNTIME_STATS_H__
+
+#include <stdint.h>
+
+/** @brief Highest task number (uxTCBNumber) whose switches are counted. */
+#define RUNTIME_STATS_MAX_TASKS     16
+
+/** @brief Reporting period of the stats task, in ms. */
+#define RUNTIME_STATS_PERIOD_MS     1000
+
+/** @brief Context switches into each task, indexed by task number. */
+extern volatile uint32_t g_pui32RunTimeSwitches[RUNTIME_STATS_MAX_TASKS];
+
+/** @brief Starts the run-time counter timer (called by the kernel). */
+void vRunTimeStatsTimerInit(void);
+
+/** @brief Returns the free-running counter (50 MHz ticks, wraps in ~86 s). */
+uint32_t ulRunTimeStatsTimerGet(void);
+
+/** @brief Creates the periodic reporter task. Returns 0 on success. */
+uint32_t RunTimeStatsTaskInit(void);
+
+// Kernel hooks. runtimeStatsTASK_SWITCHED_IN() is expanded through
+// traceTASK_SWITCHED_IN() in trace_recorder.h, inside tasks.c where
+// pxCurrentTCB is in scope.
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    vRunTimeStatsTimerInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()            ulRunTimeStatsTimerGet()
+#define runtimeStatsTASK_SWITCHED_IN()                                      \
+    do {                                                                    \
+        if (pxCurrentTCB->uxTCBNumber < RUNTIME_STATS_MAX_TASKS)            \
+            g_pui32RunTimeSwitches[pxCurrentTCB->uxTCBNumber]++;            \
+    } while (0)
+
+#endif /* __RUNTIME_STATS_H__ */
@@ -0,0 +1,90 @@
+/******************************************************************************
+ *
+ * stack_monitor.c
+ *
+ * Purpose:
+ * Per-task stack high-water marks and trimmed stack size recommendations,
+ * reported through the deferred log.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include <stdbool.h>
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "task.h"            // FreeRTOS task functionalities
+#include "stack_monitor.h"   // Stack monitor
+#include "log_task.h"        // Deferred log
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+/** @brief Allocated depth in words, indexed by task number. 0 = unknown. */
+static uint32_t g_pui32StackDepth[STACK_MONITOR_MAX_TASKS];
+
+/** @brief Lowest free stack seen in words, indexed by task number. */
+static uint32_t g_pui32StackMinFree[STACK_MONITOR_MAX_TASKS];
+
+static uint32_t g_ui32StackPeriods = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+StackMonitorTaskCreated(uint32_t ui32Number, uint32_t ui32Depth)
+{
+    if (ui32Number < STACK_MONITOR_MAX_TASKS)
+    {
+        g_pui32StackDepth[ui32Number] = ui32Depth;
+        g_pui32StackMinFree[ui32Number] = ui32Depth;
+    }
+}
+
+
+uint32_t
+StackMonitorRecommend(uint32_t ui32Used)
+{
+    uint32_t ui32Words = ui32Used + ui32Used / STACK_MONITOR_MARGIN_DIV +
+                         STACK_MONITOR_MARGIN_WORDS;
+
+    return (ui32Words + 7) & ~7u;
+}
+
+
+void
+StackMonitorUpdate(const TaskStatus_t *psTasks, uint32_t ui32Count)
+{
+    uint32_t i;
+    bool bReport;
+
+    g_ui32StackPeriods++;
+    bReport = (g_ui32StackPeriods % STACK_MONITOR_REPORT_PERIODS) == 0;
+
+    for (i = 0; i < ui32Count; i++)
+    {
+        UBaseType_t uxNum = psTasks[i].xTaskNumber;
+        uint32_t ui32Used;
+
+        if (uxNum >= STACK_MONITOR_MAX_TASKS || g_pui32StackDepth[uxNum] == 0)
+        {
+            continue;
+        }
+
+        // The kernel returns the fewest free words ever seen (the painted
+        // region still intact), so this is already a high-water mark; the
+        // minimum only guards against a task being deleted and recreated.
+        if (psTasks[i].usStackHighWaterMark < g_pui32StackMinFree[uxNum])
+        {
+            g_pui32StackMinFree[uxNum] = psTasks[i].usStackHighWaterMark;
+        }
+
+        if (bReport)
+        {
+            ui32Used = g_pui32StackDepth[uxNum] - g_pui32StackMinFree[uxNum];
+            LOG4(LOG_STACK_REPORT, psTasks[i].pcTaskName, ui32Used,
+                 g_pui32StackDepth[uxNum], StackMonitorRecommend(ui32Used));
+        }
+    }
+}
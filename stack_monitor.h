@@ -0,0 +1,58 @@
+/******************************************************************************
+ *
+ * stack_monitor.h
+ *
+ * Purpose:
+ * Stack high-water-mark tracking and stack size recommendations.
+ *
+ * Every task's stack is painted with a known byte at creation (the kernel
+ * does this whenever INCLUDE_uxTaskGetStackHighWaterMark is set). The stats
+ * task passes each system-state snapshot to StackMonitorUpdate(), which keeps
+ * the lowest free-stack figure seen per task and periodically logs the used
+ * depth against the allocated depth with a recommended size of
+ *
+ *     used + used / STACK_MONITOR_MARGIN_DIV + STACK_MONITOR_MARGIN_WORDS
+ *
+ * rounded up to a multiple of 8 words. The fixed part covers an exception
+ * frame with FPU state (26 words) landing at the deepest point, which a
+ * short measurement run may never have caught.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __STACK_MONITOR_H__
+#define __STACK_MONITOR_H__
+
+#include <stdint.h>
+
+/** @brief Highest task number that is tracked. */
+#define STACK_MONITOR_MAX_TASKS     16
+
+/** @brief Recommendation margin, see above. */
+#define STACK_MONITOR_MARGIN_DIV    4
+#define STACK_MONITOR_MARGIN_WORDS  32
+
+/** @brief A report is logged every this many calls to StackMonitorUpdate(). */
+#define STACK_MONITOR_REPORT_PERIODS 10
+
+/** @brief Records a new task's stack depth in words (kernel hook). */
+void StackMonitorTaskCreated(uint32_t ui32Number, uint32_t ui32Depth);
+
+/**
+ * @brief Folds one uxTaskGetSystemState() snapshot into the high-water marks
+ * and logs the report every STACK_MONITOR_REPORT_PERIODS calls. Takes the
+ * struct tag so this header need not include task.h.
+ */
+struct xTASK_STATUS;
+void StackMonitorUpdate(const struct xTASK_STATUS *psTasks, uint32_t ui32Count);
+
+/** @brief Returns the recommended depth in words for a measured usage. */
+uint32_t StackMonitorRecommend(uint32_t ui32Used);
+
+// Kernel hook, expanded inside tasks.c through traceTASK_CREATE() in
+// trace_recorder.h. Needs configRECORD_STACK_HIGH_ADDRESS for pxEndOfStack.
+#define stackMonitorTASK_CREATE(pxNewTCB)                                   \
+    StackMonitorTaskCreated((pxNewTCB)->uxTCBNumber,                        \
+                            (pxNewTCB)->pxEndOfStack - (pxNewTCB)->pxStack + 1)
+
+#endif /* __STACK_MONITOR_H__ */
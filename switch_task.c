@@ -1,7 +1,8 @@
 //*****************************************************************************
 //
-// switch_task.c - FreeRTOS task to process the button presses and send the
-// relevant information using queues to other tasks to react.
+// switch_task.c - Button polling, run as a software-timer callback on the
+// FreeRTOS timer service task, that sends the new targets using queues to
+// the other tasks to react.
 //
 // By Jamie Thomas - Group 9
 // 12/08/2023
@@ -17,35 +18,58 @@
 #include "driverlib/gpio.h"
 #include "driverlib/rom.h"
 #include "utils/uartstdio.h"
+#include "config.h"
 #include "priorities.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "semphr.h"
+#include "timers.h"
 #include "switch_task.h"
 #include "all_buttons.h"
+#include "log_task.h"
+#include "system_state.h"
+#include "altitude_cal.h"
+#include "control_task.h"
 
 //CONSTANTS--------------------------------------------------------------------
-// The stack size for the switch task.
-#define SWITCHTASKSTACKSIZE        128         // Stack size in words
+// Variables for max step indices for height and yaw
+#define HEIGHTMAXRANGE (HEIGHT_TARGET_MAX / HEIGHT_TARGET_STEP)
+#define YAWMAXRANGE (360 / YAW_TARGET_STEP - 1)
 
-// Variables for max values for height and yaw
-#define HEIGHTMAXRANGE 10
-#define YAWMAXRANGE 23
-
-// Switch task delay variable
-#define SWITCHTASKDELAY 25
+// Button polling period in ms
+#define SWITCHPOLLPERIOD 25
 
 //STATICS AND GLOBALS----------------------------------------------------------
-// Queues and semaphores, externally defined.
-extern xSemaphoreHandle g_pUARTSemaphore;
+// Queues, externally defined.
 extern QueueHandle_t g_TargHeightDisplayQueue;
 extern QueueHandle_t g_TargYawDisplayQueue;
 extern QueueHandle_t g_TargYawControlQueue;
 extern QueueHandle_t g_TargHeightControlQueue;
 
+// Latest filtered altitude ADC reading, from the height task.
+extern uint32_t EXT_VAL;
+
+// The polling timer. Its callback runs on the timer service task, so the
+// buttons no longer need a task and stack of their own.
+static TimerHandle_t g_xSwitchTimer;
+static StaticTimer_t g_xSwitchTimerBuf;
+
+// Previous buttons' states and the target step indices, kept between polls.
+static bool g_bPrevButtonStateUp = false;
+static bool g_bPrevButtonStateRight = false;
+static bool g_bPrevButtonStateDown = false;
+static bool g_bPrevButtonStateLeft = false;
+static uint32_t g_ui32Height = 0;
+static uint32_t g_ui32Yaw = 0;
+
+// Whether Up and Down were both held at the last poll.
+static bool g_bArmChord = false;
+
 //LOCAL FUNCTION PROTOTYPES ---------------------------------------------------
 bool checkButton(bool* prevButtonState, uint8_t buttonNumber);
+static void SwitchSend(QueueHandle_t xQueue, const char *pcName,
+                       int32_t *pi32Value);
+static void SwitchCalibrationPoll(void);
 
 //FUNCTIONS--------------------------------------------------------------------
 //*****************************************************************************
@@ -73,188 +97,195 @@ bool checkButton(
 
 //*****************************************************************************
 //
-// This task reads the buttons' state and passes this information to the
-// control task and display task through the relevant queues.
+// Sends a new target to a display or control queue. Timer callbacks must not
+// block, and spinning here would stop every other timer, so a full queue
+// drops the update and logs it. Each send carries the whole target, so the
+// next press puts the consumer right.
 //
 //*****************************************************************************
 static void
-SwitchTask(void *pvParameters)
+SwitchSend(QueueHandle_t xQueue, const char *pcName, int32_t *pi32Value)
 {
-    // Used for task delay timing
-    portTickType ui16LastTime;
-    uint32_t ui32SwitchDelay = SWITCHTASKDELAY;
-
-    // True when a button is pressed which triggers the queues to be sent.
-    bool buttonPressed = false;
-
-    // Storing previous buttons' states
-    bool ui8PrevButtonStateUp;
-    ui8PrevButtonStateUp = false;
+    if(xQueueSend(xQueue, pi32Value, 0) != pdPASS)
+    {
+        LOG1(LOG_TARGET_DROPPED, pcName);
+    }
+}
 
-    bool ui8PrevButtonStateRight;
-    ui8PrevButtonStateRight = false;
+//*****************************************************************************
+//
+// Button handling during an altitude calibration sweep: Up records the
+// current height as the next point, Down abandons the sweep. Targets are
+// left alone until the sweep ends.
+//
+//*****************************************************************************
+static void
+SwitchCalibrationPoll(void)
+{
+    if(checkButton(&g_bPrevButtonStateUp, UP_BUTTON))
+    {
+        // Saving the table at the last point programs the EEPROM, which
+        // holds up the other timers for a few milliseconds, once.
+        AltitudeCalRecord(EXT_VAL);
+    }
 
-    bool ui8PrevButtonStateDown;
-    ui8PrevButtonStateDown = false;
+    if(checkButton(&g_bPrevButtonStateDown, DOWN_BUTTON))
+    {
+        AltitudeCalAbort();
+    }
 
-    bool ui8PrevButtonStateLeft;
-    ui8PrevButtonStateLeft = false;
+    // Keep the edge detection current for when the sweep ends.
+    checkButton(&g_bPrevButtonStateLeft, LEFT_BUTTON);
+    checkButton(&g_bPrevButtonStateRight, RIGHT_BUTTON);
+}
 
+//*****************************************************************************
+//
+// Timer callback that reads the buttons' state and passes this information
+// to the control task and display task through the relevant queues.
+//
+//*****************************************************************************
+static void
+SwitchPoll(TimerHandle_t xTimer)
+{
+    // True when a button is pressed which triggers the queues to be sent.
+    bool buttonPressed = false;
 
-    // Initialise values for target height and yaw
-    uint32_t ui32Height = 0;
-    uint32_t ui32Yaw = 0;
+    // The height before this poll's steps, restored if they close the chord.
+    uint32_t ui32HeightWas = g_ui32Height;
 
-    // Get the current tick count.
-    ui16LastTime = xTaskGetTickCount();
+    (void)xTimer;
 
-    // Loop forever.
-    while(1)
+    if(AltitudeCalActive())
     {
+        SwitchCalibrationPoll();
+        return;
+    }
 
-        // Up Button.
-        // Check if previous debounced state is equal to the current state.
-        if(checkButton(&ui8PrevButtonStateUp, UP_BUTTON))
-        {
-
-            buttonPressed = true; // Trigger Queues
-
-            // Adjust height value
-            ui32Height += 1;
-            if (ui32Height > HEIGHTMAXRANGE) {
-                ui32Height = HEIGHTMAXRANGE;
-            }
+    // Up Button.
+    // Check if previous debounced state is equal to the current state.
+    if(checkButton(&g_bPrevButtonStateUp, UP_BUTTON))
+    {
 
-            // Guard UART from concurrent access.
-            xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-            UARTprintf("Up Button is pressed.     \n");
-            xSemaphoreGive(g_pUARTSemaphore);
+        buttonPressed = true; // Trigger Queues
 
+        // Adjust height value
+        g_ui32Height += 1;
+        if (g_ui32Height > HEIGHTMAXRANGE) {
+            g_ui32Height = HEIGHTMAXRANGE;
         }
 
-        // Right Button.
-        // Check if previous debounced state is equal to the current state.
-        if(checkButton(&ui8PrevButtonStateRight, RIGHT_BUTTON))
-        {
+        // Deferred to the log task so the UART never stalls polling.
+        LOG1(LOG_BUTTON_PRESSED, "Up");
 
-            buttonPressed = true; // Trigger Queues
+    }
 
-            // Adjust height value
-            ui32Yaw += 1;
-            if (ui32Yaw > YAWMAXRANGE) {
-                ui32Yaw = 0;
-            }
+    // Right Button.
+    // Check if previous debounced state is equal to the current state.
+    if(checkButton(&g_bPrevButtonStateRight, RIGHT_BUTTON))
+    {
 
-            // Guard UART from concurrent access.
-            xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-            UARTprintf("Right Button is pressed.     \n");
-            xSemaphoreGive(g_pUARTSemaphore);
+        buttonPressed = true; // Trigger Queues
 
+        // Adjust yaw value
+        g_ui32Yaw += 1;
+        if (g_ui32Yaw > YAWMAXRANGE) {
+            g_ui32Yaw = 0;
         }
 
-        // Down Button.
-        // Check if previous debounced state is equal to the current state.
-        if(checkButton(&ui8PrevButtonStateDown, DOWN_BUTTON))
-        {
+        // Deferred to the log task so the UART never stalls polling.
+        LOG1(LOG_BUTTON_PRESSED, "Right");
 
-            buttonPressed = true; // Trigger Queues
+    }
 
-            // Adjust height value
-            if (ui32Height > 0) {
-                ui32Height -= 1;
-            }
+    // Down Button.
+    // Check if previous debounced state is equal to the current state.
+    if(checkButton(&g_bPrevButtonStateDown, DOWN_BUTTON))
+    {
 
-            // Guard UART from concurrent access.
-            xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-            UARTprintf("Down Button is pressed.     \n");
-            xSemaphoreGive(g_pUARTSemaphore);
+        buttonPressed = true; // Trigger Queues
 
+        // Adjust height value
+        if (g_ui32Height > 0) {
+            g_ui32Height -= 1;
         }
 
-        // Left Button.
-        // Check if previous debounced state is equal to the current state.
-        if(checkButton(&ui8PrevButtonStateLeft, LEFT_BUTTON))
-        {
+        // Deferred to the log task so the UART never stalls polling.
+        LOG1(LOG_BUTTON_PRESSED, "Down");
 
-            buttonPressed = true; // Trigger Queue
+    }
 
-            // Adjust yaw value
-            if (ui32Yaw > 0) {
-                ui32Yaw -= 1;
-            } else {
-                ui32Yaw = YAWMAXRANGE;
-            }
+    // Left Button.
+    // Check if previous debounced state is equal to the current state.
+    if(checkButton(&g_bPrevButtonStateLeft, LEFT_BUTTON))
+    {
 
-            // Guard UART from concurrent access.
-            xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
-            UARTprintf("Left Button is pressed.     \n");
-            xSemaphoreGive(g_pUARTSemaphore);
+        buttonPressed = true; // Trigger Queue
 
+        // Adjust yaw value
+        if (g_ui32Yaw > 0) {
+            g_ui32Yaw -= 1;
+        } else {
+            g_ui32Yaw = YAWMAXRANGE;
         }
 
+        // Deferred to the log task so the UART never stalls polling.
+        LOG1(LOG_BUTTON_PRESSED, "Left");
 
-        if (buttonPressed) {
-            buttonPressed = false;
-
-            // Pass the value of the new height to the display task.
-            if(xQueueSend(g_TargHeightDisplayQueue, &ui32Height, portMAX_DELAY) !=
-               pdPASS)
-            {
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //UARTprintf("\nQueue full. This should never happen.\n");
-                while(1)
-                {
-                }
-            }
-
-            // Pass the value of the new yaw to the display task.
-            if(xQueueSend(g_TargYawDisplayQueue, &ui32Yaw, portMAX_DELAY) !=
-               pdPASS)
-            {
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //UARTprintf("\nQueue full. This should never happen.\n");
-                while(1)
-                {
-                }
-            }
-
-            // Pass the value of the new height to the display task.
-            if(xQueueSend(g_TargHeightControlQueue, &ui32Height, portMAX_DELAY) !=
-               pdPASS)
-            {
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //UARTprintf("\nQueue full. This should never happen.\n");
-                while(1)
-                {
-                }
-            }
-
-            // Pass the value of the new yaw to the display task.
-            if(xQueueSend(g_TargYawControlQueue, &ui32Yaw, portMAX_DELAY) !=
-               pdPASS)
-            {
-                // Error. The queue should never be full. If so print the
-                // error message on UART and wait for ever.
-                //UARTprintf("\nQueue full. This should never happen.\n");
-                while(1)
-                {
-                }
-            }
+    }
 
+
+    // Left and Right held together while disarmed start an altitude
+    // calibration sweep. Their yaw steps cancel, so the target is unchanged.
+    if(g_bPrevButtonStateLeft && g_bPrevButtonStateRight &&
+       !(SystemStateGet() & SYSTEM_STATE_ARMED))
+    {
+        AltitudeCalBegin();
+    }
+
+    // Up and Down held together arm the motors, once as the chord closes.
+    // The button pressed second steps the height on its own (Down at zero
+    // does nothing, then Up steps to 1), so the steps of the poll closing
+    // the chord are undone and the target the control task checks before
+    // arming is unchanged.
+    bool bArmChord = g_bPrevButtonStateUp && g_bPrevButtonStateDown;
+    if(bArmChord && !g_bArmChord)
+    {
+        g_ui32Height = ui32HeightWas;
+        if(!(SystemStateGet() & SYSTEM_STATE_ARMED))
+        {
+            control_request_arm();
         }
+    }
+    g_bArmChord = bArmChord;
+
+    if (buttonPressed) {
+        // Convert the step indices to the setpoint units the control
+        // task works in. Yaw wraps into -180..179 degrees.
+        int32_t i32Height = g_ui32Height * HEIGHT_TARGET_STEP;
+        int32_t i32Yaw = g_ui32Yaw * YAW_TARGET_STEP;
+        if (i32Yaw >= 180) {
+            i32Yaw -= 360;
+        }
+
+#if POT_SETPOINT_MODE != POT_SETPOINT_HEIGHT
+        // Pass the value of the new height to the display and control tasks.
+        SwitchSend(g_TargHeightDisplayQueue, "Height display", &i32Height);
+        SwitchSend(g_TargHeightControlQueue, "Height control", &i32Height);
+#endif
 
+#if POT_SETPOINT_MODE != POT_SETPOINT_YAW
+        // Pass the value of the new yaw to the display and control tasks.
+        SwitchSend(g_TargYawDisplayQueue, "Yaw display", &i32Yaw);
+        SwitchSend(g_TargYawControlQueue, "Yaw control", &i32Yaw);
+#endif
 
-        // Wait for the required amount of time to check back.
-        vTaskDelayUntil(&ui16LastTime, ui32SwitchDelay / portTICK_RATE_MS);
     }
 }
 
 //*****************************************************************************
 //
-// Initializes the switch task.
+// Initializes the buttons and starts the polling timer.
 //
 //*****************************************************************************
 uint32_t
@@ -268,10 +299,13 @@ SwitchTaskInit(void)
     // Initialize the buttons
     ButtonsInit();
 
-    // Create the switch task.
-    if(xTaskCreate(SwitchTask, (const portCHAR *)"Switch",
-                   SWITCHTASKSTACKSIZE, NULL, tskIDLE_PRIORITY +
-                   PRIORITY_SWITCH_TASK, NULL) != pdTRUE)
+    // Create the polling timer. The start command is queued until the
+    // scheduler starts the timer service task.
+    g_xSwitchTimer = xTimerCreateStatic("Switch",
+                                        SWITCHPOLLPERIOD / portTICK_RATE_MS,
+                                        pdTRUE, NULL, SwitchPoll,
+                                        &g_xSwitchTimerBuf);
+    if(g_xSwitchTimer == NULL || xTimerStart(g_xSwitchTimer, 0) != pdPASS)
     {
         return(1);
     }
@@ -1,6 +1,6 @@
 //*****************************************************************************
 //
-// switch_task.h - Prototypes for the switch task.
+// switch_task.h - Prototypes for the button polling timer.
 //
 //*****************************************************************************
 
@@ -9,7 +9,7 @@
 
 //*****************************************************************************
 //
-// Prototypes for the switch task.
+// Prototypes for the button polling timer.
 //
 //*****************************************************************************
 extern uint32_t SwitchTaskInit(void);
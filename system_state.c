@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ * system_state.c
+ *
+ * Purpose:
+ * Event-group backed system state with per-transition timestamps. See
+ * system_state.h.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "system_state.h"    // System state
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "task.h"            // FreeRTOS task functionalities
+#include "event_groups.h"    // FreeRTOS event group functionalities
+#include "log_task.h"        // Deferred log
+#include "trace_recorder.h"  // TraceStop
+#include "pwm_task.h"        // PWMMotorsOff
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static EventGroupHandle_t g_xStateGroup = NULL;
+static StaticEventGroup_t g_xStateGroupBuf;
+
+/**
+ * @brief Copy of the bits, updated with the group, so SystemStateGet() is a
+ * plain load rather than a scheduler suspend.
+ */
+static volatile EventBits_t g_xStateBits = 0;
+
+/** @brief Tick of the last change of each bit, indexed by bit number. */
+static volatile TickType_t g_pxStateChangedAt[SYSTEM_STATE_NUM_BITS];
+
+static volatile uint32_t g_ui32GroundADC = 0;
+
+/** @brief Bit names for the log, indexed by bit number. */
+static const char * const g_ppcStateNames[SYSTEM_STATE_NUM_BITS] = {
+    "CALIBRATED", "ARMED", "AIRBORNE", "FAULT"
+};
+
+// LOCAL FUNCTION PROTOTYPES---------------------------------------------------
+
+static void stampChanges(EventBits_t xChanged, uint32_t ui32Set);
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Records the time of each changed bit and logs it.
+ */
+static void
+stampChanges(EventBits_t xChanged, uint32_t ui32Set)
+{
+    TickType_t xNow = xTaskGetTickCount();
+    uint32_t i;
+
+    for (i = 0; i < SYSTEM_STATE_NUM_BITS; i++)
+    {
+        if (xChanged & ((EventBits_t)1 << i))
+        {
+            g_pxStateChangedAt[i] = xNow;
+            LOG2(LOG_STATE_CHANGE, g_ppcStateNames[i], ui32Set ? "set" : "cleared");
+        }
+    }
+}
+
+
+uint32_t
+SystemStateInit(void)
+{
+    g_xStateGroup = xEventGroupCreateStatic(&g_xStateGroupBuf);
+    if (g_xStateGroup == NULL)
+    {
+        return(1);
+    }
+
+    return(0);
+}
+
+
+void
+SystemStateSet(EventBits_t xBits)
+{
+    EventBits_t xChanged;
+
+    // Keep the copy, the group and the timestamps in step with any other
+    // task changing the state at the same time.
+    vTaskSuspendAll();
+    xChanged = xBits & ~g_xStateBits;
+    g_xStateBits |= xBits;
+    xEventGroupSetBits(g_xStateGroup, xBits);
+    stampChanges(xChanged, 1);
+    (void)xTaskResumeAll();
+}
+
+
+void
+SystemStateClear(EventBits_t xBits)
+{
+    EventBits_t xChanged;
+
+    vTaskSuspendAll();
+    xChanged = xBits & g_xStateBits;
+    g_xStateBits &= ~xBits;
+    xEventGroupClearBits(g_xStateGroup, xBits);
+    stampChanges(xChanged, 0);
+    (void)xTaskResumeAll();
+}
+
+
+EventBits_t
+SystemStateGet(void)
+{
+    return g_xStateBits;
+}
+
+
+EventBits_t
+SystemStateWait(EventBits_t xBits, TickType_t xTicksToWait)
+{
+    return xEventGroupWaitBits(g_xStateGroup, xBits, pdFALSE, pdTRUE,
+                               xTicksToWait);
+}
+
+
+TickType_t
+SystemStateChangedAt(EventBits_t xBit)
+{
+    uint32_t i;
+
+    for (i = 0; i < SYSTEM_STATE_NUM_BITS; i++)
+    {
+        if (xBit == ((EventBits_t)1 << i))
+        {
+            return g_pxStateChangedAt[i];
+        }
+    }
+
+    return 0;
+}
+
+
+void
+SystemStateFatal(void)
+{
+    // Motors first. The caller spins at its own priority from here on, and
+    // without time slicing the PWM task may never run again to do it.
+    PWMMotorsOff();
+    SystemStateClear(SYSTEM_STATE_ARMED);
+    SystemStateSet(SYSTEM_STATE_FAULT);
+    TraceStop();
+    LogFlush();
+    while(1)
+    {
+    }
+}
+
+
+void
+SystemStateCalibrate(uint32_t ui32GroundADC)
+{
+    // The reference is written before the bit that publishes it.
+    g_ui32GroundADC = ui32GroundADC;
+    SystemStateSet(SYSTEM_STATE_CALIBRATED);
+}
+
+
+uint32_t
+SystemStateGround(void)
+{
+    return g_ui32GroundADC;
+}
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * system_state.h
+ *
+ * Purpose:
+ * System-wide state flags shared by every task, kept in a FreeRTOS event
+ * group, plus the ground reference the height readings are measured from.
+ *
+ * Tasks wait on a state with SystemStateWait() instead of polling their own
+ * copies. Every transition records the tick it happened at and is written to
+ * the log, so the order of events can be read back after a flight.
+ *
+ *   CALIBRATED  the ground reference has been measured from a settled
+ *               window of readings (SystemStateGround)
+ *   ARMED       the operator armed the motors (Up and Down together, on
+ *               the ground with a zero height target); motors may run.
+ *               Cleared on landing with a zero target and on a fault
+ *   AIRBORNE    the measured height is clear of the ground
+ *   FAULT       a task hit a fatal error (SystemStateFatal)
+ *
+ * Set, clear and wait must be called from tasks (or timer callbacks), not
+ * ISRs. SystemStateGet() and SystemStateGround() are safe anywhere.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __SYSTEM_STATE_H__
+#define __SYSTEM_STATE_H__
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "event_groups.h"
+
+/** @brief State bits. */
+#define SYSTEM_STATE_CALIBRATED     ((EventBits_t)0x01)
+#define SYSTEM_STATE_ARMED          ((EventBits_t)0x02)
+#define SYSTEM_STATE_AIRBORNE       ((EventBits_t)0x04)
+#define SYSTEM_STATE_FAULT          ((EventBits_t)0x08)
+#define SYSTEM_STATE_NUM_BITS       4
+
+/** @brief Creates the event group. Returns 0 on success. */
+uint32_t SystemStateInit(void);
+
+/** @brief Sets state bits, timestamping and logging any that change. */
+void SystemStateSet(EventBits_t xBits);
+
+/** @brief Clears state bits, timestamping and logging any that change. */
+void SystemStateClear(EventBits_t xBits);
+
+/** @brief Returns the current state bits without blocking. */
+EventBits_t SystemStateGet(void);
+
+/**
+ * @brief Blocks until all of xBits are set or xTicksToWait expires. Returns
+ * the state bits at the time it returned.
+ */
+EventBits_t SystemStateWait(EventBits_t xBits, TickType_t xTicksToWait);
+
+/** @brief Tick at which the given single bit last changed, 0 if never. */
+TickType_t SystemStateChangedAt(EventBits_t xBit);
+
+/**
+ * @brief Fatal error: turns the motors off, clears ARMED, sets FAULT,
+ * freezes the trace, flushes the log and spins. Log the cause first.
+ */
+void SystemStateFatal(void);
+
+/** @brief Stores the ground reference ADC value and sets CALIBRATED. */
+void SystemStateCalibrate(uint32_t ui32GroundADC);
+
+/** @brief The ground reference ADC value. Only valid once CALIBRATED. */
+uint32_t SystemStateGround(void);
+
+#endif /* __SYSTEM_STATE_H__ */
@@ -0,0 +1,243 @@
+/******************************************************************************
+ *
+ * telemetry.c
+ *
+ * Purpose:
+ * Delta/zig-zag varint encoding of control-loop telemetry and its transport
+ * to UART0. Each encoded frame is copied into a block of the smallest
+ * mem_pool.h class that fits, and the block is queued for the log task,
+ * which writes it out and frees it.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // System-wide configurations
+#include "telemetry.h"       // Telemetry encoder
+#include "mem_pool.h"        // Block pools
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities
+#include "queue.h"           // FreeRTOS queue functionalities
+
+// CONSTANTS-------------------------------------------------------------------
+
+/**
+ * @brief Frames that can wait for the log task. Matches the 16 and 32 byte
+ * pool classes, which hold the deltas and the keyframes; the pools, not the
+ * queue, run out first.
+ */
+#define TELEMETRY_QUEUE_LENGTH  24
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+#if TELEMETRY_ENABLE
+static QueueHandle_t g_telemetryQueue = NULL;
+static StaticQueue_t g_telemetryQueueStruct;
+static uint8_t *g_ppui8TelemetryStorage[TELEMETRY_QUEUE_LENGTH];
+static telemetryEncoder_t g_telemetryEncoder;
+#endif
+
+/** @brief Records dropped because no pool block or queue slot was free. */
+volatile uint32_t g_ui32TelemetryDropped = 0;
+
+// LOCAL FUNCTION PROTOTYPES---------------------------------------------------
+
+static uint8_t *putVarint(uint8_t *pui8Out, uint32_t ui32Value);
+static uint32_t zigzag(int32_t i32Value);
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Writes ui32Value as an LEB128 varint and returns the new end.
+ */
+static uint8_t *
+putVarint(uint8_t *pui8Out, uint32_t ui32Value)
+{
+    while (ui32Value >= 0x80)
+    {
+        *pui8Out++ = (uint8_t)(ui32Value | 0x80);
+        ui32Value >>= 7;
+    }
+    *pui8Out++ = (uint8_t)ui32Value;
+    return pui8Out;
+}
+
+/**
+ * @brief Maps signed values to unsigned so small magnitudes stay small.
+ */
+static uint32_t
+zigzag(int32_t i32Value)
+{
+    return ((uint32_t)i32Value << 1) ^ (uint32_t)(i32Value >> 31);
+}
+
+
+void
+TelemetryEncoderReset(telemetryEncoder_t *psEnc)
+{
+    uint32_t i;
+
+    psEnc->ui32PrevTick = 0;
+    for (i = 0; i < TELEMETRY_NUM_CHANNELS; i++)
+    {
+        psEnc->pi32Prev[i] = 0;
+    }
+    psEnc->ui32SinceKeyframe = 0;
+    psEnc->ui8Seq = 0;
+    psEnc->bNeedKeyframe = true;
+}
+
+
+uint32_t
+TelemetryEncode(telemetryEncoder_t *psEnc, const telemetryRecord_t *psRec,
+                uint8_t *pui8Out)
+{
+    uint8_t *pui8End = pui8Out;
+    uint32_t i;
+
+    if (psEnc->bNeedKeyframe ||
+        psEnc->ui32SinceKeyframe >= TELEMETRY_KEYFRAME_INTERVAL)
+    {
+        uint8_t ui8Sum = 0;
+        uint8_t *pui8Sum;
+
+        *pui8End++ = TELEMETRY_KEYFRAME_TAG;
+        pui8Sum = pui8End;
+        *pui8End++ = psEnc->ui8Seq;
+        pui8End = putVarint(pui8End, psRec->ui32Tick);
+        for (i = 0; i < TELEMETRY_NUM_CHANNELS; i++)
+        {
+            pui8End = putVarint(pui8End, zigzag(psRec->pi32Values[i]));
+        }
+
+        // Checksum covers everything after the tag.
+        while (pui8Sum < pui8End)
+        {
+            ui8Sum += *pui8Sum++;
+        }
+        *pui8End++ = ui8Sum;
+
+        psEnc->ui32SinceKeyframe = 0;
+        psEnc->bNeedKeyframe = false;
+    }
+    else
+    {
+        uint8_t *pui8Tag = pui8End++;
+        uint8_t ui8Mask = 0;
+
+        pui8End = putVarint(pui8End, psRec->ui32Tick - psEnc->ui32PrevTick);
+        for (i = 0; i < TELEMETRY_NUM_CHANNELS; i++)
+        {
+            int32_t i32Delta = psRec->pi32Values[i] - psEnc->pi32Prev[i];
+
+            if (i32Delta != 0)
+            {
+                ui8Mask |= 1 << i;
+                pui8End = putVarint(pui8End, zigzag(i32Delta));
+            }
+        }
+        *pui8Tag = TELEMETRY_DELTA_TAG | ui8Mask;
+
+        psEnc->ui32SinceKeyframe++;
+    }
+
+    psEnc->ui32PrevTick = psRec->ui32Tick;
+    for (i = 0; i < TELEMETRY_NUM_CHANNELS; i++)
+    {
+        psEnc->pi32Prev[i] = psRec->pi32Values[i];
+    }
+    psEnc->ui8Seq++;
+
+    return pui8End - pui8Out;
+}
+
+
+uint32_t
+TelemetryInit(void)
+{
+#if TELEMETRY_ENABLE
+    TelemetryEncoderReset(&g_telemetryEncoder);
+
+    g_telemetryQueue = xQueueCreateStatic(TELEMETRY_QUEUE_LENGTH,
+                                          sizeof(uint8_t *),
+                                          (uint8_t *)g_ppui8TelemetryStorage,
+                                          &g_telemetryQueueStruct);
+    if (g_telemetryQueue == NULL)
+    {
+        return(1);
+    }
+#endif
+
+    return(0);
+}
+
+
+void
+TelemetryPush(const telemetryRecord_t *psRec)
+{
+#if TELEMETRY_ENABLE
+    uint8_t pui8Frame[TELEMETRY_MAX_RECORD_SIZE];
+    uint8_t *pui8Block;
+    uint32_t ui32Len;
+    uint32_t i;
+
+    if (g_telemetryQueue == NULL)
+    {
+        return;
+    }
+
+    // Encoded first so the block can be no bigger than the frame needs.
+    ui32Len = TelemetryEncode(&g_telemetryEncoder, psRec, pui8Frame);
+    pui8Block = MemPoolAlloc(ui32Len + 1);
+    if (pui8Block != NULL)
+    {
+        pui8Block[0] = (uint8_t)ui32Len;
+        for (i = 0; i < ui32Len; i++)
+        {
+            pui8Block[i + 1] = pui8Frame[i];
+        }
+        if (xQueueSend(g_telemetryQueue, &pui8Block, 0) != pdPASS)
+        {
+            MemPoolFree(pui8Block);
+            pui8Block = NULL;
+        }
+    }
+
+    if (pui8Block == NULL)
+    {
+        // The host would decode the next delta against this lost record.
+        g_telemetryEncoder.bNeedKeyframe = true;
+        g_ui32TelemetryDropped++;
+    }
+#else
+    (void)psRec;
+#endif
+}
+
+
+void
+TelemetryFlush(void)
+{
+#if TELEMETRY_ENABLE
+    uint8_t *pui8Block;
+    uint32_t i;
+
+    if (g_telemetryQueue == NULL)
+    {
+        return;
+    }
+
+    while (xQueueReceive(g_telemetryQueue, &pui8Block, 0) == pdPASS)
+    {
+        // Raw bytes: UARTwrite would expand 0x0A to CR LF inside a frame.
+        for (i = 1; i <= pui8Block[0]; i++)
+        {
+            UARTCharPut(UART0_BASE, pui8Block[i]);
+        }
+        MemPoolFree(pui8Block);
+    }
+#endif
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ * telemetry.h
+ *
+ * Purpose:
+ * Streaming delta/varint encoder for control-loop telemetry records.
+ *
+ * Each record holds the control state for one cycle. Successive records are
+ * delta encoded per channel with zig-zag varints, so a slowly changing
+ * record costs only a few bytes. A self-contained keyframe is emitted every
+ * TELEMETRY_KEYFRAME_INTERVAL records (and after any dropped record) so a
+ * host can join the stream at any point. tools/telemetry_decode.py is the
+ * matching host decoder.
+ *
+ * Wire format (all multi-byte values are LEB128 varints):
+ *   keyframe: 0xA5, seq (u8), tick, 6 x zigzag(value), checksum (u8)
+ *   delta:    0xC0 | changed-channel mask, tick delta,
+ *             zigzag(delta) for each channel whose mask bit is set
+ * Text from the log task is interleaved as whole lines; every line starts
+ * with a byte below 0x80 so the decoder can tell it apart from a record.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Data channels carried in each record, in wire order. */
+enum {
+    TELEMETRY_HEIGHT_ADC = 0,
+    TELEMETRY_YAW,
+    TELEMETRY_MAIN_DUTY,
+    TELEMETRY_TAIL_DUTY,
+    TELEMETRY_TARG_HEIGHT,
+    TELEMETRY_TARG_YAW,
+    TELEMETRY_NUM_CHANNELS
+};
+
+#define TELEMETRY_KEYFRAME_TAG        0xA5
+#define TELEMETRY_DELTA_TAG           0xC0
+#define TELEMETRY_KEYFRAME_INTERVAL   64
+
+/** @brief Worst case encoded size of one record in bytes. */
+#define TELEMETRY_MAX_RECORD_SIZE     (3 + 5 * (TELEMETRY_NUM_CHANNELS + 1))
+
+/** @brief One control-cycle sample. */
+typedef struct {
+    uint32_t ui32Tick;
+    int32_t pi32Values[TELEMETRY_NUM_CHANNELS];
+} telemetryRecord_t;
+
+/** @brief Per-stream encoder state. */
+typedef struct {
+    uint32_t ui32PrevTick;
+    int32_t pi32Prev[TELEMETRY_NUM_CHANNELS];
+    uint32_t ui32SinceKeyframe;
+    uint8_t ui8Seq;
+    bool bNeedKeyframe;
+} telemetryEncoder_t;
+
+/** @brief Resets an encoder so its next record is a keyframe. */
+void TelemetryEncoderReset(telemetryEncoder_t *psEnc);
+
+/**
+ * @brief Encodes one record into pui8Out (at least TELEMETRY_MAX_RECORD_SIZE
+ * bytes) and returns the number of bytes written.
+ */
+uint32_t TelemetryEncode(telemetryEncoder_t *psEnc,
+                         const telemetryRecord_t *psRec, uint8_t *pui8Out);
+
+/** @brief Records dropped because no pool block or queue slot was free. The
+ * log task reports the count as it grows. */
+extern volatile uint32_t g_ui32TelemetryDropped;
+
+/**
+ * @brief Creates the queue of frames for the log task. Returns 0 on success.
+ * Call after MemPoolInit(). With TELEMETRY_ENABLE at 0 there is no queue and
+ * this does nothing.
+ */
+uint32_t TelemetryInit(void);
+
+/**
+ * @brief Encodes a record into a pool block and queues it for transmission
+ * without blocking. If no block or queue slot is free the record is dropped and the next one is sent as a
+ * keyframe so the host never decodes against a missing delta.
+ */
+void TelemetryPush(const telemetryRecord_t *psRec);
+
+/**
+ * @brief Sends every queued record to UART0 and frees its block. Called by the log task with
+ * the UART mutex held so records and text lines never interleave mid-frame.
+ */
+void TelemetryFlush(void);
+
+#endif /* __TELEMETRY_H__ */
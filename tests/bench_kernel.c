@@ -0,0 +1,364 @@
+/******************************************************************************
+ *
+ * bench_kernel.c
+ *
+ * Purpose:
+ * Host port of the kernel primitive benchmark in kernel_bench.c. Runs the
+ * uncontended cases, and a receive woken from its event list, against the
+ * firmware's FreeRTOSConfig.h and prints the same CSV columns, in ns per
+ * operation instead of cycles, so tools/bench_compare.py can track a host
+ * baseline between board runs:
+ *
+ *   make -C tests bench > host.csv
+ *   python3 tools/bench_compare.py --threshold 30 baseline.csv host.csv
+ *
+ * A shared host is noisier than the board, hence the looser threshold.
+ * There is only one host task, so contention costs (context switches, a
+ * blocked receiver running) are only measured on the target.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host_kernel.h"
+#include "tiva.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define BENCH_SAMPLES           1000
+#define BENCH_BATCH             256     // Operations timed per sample
+#define BENCH_ITEM_BYTES        16
+#define BENCH_QUEUE_LENGTH      4
+#define BENCH_STREAM_SIZE       64
+#define BENCH_EVENT_BIT         0x01
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static uint32_t g_pui32Samples[BENCH_SAMPLES];
+static int64_t g_i64Start;
+
+static QueueHandle_t g_xQueue;
+static SemaphoreHandle_t g_xSemaphore;
+static SemaphoreHandle_t g_xMutex;
+static EventGroupHandle_t g_xEvent;
+static StreamBufferHandle_t g_xStream;
+static MessageBufferHandle_t g_xMessage;
+
+static StaticQueue_t g_xQueueBuf;
+static uint32_t g_pui32QueueStorage[BENCH_QUEUE_LENGTH];
+static StaticSemaphore_t g_xSemaphoreBuf, g_xMutexBuf;
+static StaticEventGroup_t g_xEventBuf;
+static StaticStreamBuffer_t g_xStreamBuf, g_xMessageBuf;
+static uint8_t g_pui8StreamStorage[BENCH_STREAM_SIZE + 1];
+static uint8_t g_pui8MessageStorage[BENCH_STREAM_SIZE + 1];
+
+static uint8_t g_pui8Item[BENCH_ITEM_BYTES];
+static uint32_t g_pui32Batch[BENCH_QUEUE_LENGTH];
+static uint32_t g_ui32Errors = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+static int64_t
+nowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (int64_t)sNow.tv_sec * 1000000000 + sNow.tv_nsec;
+}
+
+
+static void
+start(void)
+{
+    g_i64Start = nowNs();
+}
+
+
+/** @brief Stores the time since start() per operation, in ns. */
+static void
+sample(uint32_t i, uint32_t ui32Ops)
+{
+    g_pui32Samples[i] = (uint32_t)((nowNs() - g_i64Start + ui32Ops / 2) / ui32Ops);
+}
+
+
+static int
+compareSamples(const void *pvA, const void *pvB)
+{
+    uint32_t ui32A = *(const uint32_t *)pvA, ui32B = *(const uint32_t *)pvB;
+
+    return ui32A < ui32B ? -1 : ui32A > ui32B;
+}
+
+
+static void
+report(const char *pcPrimitive, const char *pcCase)
+{
+    uint64_t ui64Sum = 0;
+    uint32_t i;
+
+    qsort(g_pui32Samples, BENCH_SAMPLES, sizeof(g_pui32Samples[0]),
+          compareSamples);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        ui64Sum += g_pui32Samples[i];
+    }
+
+    printf("%s,%s,%u,%u,%u,%u,%u,%u\n", pcPrimitive, pcCase, BENCH_SAMPLES,
+           g_pui32Samples[0], g_pui32Samples[BENCH_SAMPLES / 2],
+           g_pui32Samples[BENCH_SAMPLES * 99 / 100],
+           g_pui32Samples[BENCH_SAMPLES - 1],
+           (uint32_t)(ui64Sum / BENCH_SAMPLES));
+}
+
+
+/** @brief Runs inside a receive that has blocked: the send that wakes it. */
+static void
+wakeQueue(void)
+{
+    uint32_t ui32Item = 1;
+
+    xQueueSend(g_xQueue, &ui32Item, 0);
+}
+
+
+static void
+wakeSemaphore(void)
+{
+    xSemaphoreGive(g_xSemaphore);
+}
+
+
+/**
+ * @brief Times ui32Ops receives that block and are woken by pfnWake from the
+ * block hook, less the same receives when the item is already there.
+ */
+static uint32_t
+timeWake(void (*pfnWake)(void), BaseType_t (*pfnTake)(void), uint32_t ui32Ops)
+{
+    int64_t i64Blocked, i64Ready;
+    uint32_t j;
+
+    i64Blocked = nowNs();
+    for (j = 0; j < ui32Ops; j++)
+    {
+        HostOnNextBlock(pfnWake);
+        g_ui32Errors += pfnTake() != pdPASS;
+    }
+    i64Ready = nowNs();
+    i64Blocked = i64Ready - i64Blocked;
+    for (j = 0; j < ui32Ops; j++)
+    {
+        pfnWake();
+        g_ui32Errors += pfnTake() != pdPASS;
+    }
+    i64Ready = nowNs() - i64Ready;
+
+    // Clock noise can make the difference negative in a quiet sample.
+    return i64Blocked > i64Ready ?
+           (uint32_t)((i64Blocked - i64Ready + ui32Ops / 2) / ui32Ops) : 0;
+}
+
+
+static BaseType_t
+takeQueue(void)
+{
+    uint32_t ui32Item;
+
+    return xQueueReceive(g_xQueue, &ui32Item, 10);
+}
+
+
+static BaseType_t
+takeSemaphore(void)
+{
+    return xSemaphoreTake(g_xSemaphore, 10);
+}
+
+
+int
+main(void)
+{
+    uint32_t ui32Item = 0;
+    uint32_t i, j;
+
+    HostKernelReset();
+    TivaReset();
+
+    g_xQueue = xQueueCreateStatic(BENCH_QUEUE_LENGTH, sizeof(uint32_t),
+                                  (uint8_t *)g_pui32QueueStorage, &g_xQueueBuf);
+    g_xSemaphore = xSemaphoreCreateBinaryStatic(&g_xSemaphoreBuf);
+    g_xMutex = xSemaphoreCreateMutexStatic(&g_xMutexBuf);
+    g_xEvent = xEventGroupCreateStatic(&g_xEventBuf);
+    g_xStream = xStreamBufferCreateStatic(BENCH_STREAM_SIZE, 1,
+                                          g_pui8StreamStorage, &g_xStreamBuf);
+    g_xMessage = xMessageBufferCreateStatic(BENCH_STREAM_SIZE,
+                                            g_pui8MessageStorage,
+                                            &g_xMessageBuf);
+
+    printf("# kernel_bench host unit=ns batch=%u run_time_stats=%u "
+           "stack_check=%u\n", BENCH_BATCH, configGENERATE_RUN_TIME_STATS,
+           configCHECK_FOR_STACK_OVERFLOW);
+    printf("primitive,case,samples,min,median,p99,max,mean\n");
+
+    // Send and receive are timed together and halved: the host clock is
+    // too coarse to split them one call at a time.
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xQueueSend(g_xQueue, &ui32Item, 0);
+            xQueueReceive(g_xQueue, &ui32Item, 0);
+        }
+        sample(i, 2 * BENCH_BATCH);
+    }
+    report("queue", "send_receive");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            uint32_t k;
+
+            for (k = 0; k < BENCH_QUEUE_LENGTH; k++)
+            {
+                xQueueSend(g_xQueue, &g_pui32Batch[k], 0);
+            }
+            for (k = 0; k < BENCH_QUEUE_LENGTH; k++)
+            {
+                xQueueReceive(g_xQueue, &g_pui32Batch[k], 0);
+            }
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("queue", "send_receive_x4");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            g_ui32Errors += xQueueSendMultiple(g_xQueue, g_pui32Batch,
+                                               BENCH_QUEUE_LENGTH, 0) != BENCH_QUEUE_LENGTH;
+            g_ui32Errors += xQueueReceiveMultiple(g_xQueue, g_pui32Batch,
+                                                  BENCH_QUEUE_LENGTH, 0) != BENCH_QUEUE_LENGTH;
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("queue", "send_receive_multiple_x4");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xSemaphoreGive(g_xSemaphore);
+            xSemaphoreTake(g_xSemaphore, 0);
+        }
+        sample(i, 2 * BENCH_BATCH);
+    }
+    report("semaphore", "give_take");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xSemaphoreTake(g_xMutex, 0);
+            xSemaphoreGive(g_xMutex);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("mutex", "take_give");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("notify", "give_take");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xEventGroupSetBits(g_xEvent, BENCH_EVENT_BIT);
+            xEventGroupWaitBits(g_xEvent, BENCH_EVENT_BIT, pdTRUE, pdFALSE, 0);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("event_group", "set_wait");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xStreamBufferSend(g_xStream, g_pui8Item, BENCH_ITEM_BYTES, 0);
+            g_ui32Errors += xStreamBufferReceive(g_xStream, g_pui8Item,
+                                                 BENCH_ITEM_BYTES, 0) != BENCH_ITEM_BYTES;
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("stream_buffer", "send_receive_16");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            xMessageBufferSend(g_xMessage, g_pui8Item, BENCH_ITEM_BYTES, 0);
+            g_ui32Errors += xMessageBufferReceive(g_xMessage, g_pui8Item,
+                                                  BENCH_ITEM_BYTES, 0) != BENCH_ITEM_BYTES;
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("message_buffer", "send_receive_16");
+
+    // A receive that blocks on the object and is woken by a send or give:
+    // the extra cost of the trip through the event list, over a receive
+    // that finds the item already there.
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        g_pui32Samples[i] = timeWake(wakeQueue, takeQueue, BENCH_BATCH);
+    }
+    report("queue", "wake");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        g_pui32Samples[i] = timeWake(wakeSemaphore, takeSemaphore, BENCH_BATCH);
+    }
+    report("semaphore", "wake");
+
+    if (g_ui32Errors != 0 || HostCriticalNesting() != 0 ||
+        g_ui32HostWakeups != 2 * BENCH_SAMPLES * BENCH_BATCH)
+    {
+        printf("# FAILED: %u errors, %u wake-ups\n", g_ui32Errors,
+               g_ui32HostWakeups);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/******************************************************************************
+ *
+ * bench_mem_pool.c
+ *
+ * Purpose:
+ * Host benchmark of the mem_pool.h block pools against heap_4, the general
+ * allocator the firmware used before every object became static. heap_4 is
+ * built here from the kernel's own source (host/heap_4.c, unchanged) with
+ * the 10 KB heap the firmware had, and does not go into the firmware.
+ *
+ * Each case times an allocate and the matching free, per pair, in the same
+ * CSV columns as bench_kernel.c:
+ *  - empty:      nothing else allocated.
+ *  - fragmented: the heap has been cut into many small free holes by
+ *                freeing every other block of a run, so heap_4 walks its
+ *                free list to find room for a larger block. The pools also
+ *                have blocks live, which makes no difference to them.
+ * The worst case, not the median, is what matters in the control loop.
+ *
+ *   make -C tests bench
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "host_kernel.h"
+#include "tiva.h"
+#include "FreeRTOS.h"
+#include "mem_pool.h"
+
+// The firmware's heap before static allocation, for heap_4 alone.
+#undef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configTOTAL_HEAP_SIZE               10240
+#include "heap_4.c"
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define BENCH_SAMPLES           1000
+#define BENCH_BATCH             256     // Pairs timed per sample
+#define BENCH_HOLES             64      // Free holes left in the heap
+#define BENCH_HOLE_SIZE         16
+#define BENCH_POOL_LIVE         8       // Half the 16 byte class
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static uint32_t g_pui32Samples[BENCH_SAMPLES];
+static int64_t g_i64Start;
+static void *g_ppvLive[2 * BENCH_HOLES];
+static void *g_ppvPoolLive[BENCH_POOL_LIVE];
+static uint32_t g_ui32Errors = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+static int64_t
+nowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (int64_t)sNow.tv_sec * 1000000000 + sNow.tv_nsec;
+}
+
+
+static void
+start(void)
+{
+    g_i64Start = nowNs();
+}
+
+
+/** @brief Stores the time since start() per operation, in ns. */
+static void
+sample(uint32_t i, uint32_t ui32Ops)
+{
+    g_pui32Samples[i] = (uint32_t)((nowNs() - g_i64Start + ui32Ops / 2) / ui32Ops);
+}
+
+
+static int
+compareSamples(const void *pvA, const void *pvB)
+{
+    uint32_t ui32A = *(const uint32_t *)pvA, ui32B = *(const uint32_t *)pvB;
+
+    return ui32A < ui32B ? -1 : ui32A > ui32B;
+}
+
+
+static void
+report(const char *pcPrimitive, const char *pcCase)
+{
+    uint64_t ui64Sum = 0;
+    uint32_t i;
+
+    qsort(g_pui32Samples, BENCH_SAMPLES, sizeof(g_pui32Samples[0]),
+          compareSamples);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        ui64Sum += g_pui32Samples[i];
+    }
+
+    printf("%s,%s,%u,%u,%u,%u,%u,%u\n", pcPrimitive, pcCase, BENCH_SAMPLES,
+           g_pui32Samples[0], g_pui32Samples[BENCH_SAMPLES / 2],
+           g_pui32Samples[BENCH_SAMPLES * 99 / 100],
+           g_pui32Samples[BENCH_SAMPLES - 1],
+           (uint32_t)(ui64Sum / BENCH_SAMPLES));
+}
+
+
+/** @brief Times an allocate and free of ui32Size bytes from the pools. */
+static void
+timePool(const char *pcCase, size_t ui32Size)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            void *pvBlock = MemPoolAlloc(ui32Size);
+
+            g_ui32Errors += pvBlock == NULL;
+            MemPoolFree(pvBlock);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("mem_pool", pcCase);
+}
+
+
+/** @brief Times an allocate and free of ui32Size bytes from heap_4. */
+static void
+timeHeap(const char *pcCase, size_t ui32Size)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            void *pvBlock = pvPortMalloc(ui32Size);
+
+            g_ui32Errors += pvBlock == NULL;
+            vPortFree(pvBlock);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    report("heap_4", pcCase);
+}
+
+
+/**
+ * @brief Allocates a run of small blocks from heap_4 and frees every other
+ * one, leaving BENCH_HOLES holes too small for anything bigger.
+ */
+static void
+fragment(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2 * BENCH_HOLES; i++)
+    {
+        g_ppvLive[i] = pvPortMalloc(BENCH_HOLE_SIZE);
+        g_ui32Errors += g_ppvLive[i] == NULL;
+    }
+    for (i = 0; i < 2 * BENCH_HOLES; i += 2)
+    {
+        vPortFree(g_ppvLive[i]);
+        g_ppvLive[i] = NULL;
+    }
+}
+
+
+static void
+release(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2 * BENCH_HOLES; i++)
+    {
+        vPortFree(g_ppvLive[i]);
+        g_ppvLive[i] = NULL;
+    }
+}
+
+
+int
+main(void)
+{
+    static const size_t pui32Sizes[] = { 16, 32, 64, 128 };
+    static const char * const ppcEmpty[] = {
+        "alloc_free_16", "alloc_free_32", "alloc_free_64", "alloc_free_128"
+    };
+    static const char * const ppcFragmented[] = {
+        "alloc_free_16_fragmented", "alloc_free_32_fragmented",
+        "alloc_free_64_fragmented", "alloc_free_128_fragmented"
+    };
+    uint32_t i;
+
+    HostKernelReset();
+    TivaReset();
+    MemPoolInit();
+
+    printf("# mem_pool_bench host unit=ns batch=%u heap=%u holes=%u\n",
+           BENCH_BATCH, configTOTAL_HEAP_SIZE, BENCH_HOLES);
+    printf("primitive,case,samples,min,median,p99,max,mean\n");
+
+    for (i = 0; i < 4; i++)
+    {
+        timePool(ppcEmpty[i], pui32Sizes[i]);
+        timeHeap(ppcEmpty[i], pui32Sizes[i]);
+    }
+
+    // The 16 byte class has too few blocks for the heap's pattern, so the
+    // pools just keep some live; what they hold makes no difference to them.
+    for (i = 0; i < BENCH_POOL_LIVE; i++)
+    {
+        g_ppvPoolLive[i] = MemPoolAlloc(BENCH_HOLE_SIZE);
+        g_ui32Errors += g_ppvPoolLive[i] == NULL;
+    }
+    fragment();
+    for (i = 0; i < 4; i++)
+    {
+        timePool(ppcFragmented[i], pui32Sizes[i]);
+        timeHeap(ppcFragmented[i], pui32Sizes[i]);
+    }
+    release();
+    for (i = 0; i < BENCH_POOL_LIVE; i++)
+    {
+        MemPoolFree(g_ppvPoolLive[i]);
+    }
+
+    if (g_ui32Errors != 0 || HostCriticalNesting() != 0)
+    {
+        printf("# FAILED: %u errors\n", g_ui32Errors);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+ *
+ * bench_ring_buf.c
+ *
+ * Purpose:
+ * Host micro-benchmark of the ring buffer against circBufT, the course
+ * buffer it replaced in the firmware. circBufT is no longer built into the
+ * firmware; its unchanged source is kept in host/ for this comparison only.
+ *
+ * Each case moves BENCH_BLOCK uint32_t samples through a buffer of the same
+ * capacity and back out, the pattern of the ADC averaging windows, and
+ * prints ns per sample in the CSV columns of bench_kernel.c:
+ *  - circbuf:  writeCircBuf() / readCircBuf(), one sample per call, no
+ *              full or empty checks.
+ *  - ringbuf:  writeRingBuf() / readRingBuf(), one checked copy per call.
+ *  - ringbuf:  writeRingBufN() / readRingBufN(), at most two spans.
+ *
+ *   make -C tests bench
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+// Both built into this file, so neither gets the call overhead the other
+// does not.
+#include "ringBuf.c"
+#include "circBufT.c"
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define BENCH_SAMPLES           1000
+#define BENCH_BATCH             64      // Blocks timed per sample
+#define BENCH_CAPACITY          16
+#define BENCH_BLOCK             10      // Not a divisor of the capacity, so
+                                        // the spans keep moving across the wrap
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static uint32_t g_pui32Samples[BENCH_SAMPLES];
+static int64_t g_i64Start;
+static uint32_t g_pui32In[BENCH_BLOCK];
+static uint32_t g_pui32Out[BENCH_BLOCK];
+static uint32_t g_pui32Storage[BENCH_CAPACITY];
+static uint32_t g_ui32Errors = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+static int64_t
+nowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (int64_t)sNow.tv_sec * 1000000000 + sNow.tv_nsec;
+}
+
+
+static void
+start(void)
+{
+    g_i64Start = nowNs();
+}
+
+
+/** @brief Stores the time since start() per operation, in ns. */
+static void
+sample(uint32_t i, uint32_t ui32Ops)
+{
+    g_pui32Samples[i] = (uint32_t)((nowNs() - g_i64Start + ui32Ops / 2) / ui32Ops);
+}
+
+
+static int
+compareSamples(const void *pvA, const void *pvB)
+{
+    uint32_t ui32A = *(const uint32_t *)pvA, ui32B = *(const uint32_t *)pvB;
+
+    return ui32A < ui32B ? -1 : ui32A > ui32B;
+}
+
+
+static void
+report(const char *pcPrimitive, const char *pcCase)
+{
+    uint64_t ui64Sum = 0;
+    uint32_t i;
+
+    qsort(g_pui32Samples, BENCH_SAMPLES, sizeof(g_pui32Samples[0]),
+          compareSamples);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        ui64Sum += g_pui32Samples[i];
+    }
+
+    printf("%s,%s,%u,%u,%u,%u,%u,%u\n", pcPrimitive, pcCase, BENCH_SAMPLES,
+           g_pui32Samples[0], g_pui32Samples[BENCH_SAMPLES / 2],
+           g_pui32Samples[BENCH_SAMPLES * 99 / 100],
+           g_pui32Samples[BENCH_SAMPLES - 1],
+           (uint32_t)(ui64Sum / BENCH_SAMPLES));
+}
+
+
+/** @brief Counts a block that did not come back out in order. */
+static void
+checkBlock(void)
+{
+    uint32_t k;
+
+    for (k = 0; k < BENCH_BLOCK; k++)
+    {
+        g_ui32Errors += g_pui32Out[k] != g_pui32In[k];
+    }
+}
+
+
+int
+main(void)
+{
+    circBuf_t sCirc;
+    ringBuf_t sRing;
+    uint32_t i, j, k;
+
+    for (k = 0; k < BENCH_BLOCK; k++)
+    {
+        g_pui32In[k] = k * 2654435761u;
+    }
+
+    printf("# ring_buf_bench host unit=ns capacity=%u block=%u\n",
+           BENCH_CAPACITY, BENCH_BLOCK);
+    printf("primitive,case,samples,min,median,p99,max,mean\n");
+
+    if (initCircBuf(&sCirc, BENCH_CAPACITY) == NULL)
+    {
+        printf("# FAILED: no memory\n");
+        return 1;
+    }
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            for (k = 0; k < BENCH_BLOCK; k++)
+            {
+                writeCircBuf(&sCirc, g_pui32In[k]);
+            }
+            for (k = 0; k < BENCH_BLOCK; k++)
+            {
+                g_pui32Out[k] = readCircBuf(&sCirc);
+            }
+        }
+        sample(i, BENCH_BATCH * BENCH_BLOCK);
+        checkBlock();
+    }
+    report("circbuf", "write_read");
+    freeCircBuf(&sCirc);
+
+    initRingBuf(&sRing, g_pui32Storage, sizeof(uint32_t), BENCH_CAPACITY);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            for (k = 0; k < BENCH_BLOCK; k++)
+            {
+                g_ui32Errors += !writeRingBuf(&sRing, &g_pui32In[k]);
+            }
+            for (k = 0; k < BENCH_BLOCK; k++)
+            {
+                g_ui32Errors += !readRingBuf(&sRing, &g_pui32Out[k]);
+            }
+        }
+        sample(i, BENCH_BATCH * BENCH_BLOCK);
+        checkBlock();
+    }
+    report("ringbuf", "write_read");
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            g_ui32Errors += writeRingBufN(&sRing, g_pui32In, BENCH_BLOCK) !=
+                            BENCH_BLOCK;
+            g_ui32Errors += readRingBufN(&sRing, g_pui32Out, BENCH_BLOCK) !=
+                            BENCH_BLOCK;
+        }
+        sample(i, BENCH_BATCH * BENCH_BLOCK);
+        checkBlock();
+    }
+    report("ringbuf", "write_read_n");
+
+    if (g_ui32Errors != 0)
+    {
+        printf("# FAILED: %u errors\n", g_ui32Errors);
+        return 1;
+    }
+
+    return 0;
+}
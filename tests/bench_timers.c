@@ -0,0 +1,309 @@
+/******************************************************************************
+ *
+ * bench_timers.c
+ *
+ * Purpose:
+ * Host benchmark of the timer service's active timer store with hundreds of
+ * concurrent timers: the sorted lists of stock FreeRTOS, or the timing wheel
+ * in timers.c when configUSE_TIMER_WHEEL is 1. This file builds whichever
+ * the configuration selects (the lists, by default); bench_timers_wheel.c
+ * builds it again with the wheel, so one make run prints both.
+ *
+ * timers.c is included so its internal functions can be driven directly,
+ * without the command queue, and the figures are the store alone. For each
+ * number of active auto-reload timers, with periods mostly up to
+ * BENCH_MAX_PERIOD ticks and one in ten beyond the wheel's span:
+ *  - reset_N: stop a random timer and start it again, as xTimerReset()
+ *    does. A sorted insert walks the list; the wheel does not.
+ *  - tick_N:  advance one tick, expiring and reloading whatever is due.
+ *  - late_N:  advance 1 to BENCH_MAX_LATE ticks at once, as a timer task
+ *    that woke late does, catching up every expiry in between.
+ * Each row is ns per operation in the CSV columns of bench_kernel.c, and
+ * every expiry is checked to be on time.
+ *
+ *   make -C tests bench
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "host_kernel.h"
+#include "tiva.h"
+#include "../FreeRTOS/timers.c"
+
+// CONSTANTS-------------------------------------------------------------------
+
+#define BENCH_SAMPLES           1000
+#define BENCH_BATCH             64      // Resets or ticks timed per sample
+#define BENCH_MAX_TIMERS        1000
+#define BENCH_MAX_PERIOD        300     // Ticks, for nine timers in ten
+#define BENCH_FAR_PERIOD        20000   // Ticks, for the tenth
+#define BENCH_MAX_LATE          40      // Ticks a late wake may cover
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+    #define BENCH_PRIMITIVE     "timer_wheel"
+#else
+    #define BENCH_PRIMITIVE     "timer_list"
+#endif
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+static uint32_t g_pui32Samples[BENCH_SAMPLES];
+static int64_t g_i64Start;
+
+static Timer_t g_psTimers[BENCH_MAX_TIMERS];
+static TickType_t g_pxDue[BENCH_MAX_TIMERS];
+static uint32_t g_pui32Picks[BENCH_SAMPLES * BENCH_BATCH];
+static TickType_t g_xNow = 1000;
+static uint32_t g_ui32Fired = 0;
+static uint32_t g_ui32Errors = 0;
+static uint32_t g_ui32Seed = 1;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+static int64_t
+nowNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+    return (int64_t)sNow.tv_sec * 1000000000 + sNow.tv_nsec;
+}
+
+
+static void
+start(void)
+{
+    g_i64Start = nowNs();
+}
+
+
+/** @brief Stores the time since start() per operation, in ns. */
+static void
+sample(uint32_t i, uint32_t ui32Ops)
+{
+    g_pui32Samples[i] = (uint32_t)((nowNs() - g_i64Start + ui32Ops / 2) / ui32Ops);
+}
+
+
+static int
+compareSamples(const void *pvA, const void *pvB)
+{
+    uint32_t ui32A = *(const uint32_t *)pvA, ui32B = *(const uint32_t *)pvB;
+
+    return ui32A < ui32B ? -1 : ui32A > ui32B;
+}
+
+
+static void
+report(const char *pcPrimitive, const char *pcCase)
+{
+    uint64_t ui64Sum = 0;
+    uint32_t i;
+
+    qsort(g_pui32Samples, BENCH_SAMPLES, sizeof(g_pui32Samples[0]),
+          compareSamples);
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        ui64Sum += g_pui32Samples[i];
+    }
+
+    printf("%s,%s,%u,%u,%u,%u,%u,%u\n", pcPrimitive, pcCase, BENCH_SAMPLES,
+           g_pui32Samples[0], g_pui32Samples[BENCH_SAMPLES / 2],
+           g_pui32Samples[BENCH_SAMPLES * 99 / 100],
+           g_pui32Samples[BENCH_SAMPLES - 1],
+           (uint32_t)(ui64Sum / BENCH_SAMPLES));
+}
+
+
+static uint32_t
+randomBelow(uint32_t ui32Limit)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return (g_ui32Seed >> 8) % ui32Limit;
+}
+
+
+/** @brief Counts the expiry and checks it is not early. */
+static void
+expired(TimerHandle_t xTimer)
+{
+    Timer_t *pxTimer = (Timer_t *)xTimer;
+    uint32_t ui32Index = (uint32_t)(uintptr_t)pxTimer->pvTimerID;
+
+    g_ui32Errors += (int32_t)(g_xNow - g_pxDue[ui32Index]) < 0;
+    g_pxDue[ui32Index] += pxTimer->xTimerPeriodInTicks;
+    g_ui32Fired++;
+}
+
+
+static void
+startTimer(uint32_t ui32Index)
+{
+    Timer_t *pxTimer = &g_psTimers[ui32Index];
+
+    g_pxDue[ui32Index] = g_xNow + pxTimer->xTimerPeriodInTicks;
+    pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+    g_ui32Errors += prvInsertTimerInActiveList(pxTimer, g_pxDue[ui32Index],
+                                               g_xNow, g_xNow) != pdFALSE;
+}
+
+
+static void
+stopTimer(uint32_t ui32Index)
+{
+    Timer_t *pxTimer = &g_psTimers[ui32Index];
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+    prvWheelRemove(pxTimer);
+#else
+    ( void ) uxListRemove(&(pxTimer->xTimerListItem));
+#endif
+    pxTimer->ucStatus &= (uint8_t)~tmrSTATUS_IS_ACTIVE;
+}
+
+
+/** @brief What the timer task does on waking at g_xNow. */
+static void
+advance(void)
+{
+#if ( configUSE_TIMER_WHEEL == 1 )
+    prvWheelAdvance(g_xNow);
+#else
+    BaseType_t xListWasEmpty;
+    TickType_t xNextExpireTime;
+
+    for (;;)
+    {
+        xNextExpireTime = prvGetNextExpireTime(&xListWasEmpty);
+        if (xListWasEmpty != pdFALSE || xNextExpireTime > g_xNow)
+        {
+            break;
+        }
+        prvProcessExpiredTimer(xNextExpireTime, g_xNow);
+    }
+#endif
+}
+
+
+static void
+runCount(uint32_t ui32Timers)
+{
+    char pcCase[32];
+    uint32_t i, j;
+
+    for (i = 0; i < ui32Timers; i++)
+    {
+        startTimer(i);
+    }
+    for (i = 0; i < BENCH_SAMPLES * BENCH_BATCH; i++)
+    {
+        g_pui32Picks[i] = randomBelow(ui32Timers);
+    }
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        const uint32_t *pui32Picks = &g_pui32Picks[i * BENCH_BATCH];
+
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            stopTimer(pui32Picks[j]);
+            startTimer(pui32Picks[j]);
+        }
+        sample(i, BENCH_BATCH);
+    }
+    snprintf(pcCase, sizeof(pcCase), "reset_%u", ui32Timers);
+    report(BENCH_PRIMITIVE, pcCase);
+
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            g_xNow++;
+            advance();
+        }
+        sample(i, BENCH_BATCH);
+    }
+    snprintf(pcCase, sizeof(pcCase), "tick_%u", ui32Timers);
+    report(BENCH_PRIMITIVE, pcCase);
+
+    for (i = 0; i < BENCH_SAMPLES * BENCH_BATCH; i++)
+    {
+        g_pui32Picks[i] = 1 + randomBelow(BENCH_MAX_LATE);
+    }
+    for (i = 0; i < BENCH_SAMPLES; i++)
+    {
+        const uint32_t *pui32Steps = &g_pui32Picks[i * BENCH_BATCH];
+
+        start();
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+            g_xNow += pui32Steps[j];
+            advance();
+        }
+        sample(i, BENCH_BATCH);
+    }
+    snprintf(pcCase, sizeof(pcCase), "late_%u", ui32Timers);
+    report(BENCH_PRIMITIVE, pcCase);
+
+    // Nothing may be left overdue, and every timer is still running.
+    for (i = 0; i < ui32Timers; i++)
+    {
+        g_ui32Errors += (int32_t)(g_pxDue[i] - g_xNow) <= 0;
+        g_ui32Errors += (g_psTimers[i].ucStatus & tmrSTATUS_IS_ACTIVE) == 0;
+        stopTimer(i);
+    }
+}
+
+
+int
+main(void)
+{
+    static const uint32_t pui32Counts[] = { 100, 300, 1000 };
+    uint32_t i;
+
+    HostKernelReset();
+    TivaReset();
+    HostTickSet(g_xNow);
+    prvCheckForValidListAndQueue();
+
+    for (i = 0; i < BENCH_MAX_TIMERS; i++)
+    {
+        Timer_t *pxTimer = &g_psTimers[i];
+
+        vListInitialiseItem(&(pxTimer->xTimerListItem));
+        pxTimer->pcTimerName = "Bench";
+        pxTimer->pvTimerID = (void *)(uintptr_t)i;
+        pxTimer->pxCallbackFunction = expired;
+        pxTimer->xTimerPeriodInTicks = 1 + randomBelow((i % 10 == 9) ?
+                                                       BENCH_FAR_PERIOD :
+                                                       BENCH_MAX_PERIOD);
+        pxTimer->ucStatus = tmrSTATUS_IS_STATICALLY_ALLOCATED |
+                            tmrSTATUS_IS_AUTORELOAD;
+    }
+
+    printf("# timer_bench host unit=ns wheel=%u batch=%u max_period=%u max_late=%u\n",
+           configUSE_TIMER_WHEEL, BENCH_BATCH, BENCH_MAX_PERIOD, BENCH_MAX_LATE);
+    printf("primitive,case,samples,min,median,p99,max,mean\n");
+
+    for (i = 0; i < sizeof(pui32Counts) / sizeof(pui32Counts[0]); i++)
+    {
+        runCount(pui32Counts[i]);
+    }
+
+    if (g_ui32Errors != 0 || g_ui32Fired == 0 || HostCriticalNesting() != 0)
+    {
+        printf("# FAILED: %u errors, %u expiries\n", g_ui32Errors, g_ui32Fired);
+        return 1;
+    }
+
+    return 0;
+}
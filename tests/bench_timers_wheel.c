@@ -0,0 +1,16 @@
+/******************************************************************************
+ *
+ * bench_timers_wheel.c
+ *
+ * Purpose:
+ * bench_timers.c built with the timing wheel, whatever FreeRTOSConfig.h
+ * selects, so its rows can be set against the sorted lists'.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include "FreeRTOS.h"
+#undef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL   1
+#include "bench_timers.c"
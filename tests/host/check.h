@@ -0,0 +1,46 @@
+/******************************************************************************
+ *
+ * check.h
+ *
+ * Purpose:
+ * The few assertion macros the host tests share. A failed CHECK prints where
+ * and why and the test carries on, so one run reports every failure; main()
+ * ends with CHECK_EXIT() to turn the count into the exit status.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __CHECK_H__
+#define __CHECK_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+static uint32_t g_ui32CheckFailures = 0;
+static uint32_t g_ui32CheckCount = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        g_ui32CheckCount++;                                                 \
+        if (!(cond)) {                                                      \
+            g_ui32CheckFailures++;                                          \
+            printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, #cond);         \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                      \
+    do {                                                                    \
+        long long llA = (long long)(a), llB = (long long)(b);               \
+        g_ui32CheckCount++;                                                 \
+        if (llA != llB) {                                                   \
+            g_ui32CheckFailures++;                                          \
+            printf("%s:%d: FAIL: %s == %s (%lld != %lld)\n", __FILE__,     \
+                   __LINE__, #a, #b, llA, llB);                             \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EXIT()                                                        \
+    (printf("%s: %u checks, %u failed\n", __FILE__, g_ui32CheckCount,       \
+            g_ui32CheckFailures), g_ui32CheckFailures != 0)
+
+#endif /* __CHECK_H__ */
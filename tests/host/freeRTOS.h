@@ -0,0 +1,2 @@
+/* The firmware includes FreeRTOS.h under both spellings. */
+#include "FreeRTOS.h"
@@ -0,0 +1,766 @@
+/******************************************************************************
+ *
+ * host_kernel.c
+ *
+ * Purpose:
+ * Host implementation of the task API used by the kernel sources and the
+ * firmware. See host_kernel.h.
+ *
+ * There is one task control block. A task that blocks on a queue or event
+ * group is put on the object's event list as on the target, and yields. The
+ * yield runs the test's hook, if any, which can wake it; if nothing does,
+ * the wait times out when it is next checked and the tick moves on by the
+ * whole block time.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "host_kernel.h"
+
+// CONSTANTS-------------------------------------------------------------------
+
+/** @brief As in tasks.c: marks an event list item used by an event group. */
+#define taskEVENT_LIST_ITEM_VALUE_IN_USE    0x80000000UL
+
+/** @brief As in tasks.c: what a new task's stack is painted with. */
+#define tskSTACK_FILL_BYTE                  0xa5U
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+hostTask_t g_psHostTasks[HOST_MAX_TASKS];
+uint32_t g_ui32HostTaskCount = 0;
+uint32_t g_ui32HostWakeups = 0;
+TickType_t g_xHostWokenAt = 0;
+uint32_t g_ui32HostAsserts = 0;
+
+/** @brief The parts of a TCB the event lists reach. */
+typedef struct {
+    ListItem_t xEventListItem;
+    UBaseType_t uxPriority;
+    TickType_t xBlockTime;
+} hostTCB_t;
+
+static hostTCB_t g_sCurrent;
+static volatile TickType_t g_xTick = 0;
+static uint32_t g_ui32Critical = 0;
+static uint32_t g_ui32Suspended = 0;
+static void (*g_pfnBlockHook)(void) = NULL;
+static hostTask_t *g_psIdleTask = NULL;
+
+/** @brief Step budget and unwind point of the task HostRunTask is running. */
+static jmp_buf g_xTaskExit;
+static uint32_t g_ui32Steps = 0;
+static uint32_t g_ui32StepBudget = 0;
+static uint32_t g_ui32TaskRunning = 0;
+
+static sigjmp_buf g_xSpinExit;
+
+/** @brief Where vTaskStartScheduler() returns to during HostBoot(). */
+static sigjmp_buf g_xBootExit;
+static uint32_t g_ui32Booting = 0;
+
+/** @brief Notification values and states of the one task, by index. */
+static uint32_t g_pui32NotifyValue[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+static uint8_t g_pui8NotifyPending[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+/**
+ * @brief Counts a blocking point against the running task's budget, and
+ * leaves the task once it is spent.
+ */
+static void
+hostStep(void)
+{
+    if (g_ui32TaskRunning && ++g_ui32Steps >= g_ui32StepBudget)
+    {
+        longjmp(g_xTaskExit, 1);
+    }
+}
+
+
+/**
+ * @brief The running task has blocked: the test's hook plays whatever runs
+ * meanwhile, then the block counts as a step.
+ */
+static void
+hostBlock(void)
+{
+    void (*pfnHook)(void) = g_pfnBlockHook;
+
+    if (pfnHook != NULL)
+    {
+        g_pfnBlockHook = NULL;
+        pfnHook();
+    }
+
+    hostStep();
+}
+
+
+/**
+ * @brief Takes the task off any event list it is still on, as the tick
+ * interrupt does when a block times out.
+ */
+static void
+hostUnblock(void)
+{
+    if (listLIST_ITEM_CONTAINER(&g_sCurrent.xEventListItem) != NULL)
+    {
+        (void)uxListRemove(&g_sCurrent.xEventListItem);
+    }
+}
+
+
+void
+HostKernelReset(void)
+{
+    memset(g_psHostTasks, 0, sizeof(g_psHostTasks));
+    g_ui32HostTaskCount = 0;
+    g_ui32HostWakeups = 0;
+    g_xHostWokenAt = 0;
+    g_ui32HostAsserts = 0;
+    g_xTick = 0;
+    g_ui32Critical = 0;
+    g_ui32Suspended = 0;
+    g_pfnBlockHook = NULL;
+    g_psIdleTask = NULL;
+    memset(g_pui32NotifyValue, 0, sizeof(g_pui32NotifyValue));
+    memset(g_pui8NotifyPending, 0, sizeof(g_pui8NotifyPending));
+
+    vListInitialiseItem(&g_sCurrent.xEventListItem);
+    listSET_LIST_ITEM_OWNER(&g_sCurrent.xEventListItem, &g_sCurrent);
+    g_sCurrent.uxPriority = tskIDLE_PRIORITY;
+}
+
+
+void HostTickSet(TickType_t xTick) { g_xTick = xTick; }
+void HostTickAdvance(TickType_t xTicks) { g_xTick += xTicks; }
+uint32_t HostCriticalNesting(void) { return g_ui32Critical; }
+uint32_t HostSuspendNesting(void) { return g_ui32Suspended; }
+void HostOnNextBlock(void (*pfnHook)(void)) { g_pfnBlockHook = pfnHook; }
+
+
+uint32_t
+HostRunTask(TaskFunction_t pxCode, void *pvParameters, uint32_t ui32Steps)
+{
+    g_ui32Steps = 0;
+    g_ui32StepBudget = ui32Steps;
+    g_ui32TaskRunning = 1;
+
+    if (setjmp(g_xTaskExit) == 0)
+    {
+        pxCode(pvParameters);
+    }
+
+    // Whatever the task was in the middle of is abandoned with it.
+    g_ui32TaskRunning = 0;
+    g_ui32Critical = 0;
+    g_ui32Suspended = 0;
+    hostUnblock();
+
+    return g_ui32Steps;
+}
+
+
+hostTask_t *
+HostTaskFind(const char *pcName)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_ui32HostTaskCount; i++)
+    {
+        if (strcmp(g_psHostTasks[i].pcName, pcName) == 0)
+        {
+            return &g_psHostTasks[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+static void
+hostSpinAlarm(int iSignal)
+{
+    (void)iSignal;
+    siglongjmp(g_xSpinExit, 1);
+}
+
+
+uint32_t
+HostExpectSpin(void (*pfnCode)(void), uint32_t ui32Ms)
+{
+    struct itimerval sTimer = { { 0, 0 }, { ui32Ms / 1000, (ui32Ms % 1000) * 1000 } };
+    struct itimerval sOff = { { 0, 0 }, { 0, 0 } };
+    uint32_t ui32Spun = 0;
+
+    signal(SIGALRM, hostSpinAlarm);
+    if (sigsetjmp(g_xSpinExit, 1) == 0)
+    {
+        setitimer(ITIMER_REAL, &sTimer, NULL);
+        pfnCode();
+    }
+    else
+    {
+        ui32Spun = 1;
+    }
+    setitimer(ITIMER_REAL, &sOff, NULL);
+    signal(SIGALRM, SIG_DFL);
+
+    // The spin may have been inside a critical section.
+    g_ui32Critical = 0;
+    g_ui32Suspended = 0;
+
+    return ui32Spun;
+}
+
+
+uint32_t
+HostBoot(int (*pfnMain)(void), uint32_t ui32Ms)
+{
+    struct itimerval sTimer = { { 0, 0 }, { ui32Ms / 1000, (ui32Ms % 1000) * 1000 } };
+    struct itimerval sOff = { { 0, 0 }, { 0, 0 } };
+    uint32_t ui32Started = 0;
+
+    signal(SIGALRM, hostSpinAlarm);
+    if (sigsetjmp(g_xSpinExit, 1) == 0)
+    {
+        if (sigsetjmp(g_xBootExit, 1) == 0)
+        {
+            g_ui32Booting = 1;
+            setitimer(ITIMER_REAL, &sTimer, NULL);
+            (void)pfnMain();
+        }
+        else
+        {
+            ui32Started = 1;
+        }
+    }
+    setitimer(ITIMER_REAL, &sOff, NULL);
+    signal(SIGALRM, SIG_DFL);
+    g_ui32Booting = 0;
+
+    return ui32Started;
+}
+
+
+// Port layer.
+void
+vHostYield(void)
+{
+    hostBlock();
+}
+
+void vPortEnterCritical(void) { g_ui32Critical++; }
+
+void
+vPortExitCritical(void)
+{
+    configASSERT(g_ui32Critical > 0);
+    g_ui32Critical--;
+}
+
+uint32_t ulHostSetInterruptMask(void) { return 0; }
+void vHostClearInterruptMask(uint32_t ulMask) { (void)ulMask; }
+
+/**
+ * @brief Counts and reports a configASSERT and carries on. The firmware's
+ * handler, which spins, is built as firmware_vAssertCalled.
+ */
+void
+vAssertCalled(const char *pcFile, unsigned long ulLine)
+{
+    g_ui32HostAsserts++;
+    fprintf(stderr, "configASSERT failed at %s:%lu\n", pcFile, ulLine);
+}
+
+
+/** @brief Weak: main.c supplies the firmware's own when it is linked. */
+__attribute__((weak)) void
+vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+                              StackType_t **ppxIdleTaskStackBuffer,
+                              uint32_t *pulIdleTaskStackSize)
+{
+    static StaticTask_t xIdleTCB;
+    static StackType_t pxIdleStack[configMINIMAL_STACK_SIZE];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTCB;
+    *ppxIdleTaskStackBuffer = pxIdleStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+__attribute__((weak)) void
+vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+                               StackType_t **ppxTimerTaskStackBuffer,
+                               uint32_t *pulTimerTaskStackSize)
+{
+    static StaticTask_t xTimerTCB;
+    static StackType_t pxTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+    *ppxTimerTaskTCBBuffer = &xTimerTCB;
+    *ppxTimerTaskStackBuffer = pxTimerStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+
+// Task creation and scheduler.
+TaskHandle_t
+xTaskCreateStatic(TaskFunction_t pxTaskCode, const char * const pcName,
+                  const uint32_t ulStackDepth, void * const pvParameters,
+                  UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                  StaticTask_t * const pxTaskBuffer)
+{
+    hostTask_t *psTask;
+
+    if (puxStackBuffer == NULL || pxTaskBuffer == NULL ||
+        g_ui32HostTaskCount == HOST_MAX_TASKS)
+    {
+        return NULL;
+    }
+
+    configASSERT(uxPriority < configMAX_PRIORITIES);
+
+    psTask = &g_psHostTasks[g_ui32HostTaskCount++];
+    psTask->pxCode = pxTaskCode;
+    psTask->pcName = pcName;
+    psTask->ui32StackDepth = ulStackDepth;
+    psTask->pvParameters = pvParameters;
+    psTask->uxPriority = uxPriority;
+    psTask->pxStack = puxStackBuffer;
+    psTask->pxTCB = pxTaskBuffer;
+
+    // Painted as tasks.c does, so the high-water mark reads what a test
+    // writes into it. Task bodies run on the host's stack, not this one.
+    memset(puxStackBuffer, tskSTACK_FILL_BYTE,
+           ulStackDepth * sizeof(StackType_t));
+
+    return (TaskHandle_t)pxTaskBuffer;
+}
+
+
+void
+vTaskStartScheduler(void)
+{
+    StaticTask_t *pxIdleTCB;
+    StackType_t *pxIdleStack;
+    uint32_t ui32IdleDepth;
+
+    // Creates what the real scheduler would, from the firmware's memory,
+    // then returns to the test instead of running anything.
+    vApplicationGetIdleTaskMemory(&pxIdleTCB, &pxIdleStack, &ui32IdleDepth);
+    (void)xTaskCreateStatic((TaskFunction_t)NULL, "IDLE", ui32IdleDepth, NULL,
+                            tskIDLE_PRIORITY, pxIdleStack, pxIdleTCB);
+    g_psIdleTask = HostTaskFind("IDLE");
+    (void)xTimerCreateTimerTask();
+
+    if (g_ui32Booting)
+    {
+        siglongjmp(g_xBootExit, 1);
+    }
+}
+
+
+TaskHandle_t
+xTaskGetIdleTaskHandle(void)
+{
+    return g_psIdleTask != NULL ? (TaskHandle_t)g_psIdleTask->pxTCB : NULL;
+}
+
+
+/** @brief Words still painted from the far end of a stack, as tasks.c counts. */
+static UBaseType_t
+freeStack(const hostTask_t *psTask)
+{
+    const uint8_t *pucByte = (const uint8_t *)psTask->pxStack;
+    uint32_t ui32Count = 0;
+
+    while (ui32Count < psTask->ui32StackDepth * sizeof(StackType_t) &&
+           *pucByte++ == (uint8_t)tskSTACK_FILL_BYTE)
+    {
+        ui32Count++;
+    }
+
+    return ui32Count / sizeof(StackType_t);
+}
+
+
+UBaseType_t
+uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray,
+                     const UBaseType_t uxArraySize,
+                     uint32_t * const pulTotalRunTime)
+{
+    UBaseType_t i;
+
+    if (uxArraySize < g_ui32HostTaskCount)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < g_ui32HostTaskCount; i++)
+    {
+        TaskStatus_t *psStatus = &pxTaskStatusArray[i];
+
+        memset(psStatus, 0, sizeof(*psStatus));
+        psStatus->xHandle = (TaskHandle_t)g_psHostTasks[i].pxTCB;
+        psStatus->pcTaskName = g_psHostTasks[i].pcName;
+        psStatus->xTaskNumber = i + 1;
+        psStatus->eCurrentState = eReady;
+        psStatus->uxCurrentPriority = g_psHostTasks[i].uxPriority;
+        psStatus->uxBasePriority = g_psHostTasks[i].uxPriority;
+        psStatus->ulRunTimeCounter = g_psHostTasks[i].ui32RunTime;
+        psStatus->pxStackBase = g_psHostTasks[i].pxStack;
+        psStatus->usStackHighWaterMark = freeStack(&g_psHostTasks[i]);
+    }
+
+    if (pulTotalRunTime != NULL)
+    {
+        *pulTotalRunTime = 0;
+    }
+
+    return g_ui32HostTaskCount;
+}
+
+
+UBaseType_t uxTaskGetNumberOfTasks(void) { return g_ui32HostTaskCount; }
+BaseType_t xTaskGetSchedulerState(void) { return taskSCHEDULER_RUNNING; }
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return (TaskHandle_t)&g_sCurrent; }
+TaskHandle_t pvTaskIncrementMutexHeldCount(void) { return (TaskHandle_t)&g_sCurrent; }
+BaseType_t xTaskPriorityInherit(TaskHandle_t const pxMutexHolder) { return pdFALSE; }
+BaseType_t xTaskPriorityDisinherit(TaskHandle_t const pxMutexHolder) { return pdFALSE; }
+void vTaskPriorityDisinheritAfterTimeout(TaskHandle_t const pxMutexHolder,
+                                         UBaseType_t uxHighestPriorityWaitingTask) {}
+void vTaskMissedYield(void) {}
+
+UBaseType_t
+uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_ui32HostTaskCount; i++)
+    {
+        if (xTask != NULL && (TaskHandle_t)g_psHostTasks[i].pxTCB == xTask)
+        {
+            return freeStack(&g_psHostTasks[i]);
+        }
+    }
+
+    // The calling task runs on the host's stack, which has no mark.
+    return configMINIMAL_STACK_SIZE;
+}
+
+
+// Tick and delays.
+TickType_t xTaskGetTickCount(void) { return g_xTick; }
+TickType_t xTaskGetTickCountFromISR(void) { return g_xTick; }
+
+void vTaskSuspendAll(void) { g_ui32Suspended++; }
+
+BaseType_t
+xTaskResumeAll(void)
+{
+    configASSERT(g_ui32Suspended > 0);
+    g_ui32Suspended--;
+
+    // No switch happened, so callers that blocked go on to yield.
+    return pdFALSE;
+}
+
+
+void
+vTaskDelay(const TickType_t xTicksToDelay)
+{
+    g_xTick += xTicksToDelay;
+    hostBlock();
+}
+
+
+BaseType_t
+xTaskDelayUntil(TickType_t * const pxPreviousWakeTime,
+                const TickType_t xTimeIncrement)
+{
+    TickType_t xWake = *pxPreviousWakeTime + xTimeIncrement;
+    BaseType_t xDelayed = pdFALSE;
+
+    // Late wakes do not delay, as on the target.
+    if ((int32_t)(xWake - g_xTick) > 0)
+    {
+        g_xTick = xWake;
+        xDelayed = pdTRUE;
+    }
+    *pxPreviousWakeTime = xWake;
+    hostBlock();
+
+    return xDelayed;
+}
+
+
+void
+vTaskSetTimeOutState(TimeOut_t * const pxTimeOut)
+{
+    pxTimeOut->xOverflowCount = 0;
+    pxTimeOut->xTimeOnEntering = g_xTick;
+}
+
+
+void
+vTaskInternalSetTimeOutState(TimeOut_t * const pxTimeOut)
+{
+    vTaskSetTimeOutState(pxTimeOut);
+}
+
+
+BaseType_t
+xTaskCheckForTimeOut(TimeOut_t * const pxTimeOut,
+                     TickType_t * const pxTicksToWait)
+{
+    // With a hook waiting to run, the caller goes on to block and yield,
+    // and the hook gets its chance to satisfy the wait.
+    if (g_pfnBlockHook != NULL && *pxTicksToWait != 0)
+    {
+        return pdFALSE;
+    }
+
+    // Nothing else will run, so a wait that is still unsatisfied has
+    // taken its whole block time.
+    if (*pxTicksToWait != portMAX_DELAY)
+    {
+        g_xTick = pxTimeOut->xTimeOnEntering + *pxTicksToWait;
+    }
+    *pxTicksToWait = 0;
+    hostUnblock();
+
+    return pdTRUE;
+}
+
+
+// Event lists.
+void
+vTaskPlaceOnEventList(List_t * const pxEventList, const TickType_t xTicksToWait)
+{
+    listSET_LIST_ITEM_VALUE(&g_sCurrent.xEventListItem,
+                            configMAX_PRIORITIES - g_sCurrent.uxPriority);
+    vListInsert(pxEventList, &g_sCurrent.xEventListItem);
+    g_sCurrent.xBlockTime = xTicksToWait;
+}
+
+
+void
+vTaskPlaceOnEventListRestricted(List_t * const pxEventList,
+                                TickType_t xTicksToWait,
+                                const BaseType_t xWaitIndefinitely)
+{
+    vListInsertEnd(pxEventList, &g_sCurrent.xEventListItem);
+    g_sCurrent.xBlockTime = xWaitIndefinitely ? portMAX_DELAY : xTicksToWait;
+}
+
+
+void
+vTaskPlaceOnUnorderedEventList(List_t * pxEventList,
+                               const TickType_t xItemValue,
+                               const TickType_t xTicksToWait)
+{
+    configASSERT(g_ui32Suspended != 0);
+    listSET_LIST_ITEM_VALUE(&g_sCurrent.xEventListItem,
+                            xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE);
+    vListInsertEnd(pxEventList, &g_sCurrent.xEventListItem);
+    g_sCurrent.xBlockTime = xTicksToWait;
+}
+
+
+BaseType_t
+xTaskRemoveFromEventList(const List_t * const pxEventList)
+{
+    hostTCB_t *psUnblocked = listGET_OWNER_OF_HEAD_ENTRY(pxEventList);
+
+    (void)uxListRemove(&psUnblocked->xEventListItem);
+    g_ui32HostWakeups++;
+    g_xHostWokenAt = g_xTick;
+
+    return pdFALSE;
+}
+
+
+void
+vTaskRemoveFromUnorderedEventList(ListItem_t * pxEventListItem,
+                                  const TickType_t xItemValue)
+{
+    configASSERT(g_ui32Suspended != 0);
+    listSET_LIST_ITEM_VALUE(pxEventListItem,
+                            xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE);
+    (void)uxListRemove(pxEventListItem);
+    g_ui32HostWakeups++;
+    g_xHostWokenAt = g_xTick;
+}
+
+
+TickType_t
+uxTaskResetEventItemValue(void)
+{
+    TickType_t uxReturn = listGET_LIST_ITEM_VALUE(&g_sCurrent.xEventListItem);
+
+    // Still on the list means nobody set the bits: the wait timed out.
+    if (listLIST_ITEM_CONTAINER(&g_sCurrent.xEventListItem) != NULL)
+    {
+        hostUnblock();
+        if (g_sCurrent.xBlockTime != portMAX_DELAY)
+        {
+            g_xTick += g_sCurrent.xBlockTime;
+        }
+        uxReturn = 0;
+    }
+
+    listSET_LIST_ITEM_VALUE(&g_sCurrent.xEventListItem,
+                            configMAX_PRIORITIES - g_sCurrent.uxPriority);
+
+    return uxReturn;
+}
+
+
+// Task notifications, for the one task.
+BaseType_t
+xTaskGenericNotify(TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify,
+                   uint32_t ulValue, eNotifyAction eAction,
+                   uint32_t *pulPreviousNotificationValue)
+{
+    uint32_t *pui32Value = &g_pui32NotifyValue[uxIndexToNotify];
+    BaseType_t xReturn = pdPASS;
+
+    if (pulPreviousNotificationValue != NULL)
+    {
+        *pulPreviousNotificationValue = *pui32Value;
+    }
+
+    switch (eAction)
+    {
+        case eSetBits:
+            *pui32Value |= ulValue;
+            break;
+        case eIncrement:
+            (*pui32Value)++;
+            break;
+        case eSetValueWithOverwrite:
+            *pui32Value = ulValue;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (g_pui8NotifyPending[uxIndexToNotify])
+            {
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                *pui32Value = ulValue;
+            }
+            break;
+        default:
+            break;
+    }
+    g_pui8NotifyPending[uxIndexToNotify] = 1;
+
+    return xReturn;
+}
+
+
+BaseType_t
+xTaskGenericNotifyFromISR(TaskHandle_t xTaskToNotify,
+                          UBaseType_t uxIndexToNotify, uint32_t ulValue,
+                          eNotifyAction eAction,
+                          uint32_t *pulPreviousNotificationValue,
+                          BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken != NULL)
+    {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+
+    return xTaskGenericNotify(xTaskToNotify, uxIndexToNotify, ulValue, eAction,
+                              pulPreviousNotificationValue);
+}
+
+
+void
+vTaskGenericNotifyGiveFromISR(TaskHandle_t xTaskToNotify,
+                              UBaseType_t uxIndexToNotify,
+                              BaseType_t *pxHigherPriorityTaskWoken)
+{
+    (void)xTaskGenericNotifyFromISR(xTaskToNotify, uxIndexToNotify, 0,
+                                    eIncrement, NULL, pxHigherPriorityTaskWoken);
+}
+
+
+BaseType_t
+xTaskGenericNotifyWait(UBaseType_t uxIndexToWaitOn,
+                       uint32_t ulBitsToClearOnEntry,
+                       uint32_t ulBitsToClearOnExit,
+                       uint32_t *pulNotificationValue,
+                       TickType_t xTicksToWait)
+{
+    if (!g_pui8NotifyPending[uxIndexToWaitOn])
+    {
+        g_pui32NotifyValue[uxIndexToWaitOn] &= ~ulBitsToClearOnEntry;
+        if (xTicksToWait != 0)
+        {
+            hostBlock();
+        }
+    }
+
+    if (pulNotificationValue != NULL)
+    {
+        *pulNotificationValue = g_pui32NotifyValue[uxIndexToWaitOn];
+    }
+
+    if (!g_pui8NotifyPending[uxIndexToWaitOn])
+    {
+        return pdFALSE;
+    }
+
+    g_pui32NotifyValue[uxIndexToWaitOn] &= ~ulBitsToClearOnExit;
+    g_pui8NotifyPending[uxIndexToWaitOn] = 0;
+
+    return pdTRUE;
+}
+
+
+uint32_t
+ulTaskGenericNotifyTake(UBaseType_t uxIndexToWaitOn,
+                        BaseType_t xClearCountOnExit,
+                        TickType_t xTicksToWait)
+{
+    uint32_t ui32Value;
+
+    if (g_pui32NotifyValue[uxIndexToWaitOn] == 0 && xTicksToWait != 0)
+    {
+        hostBlock();
+    }
+
+    ui32Value = g_pui32NotifyValue[uxIndexToWaitOn];
+    if (ui32Value != 0)
+    {
+        g_pui32NotifyValue[uxIndexToWaitOn] = xClearCountOnExit ? 0 : ui32Value - 1;
+    }
+    g_pui8NotifyPending[uxIndexToWaitOn] = 0;
+
+    return ui32Value;
+}
+
+
+BaseType_t
+xTaskGenericNotifyStateClear(TaskHandle_t xTask, UBaseType_t uxIndexToClear)
+{
+    BaseType_t xWasPending = g_pui8NotifyPending[uxIndexToClear] ? pdPASS : pdFAIL;
+
+    g_pui8NotifyPending[uxIndexToClear] = 0;
+
+    return xWasPending;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ * host_kernel.h
+ *
+ * Purpose:
+ * The task side of the FreeRTOS kernel for host tests. tasks.c is not built;
+ * host_kernel.c stands in for it with one task running at a time on the
+ * test's own thread, so queue.c, event_groups.c, timers.c and the firmware
+ * modules can be exercised deterministically.
+ *
+ * The tick only moves when a test moves it, or when the running task
+ * delays or times out. A task body, which never returns, is run with
+ * HostRunTask() for a fixed number of blocking points (delays and yields)
+ * and is then unwound with longjmp, the way the scheduler would switch away
+ * from it.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __HOST_KERNEL_H__
+#define __HOST_KERNEL_H__
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** @brief Most tasks xTaskCreateStatic() will record. */
+#define HOST_MAX_TASKS      16
+
+/** @brief What xTaskCreateStatic() was asked for. */
+typedef struct {
+    TaskFunction_t pxCode;
+    const char *pcName;
+    uint32_t ui32StackDepth;
+    void *pvParameters;
+    UBaseType_t uxPriority;
+    StackType_t *pxStack;
+    StaticTask_t *pxTCB;
+    uint32_t ui32RunTime;       // Reported as ulRunTimeCounter
+} hostTask_t;
+
+extern hostTask_t g_psHostTasks[HOST_MAX_TASKS];
+extern uint32_t g_ui32HostTaskCount;
+
+/** @brief Event list wake-ups and the tick of the most recent one. */
+extern uint32_t g_ui32HostWakeups;
+extern TickType_t g_xHostWokenAt;
+
+/** @brief configASSERT failures caught since the reset. */
+extern uint32_t g_ui32HostAsserts;
+
+/** @brief Forgets every task and wake-up and sets the tick to zero. */
+void HostKernelReset(void);
+
+/** @brief Sets or moves the tick count. */
+void HostTickSet(TickType_t xTick);
+void HostTickAdvance(TickType_t xTicks);
+
+/** @brief Current critical section and scheduler suspension depths. */
+uint32_t HostCriticalNesting(void);
+uint32_t HostSuspendNesting(void);
+
+/**
+ * @brief Runs the next time the running task blocks (delays or yields),
+ * then is cleared. This is where the test plays the rest of the system:
+ * whatever it sends, gives, sets or advances is there when the task
+ * resumes. A wait with a block time does not time out while a hook is
+ * pending, so a queue or semaphore wait really blocks on the object's
+ * event list and can be woken by the hook.
+ */
+void HostOnNextBlock(void (*pfnHook)(void));
+
+/**
+ * @brief Calls a task function until it has reached ui32Steps blocking
+ * points, then unwinds it. Returns the number reached, which is less than
+ * ui32Steps only if the function returned.
+ */
+uint32_t HostRunTask(TaskFunction_t pxCode, void *pvParameters,
+                     uint32_t ui32Steps);
+
+/** @brief Handle of the recorded task with the given name, or NULL. */
+hostTask_t *HostTaskFind(const char *pcName);
+
+/**
+ * @brief Runs pfnCode, which is expected to end in a fatal spin, and breaks
+ * it out of the spin with a timer signal after ui32Ms. Returns 1 if it was
+ * still spinning then and 0 if it returned.
+ */
+uint32_t HostExpectSpin(void (*pfnCode)(void), uint32_t ui32Ms);
+
+/**
+ * @brief Runs a firmware main() until it starts the scheduler. Returns 1 if
+ * it got there and 0 if it was still spinning (a failed init) after
+ * ui32Ms. The firmware's main is built as firmware_main().
+ */
+uint32_t HostBoot(int (*pfnMain)(void), uint32_t ui32Ms);
+
+#endif /* __HOST_KERNEL_H__ */
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ * portmacro.h
+ *
+ * Purpose:
+ * Host port for the unit tests. Takes the place of
+ * FreeRTOS/portable/CCS/ARM_CM4F/portmacro.h so the kernel's list, queue,
+ * event group, stream buffer and timer sources build for the host against
+ * the firmware's own FreeRTOSConfig.h. There is no scheduler: host_kernel.c
+ * implements the task API those sources call, one task at a time.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+
+/* Type definitions, as on the target so structure sizes and wrap-around
+ * match. */
+#define portCHAR          char
+#define portFLOAT         float
+#define portDOUBLE        double
+#define portLONG          long
+#define portSHORT         short
+#define portSTACK_TYPE    uint32_t
+#define portBASE_TYPE     long
+
+typedef portSTACK_TYPE   StackType_t;
+typedef long             BaseType_t;
+typedef unsigned long    UBaseType_t;
+
+typedef uint32_t         TickType_t;
+#define portMAX_DELAY              ( TickType_t ) 0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC    1
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH      ( -1 )
+#define portTICK_PERIOD_MS    ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portBYTE_ALIGNMENT    8
+#define portPOINTER_SIZE_TYPE uintptr_t
+#define portNOP()
+#define portFORCE_INLINE      inline __attribute__( ( always_inline ) )
+
+/* A yield is where the one host task would block: host_kernel.c runs the
+ * test's hook there and counts it against the task's step budget. */
+extern void vHostYield( void );
+#define portYIELD()                                 vHostYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired )    do { if( xSwitchRequired != pdFALSE ) portYIELD(); } while( 0 )
+#define portYIELD_FROM_ISR( x )                     portEND_SWITCHING_ISR( x )
+
+/* Critical sections only count nesting, so tests can check they balance. */
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+extern uint32_t ulHostSetInterruptMask( void );
+extern void vHostClearInterruptMask( uint32_t ulMask );
+
+#define portDISABLE_INTERRUPTS()                  ( void ) ulHostSetInterruptMask()
+#define portENABLE_INTERRUPTS()                   vHostClearInterruptMask( 0 )
+#define portENTER_CRITICAL()                      vPortEnterCritical()
+#define portEXIT_CRITICAL()                       vPortExitCritical()
+#define portSET_INTERRUPT_MASK_FROM_ISR()         ulHostSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )    vHostClearInterruptMask( x )
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters )    void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
+
+#endif /* PORTMACRO_H */
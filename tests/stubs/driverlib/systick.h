@@ -0,0 +1,2 @@
+/* Host stub: see tests/stubs/tiva.h. */
+#include "tiva.h"
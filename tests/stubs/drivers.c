@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ * drivers.c
+ *
+ * Purpose:
+ * Host stand-ins for the board drivers under drivers/: the OrbitOLED
+ * display keeps the text of each row so a test can read the screen back,
+ * and its initialisation takes as many cycles of the DWT counter as the
+ * panel's power-up sequence busy-waits on the board. The RGB LED does
+ * nothing.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "dwt.h"
+#include "drivers/OrbitOLED/OrbitOLEDInterface.h"
+#include "drivers/rgb.h"
+
+/** @brief The DelayMs() calls in OrbitOledInit(). */
+#define OLED_POWER_UP_MS    102
+
+/** @brief Text on each of the four rows, as last drawn. */
+char g_ppcOLEDRows[4][17];
+
+void
+OLEDInitialise(void)
+{
+    memset(g_ppcOLEDRows, 0, sizeof(g_ppcOLEDRows));
+    DWT_CYCLES() += OLED_POWER_UP_MS * (configCPU_CLOCK_HZ / 1000);
+}
+
+void
+OLEDStringDraw(const char *pcStr, uint32_t ulColumn, uint32_t ulRow)
+{
+    if (ulRow < 4 && ulColumn < 16)
+    {
+        strncpy(&g_ppcOLEDRows[ulRow][ulColumn], pcStr, 16 - ulColumn);
+    }
+}
+
+void RGBInit(uint32_t ui32Enable) {}
+void RGBEnable(void) {}
+void RGBDisable(void) {}
+void RGBColorSet(volatile uint32_t *pui32RGBColor) {}
+void RGBIntensitySet(float fIntensity) {}
@@ -0,0 +1,388 @@
+/******************************************************************************
+ *
+ * tiva.c
+ *
+ * Purpose:
+ * Host implementations of the TivaWare calls declared in tiva.h. Calls that
+ * only configure hardware do nothing; the ones a test needs to see or drive
+ * go through the records and inputs at the top of this file.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "tiva.h"
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+volatile uint32_t g_ui32TivaTimer = 0;
+uint32_t g_pui32TivaPWMOutputs[2];
+uint32_t g_ui32TivaPWMOffCalls = 0;
+uint8_t g_pui8TivaIntPriority[160];
+char g_pcTivaUART[16384];
+uint32_t g_ui32TivaUARTLen = 0;
+uint32_t g_pui32TivaEEPROM[512];
+
+/** @brief GPIO ports in the order of g_pui8PinLevels. */
+static const uint32_t g_pui32Ports[] = {
+    GPIO_PORTA_BASE, GPIO_PORTB_BASE, GPIO_PORTC_BASE,
+    GPIO_PORTD_BASE, GPIO_PORTE_BASE, GPIO_PORTF_BASE
+};
+#define NUM_PORTS   (sizeof(g_pui32Ports) / sizeof(g_pui32Ports[0]))
+
+static uint8_t g_pui8PinLevels[NUM_PORTS];
+static uint32_t g_ui32ADCSample = 0;
+
+/** @brief Registers touched through HWREG, looked up by address. */
+#define NUM_REGISTERS   32
+static uint32_t g_pui32RegAddr[NUM_REGISTERS];
+static volatile uint32_t g_pui32RegValue[NUM_REGISTERS];
+static uint32_t g_ui32RegCount = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+TivaReset(void)
+{
+    g_ui32TivaTimer = 0;
+    memset(g_pui32TivaPWMOutputs, 0, sizeof(g_pui32TivaPWMOutputs));
+    g_ui32TivaPWMOffCalls = 0;
+    memset(g_pui8TivaIntPriority, 0, sizeof(g_pui8TivaIntPriority));
+    g_ui32TivaUARTLen = 0;
+    g_pcTivaUART[0] = '\0';
+    memset(g_pui32TivaEEPROM, 0xFF, sizeof(g_pui32TivaEEPROM));
+    memset(g_pui8PinLevels, 0, sizeof(g_pui8PinLevels));
+    g_ui32ADCSample = 0;
+    g_ui32RegCount = 0;
+}
+
+
+volatile uint32_t *
+HostRegister(uint32_t ui32Addr)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_ui32RegCount; i++)
+    {
+        if (g_pui32RegAddr[i] == ui32Addr)
+        {
+            return &g_pui32RegValue[i];
+        }
+    }
+
+    if (g_ui32RegCount == NUM_REGISTERS)
+    {
+        fprintf(stderr, "tiva: more than %d registers used\n", NUM_REGISTERS);
+        return &g_pui32RegValue[NUM_REGISTERS - 1];
+    }
+
+    g_pui32RegAddr[g_ui32RegCount] = ui32Addr;
+    g_pui32RegValue[g_ui32RegCount] = 0;
+    return &g_pui32RegValue[g_ui32RegCount++];
+}
+
+
+static int32_t
+portIndex(uint32_t ui32Port)
+{
+    uint32_t i;
+
+    for (i = 0; i < NUM_PORTS; i++)
+    {
+        if (g_pui32Ports[i] == ui32Port)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+void
+TivaPinSet(uint32_t ui32Port, uint8_t ui8Pins, bool bHigh)
+{
+    int32_t i32Port = portIndex(ui32Port);
+
+    if (i32Port >= 0)
+    {
+        if (bHigh)
+        {
+            g_pui8PinLevels[i32Port] |= ui8Pins;
+        }
+        else
+        {
+            g_pui8PinLevels[i32Port] &= ~ui8Pins;
+        }
+    }
+}
+
+
+void
+TivaADCSet(uint32_t ui32Sample)
+{
+    g_ui32ADCSample = ui32Sample;
+}
+
+
+static void
+uartAppend(const char *pcData, uint32_t ui32Len)
+{
+    if (ui32Len > sizeof(g_pcTivaUART) - 1 - g_ui32TivaUARTLen)
+    {
+        ui32Len = sizeof(g_pcTivaUART) - 1 - g_ui32TivaUARTLen;
+    }
+    memcpy(&g_pcTivaUART[g_ui32TivaUARTLen], pcData, ui32Len);
+    g_ui32TivaUARTLen += ui32Len;
+    g_pcTivaUART[g_ui32TivaUARTLen] = '\0';
+}
+
+
+// System control.
+void SysCtlClockSet(uint32_t ui32Config) { (void)ui32Config; }
+uint32_t SysCtlClockGet(void) { return 50000000; }
+void SysCtlPWMClockSet(uint32_t ui32Config) { (void)ui32Config; }
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) { (void)ui32Peripheral; }
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral) { (void)ui32Peripheral; return true; }
+void SysCtlPeripheralReset(uint32_t ui32Peripheral) { (void)ui32Peripheral; }
+void SysCtlDelay(uint32_t ui32Count) { (void)ui32Count; }
+
+// GPIO.
+void GPIODirModeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO) {}
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins,
+                      uint32_t ui32Strength, uint32_t ui32PadType) {}
+void GPIOPinConfigure(uint32_t ui32PinConfig) {}
+void GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypePWM(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType) {}
+void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+void GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+uint32_t GPIOIntStatus(uint32_t ui32Port, bool bMasked) { return 0; }
+void GPIOIntRegister(uint32_t ui32Port, void (*pfnIntHandler)(void)) {}
+
+int32_t
+GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    int32_t i32Port = portIndex(ui32Port);
+
+    return i32Port < 0 ? 0 : (g_pui8PinLevels[i32Port] & ui8Pins);
+}
+
+void
+GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    int32_t i32Port = portIndex(ui32Port);
+
+    if (i32Port >= 0)
+    {
+        g_pui8PinLevels[i32Port] = (g_pui8PinLevels[i32Port] & ~ui8Pins) |
+                                   (ui8Val & ui8Pins);
+    }
+}
+
+// ADC. Every conversion returns the sample the test last set.
+void ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                          uint32_t ui32Trigger, uint32_t ui32Priority) {}
+void ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                              uint32_t ui32Step, uint32_t ui32Config) {}
+void ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum) {}
+void ADCProcessorTrigger(uint32_t ui32Base, uint32_t ui32SequenceNum) {}
+void ADCIntRegister(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                    void (*pfnHandler)(void)) {}
+void ADCIntEnable(uint32_t ui32Base, uint32_t ui32SequenceNum) {}
+void ADCIntClear(uint32_t ui32Base, uint32_t ui32SequenceNum) {}
+uint32_t ADCIntStatus(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                      bool bMasked) { return 1; }
+
+int32_t
+ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                   uint32_t *pui32Buffer)
+{
+    *pui32Buffer = g_ui32ADCSample;
+    return 1;
+}
+
+// PWM.
+void PWMGenConfigure(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Config) {}
+void PWMGenPeriodSet(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Period) {}
+void PWMGenEnable(uint32_t ui32Base, uint32_t ui32Gen) {}
+void PWMPulseWidthSet(uint32_t ui32Base, uint32_t ui32PWMOut,
+                      uint32_t ui32Width) {}
+
+void
+PWMOutputState(uint32_t ui32Base, uint32_t ui32PWMOutBits, bool bEnable)
+{
+    uint32_t *pui32Outputs = &g_pui32TivaPWMOutputs[ui32Base == PWM1_BASE];
+
+    if (bEnable)
+    {
+        *pui32Outputs |= ui32PWMOutBits;
+    }
+    else
+    {
+        *pui32Outputs &= ~ui32PWMOutBits;
+        g_ui32TivaPWMOffCalls++;
+    }
+}
+
+// Timers. Every timer reads back the one host counter.
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config) {}
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value) {}
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer) {}
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer) { return g_ui32TivaTimer; }
+
+// Interrupts.
+void
+IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+    if (ui32Interrupt < sizeof(g_pui8TivaIntPriority))
+    {
+        g_pui8TivaIntPriority[ui32Interrupt] = ui8Priority;
+    }
+}
+
+void IntEnable(uint32_t ui32Interrupt) {}
+bool IntMasterEnable(void) { return false; }
+bool IntMasterDisable(void) { return false; }
+
+// UART.
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source) {}
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud,
+                     uint32_t ui32SrcClock) {}
+
+void
+UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    uartAppend((const char *)&ucData, 1);
+}
+
+/**
+ * @brief UARTvprintf as TivaWare implements it: every argument is fetched as
+ * a 32-bit word, %s included, and only %c %d %i %p %s %u %x %X and %% are
+ * understood, with an optional zero-filled width. The deferred log passes
+ * its strings as 32-bit words too, which is why the tests link without PIE.
+ */
+void
+UARTvprintf(const char *pcString, va_list vaArgP)
+{
+    char pcField[40];
+
+    while (*pcString)
+    {
+        uint32_t ui32Width = 0;
+        bool bZero = false;
+        uint32_t ui32Value;
+        int iLen = 0;
+
+        if (*pcString != '%')
+        {
+            uartAppend(pcString++, 1);
+            continue;
+        }
+
+        pcString++;
+        if (*pcString == '0')
+        {
+            bZero = true;
+            pcString++;
+        }
+        while (*pcString >= '0' && *pcString <= '9')
+        {
+            ui32Width = ui32Width * 10 + (*pcString++ - '0');
+        }
+
+        switch (*pcString++)
+        {
+            case '%':
+                uartAppend("%", 1);
+                continue;
+            case 'c':
+                pcField[0] = (char)va_arg(vaArgP, uint32_t);
+                iLen = 1;
+                break;
+            case 'd':
+            case 'i':
+                ui32Value = va_arg(vaArgP, uint32_t);
+                iLen = snprintf(pcField, sizeof(pcField), "%*d", (int)ui32Width,
+                                (int32_t)ui32Value);
+                break;
+            case 's':
+            {
+                const char *pcArg = (const char *)(uintptr_t)va_arg(vaArgP, uint32_t);
+                uint32_t ui32Len = strlen(pcArg);
+
+                while (ui32Width-- > ui32Len)
+                {
+                    uartAppend(" ", 1);
+                }
+                uartAppend(pcArg, ui32Len);
+                continue;
+            }
+            case 'u':
+                ui32Value = va_arg(vaArgP, uint32_t);
+                iLen = snprintf(pcField, sizeof(pcField),
+                                bZero ? "%0*u" : "%*u", (int)ui32Width, ui32Value);
+                break;
+            case 'x':
+            case 'p':
+                ui32Value = va_arg(vaArgP, uint32_t);
+                iLen = snprintf(pcField, sizeof(pcField),
+                                bZero ? "%0*x" : "%*x", (int)ui32Width, ui32Value);
+                break;
+            case 'X':
+                ui32Value = va_arg(vaArgP, uint32_t);
+                iLen = snprintf(pcField, sizeof(pcField),
+                                bZero ? "%0*X" : "%*X", (int)ui32Width, ui32Value);
+                break;
+            default:
+                uartAppend("ERROR", 5);
+                return;
+        }
+
+        uartAppend(pcField, iLen);
+    }
+}
+
+void
+UARTprintf(const char *pcString, ...)
+{
+    va_list vaArgP;
+
+    va_start(vaArgP, pcString);
+    UARTvprintf(pcString, vaArgP);
+    va_end(vaArgP);
+}
+
+int
+UARTwrite(const char *pcBuf, uint32_t ui32Len)
+{
+    uartAppend(pcBuf, ui32Len);
+    return ui32Len;
+}
+
+// EEPROM. Addresses are in bytes and counts in bytes, as on the part.
+uint32_t EEPROMInit(void) { return EEPROM_INIT_OK; }
+
+void
+EEPROMRead(uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    memcpy(pui32Data, (uint8_t *)g_pui32TivaEEPROM + ui32Address, ui32Count);
+}
+
+uint32_t
+EEPROMProgram(uint32_t *pui32Data, uint32_t ui32Address, uint32_t ui32Count)
+{
+    memcpy((uint8_t *)g_pui32TivaEEPROM + ui32Address, pui32Data, ui32Count);
+    return 0;
+}
+
+// SysTick.
+void SysTickPeriodSet(uint32_t ui32Period) {}
+void SysTickEnable(void) {}
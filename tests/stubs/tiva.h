@@ -0,0 +1,252 @@
+/******************************************************************************
+ *
+ * tiva.h
+ *
+ * Purpose:
+ * Host stand-in for the parts of TivaWare the firmware uses. Every driverlib,
+ * inc and utils header under tests/stubs includes this one file. Register
+ * addresses and flag values are the real TM4C123 ones, so the firmware's
+ * own tables and comparisons behave as they do on the board.
+ *
+ * The calls land in tiva.c, which records what the firmware asked for
+ * (output states, UART bytes, priorities) and returns what a test has set
+ * up (pin levels, ADC samples, timer counts).
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __TIVA_H__
+#define __TIVA_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+// inc/hw_types.h: registers live in a small host table keyed by address.
+#define HWREG(x)                (*HostRegister((uint32_t)(x)))
+volatile uint32_t *HostRegister(uint32_t ui32Addr);
+
+// inc/hw_memmap.h
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTC_BASE         0x40006000
+#define GPIO_PORTD_BASE         0x40007000
+#define GPIO_PORTE_BASE         0x40024000
+#define GPIO_PORTF_BASE         0x40025000
+#define TIMER0_BASE             0x40030000
+#define TIMER1_BASE             0x40031000
+#define TIMER2_BASE             0x40032000
+#define UART0_BASE              0x4000C000
+#define ADC0_BASE               0x40038000
+#define ADC1_BASE               0x40039000
+#define PWM0_BASE               0x40028000
+#define PWM1_BASE               0x40029000
+
+// inc/hw_gpio.h
+#define GPIO_O_LOCK             0x00000520
+#define GPIO_O_CR               0x00000524
+#define GPIO_LOCK_KEY           0x4C4F434B
+
+// inc/hw_ints.h
+#define INT_GPIOB               17
+#define INT_GPIOC               18
+
+// driverlib/sysctl.h
+#define SYSCTL_PERIPH_ADC0      0xf0003800
+#define SYSCTL_PERIPH_ADC1      0xf0003801
+#define SYSCTL_PERIPH_EEPROM0   0xf0005800
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOB     0xf0000801
+#define SYSCTL_PERIPH_GPIOC     0xf0000802
+#define SYSCTL_PERIPH_GPIOD     0xf0000803
+#define SYSCTL_PERIPH_GPIOE     0xf0000804
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+#define SYSCTL_PERIPH_PWM0      0xf0004000
+#define SYSCTL_PERIPH_PWM1      0xf0004001
+#define SYSCTL_PERIPH_TIMER0    0xf0000400
+#define SYSCTL_PERIPH_TIMER1    0xf0000401
+#define SYSCTL_PERIPH_TIMER2    0xf0000402
+#define SYSCTL_PERIPH_UART0     0xf0001800
+#define SYSCTL_SYSDIV_4         0xC1C00000
+#define SYSCTL_USE_PLL          0x00000000
+#define SYSCTL_OSC_MAIN         0x00000000
+#define SYSCTL_XTAL_16MHZ       0x00000540
+#define SYSCTL_PWMDIV_4         0x00120000
+
+void SysCtlClockSet(uint32_t ui32Config);
+uint32_t SysCtlClockGet(void);
+void SysCtlPWMClockSet(uint32_t ui32Config);
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral);
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral);
+void SysCtlPeripheralReset(uint32_t ui32Peripheral);
+void SysCtlDelay(uint32_t ui32Count);
+
+// driverlib/gpio.h
+#define GPIO_PIN_0              0x00000001
+#define GPIO_PIN_1              0x00000002
+#define GPIO_PIN_2              0x00000004
+#define GPIO_PIN_3              0x00000008
+#define GPIO_PIN_4              0x00000010
+#define GPIO_PIN_5              0x00000020
+#define GPIO_PIN_6              0x00000040
+#define GPIO_PIN_7              0x00000080
+#define GPIO_DIR_MODE_IN        0x00000000
+#define GPIO_DIR_MODE_OUT       0x00000001
+#define GPIO_DIR_MODE_HW        0x00000002
+#define GPIO_FALLING_EDGE       0x00000000
+#define GPIO_BOTH_EDGES         0x00000001
+#define GPIO_STRENGTH_2MA       0x00000001
+#define GPIO_STRENGTH_4MA       0x00000002
+#define GPIO_PIN_TYPE_STD_WPU   0x0000000A
+#define GPIO_PIN_TYPE_STD_WPD   0x0000000C
+
+void GPIODirModeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO);
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins,
+                      uint32_t ui32Strength, uint32_t ui32PadType);
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+void GPIOPinConfigure(uint32_t ui32PinConfig);
+void GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPinTypePWM(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType);
+void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags);
+void GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags);
+void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags);
+uint32_t GPIOIntStatus(uint32_t ui32Port, bool bMasked);
+void GPIOIntRegister(uint32_t ui32Port, void (*pfnIntHandler)(void));
+
+// driverlib/pin_map.h
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PC5_M0PWM7         0x00021404
+#define GPIO_PF1_M1PWM5         0x00050405
+
+// driverlib/adc.h
+#define ADC_TRIGGER_PROCESSOR   0x00000000
+#define ADC_CTL_CH0             0x00000000
+#define ADC_CTL_CH9             0x00000009
+#define ADC_CTL_IE              0x00000040
+#define ADC_CTL_END             0x00000020
+
+void ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                          uint32_t ui32Trigger, uint32_t ui32Priority);
+void ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                              uint32_t ui32Step, uint32_t ui32Config);
+void ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum);
+int32_t ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                           uint32_t *pui32Buffer);
+void ADCProcessorTrigger(uint32_t ui32Base, uint32_t ui32SequenceNum);
+void ADCIntRegister(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                    void (*pfnHandler)(void));
+void ADCIntEnable(uint32_t ui32Base, uint32_t ui32SequenceNum);
+void ADCIntClear(uint32_t ui32Base, uint32_t ui32SequenceNum);
+uint32_t ADCIntStatus(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                      bool bMasked);
+
+// driverlib/pwm.h
+#define PWM_GEN_2               0x000000C0
+#define PWM_GEN_3               0x00000100
+#define PWM_OUT_5               0x000000C5
+#define PWM_OUT_7               0x00000107
+#define PWM_OUT_5_BIT           0x00000020
+#define PWM_OUT_7_BIT           0x00000080
+#define PWM_GEN_MODE_UP_DOWN    0x00000002
+#define PWM_GEN_MODE_NO_SYNC    0x00000000
+
+void PWMGenConfigure(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Config);
+void PWMGenPeriodSet(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Period);
+void PWMGenEnable(uint32_t ui32Base, uint32_t ui32Gen);
+void PWMPulseWidthSet(uint32_t ui32Base, uint32_t ui32PWMOut,
+                      uint32_t ui32Width);
+void PWMOutputState(uint32_t ui32Base, uint32_t ui32PWMOutBits, bool bEnable);
+
+// driverlib/timer.h
+#define TIMER_A                 0x000000FF
+#define TIMER_B                 0x0000FF00
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_CFG_PERIODIC_UP   0x00000032
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value);
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer);
+
+// driverlib/interrupt.h
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority);
+void IntEnable(uint32_t ui32Interrupt);
+bool IntMasterEnable(void);
+bool IntMasterDisable(void);
+
+// driverlib/uart.h
+#define UART_CLOCK_PIOSC        0x00000005
+
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData);
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source);
+
+// driverlib/eeprom.h
+#define EEPROM_INIT_OK          0
+
+uint32_t EEPROMInit(void);
+void EEPROMRead(uint32_t *pui32Data, uint32_t ui32Address,
+                uint32_t ui32Count);
+uint32_t EEPROMProgram(uint32_t *pui32Data, uint32_t ui32Address,
+                       uint32_t ui32Count);
+
+// driverlib/systick.h
+void SysTickPeriodSet(uint32_t ui32Period);
+void SysTickEnable(void);
+
+// driverlib/debug.h
+#define ASSERT(expr)
+
+// driverlib/rom.h and rom_map.h: straight to the stubs above.
+#define MAP_SysCtlPeripheralEnable  SysCtlPeripheralEnable
+#define MAP_GPIODirModeSet          GPIODirModeSet
+#define MAP_GPIOPadConfigSet        GPIOPadConfigSet
+#define MAP_GPIOPinRead             GPIOPinRead
+
+// utils/uartstdio.h
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud,
+                     uint32_t ui32SrcClock);
+void UARTprintf(const char *pcString, ...);
+void UARTvprintf(const char *pcString, va_list vaArgP);
+int UARTwrite(const char *pcBuf, uint32_t ui32Len);
+
+//*****************************************************************************
+//
+// Test controls and records.
+//
+//*****************************************************************************
+
+/** @brief Clears every record and input below back to power-on. */
+void TivaReset(void);
+
+/** @brief Level a pin reads back (non-zero for high). */
+void TivaPinSet(uint32_t ui32Port, uint8_t ui8Pins, bool bHigh);
+
+/** @brief Sample the next ADCSequenceDataGet() on any converter returns. */
+void TivaADCSet(uint32_t ui32Sample);
+
+/** @brief Value TimerValueGet() returns for every timer. */
+extern volatile uint32_t g_ui32TivaTimer;
+
+/** @brief Output bits currently enabled on PWM0 and PWM1. */
+extern uint32_t g_pui32TivaPWMOutputs[2];
+
+/** @brief Number of PWMOutputState(..., false) calls since the reset. */
+extern uint32_t g_ui32TivaPWMOffCalls;
+
+/** @brief Last priority set for each interrupt number. */
+extern uint8_t g_pui8TivaIntPriority[160];
+
+/** @brief Everything sent through UARTCharPut and UARTprintf. */
+extern char g_pcTivaUART[16384];
+extern uint32_t g_ui32TivaUARTLen;
+
+/** @brief The EEPROM contents, in words. */
+extern uint32_t g_pui32TivaEEPROM[512];
+
+#endif /* __TIVA_H__ */
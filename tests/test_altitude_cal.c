@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * test_altitude_cal.c
+ *
+ * Purpose:
+ * Host test of the altitude linearisation: the table build and its checks,
+ * a sweep through the record calls, the record kept in the stubbed EEPROM
+ * across a restart, and the fall back to the linear conversion when the
+ * record is missing or corrupt.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "log_task.h"
+#include "altitude_cal.h"
+
+#define GROUND_ADC      3000
+
+/**
+ * @brief A rig whose sensor is more sensitive near the top. The points are
+ * on table segment boundaries, so the knees between them are not rounded
+ * off by the interpolation.
+ */
+static const uint32_t g_pui32Drops[ALTITUDE_CAL_POINTS] = {
+    0, 256, 640, 1024, 1536, 2048
+};
+
+/** @brief Checks every point lands on its share of the span. */
+static void
+checkPoints(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < ALTITUDE_CAL_POINTS; i++)
+    {
+        CHECK_EQ(AltitudeCalHeight(g_pui32Drops[i]),
+                 i * 2048 / (ALTITUDE_CAL_POINTS - 1));
+    }
+}
+
+static void
+checkIdentity(void)
+{
+    CHECK_EQ(AltitudeCalHeight(0), 0);
+    CHECK_EQ(AltitudeCalHeight(700), 700);
+    CHECK_EQ(AltitudeCalHeight(4095), 4095);
+}
+
+static void
+sweep(const uint32_t *pui32Drops)
+{
+    uint32_t i;
+
+    AltitudeCalBegin();
+    for (i = 0; i < ALTITUDE_CAL_POINTS; i++)
+    {
+        CHECK(AltitudeCalActive());
+        CHECK_EQ(AltitudeCalRecord(GROUND_ADC - pui32Drops[i]),
+                 i == ALTITUDE_CAL_POINTS - 1);
+    }
+    CHECK(!AltitudeCalActive());
+}
+
+int
+main(void)
+{
+    static const uint32_t pui32Linear[ALTITUDE_CAL_POINTS] = {
+        0, 400, 800, 1200, 1600, 2000
+    };
+    static const uint32_t pui32Falling[ALTITUDE_CAL_POINTS] = {
+        0, 400, 800, 700, 1600, 2000
+    };
+    static const uint32_t pui32Short[ALTITUDE_CAL_POINTS] = {
+        0, 20, 40, 60, 80, 100
+    };
+    uint16_t pui16Table[ALTITUDE_CAL_TABLE_SIZE];
+    uint32_t i, ui32Prev, ui32Monotonic = 1;
+
+    HostKernelReset();
+    TivaReset();
+
+    // A linear rig gives back the identity table; bad sweeps are refused.
+    CHECK(AltitudeCalBuild(pui32Linear, pui16Table));
+    for (i = 0; i < ALTITUDE_CAL_TABLE_SIZE; i++)
+    {
+        CHECK_EQ(pui16Table[i], i << ALTITUDE_CAL_SEGMENT_BITS);
+    }
+    CHECK(!AltitudeCalBuild(pui32Falling, pui16Table));
+    CHECK(!AltitudeCalBuild(pui32Short, pui16Table));
+
+    // Nothing saved yet: the linear conversion.
+    CHECK_EQ(AltitudeCalInit(), 0);
+    checkIdentity();
+
+    // A sweep is published and saved, and maps each point to its height.
+    sweep(g_pui32Drops);
+    checkPoints();
+    ui32Prev = AltitudeCalHeight(0);
+    for (i = 1; i <= 5000; i++)
+    {
+        ui32Monotonic &= AltitudeCalHeight(i) >= ui32Prev;
+        ui32Prev = AltitudeCalHeight(i);
+    }
+    CHECK(ui32Monotonic);
+    CHECK_EQ(AltitudeCalHeight(5000), AltitudeCalHeight(4095));
+
+    // It survives a restart.
+    CHECK_EQ(AltitudeCalInit(), 0);
+    checkPoints();
+
+    // A sweep that goes down part way, or is abandoned, keeps the table.
+    sweep(pui32Falling);
+    checkPoints();
+    AltitudeCalBegin();
+    AltitudeCalRecord(GROUND_ADC);
+    AltitudeCalAbort();
+    CHECK(!AltitudeCalActive());
+    CHECK(!AltitudeCalRecord(GROUND_ADC));
+    checkPoints();
+
+    // A corrupt record is ignored at the next start.
+    g_pui32TivaEEPROM[3] ^= 0x10;
+    CHECK_EQ(AltitudeCalInit(), 0);
+    checkIdentity();
+
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "no table saved") != NULL);
+    CHECK(strstr(g_pcTivaUART, "table saved") != NULL);
+    CHECK(strstr(g_pcTivaUART, "table loaded") != NULL);
+    CHECK(strstr(g_pcTivaUART, "sweep rejected") != NULL);
+    CHECK(strstr(g_pcTivaUART, "sweep abandoned") != NULL);
+
+    return CHECK_EXIT();
+}
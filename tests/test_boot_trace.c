@@ -0,0 +1,85 @@
+/******************************************************************************
+ *
+ * test_boot_trace.c
+ *
+ * Purpose:
+ * Host test of the start-up milestones, timed on the stubbed DWT counter
+ * with the OLED's power-up delay stubbed in: main() zeroes the counter once,
+ * the control milestones are reached before the display is brought up, the
+ * display's delay shows only in its own milestone, and the kernel benchmark
+ * starts the counter without resetting it.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "dwt.h"
+#include "boot_trace.h"
+#include "log_task.h"
+
+// The benchmark is compiled out of the firmware unless asked for.
+#include "config.h"
+#undef KERNEL_BENCH_ENABLE
+#define KERNEL_BENCH_ENABLE 1
+#include "kernel_bench.c"
+
+#define CYCLES_PER_US       (configCPU_CLOCK_HZ / 1000000)
+
+/** @brief The OLED power-up the display task now waits through. */
+#define OLED_POWER_UP_US    102000
+
+extern int firmware_main(void);
+
+int
+main(void)
+{
+    hostTask_t *psDisplay;
+
+    HostKernelReset();
+    TivaReset();
+
+    // Whatever the counter held, the boot is timed from main().
+    DWT_CYCLES() = 12345678;
+    CHECK_EQ(HostBoot(firmware_main, 2000), 1);
+    CHECK(HWREG(DEM_CR) & DEM_CR_TRCENA);
+    CHECK(HWREG(DWT_CTRL) & DWT_CTRL_CYCCNTENA);
+    CHECK(BootTraceMicroseconds(BOOT_MARK_SCHEDULER_START) < OLED_POWER_UP_US);
+    CHECK(BootTraceMicroseconds(BOOT_MARK_CRITICAL_READY) <=
+          BootTraceMicroseconds(BOOT_MARK_SCHEDULER_START));
+    CHECK_EQ(BootTraceMicroseconds(BOOT_MARK_DISPLAY_READY), 0);
+
+    // The display task brings up the OLED once it is scheduled; its
+    // power-up time lands after the scheduler has started.
+    psDisplay = HostTaskFind("Display");
+    CHECK(psDisplay != NULL);
+    if (psDisplay != NULL)
+    {
+        CHECK_EQ(HostRunTask(psDisplay->pxCode, psDisplay->pvParameters, 1), 1);
+    }
+    CHECK_EQ(BootTraceMicroseconds(BOOT_MARK_DISPLAY_READY) -
+             BootTraceMicroseconds(BOOT_MARK_SCHEDULER_START), OLED_POWER_UP_US);
+
+    // Later marks of a milestone already reached are ignored.
+    DWT_CYCLES() += 5 * OLED_POWER_UP_US * CYCLES_PER_US;
+    BootTraceMark(BOOT_MARK_DISPLAY_READY);
+    BootTraceMark(BOOT_NUM_MARKS);
+    CHECK_EQ(BootTraceMicroseconds(BOOT_MARK_DISPLAY_READY), OLED_POWER_UP_US);
+    CHECK_EQ(BootTraceMicroseconds(BOOT_NUM_MARKS), 0);
+
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "Boot: critical init done at 0 us.\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Boot: display ready at 102000 us.\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Boot: display ready at 612000 us.\n") == NULL);
+
+    // The benchmark only takes differences, and leaves the count alone.
+    DWT_CYCLES() = 4242;
+    CHECK_EQ(KernelBenchInit(), 0);
+    CHECK_EQ(DWT_CYCLES(), 4242);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,328 @@
+/******************************************************************************
+ *
+ * test_dsp_filter.c
+ *
+ * Purpose:
+ * Host test of the fixed-point filter kernels against plain reference
+ * implementations: the FIR and CIC must match a direct convolution exactly,
+ * the biquad cascade must stay within a count of the same filter in double
+ * precision, the median network must agree with a sort, and the matrix
+ * product must wrap at 32 bits as the SMLAD instruction does.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "check.h"
+#include "dsp_filter.h"
+
+#define NUM_SAMPLES     2000
+#define FIR_TAPS        16
+#define CIC_MAX_RATIO   16
+
+static int16_t g_pi16In[NUM_SAMPLES];
+static int16_t g_pi16Out[NUM_SAMPLES];
+static uint32_t g_ui32Seed = 1;
+
+/** @brief Repeatable pseudo-random numbers, so a failure can be replayed. */
+static int32_t
+randomRange(int32_t i32Lo, int32_t i32Hi)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return i32Lo + (int32_t)((g_ui32Seed >> 8) % (uint32_t)(i32Hi - i32Lo + 1));
+}
+
+/** @brief 12-bit ADC counts: a slow ramp, noise and the odd full-scale step. */
+static void
+fillInput(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < NUM_SAMPLES; i++)
+    {
+        g_pi16In[i] = (int16_t)(1000 + (i % 500) + randomRange(-40, 40) +
+                                ((i / 300) & 1 ? 2000 : 0));
+    }
+}
+
+static int16_t
+clamp16(int64_t i64Value)
+{
+    return i64Value > INT16_MAX ? INT16_MAX :
+           i64Value < INT16_MIN ? INT16_MIN : (int16_t)i64Value;
+}
+
+static int
+compareInt16(const void *pvA, const void *pvB)
+{
+    return *(const int16_t *)pvA - *(const int16_t *)pvB;
+}
+
+static void
+testFir(void)
+{
+    static const int16_t pi16Taps[FIR_TAPS] = {
+        -310, -120, 420, 1350, 2600, 3800, 4600, 4880,
+        4880, 4600, 3800, 2600, 1350, 420, -120, -310,
+    };
+    uint32_t pui32Coeffs[FIR_TAPS / 2];
+    int16_t pi16State[2 * FIR_TAPS];
+    dspFir_t sFir;
+    uint32_t i, k, ui32Mismatches = 0;
+
+    for (i = 0; i < FIR_TAPS / 2; i++)
+    {
+        pui32Coeffs[i] = DSP_FIR_PAIR(pi16Taps[2 * i], pi16Taps[2 * i + 1]);
+    }
+    CHECK(!DspFirInit(&sFir, pui32Coeffs, pi16State, FIR_TAPS - 1));
+    CHECK(DspFirInit(&sFir, pui32Coeffs, pi16State, FIR_TAPS));
+    DspFirBlock(&sFir, g_pi16In, g_pi16Out, NUM_SAMPLES);
+
+    // y[n] = round(sum h[k] x[n - k] / 2^15), x before the start zero.
+    for (i = 0; i < NUM_SAMPLES; i++)
+    {
+        int64_t i64Acc = 1 << 14;
+
+        for (k = 0; k < FIR_TAPS && k <= i; k++)
+        {
+            i64Acc += (int64_t)pi16Taps[k] * g_pi16In[i - k];
+        }
+        ui32Mismatches += g_pi16Out[i] != clamp16(i64Acc >> 15);
+    }
+    CHECK_EQ(ui32Mismatches, 0);
+
+    // Primed with the first reading, a constant comes out at the DC gain
+    // straight away, with no start-up transient.
+    for (i = 0, k = 0; i < FIR_TAPS; i++)
+    {
+        k += pi16Taps[i];
+    }
+    DspFirReset(&sFir, 2048);
+    CHECK_EQ(DspFirProcess(&sFir, 2048), (2048 * (int32_t)k + (1 << 14)) >> 15);
+}
+
+static void
+testBiquad(void)
+{
+    // Two Butterworth low-pass sections, b0 b1 b2 a1 a2 in Q14, each with
+    // a DC gain of exactly one: b0 + b1 + b2 = 1 + a1 + a2.
+    static const int16_t ppi16Coeffs[2][5] = {
+        { 329, 658, 329, -25576, 10508 },
+        { 1106, 2208, 1106, -18727, 6763 },
+    };
+    double ppdState[2][4] = { { 0 } };
+    dspBiquad_t sBiquad;
+    int32_t i32Error, i32WorstError = 0;
+    uint32_t i, j;
+
+    CHECK(!DspBiquadInit(&sBiquad, ppi16Coeffs, DSP_BIQUAD_MAX_STAGES + 1));
+    CHECK(DspBiquadInit(&sBiquad, ppi16Coeffs, 2));
+    DspBiquadBlock(&sBiquad, g_pi16In, g_pi16Out, NUM_SAMPLES);
+
+    for (i = 0; i < NUM_SAMPLES; i++)
+    {
+        double dValue = g_pi16In[i];
+
+        for (j = 0; j < 2; j++)
+        {
+            const int16_t *pi16C = ppi16Coeffs[j];
+            double *pdS = ppdState[j];      // x1 x2 y1 y2
+            double dOut = (pi16C[0] * dValue + pi16C[1] * pdS[0] +
+                           pi16C[2] * pdS[1] - pi16C[3] * pdS[2] -
+                           pi16C[4] * pdS[3]) / 16384.0;
+
+            pdS[1] = pdS[0];
+            pdS[0] = dValue;
+            pdS[3] = pdS[2];
+            pdS[2] = dOut;
+            dValue = dOut;
+        }
+
+        i32Error = abs(g_pi16Out[i] - (int32_t)floor(dValue + 0.5));
+        if (i32Error > i32WorstError)
+        {
+            i32WorstError = i32Error;
+        }
+    }
+    CHECK(i32WorstError <= 1);
+
+    // Settled on a constant, the error feedback leaves no dead band.
+    DspBiquadReset(&sBiquad, 3000);
+    for (i = 0; i < 200; i++)
+    {
+        g_pi16Out[0] = DspBiquadProcess(&sBiquad, 3000);
+    }
+    CHECK_EQ(g_pi16Out[0], 3000);
+}
+
+static void
+testCic(uint32_t ui32Order, uint32_t ui32Ratio)
+{
+    // Impulse response: a boxcar of the ratio convolved ui32Order times.
+    int64_t pi64H[DSP_CIC_MAX_ORDER * CIC_MAX_RATIO] = { 0 };
+    int64_t pi64Next[DSP_CIC_MAX_ORDER * CIC_MAX_RATIO];
+    uint32_t ui32Len = 1, ui32Outputs, ui32Shift = 0;
+    uint32_t i, j, k, ui32Mismatches = 0;
+    dspCic_t sCic;
+
+    pi64H[0] = 1;
+    for (i = 0; i < ui32Order; i++)
+    {
+        for (j = 0; j < ui32Len + ui32Ratio - 1; j++)
+        {
+            pi64Next[j] = 0;
+            for (k = 0; k < ui32Ratio; k++)
+            {
+                pi64Next[j] += j >= k && j - k < ui32Len ? pi64H[j - k] : 0;
+            }
+        }
+        ui32Len += ui32Ratio - 1;
+        for (j = 0; j < ui32Len; j++)
+        {
+            pi64H[j] = pi64Next[j];
+        }
+    }
+    for (i = 1; i < ui32Ratio; i <<= 1)
+    {
+        ui32Shift += ui32Order;
+    }
+
+    CHECK(DspCicInit(&sCic, ui32Order, ui32Ratio));
+    ui32Outputs = DspCicBlock(&sCic, g_pi16In, g_pi16Out, NUM_SAMPLES);
+    CHECK_EQ(ui32Outputs, NUM_SAMPLES / ui32Ratio);
+
+    // Output j is taken once input (j + 1) R - 1 is in.
+    for (j = 0; j < ui32Outputs; j++)
+    {
+        uint32_t n = (j + 1) * ui32Ratio - 1;
+        int64_t i64Acc = 0;
+
+        for (k = 0; k < ui32Len && k <= n; k++)
+        {
+            i64Acc += pi64H[k] * g_pi16In[n - k];
+        }
+        ui32Mismatches += g_pi16Out[j] != clamp16(i64Acc >> ui32Shift);
+    }
+    CHECK_EQ(ui32Mismatches, 0);
+}
+
+static void
+testMedian(void)
+{
+    static const uint32_t pui32Sizes[] = { 3, 5, 7, 9 };
+    int16_t pi16Sorted[DSP_MEDIAN_MAX_WINDOW];
+    dspMedian_t sMedian;
+    dspHampel_t sHampel;
+    uint32_t i, j, s, ui32Mismatches = 0;
+
+    CHECK(!DspMedianInit(&sMedian, 4));
+    CHECK(!DspMedianInit(&sMedian, 11));
+
+    for (s = 0; s < sizeof(pui32Sizes) / sizeof(pui32Sizes[0]); s++)
+    {
+        uint32_t ui32Size = pui32Sizes[s];
+
+        CHECK(DspMedianInit(&sMedian, ui32Size));
+        for (i = 0; i < NUM_SAMPLES; i++)
+        {
+            // Wide values too: the network must not overflow.
+            int16_t i16In = (int16_t)randomRange(INT16_MIN, INT16_MAX);
+            int16_t i16Median = DspMedianProcess(&sMedian, i16In);
+
+            if (i + 1 < ui32Size)
+            {
+                continue;
+            }
+            for (j = 0; j < ui32Size; j++)
+            {
+                pi16Sorted[j] = sMedian.pi16Window[j];
+            }
+            qsort(pi16Sorted, ui32Size, sizeof(int16_t), compareInt16);
+            ui32Mismatches += i16Median != pi16Sorted[ui32Size / 2];
+        }
+    }
+    CHECK_EQ(ui32Mismatches, 0);
+
+    // A lone spike on a noisy level is replaced; the level itself, and a
+    // step that stays, pass unchanged.
+    CHECK(DspHampelInit(&sHampel, 5, DSP_HAMPEL_SIGMAS_Q8(3)));
+    DspHampelReset(&sHampel, 1000);
+    CHECK_EQ(DspHampelProcess(&sHampel, 1001), 1001);
+    CHECK_EQ(DspHampelProcess(&sHampel, 999), 999);
+    CHECK_EQ(DspHampelProcess(&sHampel, 1900), 1000);
+    CHECK_EQ(DspHampelProcess(&sHampel, 1000), 1000);
+    CHECK_EQ(sHampel.ui32Replaced, 1);
+    for (i = 0; i < 3; i++)
+    {
+        DspHampelProcess(&sHampel, 1500);
+    }
+    CHECK_EQ(DspHampelProcess(&sHampel, 1500), 1500);
+}
+
+static void
+testMatVec(void)
+{
+    enum { ROWS = 3, COLS = 8 };
+    int16_t ppi16M[ROWS][COLS], pi16V[COLS];
+    uint32_t pui32Packed[ROWS * COLS / 2];
+    int32_t pi32Out[ROWS];
+    uint32_t i, j, ui32Mismatches = 0;
+
+    // Full-range entries, so some rows wrap.
+    for (i = 0; i < ROWS; i++)
+    {
+        for (j = 0; j < COLS; j++)
+        {
+            ppi16M[i][j] = (int16_t)randomRange(INT16_MIN, INT16_MAX);
+        }
+        for (j = 0; j < COLS / 2; j++)
+        {
+            pui32Packed[i * COLS / 2 + j] = DSP_MAT_PAIR(ppi16M[i][2 * j],
+                                                         ppi16M[i][2 * j + 1]);
+        }
+    }
+    for (j = 0; j < COLS; j++)
+    {
+        pi16V[j] = j == 0 ? INT16_MIN : (int16_t)randomRange(INT16_MIN, INT16_MAX);
+    }
+    ppi16M[0][0] = INT16_MIN;
+    pui32Packed[0] = DSP_MAT_PAIR(INT16_MIN, ppi16M[0][1]);
+
+    DspMatVec(pui32Packed, pi16V, pi32Out, ROWS, COLS);
+    for (i = 0; i < ROWS; i++)
+    {
+        uint32_t ui32Acc = 0;
+
+        for (j = 0; j < COLS; j++)
+        {
+            ui32Acc += (uint32_t)((int32_t)ppi16M[i][j] * pi16V[j]);
+        }
+        ui32Mismatches += (uint32_t)pi32Out[i] != ui32Acc;
+    }
+    CHECK_EQ(ui32Mismatches, 0);
+}
+
+int
+main(void)
+{
+    uint32_t ui32Order, ui32Ratio;
+
+    fillInput();
+    testFir();
+    testBiquad();
+    for (ui32Order = 1; ui32Order <= DSP_CIC_MAX_ORDER; ui32Order++)
+    {
+        for (ui32Ratio = 1; ui32Ratio <= CIC_MAX_RATIO; ui32Ratio <<= 1)
+        {
+            testCic(ui32Order, ui32Ratio);
+        }
+    }
+    CHECK(!DspCicInit(&(dspCic_t){ 0 }, 2, 6));
+    testMedian();
+    testMatVec();
+
+    return CHECK_EXIT();
+}
@@ -0,0 +1,221 @@
+/******************************************************************************
+ *
+ * test_empc.c
+ *
+ * Purpose:
+ * Host test of the explicit MPC table as the firmware evaluates it. The
+ * table must be well formed. Hover must be found in the first,
+ * unconstrained region with the trims as its duties. For states spread
+ * over the box the generator covered, the region found must hold the
+ * state by a plain 64-bit evaluation of its half-spaces. The duties must
+ * stay within the limits the problem was solved under, and must not jump
+ * where a neighbouring state falls in another region, as the solution is
+ * continuous.
+ * tools/empc_gen.py --check compares the same table against the QP itself.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdlib.h>
+#include "check.h"
+#include "empc.h"
+
+#define NUM_STATES      20000
+
+/** @brief Duty limits the table was solved for, in percent. */
+#define MAIN_MAX        99
+#define TAIL_MAX        85
+
+/** @brief Half-widths of tools/empc_gen.py's STATE_BOX in state units. */
+static const int32_t g_pi32Box[LQR_STATES] = {
+    1000, 2000, 180, 1000, 200 * 16, 100 * 16, 99 * 16, 99 * 16
+};
+
+static uint32_t g_ui32Seed = 1;
+
+static int32_t
+randomRange(int32_t i32Lo, int32_t i32Hi)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return i32Lo + (int32_t)((g_ui32Seed >> 8) % (uint32_t)(i32Hi - i32Lo + 1));
+}
+
+/** @brief A state mostly near hover, as the generator's check draws them. */
+static void
+randomState(int16_t *pi16State)
+{
+    uint32_t i;
+
+    for (i = 0; i < LQR_STATES; i++)
+    {
+        // Sum of three uniforms: bell shaped, about 0.3 of the box wide.
+        int32_t i32Value = (randomRange(-g_pi32Box[i], g_pi32Box[i]) +
+                            randomRange(-g_pi32Box[i], g_pi32Box[i]) +
+                            randomRange(-g_pi32Box[i], g_pi32Box[i])) / 6;
+
+        pi16State[i] = (int16_t)i32Value;
+    }
+}
+
+/** @brief Largest amount by which the state breaks one of the region's
+ * half-spaces, or a value <= 0 if it is inside. */
+static int64_t
+excess(uint32_t ui32Region, const int16_t *pi16State)
+{
+    const empcRegion_t *psRegion = &g_sEmpcTable.psRegions[ui32Region];
+    int64_t i64Worst = INT64_MIN;
+    uint32_t i, j;
+
+    for (i = 0; i < psRegion->ui16Count; i++)
+    {
+        const uint32_t *pui32Row = &g_sEmpcTable.pui32Halfspaces[
+            (psRegion->ui16First + i) * LQR_STATES / 2];
+        int64_t i64Sum = 0;
+
+        for (j = 0; j < LQR_STATES / 2; j++)
+        {
+            i64Sum += (int64_t)(int16_t)pui32Row[j] * pi16State[2 * j] +
+                      (int64_t)(int16_t)(pui32Row[j] >> 16) * pi16State[2 * j + 1];
+        }
+        i64Sum -= g_sEmpcTable.pi32Bounds[psRegion->ui16First + i];
+        if (i64Sum > i64Worst)
+        {
+            i64Worst = i64Sum;
+        }
+    }
+
+    return i64Worst;
+}
+
+/** @brief A region's law at a state, as the firmware evaluates it. */
+static void
+law(uint32_t ui32Region, const int16_t *pi16State, int32_t *pi32Duty)
+{
+    const empcRegion_t *psRegion = &g_sEmpcTable.psRegions[ui32Region];
+    uint32_t i, j;
+
+    for (i = 0; i < LQR_DUTIES; i++)
+    {
+        const uint32_t *pui32Row = &psRegion->pui32Gains[i * LQR_STATES / 2];
+        int64_t i64Sum = 0;
+
+        for (j = 0; j < LQR_STATES / 2; j++)
+        {
+            i64Sum += (int64_t)(int16_t)pui32Row[j] * pi16State[2 * j] +
+                      (int64_t)(int16_t)(pui32Row[j] >> 16) * pi16State[2 * j + 1];
+        }
+        pi32Duty[i] = (int32_t)((psRegion->pi32Trim[i] - i64Sum) >>
+                                psRegion->pui32Shift[i]);
+    }
+}
+
+static void
+checkTable(void)
+{
+    uint32_t r, ui32Next = 0;
+
+    CHECK(g_sEmpcTable.ui32Regions > 0);
+    for (r = 0; r < g_sEmpcTable.ui32Regions; r++)
+    {
+        const empcRegion_t *psRegion = &g_sEmpcTable.psRegions[r];
+
+        // Regions take consecutive runs of half-spaces.
+        CHECK_EQ(psRegion->ui16First, ui32Next);
+        CHECK(psRegion->ui16Count > 0 && psRegion->ui16Count <= EMPC_MAX_HALFSPACES);
+        ui32Next += psRegion->ui16Count;
+    }
+}
+
+int
+main(void)
+{
+    int16_t pi16State[LQR_STATES] = { 0 };
+    int16_t pi16Near[LQR_STATES];
+    int32_t pi32Duty[LQR_DUTIES], pi32NearDuty[LQR_DUTIES];
+    int32_t pi32LawDuty[LQR_DUTIES];
+    const empcRegion_t *psHover = &g_sEmpcTable.psRegions[0];
+    uint32_t ui32Outside = 0, ui32Wrong = 0, ui32OffLimits = 0;
+    uint32_t ui32Jumps = 0;
+    uint32_t i, r;
+
+    checkTable();
+
+    // Hover: the unconstrained region, and nothing but the trims.
+    CHECK_EQ(EmpcLocate(pi16State, g_sEmpcTable.ui32Regions), 0);
+    CHECK(excess(0, pi16State) <= 0);
+    EmpcEvaluate(pi16State, pi32Duty);
+    CHECK_EQ(pi32Duty[LQR_MAIN], psHover->pi32Trim[LQR_MAIN] >> psHover->pui32Shift[LQR_MAIN]);
+    CHECK_EQ(pi32Duty[LQR_TAIL], psHover->pi32Trim[LQR_TAIL] >> psHover->pui32Shift[LQR_TAIL]);
+
+    for (i = 0; i < NUM_STATES; i++)
+    {
+        uint32_t ui32Found;
+
+        randomState(pi16State);
+        ui32Found = EmpcLocate(pi16State, g_sEmpcTable.ui32Regions);
+
+        // The first region holding the state, or if none does (rounding at
+        // a boundary), none is found inside.
+        if (excess(ui32Found, pi16State) > 0)
+        {
+            ui32Outside++;
+            for (r = 0; r < g_sEmpcTable.ui32Regions; r++)
+            {
+                ui32Wrong += excess(r, pi16State) <= 0;
+            }
+        }
+        else
+        {
+            for (r = 0; r < ui32Found; r++)
+            {
+                ui32Wrong += excess(r, pi16State) <= 0;
+            }
+        }
+
+        // The firmware truncates to whole percent, hence the count of slack.
+        EmpcEvaluate(pi16State, pi32Duty);
+        ui32OffLimits += pi32Duty[LQR_MAIN] < -1 || pi32Duty[LQR_MAIN] > MAIN_MAX + 1 ||
+                         pi32Duty[LQR_TAIL] < -1 || pi32Duty[LQR_TAIL] > TAIL_MAX + 1;
+
+        // The law found must be the region's own.
+        law(ui32Found, pi16State, pi32LawDuty);
+        ui32Wrong += pi32LawDuty[LQR_MAIN] != pi32Duty[LQR_MAIN] ||
+                     pi32LawDuty[LQR_TAIL] != pi32Duty[LQR_TAIL];
+
+        // One count along one state, possibly into another region, moves
+        // the duties no further than one of the two laws would over that
+        // step. A jump where the laws fail to meet would move them further.
+        for (r = 0; r < LQR_STATES; r++)
+        {
+            pi16Near[r] = pi16State[r];
+        }
+        pi16Near[i % LQR_STATES] += 1;
+        EmpcEvaluate(pi16Near, pi32NearDuty);
+        for (r = 0; r < LQR_DUTIES; r++)
+        {
+            int32_t pi32A[LQR_DUTIES], pi32B[LQR_DUTIES];
+            int32_t pi32A1[LQR_DUTIES], pi32B1[LQR_DUTIES];
+            uint32_t ui32Near = EmpcLocate(pi16Near, g_sEmpcTable.ui32Regions);
+            int32_t i32Step;
+
+            law(ui32Found, pi16State, pi32A);
+            law(ui32Found, pi16Near, pi32A1);
+            law(ui32Near, pi16State, pi32B);
+            law(ui32Near, pi16Near, pi32B1);
+            i32Step = abs(pi32A1[r] - pi32A[r]) > abs(pi32B1[r] - pi32B[r]) ?
+                      abs(pi32A1[r] - pi32A[r]) : abs(pi32B1[r] - pi32B[r]);
+            ui32Jumps += abs(pi32NearDuty[r] - pi32Duty[r]) > i32Step + 2;
+        }
+    }
+
+    printf("%u states, %u regions: %u outside every region\n", NUM_STATES,
+           g_sEmpcTable.ui32Regions, ui32Outside);
+    CHECK_EQ(ui32Wrong, 0);
+    CHECK(ui32Outside < NUM_STATES / 100);
+    CHECK_EQ(ui32OffLimits, 0);
+    CHECK_EQ(ui32Jumps, 0);
+
+    return CHECK_EXIT();
+}
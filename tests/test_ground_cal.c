@@ -0,0 +1,155 @@
+/******************************************************************************
+ *
+ * test_ground_cal.c
+ *
+ * Purpose:
+ * Host test of the control task's ground calibration on simulated ADC
+ * traces, fed one reading per control period as the task does until the
+ * ground is known. A rig settling after power-up is rejected while it still
+ * moves and accepted at the end of its first quiet window, with the mean of
+ * that window. A noisy rig is rejected and retried window after window,
+ * and a window the noise ends part way through is still rejected; only the
+ * next whole quiet one is accepted.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "config.h"
+#include "system_state.h"
+#include "control_task.c"
+
+#define GROUND_ADC          2000    // Where the rig comes to rest
+#define MAX_WINDOWS         16
+
+static uint32_t g_ui32Samples = 0;
+static uint32_t g_ui32Calibrations = 0;
+static uint32_t g_ui32CalibratedAt = 0;
+static uint32_t g_ui32CalibratedADC = 0;
+static uint32_t g_ui32Seed = 1;
+
+/** @brief Uniform integer noise in -i32Amp..i32Amp. */
+static int32_t
+noise(int32_t i32Amp)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return (int32_t)((g_ui32Seed >> 8) % (uint32_t)(2 * i32Amp + 1)) - i32Amp;
+}
+
+/** @brief Starts a trace from power-up: nothing collected, nothing known. */
+static void
+restart(void)
+{
+    SystemStateClear(SYSTEM_STATE_CALIBRATED);
+    g_ui32Samples = 0;
+    g_ui32Calibrations = 0;
+    LogFlush();
+    g_ui32TivaUARTLen = 0;
+    g_pcTivaUART[0] = '\0';
+}
+
+/**
+ * @brief One control period: a reading goes in only until the ground is
+ * known. Records the reading that published it, and what was published.
+ */
+static void
+feed(uint32_t ui32ADC)
+{
+    if (!(SystemStateGet() & SYSTEM_STATE_CALIBRATED))
+    {
+        g_ui32Samples++;
+        ground_cal_sample(ui32ADC);
+        if (SystemStateGet() & SYSTEM_STATE_CALIBRATED)
+        {
+            g_ui32Calibrations++;
+            g_ui32CalibratedAt = g_ui32Samples;
+            g_ui32CalibratedADC = SystemStateGround();
+        }
+    }
+}
+
+/** @brief Occurrences of pcText in what the log task has written. */
+static uint32_t
+logged(const char *pcText)
+{
+    const char *pcAt = g_pcTivaUART;
+    uint32_t ui32Count = 0;
+
+    LogFlush();
+    while ((pcAt = strstr(pcAt, pcText)) != NULL)
+    {
+        ui32Count++;
+        pcAt += strlen(pcText);
+    }
+
+    return ui32Count;
+}
+
+int
+main(void)
+{
+    uint32_t i;
+    float fT;
+
+    HostKernelReset();
+    TivaReset();
+    CHECK_EQ(SystemStateInit(), 0);
+
+    // Settling: the rig rings down from a 60 count swing with a 40 ms time
+    // constant, on top of a count of sensor noise. The first window still
+    // swings by far more than the limit; by the second it is inside it.
+    restart();
+    for (i = 0; i < MAX_WINDOWS * GROUND_CAL_SAMPLES; i++)
+    {
+        fT = (float)(i * CONTROL_PERIOD_MS);
+        feed(GROUND_ADC + (int32_t)lrintf(60.0f * expf(-fT / 40.0f) *
+                                          cosf(fT / 15.0f)) + noise(1));
+    }
+    CHECK_EQ(g_ui32Calibrations, 1);
+    CHECK_EQ(g_ui32CalibratedAt, 2 * GROUND_CAL_SAMPLES);
+    CHECK(g_ui32CalibratedADC >= GROUND_ADC - 1 &&
+          g_ui32CalibratedADC <= GROUND_ADC + 1);
+    CHECK_EQ(logged("unsettled, retrying"), 1);
+    CHECK_EQ(logged("accepted"), 1);
+
+    // Once known, later readings are not collected at all.
+    CHECK_EQ(g_ui32Samples, 2 * GROUND_CAL_SAMPLES);
+
+    // Noisy: eight counts either way is a variance of about 24. Every
+    // window is rejected and collection starts again from scratch.
+    restart();
+    for (i = 0; i < 10 * GROUND_CAL_SAMPLES; i++)
+    {
+        feed(GROUND_ADC + noise(8));
+    }
+    CHECK_EQ(g_ui32Calibrations, 0);
+    CHECK(!(SystemStateGet() & SYSTEM_STATE_CALIBRATED));
+    CHECK_EQ(logged("unsettled, retrying"), 10);
+
+    // The noise stops half way through a window: that window is still
+    // rejected, and the next, quiet throughout, is accepted at its end.
+    for (i = 0; i < GROUND_CAL_SAMPLES / 2; i++)
+    {
+        feed(GROUND_ADC + 5 + noise(8));
+    }
+    for (i = 0; i < 4 * GROUND_CAL_SAMPLES; i++)
+    {
+        feed(GROUND_ADC + 5 + noise(1));
+    }
+    CHECK_EQ(g_ui32Calibrations, 1);
+    CHECK_EQ(g_ui32CalibratedAt, 12 * GROUND_CAL_SAMPLES);
+    CHECK(g_ui32CalibratedADC >= GROUND_ADC + 4 &&
+          g_ui32CalibratedADC <= GROUND_ADC + 6);
+    CHECK_EQ(logged("unsettled, retrying"), 11);
+    CHECK_EQ(logged("accepted"), 1);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+ *
+ * test_log_task.c
+ *
+ * Purpose:
+ * Host test of the deferred log ring: records come out formatted and in
+ * order, a burst past the ring size is dropped and counted rather than
+ * blocking, the drain task reports the loss, and a slot reserved but not
+ * yet published holds back everything behind it. Also prints the cost of
+ * a LogWrite() call on the host.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "semphr.h"
+#include "log_task.c"
+
+#define BURST           100
+#define TIMED_CALLS     1000000
+
+static StaticSemaphore_t g_xUARTBuf;
+
+int
+main(void)
+{
+    struct timespec sStart, sEnd;
+    uint32_t i, ui32Kept = 0;
+    double dNs;
+
+    HostKernelReset();
+    TivaReset();
+    g_pUARTSemaphore = xSemaphoreCreateMutexStatic(&g_xUARTBuf);
+
+    // Formatted in the drain, stamped with the tick of the call.
+    HostTickSet(42);
+    CHECK_EQ(LOG1(LOG_BUTTON_PRESSED, "Up"), 1);
+    CHECK_EQ(LOG2(LOG_POT_CHANGED, 512, -3), 1);
+    CHECK_EQ(g_ui32TivaUARTLen, 0);
+    LogFlush();
+    CHECK(strcmp(g_pcTivaUART, "[42] Up Button is pressed.\n"
+                 "[42] Potentiometer changed, Value: '512', Setpoint: -3.\n") == 0);
+
+    // A burst with nothing draining keeps the first LOG_RING_SIZE records
+    // and drops the rest without waiting.
+    g_ui32TivaUARTLen = 0;
+    for (i = 0; i < BURST; i++)
+    {
+        ui32Kept += LOG1(LOG_ALT_CAL_POINT, i);
+    }
+    CHECK_EQ(ui32Kept, LOG_RING_SIZE);
+    CHECK_EQ(LogDroppedCount(), BURST - LOG_RING_SIZE);
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "point 0 of") != NULL);
+    CHECK(strstr(g_pcTivaUART, "point 31 of") != NULL);
+    CHECK(strstr(g_pcTivaUART, "point 32 of") == NULL);
+
+    // The drain task reports the loss as a record of its own, once.
+    g_ui32TivaUARTLen = 0;
+    CHECK_EQ(HostRunTask(LogTask, NULL, 2), 2);
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "Log overflow, 68 records dropped.\n") != NULL);
+    g_ui32TivaUARTLen = 0;
+    CHECK_EQ(HostRunTask(LogTask, NULL, 2), 2);
+    CHECK_EQ(g_ui32TivaUARTLen, 0);
+
+    // A producer pre-empted between reserving and publishing its slot holds
+    // back the records behind it, which come out in order once it is done.
+    g_ui32TivaUARTLen = 0;
+    HostTickSet(42);
+    i = g_ui32LogHead++;
+    CHECK_EQ(LOG1(LOG_BUTTON_PRESSED, "Down"), 1);
+    LogFlush();
+    CHECK_EQ(g_ui32TivaUARTLen, 0);
+    g_psLogRing[i & LOG_RING_MASK].ui32Time = 42;
+    g_psLogRing[i & LOG_RING_MASK].ui32Id = LOG_BUTTON_PRESSED;
+    g_psLogRing[i & LOG_RING_MASK].pui32Args[0] = (uint32_t)"Left";
+    g_psLogRing[i & LOG_RING_MASK].ui32Seq = i + 1;
+    LogFlush();
+    CHECK(strcmp(g_pcTivaUART, "[42] Left Button is pressed.\n"
+                 "[42] Down Button is pressed.\n") == 0);
+
+    CHECK_EQ(HostCriticalNesting(), 0);
+
+    // Cost of a call with the drain keeping up, as the tasks see it.
+    clock_gettime(CLOCK_MONOTONIC, &sStart);
+    for (i = 0; i < TIMED_CALLS; i++)
+    {
+        LOG2(LOG_POT_CHANGED, i, i);
+        if ((i & LOG_RING_MASK) == LOG_RING_MASK)
+        {
+            g_ui32LogTail = g_ui32LogHead;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &sEnd);
+    dNs = ((sEnd.tv_sec - sStart.tv_sec) * 1e9 + (sEnd.tv_nsec - sStart.tv_nsec)) /
+          TIMED_CALLS;
+    printf("log_write_ns %.1f\n", dNs);
+    CHECK_EQ(LogDroppedCount(), BURST - LOG_RING_SIZE);
+
+    return CHECK_EXIT();
+}
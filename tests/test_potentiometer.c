@@ -0,0 +1,214 @@
+/******************************************************************************
+ *
+ * test_potentiometer.c
+ *
+ * Purpose:
+ * Host test of the potentiometer setpoint, driving the height axis, on
+ * replayed noisy ADC traces at the 2 ms sampling period. For each trace the
+ * published setpoints are counted (the event rate) and the samples from a
+ * move of the pot to the setpoint reaching its new value are measured (the
+ * latency):
+ *  - held still with ADC noise, nothing is published after the first value;
+ *  - a step to either end of travel is published, exactly, within one
+ *    averaging window and one decimation of the move;
+ *  - a slow noisy turn end to end publishes about once per hysteresis band,
+ *    never back the way it came;
+ *  - a pot left turned up at power-up publishes nothing until it is turned
+ *    down to zero.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "config.h"
+
+// The setpoint is compiled out unless an axis is chosen.
+#undef POT_SETPOINT_MODE
+#define POT_SETPOINT_MODE   POT_SETPOINT_HEIGHT
+#include "potentiometer.c"
+#include "potentiometer_task.c"
+
+#define TEST_QUEUE_LENGTH   4
+#define SAMPLES_PER_S       (1000 / POT_SAMPLE_PERIOD)
+#define MAX_LATENCY         (POT_BUF_SIZE + POT_DECIMATION)
+#define HEIGHT_NOISE        6       // ADC counts either way
+#define RAMP_NOISE          20
+
+static QueueHandle_t *g_ppxQueues[] = {
+    &g_TargHeightDisplayQueue, &g_TargHeightControlQueue,
+};
+#define NUM_QUEUES      (sizeof(g_ppxQueues) / sizeof(g_ppxQueues[0]))
+
+static StaticQueue_t g_pxQueueBufs[NUM_QUEUES];
+static int32_t g_ppi32QueueStorage[NUM_QUEUES][TEST_QUEUE_LENGTH];
+
+static uint32_t g_ui32Sample = 0;       // Samples since the trace began
+static uint32_t g_ui32Events = 0;       // Setpoints published
+static int32_t g_i32Setpoint = -1;      // Latest published, -1 for none
+static uint32_t g_ui32Backwards = 0;    // Published against the turn
+static uint32_t g_ui32Seed = 1;
+
+/** @brief Uniform integer noise in -i32Amp..i32Amp. */
+static int32_t
+noise(int32_t i32Amp)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return (int32_t)((g_ui32Seed >> 8) % (uint32_t)(2 * i32Amp + 1)) - i32Amp;
+}
+
+/** @brief Power-up: an empty window and nothing published yet. */
+static void
+restart(void)
+{
+    int32_t i32Item;
+    uint32_t i;
+
+    g_bFirstSample = true;
+    g_ui32CurPotentioState = 0;
+    g_ui32Decimate = 0;
+    g_i32Published = 0;
+    g_bFirst = true;
+    g_bZeroSeen = false;
+    PotentiometerInit();
+
+    for (i = 0; i < NUM_QUEUES; i++)
+    {
+        while (xQueueReceive(*g_ppxQueues[i], &i32Item, 0) == pdPASS)
+        {
+        }
+    }
+    g_ui32Sample = 0;
+    g_ui32Events = 0;
+    g_i32Setpoint = -1;
+    g_ui32Backwards = 0;
+}
+
+/**
+ * @brief One sampling period with the ADC reading i32ADC, clipped to the
+ * converter's range. Collects what was published to the control task,
+ * checking the display was sent the same.
+ */
+static void
+sample(int32_t i32ADC, int32_t i32Direction)
+{
+    int32_t i32Control, i32Display;
+
+    TivaADCSet(i32ADC < 0 ? 0 : i32ADC > ADC_MAX_VALUE ? ADC_MAX_VALUE : i32ADC);
+    PotentiometerSample(NULL);
+    g_ui32Sample++;
+
+    while (xQueueReceive(g_TargHeightControlQueue, &i32Control, 0) == pdPASS)
+    {
+        CHECK(xQueueReceive(g_TargHeightDisplayQueue, &i32Display, 0) == pdPASS &&
+              i32Display == i32Control);
+        g_ui32Backwards += g_i32Setpoint >= 0 &&
+                           (i32Control - g_i32Setpoint) * i32Direction < 0;
+        g_i32Setpoint = i32Control;
+        g_ui32Events++;
+    }
+}
+
+/**
+ * @brief Holds the pot at ui32ADC with noise until the setpoint reads
+ * i32Want or ui32Limit samples pass. Returns the samples taken.
+ */
+static uint32_t
+holdUntil(uint32_t ui32ADC, int32_t i32Noise, int32_t i32Want,
+          uint32_t ui32Limit)
+{
+    uint32_t ui32Start = g_ui32Sample;
+
+    while (g_i32Setpoint != i32Want && g_ui32Sample - ui32Start < ui32Limit)
+    {
+        sample(ui32ADC + noise(i32Noise), 0);
+    }
+
+    return g_ui32Sample - ui32Start;
+}
+
+int
+main(void)
+{
+    uint32_t i, ui32Latency, ui32Events;
+
+    HostKernelReset();
+    TivaReset();
+    for (i = 0; i < NUM_QUEUES; i++)
+    {
+        *g_ppxQueues[i] = xQueueCreateStatic(TEST_QUEUE_LENGTH, sizeof(int32_t),
+                                             (uint8_t *)g_ppi32QueueStorage[i],
+                                             &g_pxQueueBufs[i]);
+    }
+
+    // Held still: zero is published within a window of power-up, then the
+    // middle once the window has caught up, and for ten seconds of noise
+    // after that, nothing.
+    restart();
+    ui32Latency = holdUntil(0, HEIGHT_NOISE, 0, SAMPLES_PER_S);
+    CHECK(ui32Latency <= POT_DECIMATION);
+    CHECK_EQ(g_ui32Events, 1);
+    for (i = 0; i < SAMPLES_PER_S; i++)
+    {
+        sample(ADC_MAX_VALUE / 2 + noise(HEIGHT_NOISE), 1);
+    }
+    CHECK(g_i32Setpoint >= HEIGHT_TARGET_MAX / 2 - POT_HEIGHT_HYSTERESIS &&
+          g_i32Setpoint <= HEIGHT_TARGET_MAX / 2 + POT_HEIGHT_HYSTERESIS);
+    ui32Events = g_ui32Events;
+    for (i = 0; i < 10 * SAMPLES_PER_S; i++)
+    {
+        sample(ADC_MAX_VALUE / 2 + noise(HEIGHT_NOISE), 0);
+    }
+    CHECK_EQ(g_ui32Events, ui32Events);
+
+    // Steps to each end of travel land exactly on the end value, within a
+    // window and a decimation, despite the noise at the ends.
+    ui32Latency = holdUntil(ADC_MAX_VALUE, HEIGHT_NOISE, HEIGHT_TARGET_MAX,
+                            SAMPLES_PER_S);
+    CHECK(ui32Latency <= MAX_LATENCY);
+    CHECK_EQ(g_i32Setpoint, HEIGHT_TARGET_MAX);
+    ui32Latency = holdUntil(0, HEIGHT_NOISE, 0, SAMPLES_PER_S);
+    CHECK(ui32Latency <= MAX_LATENCY);
+    CHECK_EQ(g_i32Setpoint, 0);
+    ui32Events = g_ui32Events;
+    for (i = 0; i < SAMPLES_PER_S; i++)
+    {
+        sample(noise(HEIGHT_NOISE), 0);
+    }
+    CHECK_EQ(g_ui32Events, ui32Events);
+
+    // A slow turn end to end over two seconds with heavy noise: about one
+    // event per hysteresis band, each further along, and the top reached.
+    ui32Events = g_ui32Events;
+    for (i = 0; i < 2 * SAMPLES_PER_S; i++)
+    {
+        sample((int32_t)(i * ADC_MAX_VALUE / (2 * SAMPLES_PER_S)) +
+               noise(RAMP_NOISE), 1);
+    }
+    ui32Latency = holdUntil(ADC_MAX_VALUE, RAMP_NOISE, HEIGHT_TARGET_MAX,
+                            SAMPLES_PER_S);
+    CHECK(ui32Latency <= MAX_LATENCY);
+    CHECK(g_ui32Events - ui32Events >=
+          HEIGHT_TARGET_MAX / (2 * POT_HEIGHT_HYSTERESIS));
+    CHECK(g_ui32Events - ui32Events <=
+          HEIGHT_TARGET_MAX / POT_HEIGHT_HYSTERESIS + 2);
+    CHECK_EQ(g_ui32Backwards, 0);
+
+    // Left turned up at power-up: nothing until it has been turned down.
+    restart();
+    for (i = 0; i < SAMPLES_PER_S; i++)
+    {
+        sample(3 * ADC_MAX_VALUE / 4 + noise(HEIGHT_NOISE), 0);
+    }
+    CHECK_EQ(g_ui32Events, 0);
+    ui32Latency = holdUntil(0, HEIGHT_NOISE, 0, SAMPLES_PER_S);
+    CHECK(ui32Latency <= MAX_LATENCY);
+    CHECK_EQ(g_ui32Events, 1);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,189 @@
+/******************************************************************************
+ *
+ * test_ring_buf.c
+ *
+ * Purpose:
+ * Host test of the ring buffer: capacities that are not a power of two are
+ * refused, a full buffer refuses writes and an empty one reads, peek and
+ * discard see the oldest entries, the bulk copies split correctly where the
+ * storage wraps and where the free-running indices overflow, and an element
+ * size that is not a word works. A long random run of every call is
+ * checked against a plain array FIFO.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "ringBuf.h"
+
+#define CAPACITY        8
+#define RANDOM_OPS      100000
+
+/** @brief An element that is not a multiple of a word. */
+typedef struct {
+    uint8_t pui8Bytes[3];
+} triple_t;
+
+static uint32_t g_ui32Seed = 1;
+
+static uint32_t
+randomBelow(uint32_t ui32Limit)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return (g_ui32Seed >> 8) % ui32Limit;
+}
+
+static void
+checkSingle(void)
+{
+    uint32_t pui32Storage[CAPACITY];
+    ringBuf_t sBuf;
+    uint32_t i, ui32Value;
+
+    CHECK(!initRingBuf(&sBuf, pui32Storage, sizeof(uint32_t), 0));
+    CHECK(!initRingBuf(&sBuf, pui32Storage, sizeof(uint32_t), 6));
+    CHECK(initRingBuf(&sBuf, pui32Storage, sizeof(uint32_t), CAPACITY));
+    CHECK_EQ(ringBufCount(&sBuf), 0);
+    CHECK_EQ(ringBufFree(&sBuf), CAPACITY);
+    CHECK(!readRingBuf(&sBuf, &ui32Value));
+
+    for (i = 0; i < CAPACITY; i++)
+    {
+        CHECK(writeRingBuf(&sBuf, &i));
+    }
+    ui32Value = 99;
+    CHECK(!writeRingBuf(&sBuf, &ui32Value));
+    CHECK_EQ(ringBufCount(&sBuf), CAPACITY);
+    CHECK_EQ(ringBufFree(&sBuf), 0);
+
+    // Peek leaves the entries; discard drops the oldest.
+    CHECK(peekRingBuf(&sBuf, 0, &ui32Value) && ui32Value == 0);
+    CHECK(peekRingBuf(&sBuf, CAPACITY - 1, &ui32Value) &&
+          ui32Value == CAPACITY - 1);
+    CHECK(!peekRingBuf(&sBuf, CAPACITY, &ui32Value));
+    CHECK_EQ(discardRingBuf(&sBuf, 3), 3);
+    CHECK(readRingBuf(&sBuf, &ui32Value) && ui32Value == 3);
+    CHECK_EQ(discardRingBuf(&sBuf, 100), CAPACITY - 4);
+    CHECK_EQ(ringBufCount(&sBuf), 0);
+}
+
+static void
+checkBulk(void)
+{
+    uint32_t pui32Storage[CAPACITY];
+    uint32_t pui32In[2 * CAPACITY], pui32Out[2 * CAPACITY];
+    ringBuf_t sBuf;
+    uint32_t i, ui32Value, ui32Ordered = 1;
+
+    for (i = 0; i < 2 * CAPACITY; i++)
+    {
+        pui32In[i] = i;
+    }
+
+    // Indices just short of overflowing: the spans split at the storage
+    // wrap and the counts stay right as the indices pass zero.
+    CHECK(initRingBuf(&sBuf, pui32Storage, sizeof(uint32_t), CAPACITY));
+    sBuf.windex = sBuf.rindex = 0xFFFFFFFDu;
+    CHECK_EQ(writeRingBufN(&sBuf, pui32In, 5), 5);
+    CHECK_EQ(ringBufCount(&sBuf), 5);
+    CHECK_EQ(readRingBufN(&sBuf, pui32Out, 3), 3);
+    CHECK_EQ(pui32Out[2], 2);
+    CHECK_EQ(writeRingBufN(&sBuf, pui32In + 5, 10), CAPACITY - 2);
+    CHECK_EQ(ringBufFree(&sBuf), 0);
+    CHECK_EQ(writeRingBufN(&sBuf, pui32In, 1), 0);
+    CHECK(peekRingBuf(&sBuf, 0, &ui32Value) && ui32Value == 3);
+    CHECK_EQ(readRingBufN(&sBuf, pui32Out, 2 * CAPACITY), CAPACITY);
+    for (i = 0; i < CAPACITY; i++)
+    {
+        ui32Ordered &= pui32Out[i] == 3 + i;
+    }
+    CHECK(ui32Ordered);
+    CHECK_EQ(readRingBufN(&sBuf, pui32Out, 1), 0);
+    CHECK(!readRingBuf(&sBuf, &ui32Value));
+}
+
+/** @brief Every call at random, on 3 byte elements, against an array. */
+static void
+checkRandom(void)
+{
+    triple_t psStorage[CAPACITY];
+    triple_t psModel[RANDOM_OPS];
+    triple_t psIn[CAPACITY], psOut[CAPACITY];
+    ringBuf_t sBuf;
+    uint32_t ui32Head = 0, ui32Tail = 0, ui32Next = 0;
+    uint32_t ui32Wrong = 0;
+    uint32_t i, j, n, ui32Count;
+
+    CHECK(initRingBuf(&sBuf, psStorage, sizeof(triple_t), CAPACITY));
+    for (i = 0; i < RANDOM_OPS && ui32Head + CAPACITY < RANDOM_OPS; i++)
+    {
+        ui32Count = ui32Head - ui32Tail;
+        n = randomBelow(CAPACITY + 2);
+        for (j = 0; j < n && j < CAPACITY; j++)
+        {
+            psIn[j].pui8Bytes[0] = (uint8_t)ui32Next;
+            psIn[j].pui8Bytes[1] = (uint8_t)(ui32Next >> 8);
+            psIn[j].pui8Bytes[2] = (uint8_t)(ui32Next >> 16);
+            ui32Next++;
+        }
+
+        switch (randomBelow(5))
+        {
+        case 0:
+            ui32Wrong += writeRingBuf(&sBuf, &psIn[0]) != (ui32Count < CAPACITY);
+            if (ui32Count < CAPACITY)
+            {
+                psModel[ui32Head++] = psIn[0];
+            }
+            break;
+        case 1:
+            ui32Wrong += readRingBuf(&sBuf, &psOut[0]) != (ui32Count > 0);
+            if (ui32Count > 0)
+            {
+                ui32Wrong += memcmp(&psOut[0], &psModel[ui32Tail++],
+                                    sizeof(triple_t)) != 0;
+            }
+            break;
+        case 2:
+            n = n > CAPACITY ? CAPACITY : n;
+            j = writeRingBufN(&sBuf, psIn, n);
+            ui32Wrong += j != (n < CAPACITY - ui32Count ? n : CAPACITY - ui32Count);
+            memcpy(&psModel[ui32Head], psIn, j * sizeof(triple_t));
+            ui32Head += j;
+            break;
+        case 3:
+            n = n > CAPACITY ? CAPACITY : n;
+            j = readRingBufN(&sBuf, psOut, n);
+            ui32Wrong += j != (n < ui32Count ? n : ui32Count);
+            ui32Wrong += memcmp(psOut, &psModel[ui32Tail], j * sizeof(triple_t)) != 0;
+            ui32Tail += j;
+            break;
+        default:
+            if (ui32Count > 0)
+            {
+                j = randomBelow(ui32Count);
+                ui32Wrong += !peekRingBuf(&sBuf, j, &psOut[0]);
+                ui32Wrong += memcmp(&psOut[0], &psModel[ui32Tail + j],
+                                    sizeof(triple_t)) != 0;
+            }
+            break;
+        }
+        ui32Wrong += ringBufCount(&sBuf) != ui32Head - ui32Tail;
+        ui32Wrong += ringBufFree(&sBuf) != CAPACITY - (ui32Head - ui32Tail);
+    }
+    CHECK(i > RANDOM_OPS / 4);
+    CHECK_EQ(ui32Wrong, 0);
+}
+
+int
+main(void)
+{
+    checkSingle();
+    checkBulk();
+    checkRandom();
+
+    return CHECK_EXIT();
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ * test_runtime_stats.c
+ *
+ * Purpose:
+ * Host test of the run-time stats reporter: the percentage split, and one
+ * report period of RunTimeStatsTask over a known split of the 50 MHz
+ * counter, including a period in which the counter wraps.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "log_task.h"
+#include "tiva.h"
+#include "runtime_stats.c"
+
+/** @brief One second of the 50 MHz run-time counter. */
+#define PERIOD_COUNTS   50000000u
+
+static StaticTask_t g_xTCBA, g_xTCBB;
+static StackType_t g_pxStackA[64], g_pxStackB[64];
+static hostTask_t *g_psA, *g_psB, *g_psIdle;
+
+/** @brief Switch count of a task, by its host task number. */
+#define SWITCHES(psTask)    g_pui32RunTimeSwitches[(psTask) - g_psHostTasks + 1]
+
+/** @brief The split the first report sees: A 50 %, B 10 %, idle 40 %. */
+static void
+firstPeriod(void)
+{
+    g_ui32TivaTimer += PERIOD_COUNTS;
+    g_psA->ui32RunTime += PERIOD_COUNTS / 2;
+    g_psB->ui32RunTime += PERIOD_COUNTS / 10;
+    g_psIdle->ui32RunTime += PERIOD_COUNTS / 10 * 4;
+    SWITCHES(g_psA) += 500;
+    SWITCHES(g_psB) += 100;
+    SWITCHES(g_psIdle) += 400;
+}
+
+/** @brief A: a third, B: nothing, idle: the rest. */
+static void
+secondPeriod(void)
+{
+    g_ui32TivaTimer += PERIOD_COUNTS;
+    g_psA->ui32RunTime += PERIOD_COUNTS / 3;
+    g_psIdle->ui32RunTime += PERIOD_COUNTS / 3 * 2;
+    SWITCHES(g_psA) += 20;
+}
+
+static void
+noTask(void *pvParameters)
+{
+}
+
+static void
+checkPercent(uint32_t ui32Part, uint32_t ui32Whole, uint32_t ui32Pct,
+             uint32_t ui32Tenths)
+{
+    uint32_t ui32GotPct, ui32GotTenths;
+
+    toPercent(ui32Part, ui32Whole, &ui32GotPct, &ui32GotTenths);
+    CHECK_EQ(ui32GotPct, ui32Pct);
+    CHECK_EQ(ui32GotTenths, ui32Tenths);
+}
+
+int
+main(void)
+{
+    HostKernelReset();
+    TivaReset();
+
+    // The split rounds down to tenths and survives periods of a minute.
+    checkPercent(250, 1000, 25, 0);
+    checkPercent(PERIOD_COUNTS / 3, PERIOD_COUNTS, 33, 3);
+    checkPercent(PERIOD_COUNTS, PERIOD_COUNTS, 100, 0);
+    checkPercent(4000000000u, 4000000000u, 100, 0);
+    checkPercent(999, 999, 0, 0);
+
+    g_ui32TivaTimer = 1234;
+    CHECK_EQ(ulRunTimeStatsTimerGet(), 1234);
+
+    CHECK_EQ(RunTimeStatsTaskInit(), 0);
+    CHECK(xTaskCreateStatic(noTask, "A", 64, NULL, 3, g_pxStackA, &g_xTCBA) != NULL);
+    CHECK(xTaskCreateStatic(noTask, "B", 64, NULL, 1, g_pxStackB, &g_xTCBB) != NULL);
+    vTaskStartScheduler();
+
+    g_psA = HostTaskFind("A");
+    g_psB = HostTaskFind("B");
+    g_psIdle = HostTaskFind("IDLE");
+    CHECK(g_psA != NULL && g_psB != NULL && g_psIdle != NULL);
+    CHECK_EQ(HostTaskFind("Stats")->uxPriority, PRIORITY_STATS_TASK);
+
+    // Start just short of the wrap, so the first period crosses it.
+    g_ui32TivaTimer = 0xFFFFFFFFu - PERIOD_COUNTS / 2;
+    HostOnNextBlock(firstPeriod);
+    CHECK_EQ(HostRunTask(RunTimeStatsTask, NULL, 2), 2);
+    CHECK_EQ(xTaskGetTickCount(), 2 * RUNTIME_STATS_PERIOD_MS);
+
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "  A: 50.0% cpu, 500 switches\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "  B: 10.0% cpu, 100 switches\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "CPU: idle 40.0%, 1000 switches/s over 1000 ms\n") != NULL);
+
+    // Restarted, the task keeps each task's previous count, so the second
+    // report is of the second period alone.
+    g_ui32TivaUARTLen = 0;
+    HostOnNextBlock(secondPeriod);
+    CHECK_EQ(HostRunTask(RunTimeStatsTask, NULL, 2), 2);
+    CHECK_EQ(xTaskGetTickCount(), 4 * RUNTIME_STATS_PERIOD_MS);
+
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "  A: 33.3% cpu, 20 switches\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "  B: 0.0% cpu, 0 switches\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "CPU: idle 66.6%, 20 switches/s over 1000 ms\n") != NULL);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,196 @@
+/******************************************************************************
+ *
+ * test_stack_monitor.c
+ *
+ * Purpose:
+ * Host test of the stack monitor and the kernel's stack overflow check on
+ * painted task stacks. Tasks are created through the host kernel, which
+ * paints their stacks as tasks.c does; the monitor learns their depths
+ * through the same hook tasks.c expands, on stand-in control blocks. Each
+ * stack is then written to a known depth from its top, as a task using it
+ * would, and the test checks:
+ *  - the kernel's high-water mark is the depth less the words written;
+ *  - the monitor's report gives the words used and the recommendation,
+ *    used + used / 4 + 32 rounded up to 8, and keeps the deepest use seen;
+ *  - the switch-out check passes an intact stack, and on a write into the
+ *    bottom words calls the overflow hook, which stops the motors and names
+ *    the task on the UART.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "stack_monitor.h"
+#include "log_task.h"
+
+// The overflow check is expanded here from the kernel's own macro.
+#define tskSTACK_FILL_BYTE  0xa5U
+#include "stack_macros.h"
+
+#define SHALLOW_DEPTH       128
+#define DEEP_DEPTH          256
+#define SPIN_MS             200
+
+/** @brief The TCB fields the hooks read, as tasks.c lays them out. */
+typedef struct {
+    StackType_t *pxStack;
+    StackType_t *pxEndOfStack;
+    UBaseType_t uxTCBNumber;
+    char pcTaskName[configMAX_TASK_NAME_LEN];
+} testTCB_t;
+
+enum { TASK_SHALLOW = 1, TASK_DEEP, TASK_UNTRACKED, NUM_TASKS };
+
+static StackType_t g_pxShallowStack[SHALLOW_DEPTH];
+static StackType_t g_pxDeepStack[DEEP_DEPTH];
+static StackType_t g_pxUntrackedStack[SHALLOW_DEPTH];
+static StaticTask_t g_pxTaskBufs[NUM_TASKS];
+static testTCB_t g_psTCBs[NUM_TASKS];
+static testTCB_t *pxCurrentTCB;
+static TaskStatus_t g_psStatus[HOST_MAX_TASKS];
+
+/** @brief Creates a task, and what tasks.c does for it on creation. */
+static void
+createTask(uint32_t ui32Number, const char *pcName, StackType_t *pxStack,
+           uint32_t ui32Depth, uint32_t ui32Tracked)
+{
+    testTCB_t *pxNewTCB = &g_psTCBs[ui32Number];
+
+    CHECK(xTaskCreateStatic((TaskFunction_t)NULL, pcName, ui32Depth, NULL, 1,
+                            pxStack, &g_pxTaskBufs[ui32Number]) != NULL);
+    pxNewTCB->pxStack = pxStack;
+    pxNewTCB->pxEndOfStack = &pxStack[ui32Depth - 1];
+    pxNewTCB->uxTCBNumber = ui32Number;
+    strncpy(pxNewTCB->pcTaskName, pcName, configMAX_TASK_NAME_LEN - 1);
+    if (ui32Tracked)
+    {
+        stackMonitorTASK_CREATE(pxNewTCB);
+    }
+}
+
+/** @brief Writes the top ui32Words of a stack, which grows down. */
+static void
+use(StackType_t *pxStack, uint32_t ui32Depth, uint32_t ui32Words)
+{
+    uint32_t i;
+
+    for (i = ui32Depth - ui32Words; i < ui32Depth; i++)
+    {
+        pxStack[i] = i;
+    }
+}
+
+/** @brief What the stats task does every period: one snapshot per call. */
+static void
+report(uint32_t ui32Periods)
+{
+    UBaseType_t uxCount;
+
+    while (ui32Periods-- > 0)
+    {
+        uxCount = uxTaskGetSystemState(g_psStatus, HOST_MAX_TASKS, NULL);
+        StackMonitorUpdate(g_psStatus, uxCount);
+    }
+    LogFlush();
+}
+
+/** @brief Forgets what has been written to the UART. */
+static void
+clearUART(void)
+{
+    LogFlush();
+    g_ui32TivaUARTLen = 0;
+    g_pcTivaUART[0] = '\0';
+}
+
+/** @brief What vTaskSwitchContext() checks as the current task goes out. */
+static void
+switchOut(void)
+{
+    taskCHECK_FOR_STACK_OVERFLOW();
+}
+
+int
+main(void)
+{
+    HostKernelReset();
+    TivaReset();
+
+    // Fresh stacks are painted throughout: nothing used yet.
+    createTask(TASK_SHALLOW, "Shallow", g_pxShallowStack, SHALLOW_DEPTH, 1);
+    createTask(TASK_DEEP, "Deep", g_pxDeepStack, DEEP_DEPTH, 1);
+    createTask(TASK_UNTRACKED, "Untracked", g_pxUntrackedStack, SHALLOW_DEPTH, 0);
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_SHALLOW]),
+             SHALLOW_DEPTH);
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_DEEP]),
+             DEEP_DEPTH);
+
+    // The recommendation on its own: a quarter and 32 words over, in
+    // multiples of 8.
+    CHECK_EQ(StackMonitorRecommend(0), 32);
+    CHECK_EQ(StackMonitorRecommend(1), 40);
+    CHECK_EQ(StackMonitorRecommend(40), 88);
+    CHECK_EQ(StackMonitorRecommend(96), 152);
+    CHECK_EQ(StackMonitorRecommend(100), 160);
+
+    // Used to known depths, the mark is what is left, and the report after
+    // a full reporting period gives the use and the recommendation. A task
+    // the monitor was not told of is left out.
+    use(g_pxShallowStack, SHALLOW_DEPTH, 40);
+    use(g_pxDeepStack, DEEP_DEPTH, 100);
+    use(g_pxUntrackedStack, SHALLOW_DEPTH, 10);
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_SHALLOW]),
+             SHALLOW_DEPTH - 40);
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_DEEP]),
+             DEEP_DEPTH - 100);
+    clearUART();
+    report(STACK_MONITOR_REPORT_PERIODS - 1);
+    CHECK_EQ(g_ui32TivaUARTLen, 0);
+    report(1);
+    CHECK(strstr(g_pcTivaUART, "Shallow: stack 40/128 words, recommend 88") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Deep: stack 100/256 words, recommend 160") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Untracked") == NULL);
+
+    // Deeper use raises the report; a stack painted afresh, as a task
+    // deleted and recreated would have, does not lower it.
+    use(g_pxDeepStack, DEEP_DEPTH, 200);
+    report(1);
+    memset(g_pxDeepStack, tskSTACK_FILL_BYTE, sizeof(g_pxDeepStack));
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_DEEP]),
+             DEEP_DEPTH);
+    clearUART();
+    report(STACK_MONITOR_REPORT_PERIODS - 1);
+    CHECK(strstr(g_pcTivaUART, "Deep: stack 200/256 words, recommend 288") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Shallow: stack 40/128 words, recommend 88") != NULL);
+
+    // Used to within a word of the bottom, the stack still passes the
+    // switch-out check, which only looks at the last four words.
+    pxCurrentTCB = &g_psTCBs[TASK_SHALLOW];
+    use(g_pxShallowStack, SHALLOW_DEPTH, SHALLOW_DEPTH - 4);
+    CHECK_EQ(uxTaskGetStackHighWaterMark((TaskHandle_t)&g_pxTaskBufs[TASK_SHALLOW]),
+             4);
+    clearUART();
+    CHECK_EQ(HostExpectSpin(switchOut, SPIN_MS), 0);
+    CHECK_EQ(g_ui32TivaPWMOffCalls, 0);
+
+    // One word into the bottom four, the hook stops the motors, names the
+    // task and spins.
+    g_pxShallowStack[2] = 0;
+    CHECK_EQ(HostExpectSpin(switchOut, SPIN_MS), 1);
+    CHECK(g_ui32TivaPWMOffCalls > 0);
+    CHECK(strstr(g_pcTivaUART, "\nShallow: stack overflow\n") != NULL);
+
+    // Only the task switched out is checked.
+    clearUART();
+    pxCurrentTCB = &g_psTCBs[TASK_DEEP];
+    CHECK_EQ(HostExpectSpin(switchOut, SPIN_MS), 0);
+    CHECK(strstr(g_pcTivaUART, "stack overflow") == NULL);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * test_static_boot.c
+ *
+ * Purpose:
+ * Boots the firmware's main() on the host, with the firmware's
+ * FreeRTOSConfig.h (dynamic allocation off), up to the scheduler start.
+ * Every task must be created from static memory at its configured
+ * priority, no heap allocator may be linked, and the report at the end
+ * gives the RAM the task stacks take.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "priorities.h"
+
+#if configSUPPORT_DYNAMIC_ALLOCATION != 0
+#error "The firmware is meant to build without a heap"
+#endif
+
+/** @brief Defined only if something in the link provides a heap. */
+extern void *pvPortMalloc(size_t xSize) __attribute__((weak));
+
+extern int firmware_main(void);
+
+/** @brief Every task the firmware should be running, and its priority. */
+static const struct {
+    const char *pcName;
+    UBaseType_t uxPriority;
+} g_psExpected[] = {
+    { "CONTROL",    PRIORITY_CONTROL_TASK },
+    { "RIG",        PRIORITY_HEIGHT_TASK },
+    { "pwmtask",    PRIORITY_PWM_TASK },
+    { "Yaw",        PRIORITY_YAW_TASK },
+    { "Display",    PRIORITY_DISPLAY_TASK },
+    { "Log",        PRIORITY_LOG_TASK },
+    { "Stats",      PRIORITY_STATS_TASK },
+    { "IDLE",       tskIDLE_PRIORITY },
+    { "Tmr Svc",    configTIMER_TASK_PRIORITY },
+};
+#define NUM_EXPECTED    (sizeof(g_psExpected) / sizeof(g_psExpected[0]))
+
+int
+main(void)
+{
+    uint32_t i, ui32StackBytes = 0;
+
+    HostKernelReset();
+    TivaReset();
+
+    CHECK(pvPortMalloc == NULL);
+    CHECK_EQ(HostBoot(firmware_main, 2000), 1);
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(g_ui32HostTaskCount, NUM_EXPECTED);
+
+    for (i = 0; i < NUM_EXPECTED; i++)
+    {
+        hostTask_t *psTask = HostTaskFind(g_psExpected[i].pcName);
+
+        CHECK(psTask != NULL);
+        if (psTask == NULL)
+        {
+            continue;
+        }
+        CHECK_EQ(psTask->uxPriority, g_psExpected[i].uxPriority);
+        CHECK(psTask->pxStack != NULL && psTask->pxTCB != NULL);
+    }
+
+    printf("%-10s %6s %6s\n", "task", "words", "bytes");
+    for (i = 0; i < g_ui32HostTaskCount; i++)
+    {
+        hostTask_t *psTask = &g_psHostTasks[i];
+
+        printf("%-10s %6u %6u\n", psTask->pcName, psTask->ui32StackDepth,
+               psTask->ui32StackDepth * (uint32_t)sizeof(StackType_t));
+        ui32StackBytes += psTask->ui32StackDepth * sizeof(StackType_t);
+    }
+    printf("stacks %u B + %u StaticTask_t, all static\n", ui32StackBytes,
+           g_ui32HostTaskCount);
+
+    return CHECK_EXIT();
+}
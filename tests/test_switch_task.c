@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ * test_switch_task.c
+ *
+ * Purpose:
+ * Host test of the button polling timer callback: presses become targets
+ * on the display and control queues, a full queue drops the update and
+ * logs it rather than blocking the timer service task, and holding Up and
+ * Down together asks for arming once per chord, leaving the height target
+ * where it was.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+
+// Count the arm requests rather than pulling in the control task's flag.
+#define control_request_arm     test_control_request_arm
+#include "switch_task.c"
+
+#define TEST_QUEUE_LENGTH   2
+
+static uint32_t g_ui32ArmRequests = 0;
+
+static QueueHandle_t *g_ppxQueues[] = {
+    &g_TargHeightDisplayQueue, &g_TargHeightControlQueue,
+    &g_TargYawDisplayQueue, &g_TargYawControlQueue,
+};
+#define NUM_QUEUES      (sizeof(g_ppxQueues) / sizeof(g_ppxQueues[0]))
+
+static StaticQueue_t g_pxQueueBufs[NUM_QUEUES];
+static int32_t g_ppi32QueueStorage[NUM_QUEUES][TEST_QUEUE_LENGTH];
+
+void
+test_control_request_arm(void)
+{
+    g_ui32ArmRequests++;
+}
+
+/** @brief Sets the buttons' pins; Up and Down are active high, Left and
+ * Right active low. */
+static void
+buttons(bool bUp, bool bDown, bool bLeft, bool bRight)
+{
+    TivaPinSet(GPIO_PORTE_BASE, GPIO_PIN_0, bUp);
+    TivaPinSet(GPIO_PORTD_BASE, GPIO_PIN_2, bDown);
+    TivaPinSet(GPIO_PORTF_BASE, GPIO_PIN_4, !bLeft);
+    TivaPinSet(GPIO_PORTF_BASE, GPIO_PIN_0, !bRight);
+}
+
+/** @brief Polls with the buttons set, then releases them and polls again. */
+static void
+press(bool bUp, bool bDown, bool bLeft, bool bRight)
+{
+    buttons(bUp, bDown, bLeft, bRight);
+    SwitchPoll(NULL);
+    buttons(false, false, false, false);
+    SwitchPoll(NULL);
+}
+
+static void
+drain(void)
+{
+    int32_t i32Item;
+    uint32_t i;
+
+    for (i = 0; i < NUM_QUEUES; i++)
+    {
+        while (xQueueReceive(*g_ppxQueues[i], &i32Item, 0) == pdPASS)
+        {
+        }
+    }
+}
+
+static int32_t
+latest(QueueHandle_t xQueue)
+{
+    int32_t i32Item = -1;
+
+    while (xQueueReceive(xQueue, &i32Item, 0) == pdPASS)
+    {
+    }
+
+    return i32Item;
+}
+
+int
+main(void)
+{
+    uint32_t i;
+
+    HostKernelReset();
+    TivaReset();
+    buttons(false, false, false, false);
+
+    for (i = 0; i < NUM_QUEUES; i++)
+    {
+        *g_ppxQueues[i] = xQueueCreateStatic(TEST_QUEUE_LENGTH, sizeof(int32_t),
+                                             (uint8_t *)g_ppi32QueueStorage[i],
+                                             &g_pxQueueBufs[i]);
+    }
+    CHECK_EQ(SystemStateInit(), 0);
+    CHECK_EQ(SwitchTaskInit(), 0);
+    CHECK_EQ(xTimerGetPeriod(g_xSwitchTimer), SWITCHPOLLPERIOD);
+
+    // A press is one target step, sent once to every queue, on the edge.
+    press(true, false, false, false);
+    CHECK_EQ(uxQueueMessagesWaiting(g_TargHeightDisplayQueue), 1);
+    CHECK_EQ(uxQueueMessagesWaiting(g_TargYawControlQueue), 1);
+    CHECK_EQ(latest(g_TargHeightControlQueue), HEIGHT_TARGET_STEP);
+    CHECK_EQ(latest(g_TargYawControlQueue), 0);
+    drain();
+
+    // Yaw wraps into -180..179 degrees going left from zero.
+    press(false, false, true, false);
+    CHECK_EQ(latest(g_TargYawControlQueue), -YAW_TARGET_STEP);
+    press(false, false, false, true);
+    CHECK_EQ(latest(g_TargYawDisplayQueue), 0);
+    drain();
+
+    // Nobody reading: the first presses fill the queues, the rest are
+    // dropped and logged, and the poll never blocks.
+    LogFlush();
+    g_ui32TivaUARTLen = 0;
+    for (i = 0; i < TEST_QUEUE_LENGTH + 2; i++)
+    {
+        press(true, false, false, false);
+    }
+    CHECK_EQ(xTaskGetTickCount(), 0);
+    CHECK_EQ(uxQueueMessagesWaiting(g_TargHeightControlQueue), TEST_QUEUE_LENGTH);
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "Height control queue full, target dropped.\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Yaw display queue full, target dropped.\n") != NULL);
+    drain();
+
+    // Up and Down together ask for arming once as the chord closes, not on
+    // every poll it is held, and again only after it has opened.
+    buttons(true, true, false, false);
+    SwitchPoll(NULL);
+    SwitchPoll(NULL);
+    SwitchPoll(NULL);
+    CHECK_EQ(g_ui32ArmRequests, 1);
+    buttons(true, false, false, false);
+    SwitchPoll(NULL);
+    buttons(true, true, false, false);
+    SwitchPoll(NULL);
+    CHECK_EQ(g_ui32ArmRequests, 2);
+    buttons(false, false, false, false);
+    SwitchPoll(NULL);
+
+    // Not while armed.
+    SystemStateSet(SYSTEM_STATE_ARMED);
+    press(true, true, false, false);
+    CHECK_EQ(g_ui32ArmRequests, 2);
+    SystemStateClear(SYSTEM_STATE_ARMED);
+    drain();
+
+    // Down first at zero does nothing and Up then closes the chord: its
+    // step is undone, so every height target sent stays at zero.
+    g_ui32Height = 0;
+    buttons(false, true, false, false);
+    SwitchPoll(NULL);
+    buttons(true, true, false, false);
+    SwitchPoll(NULL);
+    CHECK_EQ(g_ui32ArmRequests, 3);
+    CHECK_EQ(g_ui32Height, 0);
+    {
+        int32_t i32Item;
+        uint32_t ui32Nonzero = 0;
+
+        while (xQueueReceive(g_TargHeightControlQueue, &i32Item, 0) == pdPASS)
+        {
+            ui32Nonzero += i32Item != 0;
+        }
+        CHECK_EQ(ui32Nonzero, 0);
+    }
+    buttons(false, false, false, false);
+    SwitchPoll(NULL);
+    drain();
+
+    // Left and Right together start a calibration sweep, during which Up
+    // and Down no longer move the targets.
+    buttons(false, false, true, true);
+    SwitchPoll(NULL);
+    CHECK(AltitudeCalActive());
+    buttons(false, false, false, false);
+    SwitchPoll(NULL);
+    drain();
+    press(true, false, false, false);
+    CHECK_EQ(uxQueueMessagesWaiting(g_TargHeightControlQueue), 0);
+    press(false, true, false, false);
+    CHECK(!AltitudeCalActive());
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * test_system_state.c
+ *
+ * Purpose:
+ * Host test of the system state event group: set, clear and their
+ * timestamps, a task blocked in SystemStateWait() woken by the set itself,
+ * the control task's arming rules, and the fatal paths (SystemStateFatal and
+ * the firmware's configASSERT handler) turning the motors off.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "config.h"
+#include "system_state.h"
+#include "control_task.c"
+
+extern void firmware_vAssertCalled(const char *pcFile, unsigned long ulLine);
+
+static void
+setArmed(void)
+{
+    SystemStateSet(SYSTEM_STATE_ARMED);
+}
+
+static void
+motorsOn(void)
+{
+    PWMOutputState(PWM_MAIN_BASE, PWM_MAIN_OUTBIT, true);
+    PWMOutputState(PWM_TAIL_BASE, PWM_TAIL_OUTBIT, true);
+    g_ui32TivaPWMOffCalls = 0;
+}
+
+static void
+fatal(void)
+{
+    SystemStateFatal();
+}
+
+static void
+failAssert(void)
+{
+    firmware_vAssertCalled(__FILE__, __LINE__);
+}
+
+/** @brief Asks to arm and runs the control task's check of the request. */
+static void
+requestArm(int32_t i32TargHeight)
+{
+    control_request_arm();
+    arm_on_request(SystemStateGet(), i32TargHeight);
+}
+
+int
+main(void)
+{
+    HostKernelReset();
+    TivaReset();
+    CHECK_EQ(SystemStateInit(), 0);
+    CHECK_EQ(SystemStateGet(), 0);
+
+    // Each change is stamped with its tick and logged; a set of a bit that
+    // is already set changes nothing.
+    HostTickSet(10);
+    SystemStateSet(SYSTEM_STATE_AIRBORNE);
+    HostTickSet(15);
+    SystemStateSet(SYSTEM_STATE_AIRBORNE);
+    CHECK_EQ(SystemStateGet(), SYSTEM_STATE_AIRBORNE);
+    CHECK_EQ(SystemStateChangedAt(SYSTEM_STATE_AIRBORNE), 10);
+    HostTickSet(20);
+    SystemStateClear(SYSTEM_STATE_AIRBORNE | SYSTEM_STATE_ARMED);
+    CHECK_EQ(SystemStateGet(), 0);
+    CHECK_EQ(SystemStateChangedAt(SYSTEM_STATE_AIRBORNE), 20);
+    CHECK_EQ(SystemStateChangedAt(SYSTEM_STATE_ARMED), 0);
+    LogFlush();
+    CHECK(strcmp(g_pcTivaUART, "[10] State AIRBORNE set.\n"
+                 "[20] State AIRBORNE cleared.\n") == 0);
+
+    // A waiter is taken off the event list by the set itself, in the same
+    // tick, rather than finding the bit at its next poll.
+    HostTickSet(100);
+    HostOnNextBlock(setArmed);
+    CHECK(SystemStateWait(SYSTEM_STATE_ARMED, 50) & SYSTEM_STATE_ARMED);
+    CHECK_EQ(g_ui32HostWakeups, 1);
+    CHECK_EQ(g_xHostWokenAt, 100);
+    CHECK_EQ(xTaskGetTickCount(), 100);
+    SystemStateClear(SYSTEM_STATE_ARMED);
+
+    // With nothing setting it, the wait takes its whole block time.
+    CHECK_EQ(SystemStateWait(SYSTEM_STATE_ARMED, 50) & SYSTEM_STATE_ARMED, 0);
+    CHECK_EQ(xTaskGetTickCount(), 150);
+    CHECK_EQ(g_ui32HostWakeups, 1);
+
+    // Arming needs a ground reference and a zero height target, and a
+    // request is used up by the cycle that sees it.
+    g_ui32TivaUARTLen = 0;
+    requestArm(0);
+    CHECK_EQ(SystemStateGet() & SYSTEM_STATE_ARMED, 0);
+    SystemStateCalibrate(1234);
+    CHECK_EQ(SystemStateGround(), 1234);
+    CHECK(SystemStateGet() & SYSTEM_STATE_CALIBRATED);
+    arm_on_request(SystemStateGet(), 0);
+    CHECK_EQ(SystemStateGet() & SYSTEM_STATE_ARMED, 0);
+    requestArm(HEIGHT_TARGET_STEP);
+    CHECK_EQ(SystemStateGet() & SYSTEM_STATE_ARMED, 0);
+    requestArm(0);
+    CHECK(SystemStateGet() & SYSTEM_STATE_ARMED);
+    LogFlush();
+    CHECK(strstr(g_pcTivaUART, "Arm: refused, ground not calibrated yet.\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "Arm: refused, height target not zero.\n") != NULL);
+    CHECK(strstr(g_pcTivaUART, "State ARMED set.\n") != NULL);
+
+    // A fatal error stops the motors before it spins, disarms and raises
+    // FAULT, which then refuses any further request to arm.
+    motorsOn();
+    CHECK_EQ(HostExpectSpin(fatal, 100), 1);
+    CHECK(g_ui32TivaPWMOffCalls >= 2);
+    CHECK_EQ(g_pui32TivaPWMOutputs[0], 0);
+    CHECK_EQ(g_pui32TivaPWMOutputs[1], 0);
+    CHECK_EQ(SystemStateGet() & (SYSTEM_STATE_ARMED | SYSTEM_STATE_FAULT),
+             SYSTEM_STATE_FAULT);
+    requestArm(0);
+    CHECK_EQ(SystemStateGet() & SYSTEM_STATE_ARMED, 0);
+
+    // So does a failed configASSERT.
+    motorsOn();
+    CHECK_EQ(HostExpectSpin(failAssert, 100), 1);
+    CHECK_EQ(g_pui32TivaPWMOutputs[0], 0);
+    CHECK_EQ(g_pui32TivaPWMOutputs[1], 0);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    return CHECK_EXIT();
+}
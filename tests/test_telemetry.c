@@ -0,0 +1,109 @@
+/******************************************************************************
+ *
+ * test_telemetry.c
+ *
+ * Purpose:
+ * Host test of the telemetry transport, built with TELEMETRY_ENABLE set
+ * whatever config.h says: records pushed faster than the log task drains
+ * them are dropped and counted without blocking once their pool class is
+ * used up, the record after a drop is a keyframe, the drain sends every
+ * queued frame whole and gives its block back, and the log task reports the
+ * number dropped once.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "semphr.h"
+#include "mem_pool.h"
+#include "config.h"
+#undef TELEMETRY_ENABLE
+#define TELEMETRY_ENABLE 1
+#include "telemetry.c"
+#include "log_task.c"
+
+#define RECORDS         100
+
+static StaticSemaphore_t g_xUARTBuf;
+
+/** @brief Pushes a record with every channel changed since the last one. */
+static void
+push(uint32_t ui32Tick)
+{
+    telemetryRecord_t sRecord;
+    uint32_t i;
+
+    sRecord.ui32Tick = ui32Tick;
+    for (i = 0; i < TELEMETRY_NUM_CHANNELS; i++)
+    {
+        sRecord.pi32Values[i] = (int32_t)(ui32Tick * 37 + i);
+    }
+    TelemetryPush(&sRecord);
+}
+
+int
+main(void)
+{
+    uint32_t i, ui32Kept, ui32Dropped, ui32Failures;
+    memPoolStats_t sStats;
+    char *pcLine;
+
+    HostKernelReset();
+    TivaReset();
+    g_pUARTSemaphore = xSemaphoreCreateMutexStatic(&g_xUARTBuf);
+    MemPoolInit();
+    CHECK_EQ(TelemetryInit(), 0);
+
+    // More records than the pools hold: the deltas fill the 16 byte class
+    // and the keyframes after each drop the 32 byte one. The rest are
+    // dropped and counted as pool failures, and the encoder is left owing a
+    // keyframe.
+    for (i = 0; i < RECORDS; i++)
+    {
+        push(i);
+    }
+    ui32Dropped = g_ui32TelemetryDropped;
+    CHECK(ui32Dropped > 0 && ui32Dropped < RECORDS);
+    CHECK(g_telemetryEncoder.bNeedKeyframe);
+    ui32Kept = RECORDS - ui32Dropped;
+    for (i = 0, ui32Failures = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        CHECK(MemPoolGetStats(i, &sStats));
+        ui32Failures += sStats.ui32Failures;
+    }
+    CHECK_EQ(ui32Failures, ui32Dropped);
+    CHECK_EQ(uxQueueMessagesWaiting(g_telemetryQueue), ui32Kept);
+
+    // One drain sends the queued frames, starting with the first keyframe.
+    CHECK_EQ(HostRunTask(LogTask, NULL, 1), 1);
+    CHECK_EQ((uint8_t)g_pcTivaUART[0], TELEMETRY_KEYFRAME_TAG);
+    CHECK(g_ui32TivaUARTLen > ui32Kept);
+    CHECK_EQ(uxQueueMessagesWaiting(g_telemetryQueue), 0);
+    for (i = 0; i < MEM_POOL_NUM_CLASSES; i++)
+    {
+        CHECK(MemPoolGetStats(i, &sStats));
+        CHECK_EQ(sStats.ui32Used, 0);
+    }
+
+    // The count goes out once, as a text line ahead of the next frame,
+    // which is a keyframe again.
+    g_ui32TivaUARTLen = 0;
+    push(RECORDS);
+    CHECK(!g_telemetryEncoder.bNeedKeyframe);
+    CHECK_EQ(HostRunTask(LogTask, NULL, 1), 1);
+    pcLine = strchr(g_pcTivaUART, '\n');
+    CHECK(pcLine != NULL && strstr(g_pcTivaUART, "Telemetry overflow") != NULL &&
+          strstr(g_pcTivaUART, "Telemetry overflow") < pcLine);
+    CHECK_EQ((uint8_t)pcLine[1], TELEMETRY_KEYFRAME_TAG);
+    CHECK_EQ(g_ui32TelemetryDroppedReported, ui32Dropped);
+    g_ui32TivaUARTLen = 0;
+    CHECK_EQ(HostRunTask(LogTask, NULL, 1), 1);
+    CHECK_EQ(g_ui32TivaUARTLen, 0);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    return CHECK_EXIT();
+}
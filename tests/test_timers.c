@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ * test_timers.c
+ *
+ * Purpose:
+ * Host test of the timing wheel in timers.c when the timer service task
+ * wakes late, which the benchmark, stepping one tick at a time, never does:
+ * a lone auto-reload timer whose period is a multiple of the slot count
+ * fires once and comes back, an idle wheel restarts from the command's
+ * tick, and timers of many periods advanced by random steps each fire once
+ * per period passed, never early.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "FreeRTOS.h"
+#undef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL   1
+#include "../FreeRTOS/timers.c"
+
+#define NUM_TIMERS      64
+#define RANDOM_STEPS    2000
+#define MAX_STEP        40      // Ticks the task may wake late by
+#define SPIN_MS         500
+
+static StaticTimer_t g_psTimerBufs[NUM_TIMERS];
+static TimerHandle_t g_pxTimers[NUM_TIMERS];
+static TickType_t g_pxDue[NUM_TIMERS];
+static uint32_t g_pui32Fired[NUM_TIMERS];
+static uint32_t g_ui32Early = 0;
+static uint32_t g_ui32Seed = 1;
+
+static uint32_t
+randomBelow(uint32_t ui32Limit)
+{
+    g_ui32Seed = g_ui32Seed * 1664525u + 1013904223u;
+
+    return (g_ui32Seed >> 8) % ui32Limit;
+}
+
+/** @brief Counts the expiry against its due tick; catch-up fires are due too. */
+static void
+expired(TimerHandle_t xTimer)
+{
+    uint32_t ui32Index = (uint32_t)(uintptr_t)pvTimerGetTimerID(xTimer);
+
+    g_ui32Early += (int32_t)(xTaskGetTickCount() - g_pxDue[ui32Index]) < 0;
+    g_pxDue[ui32Index] += xTimerGetPeriod(xTimer);
+    g_pui32Fired[ui32Index]++;
+}
+
+static void
+create(uint32_t ui32Index, TickType_t xPeriod)
+{
+    g_pxTimers[ui32Index] = xTimerCreateStatic("Test", xPeriod, pdTRUE,
+                                               (void *)(uintptr_t)ui32Index,
+                                               expired,
+                                               &g_psTimerBufs[ui32Index]);
+    g_pxDue[ui32Index] = xTaskGetTickCount() + xPeriod;
+    g_pui32Fired[ui32Index] = 0;
+    CHECK(xTimerStart(g_pxTimers[ui32Index], 0) == pdPASS);
+    prvProcessReceivedCommands();
+}
+
+/** @brief What the timer task does on waking: expiries, then commands. */
+static void
+wake(void)
+{
+    prvWheelAdvance(xTaskGetTickCount());
+    prvProcessReceivedCommands();
+}
+
+/** @brief One period 16 timer, woken 3 ticks after it is due. */
+static void
+lateLone(void)
+{
+    HostTickAdvance(tmrWHEEL_SLOTS + 3);
+    wake();
+}
+
+int
+main(void)
+{
+    uint32_t i, ui32Wrong;
+    TickType_t xStart;
+
+    HostKernelReset();
+    TivaReset();
+
+    // A lone timer reloaded while the wheel is being advanced is filed
+    // against the tick being processed, so it neither lands back in the
+    // slot being emptied nor fires again until its next period.
+    create(0, tmrWHEEL_SLOTS);
+    if (HostExpectSpin(lateLone, SPIN_MS) != 0)
+    {
+        // Still in the slot; every later wake would spin too.
+        CHECK(!"late wake of a lone timer returns");
+        return CHECK_EXIT();
+    }
+    CHECK_EQ(g_pui32Fired[0], 1);
+    CHECK_EQ(g_pxDue[0], 2 * tmrWHEEL_SLOTS);
+    HostTickSet(2 * tmrWHEEL_SLOTS - 1);
+    wake();
+    CHECK_EQ(g_pui32Fired[0], 1);
+    HostTickSet(2 * tmrWHEEL_SLOTS);
+    wake();
+    CHECK_EQ(g_pui32Fired[0], 2);
+
+    // Woken several periods late, it catches up once per period.
+    HostTickSet(5 * tmrWHEEL_SLOTS + 1);
+    wake();
+    CHECK_EQ(g_pui32Fired[0], 5);
+
+    // Stopped, the wheel is left behind; a start far later restarts it
+    // from the command's tick and the timer is due one period on.
+    CHECK(xTimerStop(g_pxTimers[0], 0) == pdPASS);
+    wake();
+    CHECK(!xTimerIsTimerActive(g_pxTimers[0]));
+    HostTickSet(0x90000000u);
+    CHECK(xTimerStart(g_pxTimers[0], 0) == pdPASS);
+    g_pxDue[0] = 0x90000000u + tmrWHEEL_SLOTS;
+    wake();
+    CHECK_EQ(xTimerWheelTime, 0x90000000u);
+    HostTickAdvance(tmrWHEEL_SLOTS - 1);
+    wake();
+    CHECK_EQ(g_pui32Fired[0], 5);
+    HostTickAdvance(1);
+    wake();
+    CHECK_EQ(g_pui32Fired[0], 6);
+    CHECK(xTimerStop(g_pxTimers[0], 0) == pdPASS);
+    wake();
+
+    // Many periods, some multiples of the slot count and some beyond the
+    // wheel's span, woken late by random steps.
+    xStart = xTaskGetTickCount();
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        TickType_t xPeriod = (i % 4 == 0) ? tmrWHEEL_SLOTS * (1 + i / 4) :
+                             (i % 16 == 15) ? tmrWHEEL_SPAN + randomBelow(500) :
+                             1 + randomBelow(300);
+
+        create(i, xPeriod);
+    }
+    for (i = 0; i < RANDOM_STEPS; i++)
+    {
+        HostTickAdvance(1 + randomBelow(MAX_STEP));
+        wake();
+    }
+    ui32Wrong = 0;
+    for (i = 0; i < NUM_TIMERS; i++)
+    {
+        ui32Wrong += g_pui32Fired[i] !=
+                     (xTaskGetTickCount() - xStart) / xTimerGetPeriod(g_pxTimers[i]);
+    }
+    CHECK_EQ(ui32Wrong, 0);
+    CHECK_EQ(g_ui32Early, 0);
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
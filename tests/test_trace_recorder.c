@@ -0,0 +1,248 @@
+/******************************************************************************
+ *
+ * test_trace_recorder.c
+ *
+ * Purpose:
+ * Host test of the kernel event trace recorder, built with
+ * configUSE_TRACE_RECORDER 1 and a host TRACE_TIMESTAMP() that counts one
+ * unit per event. queue.c is built into this file so its hooks expand into
+ * the recorder; task creation and switches go through the same hooks
+ * tasks.c expands, on stand-in control blocks. The test checks:
+ *  - task names and queue numbers are recorded;
+ *  - sends, receives, a blocking receive woken by an ISR send, and the ISR
+ *    markers appear in order with their items;
+ *  - once the ring wraps it holds the newest events, oldest first;
+ *  - TraceStop() freezes it;
+ *  - the dump converts with tools/trace_to_perfetto.py.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+#include <stdint.h>
+
+// One timestamp unit per event, at 1 MHz, so every event is 1 us apart.
+static uint32_t g_ui32TraceTime = 0;
+#define configUSE_TRACE_RECORDER    1
+#define TRACE_TIMESTAMP()           (++g_ui32TraceTime)
+#define TRACE_TIMESTAMP_HZ          1000000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "check.h"
+#include "host_kernel.h"
+#include "tiva.h"
+#include "../FreeRTOS/queue.c"
+#include "trace_recorder.c"
+
+#define TEST_QUEUE_LENGTH   4
+#define TEST_STACK_DEPTH    64
+#define WRAP_ROUNDS         100     // Six events a round, past the ring
+#define CONVERTER           "python3 ../tools/trace_to_perfetto.py"
+
+/** @brief The TCB fields the task hooks read, as tasks.c lays them out. */
+typedef struct {
+    StackType_t *pxStack;
+    StackType_t *pxEndOfStack;
+    UBaseType_t uxTCBNumber;
+    char pcTaskName[configMAX_TASK_NAME_LEN];
+} testTCB_t;
+
+enum { TASK_IDLE = 1, TASK_PRODUCER, TASK_CONSUMER, NUM_TASKS };
+
+static testTCB_t g_psTCBs[NUM_TASKS];
+static StackType_t g_pxStacks[NUM_TASKS][TEST_STACK_DEPTH];
+static testTCB_t *pxCurrentTCB;
+
+static QueueHandle_t g_xQueue;
+static StaticQueue_t g_xQueueBuf;
+static uint32_t g_pui32QueueStorage[TEST_QUEUE_LENGTH];
+
+static const char *g_ppcNames[NUM_TASKS] = {
+    NULL, "IDLE", "Producer", "Consumer"
+};
+
+/** @brief What tasks.c does on creating a task. */
+static void
+createTask(uint32_t ui32Number)
+{
+    testTCB_t *pxNewTCB = &g_psTCBs[ui32Number];
+
+    pxNewTCB->pxStack = g_pxStacks[ui32Number];
+    pxNewTCB->pxEndOfStack = &g_pxStacks[ui32Number][TEST_STACK_DEPTH - 1];
+    pxNewTCB->uxTCBNumber = ui32Number;
+    strncpy(pxNewTCB->pcTaskName, g_ppcNames[ui32Number],
+            configMAX_TASK_NAME_LEN - 1);
+    traceTASK_CREATE(pxNewTCB);
+}
+
+/** @brief What vTaskSwitchContext() does. */
+static void
+switchTo(uint32_t ui32Number)
+{
+    traceTASK_SWITCHED_OUT();
+    pxCurrentTCB = &g_psTCBs[ui32Number];
+    traceTASK_SWITCHED_IN();
+}
+
+/** @brief An instrumented ISR sending to the queue. */
+static void
+isrSend(void)
+{
+    uint32_t ui32Value = 9;
+    BaseType_t xWoken = pdFALSE;
+
+    TRACE_ISR_ENTER(TRACE_ISR_YAW_PHASE);
+    CHECK(xQueueSendFromISR(g_xQueue, &ui32Value, &xWoken) == pdPASS);
+    TRACE_ISR_EXIT(TRACE_ISR_YAW_PHASE);
+}
+
+/** @brief Event n of the ring, counting every event ever written. */
+static const traceEvent_t *
+event(uint32_t n)
+{
+    return &g_sTraceBuffer.psEvents[n & (TRACE_RECORDER_EVENTS - 1)];
+}
+
+/** @brief Whether event n is of the type, id and argument given. */
+static int
+is(uint32_t n, traceEventType_t eType, uint32_t ui32Id, uint32_t ui32Arg)
+{
+    uint32_t ui32Info = event(n)->ui32Info;
+
+    return (ui32Info & 0xFF) == (uint32_t)eType &&
+           ((ui32Info >> 8) & 0xFF) == ui32Id && (ui32Info >> 16) == ui32Arg;
+}
+
+/** @brief Runs the converter on the dump; returns its exit status. */
+static int
+convert(const char *pcPath, const char *pcArgs, char *pcOut, size_t uiSize)
+{
+    char pcCommand[256];
+    size_t uiLen;
+    FILE *psPipe;
+
+    snprintf(pcCommand, sizeof(pcCommand), CONVERTER " %s %s 2>&1",
+             pcArgs, pcPath);
+    psPipe = popen(pcCommand, "r");
+    if (psPipe == NULL)
+    {
+        return -1;
+    }
+    uiLen = fread(pcOut, 1, uiSize - 1, psPipe);
+    pcOut[uiLen] = '\0';
+
+    return pclose(psPipe);
+}
+
+int
+main(void)
+{
+    static char pcOut[1 << 20];
+    char pcPath[] = "/tmp/trace_dumpXXXXXX";
+    uint32_t ui32Value = 7, ui32Head, ui32Ordered, i;
+    FILE *psDump;
+    int iFd;
+
+    HostKernelReset();
+    TivaReset();
+
+    // Names are kept against task numbers; queues are numbered from 1.
+    for (i = TASK_IDLE; i < NUM_TASKS; i++)
+    {
+        createTask(i);
+    }
+    pxCurrentTCB = &g_psTCBs[TASK_IDLE];
+    CHECK(strcmp(g_sTraceBuffer.ppcTaskNames[TASK_PRODUCER], "Producer") == 0);
+    CHECK(strcmp(g_sTraceBuffer.ppcTaskNames[TASK_CONSUMER], "Consumer") == 0);
+    g_xQueue = xQueueCreateStatic(TEST_QUEUE_LENGTH, sizeof(uint32_t),
+                                  (uint8_t *)g_pui32QueueStorage, &g_xQueueBuf);
+    CHECK_EQ(uxQueueGetQueueNumber(g_xQueue), 1);
+    CHECK_EQ(g_sTraceBuffer.ui32Head, 0);
+
+    // A producer fills, a consumer drains and then blocks on the empty
+    // queue, and an ISR's send wakes it.
+    switchTo(TASK_PRODUCER);
+    CHECK(xQueueSend(g_xQueue, &ui32Value, 0) == pdPASS);
+    CHECK(xQueueSend(g_xQueue, &ui32Value, 0) == pdPASS);
+    switchTo(TASK_CONSUMER);
+    CHECK(xQueueReceive(g_xQueue, &ui32Value, 0) == pdPASS);
+    CHECK(xQueueReceive(g_xQueue, &ui32Value, 0) == pdPASS);
+    HostOnNextBlock(isrSend);
+    ui32Value = 0;
+    CHECK(xQueueReceive(g_xQueue, &ui32Value, 5) == pdPASS && ui32Value == 9);
+
+    CHECK_EQ(g_sTraceBuffer.ui32Head, 13);
+    CHECK(is(0, TRACE_EVT_SWITCH_OUT, TASK_IDLE, 0));
+    CHECK(is(1, TRACE_EVT_SWITCH_IN, TASK_PRODUCER, 0));
+    CHECK(is(2, TRACE_EVT_QUEUE_SEND, 1, 1));
+    CHECK(is(3, TRACE_EVT_QUEUE_SEND, 1, 2));
+    CHECK(is(4, TRACE_EVT_SWITCH_OUT, TASK_PRODUCER, 0));
+    CHECK(is(5, TRACE_EVT_SWITCH_IN, TASK_CONSUMER, 0));
+    CHECK(is(6, TRACE_EVT_QUEUE_RECEIVE, 1, 2));
+    CHECK(is(7, TRACE_EVT_QUEUE_RECEIVE, 1, 1));
+    CHECK(is(8, TRACE_EVT_BLOCK_RECEIVE, 1, 0));
+    CHECK(is(9, TRACE_EVT_ISR_ENTER, TRACE_ISR_YAW_PHASE, 0));
+    CHECK(is(10, TRACE_EVT_QUEUE_SEND_ISR, 1, 1));
+    CHECK(is(11, TRACE_EVT_ISR_EXIT, TRACE_ISR_YAW_PHASE, 0));
+    CHECK(is(12, TRACE_EVT_QUEUE_RECEIVE, 1, 1));
+    CHECK_EQ(event(0)->ui32Time, 1);
+    CHECK_EQ(event(12)->ui32Time, 13);
+
+    // Past the ring's capacity the oldest events are overwritten: it holds
+    // the newest, oldest first, the last round ending where it should.
+    for (i = 0; i < WRAP_ROUNDS; i++)
+    {
+        switchTo(TASK_PRODUCER);
+        CHECK(xQueueSend(g_xQueue, &i, 0) == pdPASS);
+        switchTo(TASK_CONSUMER);
+        CHECK(xQueueReceive(g_xQueue, &ui32Value, 0) == pdPASS && ui32Value == i);
+    }
+    ui32Head = g_sTraceBuffer.ui32Head;
+    CHECK_EQ(ui32Head, 13 + 6 * WRAP_ROUNDS);
+    CHECK(ui32Head > TRACE_RECORDER_EVENTS);
+    ui32Ordered = 1;
+    for (i = ui32Head - TRACE_RECORDER_EVENTS; i < ui32Head; i++)
+    {
+        ui32Ordered &= event(i)->ui32Time == i + 1;
+    }
+    CHECK(ui32Ordered);
+    CHECK(is(ui32Head - 3, TRACE_EVT_SWITCH_OUT, TASK_PRODUCER, 0));
+    CHECK(is(ui32Head - 2, TRACE_EVT_SWITCH_IN, TASK_CONSUMER, 0));
+    CHECK(is(ui32Head - 1, TRACE_EVT_QUEUE_RECEIVE, 1, 1));
+
+    // Stopped, the ring keeps the lead-up and takes nothing more.
+    TraceStop();
+    switchTo(TASK_PRODUCER);
+    CHECK(xQueueSend(g_xQueue, &ui32Value, 0) == pdPASS);
+    CHECK_EQ(g_sTraceBuffer.ui32Head, ui32Head);
+    CHECK(is(ui32Head - 1, TRACE_EVT_QUEUE_RECEIVE, 1, 1));
+
+    // The dump, saved as the debugger would, converts on the host.
+    iFd = mkstemp(pcPath);
+    CHECK(iFd >= 0);
+    psDump = iFd >= 0 ? fdopen(iFd, "wb") : NULL;
+    CHECK(psDump != NULL);
+    if (psDump != NULL)
+    {
+        CHECK_EQ(fwrite(&g_sTraceBuffer, sizeof(g_sTraceBuffer), 1, psDump), 1);
+        fclose(psDump);
+
+        CHECK_EQ(convert(pcPath, "--text", pcOut, sizeof(pcOut)), 0);
+        CHECK(strstr(pcOut, "256 events (357 lost to wrap), stopped") != NULL);
+        CHECK(strstr(pcOut, "queue_receive      id=1   arg=1") != NULL);
+
+        CHECK_EQ(convert(pcPath, "", pcOut, sizeof(pcOut)), 0);
+        CHECK(strstr(pcOut, "\"traceEvents\"") != NULL);
+        CHECK(strstr(pcOut, "\"name\": \"Producer\"") != NULL);
+        CHECK(strstr(pcOut, "\"name\": \"Consumer\"") != NULL);
+        CHECK(strstr(pcOut, "\"name\": \"queue_send q1\"") != NULL);
+        unlink(pcPath);
+    }
+
+    CHECK_EQ(g_ui32HostAsserts, 0);
+    CHECK_EQ(HostCriticalNesting(), 0);
+    return CHECK_EXIT();
+}
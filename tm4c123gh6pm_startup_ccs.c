@@ -59,6 +59,13 @@ extern void xPortPendSVHandler(void);
 extern void vPortSVCHandler(void);
 extern void xPortSysTickHandler(void);
 
+//*****************************************************************************
+//
+// Turns the motor outputs off from the fault handler (pwm_task.h).
+//
+//*****************************************************************************
+extern void PWMMotorsOff(void);
+
 //*****************************************************************************
 //
 // The vector table.  Note that the proper constructs must be placed on this to
@@ -277,8 +284,9 @@ static void
 FaultISR(void)
 {
     //
-    // Enter an infinite loop.
+    // Stop the rotors, then enter an infinite loop.
     //
+    PWMMotorsOff();
     while(1)
     {
     }
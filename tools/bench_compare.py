@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+bench_compare.py
+
+Compares two kernel benchmark captures produced by kernel_bench.c.
+
+Each capture is the UART output of a KERNEL_BENCH_ENABLE build: '#' comment
+lines, a CSV header and one row per case, in CPU cycles. Prints the change
+in median and p99 for every case and exits with status 1 if any median got
+worse by more than the threshold, so it can gate a change in CI.
+
+    python3 tools/bench_compare.py baseline.csv current.csv
+    python3 tools/bench_compare.py --threshold 5 baseline.csv current.csv
+
+Group 9
+"""
+
+import argparse
+import csv
+import sys
+
+
+def load(path):
+    rows = {}
+    meta = []
+    with open(path, newline="") as f:
+        lines = []
+        for line in f:
+            line = line.strip()
+            if line.startswith("#"):
+                meta.append(line[1:].strip())
+            elif line:
+                lines.append(line)
+    for row in csv.DictReader(lines):
+        rows[(row["primitive"], row["case"])] = \
+            {k: int(v) for k, v in row.items() if k not in ("primitive", "case")}
+    return meta, rows
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=10.0,
+                    help="allowed median increase in percent (default 10)")
+    args = ap.parse_args()
+
+    base_meta, base = load(args.baseline)
+    cur_meta, cur = load(args.current)
+    if base_meta[:1] != cur_meta[:1]:
+        print("warning: configurations differ:\n  %s\n  %s" %
+              (base_meta[:1], cur_meta[:1]), file=sys.stderr)
+
+    print("%-16s %-16s %8s %8s %7s %8s %8s %7s" %
+          ("primitive", "case", "med", "med'", "d%", "p99", "p99'", "d%"))
+    failed = []
+    for key in sorted(set(base) | set(cur)):
+        if key not in base or key not in cur:
+            print("%-16s %-16s %s" % (key[0], key[1],
+                  "only in current" if key in cur else "only in baseline"))
+            continue
+        b, c = base[key], cur[key]
+        dmed = 100.0 * (c["median"] - b["median"]) / max(b["median"], 1)
+        dp99 = 100.0 * (c["p99"] - b["p99"]) / max(b["p99"], 1)
+        flag = ""
+        if dmed > args.threshold:
+            failed.append(key)
+            flag = "  REGRESSION"
+        print("%-16s %-16s %8d %8d %+6.1f%% %8d %8d %+6.1f%%%s" %
+              (key[0], key[1], b["median"], c["median"], dmed,
+               b["p99"], c["p99"], dp99, flag))
+
+    if failed:
+        print("%d case(s) regressed by more than %.1f%%" %
+              (len(failed), args.threshold), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,535 @@
+#!/usr/bin/env python3
+"""
+empc_gen.py
+
+Solves the model-predictive control problem for CONTROL_MODE_EMPC offline
+and writes its explicit solution as the region table in empc_regions.c.
+
+The controller has the state of CONTROL_MODE_LQR (see lqr_gains.py) and
+the same weights, with the rig linearised about hover. Over a horizon of
+HORIZON blocks, each holding both duties for BLOCK control periods, it
+minimises the usual quadratic cost, with the LQR cost-to-go as the
+terminal cost, subject to the duty limits of control_task.c: 0 to 99 for
+the main rotor, and 0 to TAIL_PWM_MAX (85) for the tail. The answer is a
+quadratic programme (QP) whose only parameter is the state. Its solution
+is piecewise affine in the state: each combination of duty limits that can
+be active at the optimum is a polyhedral region of the state space with
+its own affine law. The regions are found by enumerating the combinations
+and keeping those that contain a ball of the state space. Only the first
+block's duties are kept, as the firmware recomputes them every cycle.
+
+The regions are written in the order the firmware searches them, fewest
+active limits first, so the common unsaturated case is found first. Each
+region's half-spaces are normalised and scaled to int16 for DspMatVec(),
+and its law is quantised as in lqr_gains.c.
+
+--check compares the quantised table, evaluated the way the firmware does
+it, against the QP solved directly by projected gradient at random states,
+and exits with status 1 if they disagree. --sizes reports the region count
+and table size for a range of horizons, to pick one that fits. --plant
+loads the rig fitted by tools/sysid.py, as for lqr_gains.py.
+
+    python3 tools/empc_gen.py                     # summary
+    python3 tools/empc_gen.py --check 2000
+    python3 tools/empc_gen.py --sizes
+    python3 tools/empc_gen.py -o empc_regions.c   # regenerate the table
+
+Group 9
+"""
+
+import argparse
+import itertools
+import math
+import random
+import sys
+
+from lqr_gains import (DT, OPERATING_POINTS, STATE_SCALE, add, cost, dare,
+                       discretise, eye, inv, linear_model, mul, plant,
+                       quantise, scale, tr, zeros)
+from heli_sim import load_plant
+
+HORIZON = 2             # Blocks predicted
+BLOCK = 10              # Control periods per block (20 ms)
+TAIL_MAX = 85.0         # TAIL_PWM_MAX in control_task.c
+DESIGN_POINT = OPERATING_POINTS[1]
+
+# Half-width of the part of the state space the table must cover, in the
+# unscaled units of lqr_gains.STATE_NAMES. Outside it the nearest region's
+# law is used.
+STATE_BOX = [1000.0, 2000.0, 180.0, 1000.0, 200.0, 100.0, 99.0, 99.0]
+
+HALFSPACE_Q = 12        # EMPC_HALFSPACE_Q in empc.h
+MAX_HALFSPACES = 16     # EMPC_MAX_HALFSPACES in empc.h
+STATE_Q = 4             # LQR_STATE_Q in lqr_gains.h
+MIN_RADIUS = 1e-3       # Smallest region kept, as a fraction of STATE_BOX
+
+
+# ---------------------------------------------------------------------------
+# Problem
+# ---------------------------------------------------------------------------
+
+def block_model(p):
+    """The model over BLOCK control periods with the duties held."""
+    a, b = linear_model(p)
+    ad, bd = discretise(a, b, DT)
+    ab, bb = eye(len(ad)), zeros(len(ad), len(bd[0]))
+    for _ in range(BLOCK):
+        bb = add(mul(ad, bb), bd)
+        ab = mul(ad, ab)
+    return ab, bb
+
+
+def condensed(point, horizon):
+    """J = U'HU/2 + x'F'U + ..., G U <= w, with U the stacked block duties
+    about the trims and x the state."""
+    p = plant(point)
+    a, b = block_model(p)
+    q, r = cost(point)
+    pt = dare(a, b, q, r)
+    n, m = len(a), len(b[0])
+
+    # X = Sx x + Su U for X the stacked states after each block.
+    sx, su = [], zeros(n * horizon, m * horizon)
+    ak = eye(n)
+    for k in range(horizon):
+        ak = mul(a, ak)
+        sx.extend(ak)
+        for j in range(k + 1):
+            aj = eye(n)
+            for _ in range(k - j):
+                aj = mul(a, aj)
+            blk = mul(aj, b)
+            for i in range(n):
+                for c in range(m):
+                    su[k * n + i][j * m + c] = blk[i][c]
+
+    qbar = zeros(n * horizon, n * horizon)
+    rbar = zeros(m * horizon, m * horizon)
+    for k in range(horizon):
+        weight = pt if k == horizon - 1 else q
+        for i in range(n):
+            for j in range(n):
+                qbar[k * n + i][k * n + j] = weight[i][j]
+        for i in range(m):
+            for j in range(m):
+                rbar[k * m + i][k * m + j] = r[i][j]
+
+    h = scale(add(mul(mul(tr(su), qbar), su), rbar), 2.0)
+    f = scale(mul(mul(tr(su), qbar), sx), 2.0)
+
+    # Two limits per duty per block: u <= max - trim, -u <= trim.
+    lo = [-p["hover_duty"], -p["tail_trim"]]
+    hi = [99.0 - p["hover_duty"], TAIL_MAX - p["tail_trim"]]
+    g, w = [], []
+    for k in range(horizon):
+        for c in range(m):
+            row = [0.0] * (m * horizon)
+            row[k * m + c] = 1.0
+            g.append(row)
+            w.append(hi[c])
+            g.append([-x for x in row])
+            w.append(-lo[c])
+    return p, h, f, g, w
+
+
+# ---------------------------------------------------------------------------
+# Linear programme, for the size of a region
+# ---------------------------------------------------------------------------
+
+def simplex(a, b, c):
+    """max c'v subject to a v <= b, v >= 0. Returns (value, v) or None if
+    infeasible. Dense tableau, Bland's rule, with an auxiliary variable to
+    find a first vertex when some b < 0."""
+    eps = 1e-9
+    rows, cols = len(a), len(a[0])
+
+    # Columns: v, the auxiliary, slacks, right hand side.
+    t = [list(a[i]) + [-1.0] + [1.0 if j == i else 0.0 for j in range(rows)]
+         + [b[i]] for i in range(rows)]
+    basis = [cols + 1 + i for i in range(rows)]
+    width = cols + 1 + rows
+
+    def pivot(r, c):
+        pv = t[r][c]
+        t[r] = [x / pv for x in t[r]]
+        for i in range(rows):
+            if i != r and abs(t[i][c]) > eps:
+                f = t[i][c]
+                t[i] = [x - f * y for x, y in zip(t[i], t[r])]
+        basis[r] = c
+
+    def run(obj):
+        while True:
+            z = [obj[j] - sum(obj[basis[i]] * t[i][j] for i in range(rows))
+                 for j in range(width)]
+            enter = next((j for j in range(width) if z[j] > eps), None)
+            if enter is None:
+                return True
+            best = None
+            for i in range(rows):
+                if t[i][enter] > eps:
+                    ratio = t[i][-1] / t[i][enter]
+                    if best is None or ratio < best[0] - eps or \
+                            (abs(ratio - best[0]) <= eps and basis[i] < basis[best[1]]):
+                        best = (ratio, i)
+            if best is None:
+                return False        # Unbounded
+            pivot(best[1], enter)
+
+    worst = min(range(rows), key=lambda i: b[i])
+    if b[worst] < 0:
+        pivot(worst, cols)
+        aux = [0.0] * width
+        aux[cols] = -1.0
+        run(aux)
+        value = sum(aux[basis[i]] * t[i][-1] for i in range(rows))
+        if value < -eps:
+            return None
+        if cols in basis:
+            i = basis.index(cols)
+            j = next((j for j in range(width) if j != cols and abs(t[i][j]) > eps), None)
+            if j is not None:
+                pivot(i, j)
+    for row in t:
+        row[cols] = 0.0
+    obj = list(c) + [0.0] * (1 + rows)
+    if not run(obj):
+        return float("inf"), None
+    v = [0.0] * cols
+    for i, j in enumerate(basis):
+        if j < cols:
+            v[j] = t[i][-1]
+    return sum(ci * vi for ci, vi in zip(c, v)), v
+
+
+def chebyshev_radius(rows, bounds):
+    """Radius of the largest ball in {y : rows y <= bounds, |y_j| <= 1}."""
+    n = len(rows[0]) if rows else len(STATE_BOX)
+    # y = z - 1 with z >= 0; variables z and the radius.
+    a, b = [], []
+    for row, bound in zip(rows, bounds):
+        norm = math.sqrt(sum(x * x for x in row))
+        a.append(list(row) + [norm])
+        b.append(bound + sum(row))
+    for j in range(n):
+        e = [0.0] * (n + 1)
+        e[j] = 1.0
+        e[n] = 1.0
+        a.append(e)
+        b.append(2.0)
+        e = [0.0] * (n + 1)
+        e[j] = -1.0
+        e[n] = 1.0
+        a.append(e)
+        b.append(0.0)
+    result = simplex(a, b, [0.0] * n + [1.0])
+    return 0.0 if result is None else result[0]
+
+
+# ---------------------------------------------------------------------------
+# Regions
+# ---------------------------------------------------------------------------
+
+def solve_active(h, f, g, w, active):
+    """Affine U(x) = Ku x + ku and multipliers L(x) = Kl x + kl for a set
+    of active limits."""
+    hi = inv(h)
+    nu = len(h)
+    if active:
+        ga = [g[i] for i in active]
+        wa = [[w[i]] for i in active]
+        s = inv(mul(mul(ga, hi), tr(ga)))
+        kl = scale(mul(mul(s, mul(ga, hi)), f), -1.0)
+        cl = scale(mul(s, wa), -1.0)
+        ku = scale(add(f, mul(tr(ga), kl)), -1.0)
+        ku = mul(hi, ku)
+        cu = mul(hi, scale(mul(tr(ga), cl), -1.0))
+    else:
+        kl, cl = [], []
+        ku = scale(mul(hi, f), -1.0)
+        cu = [[0.0] for _ in range(nu)]
+    return ku, [x[0] for x in cu], kl, [x[0] for x in cl]
+
+
+def regions(point=DESIGN_POINT, horizon=HORIZON):
+    """Every non-empty critical region, fewest active limits first. Each is
+    (active, rows, bounds, K, k) in the normalised state y = x / STATE_BOX,
+    with rows y <= bounds inside and the duties about the trims K y + k."""
+    p, h, f, g, w = condensed(point, horizon)
+    nu = len(h)
+    box = STATE_BOX
+    f = [[x * s for x, s in zip(row, box)] for row in f]
+
+    found = []
+    for choice in itertools.product((0, 1, 2), repeat=nu):
+        # 0: free, 1: at its upper limit, 2: at its lower limit.
+        active = [2 * i + c - 1 for i, c in enumerate(choice) if c]
+        ku, cu, kl, cl = solve_active(h, f, g, w, active)
+        rows, bounds = [], []
+        for i in range(len(g)):
+            if i in active:
+                # Multiplier >= 0.
+                rows.append([-x for x in kl[active.index(i)]])
+                bounds.append(cl[active.index(i)])
+            elif (i // 2) not in [a // 2 for a in active]:
+                # Limit not broken: g_i U(x) <= w_i.
+                rows.append([sum(gi * kr[j] for gi, kr in zip(g[i], ku))
+                             for j in range(len(box))])
+                bounds.append(w[i] - sum(gi * c for gi, c in zip(g[i], cu)))
+        rows, bounds = normalise(rows, bounds)
+        if chebyshev_radius(rows, bounds) > MIN_RADIUS:
+            found.append((active, rows, bounds, ku[:2], cu[:2]))
+    found.sort(key=lambda r: len(r[0]))
+    return p, found
+
+
+def normalise(rows, bounds):
+    out_rows, out_bounds = [], []
+    for row, bound in zip(rows, bounds):
+        norm = max(abs(x) for x in row)
+        if norm < 1e-12:
+            continue                # Always true or never: the LP decides
+        out_rows.append([x / norm for x in row])
+        out_bounds.append(bound / norm)
+    return out_rows, out_bounds
+
+
+# ---------------------------------------------------------------------------
+# Fixed point, as the firmware evaluates it
+# ---------------------------------------------------------------------------
+
+def quantised(p, found):
+    """Rows of (half-spaces, bounds, main law, tail law) in firmware units:
+    half-spaces in Q HALFSPACE_Q of the scaled state, laws as lqr_gains."""
+    table = []
+    for _, rows, bounds, k, c in found:
+        # Scaled state x_s = x * STATE_SCALE = y * box * STATE_SCALE.
+        unit = [b * s for b, s in zip(STATE_BOX, STATE_SCALE)]
+        qrows, qbounds = [], []
+        for row, bound in zip(rows, bounds):
+            scaled = [x / u for x, u in zip(row, unit)]
+            norm = max(abs(x) for x in scaled)
+            qrows.append([int(round(x / norm * 2 ** HALFSPACE_Q)) for x in scaled])
+            # Within +/-(2^30 - 1), which decides the same for any int16
+            # state and keeps EmpcLocate()'s differences in range.
+            qbound = int(round(bound / norm * 2 ** HALFSPACE_Q))
+            qbounds.append(min(max(qbound, 1 - 2 ** 30), 2 ** 30 - 1))
+        laws = []
+        for kr, cr, trim in zip(k, c, (p["hover_duty"], p["tail_trim"])):
+            # Duty = trim + c + K y, as lqr_gains' trim - gains . x.
+            gains = [-x / b for x, b in zip(kr, STATE_BOX)]
+            laws.append(quantise(gains, trim + cr))
+        table.append((qrows, qbounds, laws[0], laws[1]))
+    return table
+
+
+def locate(table, state):
+    """EmpcLocate(): the first region containing the state, or the one it is
+    least outside."""
+    best, best_excess = 0, None
+    for n, (rows, bounds, _, _) in enumerate(table):
+        excess = max(sum(a * x for a, x in zip(row, state)) - bound
+                     for row, bound in zip(rows, bounds)) if rows else 0
+        if excess <= 0:
+            return n
+        if best_excess is None or excess < best_excess:
+            best, best_excess = n, excess
+    return best
+
+
+def evaluate(table, state):
+    region = table[locate(table, state)]
+    duty = []
+    for trim, shift, gains in (region[2], region[3]):
+        duty.append((trim - sum(a * x for a, x in zip(gains, state))) >> shift)
+    return duty
+
+
+# ---------------------------------------------------------------------------
+# Checks and output
+# ---------------------------------------------------------------------------
+
+def qp_direct(h, f, g, w, y, iters=4000):
+    """The box-constrained QP by projected gradient: independent of the
+    active-set enumeration above."""
+    nu = len(h)
+    lo = [-w[2 * i + 1] for i in range(nu)]
+    hi = [w[2 * i] for i in range(nu)]
+    lin = [sum(fr[j] * y[j] for j in range(len(y))) for fr in f]
+    step = 1.0 / max(sum(abs(x) for x in row) for row in h)
+    u = [0.0] * nu
+    for _ in range(iters):
+        grad = [sum(h[i][j] * u[j] for j in range(nu)) + lin[i] for i in range(nu)]
+        u = [min(max(u[i] - step * grad[i], lo[i]), hi[i]) for i in range(nu)]
+    return u
+
+
+def check(count, seed=1):
+    p, found = regions()
+    table = quantised(p, found)
+    _, h, f, g, w = condensed(DESIGN_POINT, HORIZON)
+    f = [[x * s for x, s in zip(row, STATE_BOX)] for row in f]
+    rng = random.Random(seed)
+    worst = 0.0
+    for _ in range(count):
+        # Mostly near hover, where the rig spends its time.
+        y = [rng.gauss(0.0, 0.15) for _ in STATE_BOX]
+        y = [min(max(v, -1.0), 1.0) for v in y]
+        state = [max(-32768, min(32767, int(v * b * s)))
+                 for v, b, s in zip(y, STATE_BOX, STATE_SCALE)]
+        y = [x / (b * s) for x, b, s in zip(state, STATE_BOX, STATE_SCALE)]
+        u = qp_direct(h, f, g, w, y)
+        want = [u[0] + p["hover_duty"], u[1] + p["tail_trim"]]
+        got = evaluate(table, state)
+        worst = max(worst, max(abs(a - b) for a, b in zip(got, want)))
+    print("checked %d states against the QP: worst duty error %.2f%%" % (count, worst))
+    # The firmware truncates to whole percent, so up to 1% is expected.
+    return worst <= 1.5
+
+
+C_HEADER = """\
+/******************************************************************************
+ *
+ * empc_regions.c
+ *
+ * Purpose:
+ * Explicit MPC region table for CONTROL_MODE_EMPC. See empc.h.
+ *
+ * Generated by tools/empc_gen.py (horizon %d blocks of %d periods) from the
+ * model and weights of tools/lqr_gains.py. Edit those and regenerate rather
+ * than editing this file.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // CONTROL_PERIOD_MS
+#include "empc.h"            // Explicit MPC
+#include "dsp_filter.h"      // DSP_MAT_PAIR
+
+#if CONTROL_PERIOD_MS != %d
+#error "empc_regions.c was generated for another CONTROL_PERIOD_MS"
+#endif
+
+#if EMPC_MAX_HALFSPACES < %d
+#error "EMPC_MAX_HALFSPACES in empc.h is too small for this table"
+#endif
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+"""
+
+
+def pair_list(values):
+    return ["DSP_MAT_PAIR(%d, %d)" % (values[i], values[i + 1])
+            for i in range(0, len(values), 2)]
+
+
+def wrap(items, indent, per_line):
+    """items joined by commas, per_line to a line."""
+    return ",\n".join(indent + ", ".join(items[i:i + per_line])
+                      for i in range(0, len(items), per_line))
+
+
+def write_c(path, p, found, table):
+    out = [C_HEADER % (HORIZON, BLOCK, int(round(DT * 1000)),
+                       max(len(t[0]) for t in table))]
+    total = sum(len(t[0]) for t in table)
+
+    # One row per line, a region's rows together.
+    out.append("static const uint32_t g_pui32Halfspaces[%d * LQR_STATES / 2] =\n{\n"
+               % total)
+    out.append(",\n".join(wrap(pair_list(row), "    ", 2)
+                          for rows, _, _, _ in table for row in rows))
+    out.append("\n};\n\n")
+
+    out.append("static const int32_t g_pi32Bounds[%d] =\n{\n" % total)
+    out.append(",\n".join(wrap(["%d" % b for b in bounds], "    ", 6)
+                          for _, bounds, _, _ in table))
+    out.append("\n};\n\n")
+
+    out.append("static const empcRegion_t g_psRegions[%d] =\n{\n" % len(table))
+    first = 0
+    lines = []
+    for (active, _, _, _, _), (rows, _, main, tail) in zip(found, table):
+        lines.append("    // %s\n    {\n        %d, %d,\n"
+                     "        { %d, %d },\n        { %d, %d },\n        {\n%s\n        }\n    }" %
+                     (describe(active), first, len(rows), main[0], tail[0],
+                      main[1], tail[1],
+                      wrap(pair_list(main[2]) + pair_list(tail[2]), "            ", 2)))
+        first += len(rows)
+    out.append(",\n".join(lines) + "\n};\n\n")
+
+    out.append("const empcTable_t g_sEmpcTable =\n{\n")
+    out.append("    %d, %d,\n    { %d, %d },\n" %
+               (len(table), int(round(p["motor_tau"] * 1000)),
+                int(round(p["hover_duty"] * 2 ** STATE_Q)),
+                int(round(p["tail_trim"] * 2 ** STATE_Q))))
+    out.append("    g_psRegions, g_pui32Halfspaces, g_pi32Bounds\n};\n")
+    with open(path, "w") as f:
+        f.write("".join(out))
+
+
+def describe(active):
+    """The limits a region has active, e.g. "now main max; next tail min"."""
+    if not active:
+        return "unconstrained"
+    parts = []
+    for block in range(HORIZON):
+        names = ["%s %s" % (("main", "tail")[(i // 2) % 2], ("max", "min")[i % 2])
+                 for i in active if i // 4 == block]
+        if names:
+            parts.append("%s %s" % ("now" if block == 0 else
+                                    "next" if block == 1 else "block %d" % block,
+                                    ", ".join(names)))
+    return "; ".join(parts)
+
+
+def table_bytes(table):
+    rows = sum(len(t[0]) for t in table)
+    return rows * (2 * len(STATE_BOX) + 4) + len(table) * (4 + 16 + 2 * len(STATE_BOX) * 2)
+
+
+def main():
+    global HORIZON
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("-o", "--output", metavar="C_FILE",
+                    help="write the region table, e.g. empc_regions.c")
+    ap.add_argument("--check", type=int, metavar="N",
+                    help="compare with the QP at N random states")
+    ap.add_argument("--sizes", action="store_true",
+                    help="region count and size for horizons 1 to 3")
+    ap.add_argument("--plant", metavar="JSON",
+                    help="plant parameters fitted by tools/sysid.py")
+    args = ap.parse_args()
+    if args.plant:
+        load_plant(args.plant)
+
+    if args.sizes:
+        print("%8s %8s %8s %10s" % ("horizon", "regions", "rows", "bytes"))
+        for n in (1, 2, 3):
+            p, found = regions(horizon=n)
+            table = quantised(p, found)
+            print("%8d %8d %8d %10d" % (n, len(table), sum(len(t[0]) for t in table),
+                                        table_bytes(table)))
+        return
+
+    p, found = regions()
+    table = quantised(p, found)
+    if max(len(t[0]) for t in table) > MAX_HALFSPACES:
+        sys.exit("a region has more than EMPC_MAX_HALFSPACES half-spaces")
+    print("horizon %d x %d periods: %d regions, %d half-spaces, %d bytes" %
+          (HORIZON, BLOCK, len(table), sum(len(t[0]) for t in table),
+           table_bytes(table)))
+    if args.output:
+        write_c(args.output, p, found, table)
+        print("wrote %s" % args.output)
+    if args.check and not check(args.check):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,402 @@
+#!/usr/bin/env python3
+"""
+gain_tune.py
+
+Searches the CONTROL_MODE_SINGLE_LOOP gains of control_task.c against the
+rig model of tools/heli_sim.py and prints the Pareto-optimal gain sets, so
+retuning starts from simulation rather than from flashing and flying.
+
+Each gain set is flown through the two step responses heli_sim.py reports,
+a height step from 300 to 500 counts and a yaw step of 60 degrees, by the
+line-for-line port of the controller there. It is scored on four figures,
+each summed over both steps and all minimised:
+
+    rise        10-90% rise time, s
+    overshoot   peak past the target, %
+    settle      time to stay within 5% of the step, s
+    effort      total duty movement of both rotors per second, %/s
+
+A response that never rises or settles scores the whole 5 s after its step.
+
+The gains are searched in a unit box, on a log scale for the proportional
+and integral gains and a linear one for the derivative gains, which are
+zero today. A Latin hypercube of gain sets comes first; from the best of
+them for each of a lattice of weightings of the four figures (normalised
+by the current gains' scores), a Nelder-Mead search minimises that
+weighted sum. The searches run in lockstep, each asking for the one to
+n + 1 gain sets its next step needs, so every round's requests are flown
+together. Every gain set flown goes into the archive the Pareto set is
+taken from, so points on a concave part of the front that the weighted
+sums pass over still appear. Gains are rounded to three figures, the
+precision they would be written with, and each set is flown once.
+
+The simulations run on a pool of processes, one per core by default, as
+Python threads share one interpreter. Each simulation of one step for one
+gain set is a job; a worker takes the next job from the shared queue as
+soon as it is free, which balances the uneven jobs as work stealing would.
+The jobs do not share state, so the time falls with the number of workers
+until a round has fewer jobs than there are workers; --divisions raises
+the number of searches for larger machines. The summary gives the
+workers' busy fraction to check that, and --scaling times the same search
+at several job counts against the cores the process may use.
+
+    python3 tools/gain_tune.py
+    python3 tools/gain_tune.py --jobs 16 --divisions 3 -o pareto.csv
+    python3 tools/gain_tune.py --plant rig.json
+    python3 tools/gain_tune.py --scaling 1,2,4,8
+
+The Pareto sets are listed best first by the equal-weight sum, and the
+first of them, marked "balanced", is printed as #defines ready to paste
+into control_task.c. On the model, the single loop cannot hold the height
+step inside 5% at any gains: its 50% offset is above the hover duty and
+the integral is cleared within 20 counts of the target, so the truncated
+proportional term alone holds the height, which stays 20-40 counts off or,
+at higher gains, oscillates. The settle score then mostly ranks the yaw.
+
+Group 9
+"""
+
+import argparse
+import itertools
+import math
+import os
+import random
+import sys
+import time
+from multiprocessing import Pool
+
+from heli_sim import SINGLE_LOOP, SingleLoop, load_plant, run, step_metrics
+
+# Search range of each gain: (#define, low, high, scale).
+PARAMS = [
+    ("PROPORTIONAL_GAIN", 0.01, 1.0, "log"),
+    ("DERIVATIVE_GAIN", 0.0, 10.0, "lin"),
+    ("INTERGRAL_GAIN", 1e-6, 1e-3, "log"),
+    ("PROPORTIONAL_GAIN_YAW", 0.1, 5.0, "log"),
+    ("DERIVATIVE_GAIN_YAW", 0.0, 10.0, "lin"),
+    ("INTERGRAL_GAIN_YAW", 1e-5, 1e-2, "log"),
+]
+NAMES = [p[0] for p in PARAMS]
+SHORT_NAMES = ["P", "D", "I", "P_YAW", "D_YAW", "I_YAW"]
+
+OBJECTIVES = ["rise", "overshoot", "settle", "effort"]
+
+# Step scenarios: length, height and yaw targets, start height, and the
+# traced quantity (heli_sim.run() columns) with its start and final values.
+STEP_AT = 1.0
+SCENARIOS = {
+    "height": (6.0, lambda t: 300 if t < STEP_AT else 500, lambda t: 0, 300,
+               1, 300.0, 500.0),
+    "yaw": (6.0, lambda t: 400, lambda t: 0 if t < STEP_AT else 60, 400,
+            2, 0.0, 60.0),
+}
+
+# Nelder-Mead coefficients and the initial simplex's size in the unit box.
+NM_REFLECT, NM_EXPAND, NM_CONTRACT, NM_SHRINK = 1.0, 2.0, 0.5, 0.5
+NM_STEP = 0.1
+
+
+# ---------------------------------------------------------------------------
+# Gains
+# ---------------------------------------------------------------------------
+
+def to_gains(u):
+    """Gain set, rounded to three figures, for a point of the unit box."""
+    gains = []
+    for x, (_, lo, hi, scale) in zip(u, PARAMS):
+        x = min(max(x, 0.0), 1.0)
+        g = lo * (hi / lo) ** x if scale == "log" else lo + (hi - lo) * x
+        gains.append(float("%.3g" % g))
+    return tuple(gains)
+
+
+def to_unit(gains):
+    u = []
+    for g, (_, lo, hi, scale) in zip(gains, PARAMS):
+        if scale == "log":
+            x = math.log(max(g, lo) / lo) / math.log(hi / lo)
+        else:
+            x = (g - lo) / (hi - lo)
+        u.append(min(max(x, 0.0), 1.0))
+    return u
+
+
+def latin_hypercube(n, rng):
+    cols = []
+    for _ in PARAMS:
+        col = [(i + rng.random()) / n for i in range(n)]
+        rng.shuffle(col)
+        cols.append(col)
+    return [list(p) for p in zip(*cols)]
+
+
+def weight_lattice(divisions):
+    """Every weighting of the objectives in steps of 1 / divisions."""
+    n = len(OBJECTIVES)
+    out = []
+    for c in itertools.product(range(divisions + 1), repeat=n):
+        if sum(c) == divisions:
+            out.append([x / divisions for x in c])
+    return out
+
+
+# ---------------------------------------------------------------------------
+# Simulation (worker processes)
+# ---------------------------------------------------------------------------
+
+def worker_init(plant):
+    if plant:
+        load_plant(plant)
+
+
+def fly(job):
+    """Scores one gain set on one scenario; returns (job, scores, CPU s)."""
+    gains, name = job
+    cpu = time.process_time()
+    seconds, targ_h, targ_y, start_h, idx, start, final = SCENARIOS[name]
+    trace = run(SingleLoop(dict(zip(NAMES, gains))), seconds, targ_h, targ_y,
+                start_h=start_h)
+    rise, overshoot, settle = step_metrics(trace, idx, STEP_AT, start, final)
+    window = seconds - STEP_AT
+    moved = 0
+    for prev, cur in zip(trace, trace[1:]):
+        if cur[0] >= STEP_AT:
+            moved += abs(cur[3] - prev[3]) + abs(cur[4] - prev[4])
+    scores = (min(rise, window), overshoot, min(settle, window), moved / window)
+    return job, scores, time.process_time() - cpu
+
+
+class Archive:
+    """Every gain set flown, with its summed scores."""
+
+    def __init__(self, pool):
+        self.pool = pool
+        self.scores = {}
+        self.sims = 0
+        self.cpu = 0.0
+
+    def evaluate(self, sets):
+        new = list(dict.fromkeys(g for g in sets if g not in self.scores))
+        parts = {g: [0.0] * len(OBJECTIVES) for g in new}
+        jobs = [(g, name) for g in new for name in SCENARIOS]
+        for (gains, _), scores, cpu in self.pool.imap_unordered(fly, jobs, chunksize=1):
+            parts[gains] = [a + b for a, b in zip(parts[gains], scores)]
+            self.cpu += cpu
+        self.sims += len(jobs)
+        for g in new:
+            self.scores[g] = tuple(parts[g])
+        return [self.scores[g] for g in sets]
+
+
+# ---------------------------------------------------------------------------
+# Search
+# ---------------------------------------------------------------------------
+
+def nelder_mead(u0, cost, iterations):
+    """Nelder-Mead over the unit box as a generator: yields the points it
+    needs next and is sent their objective scores. cost() turns those into
+    the value minimised."""
+    n = len(u0)
+    simplex = [list(u0)]
+    for i in range(n):
+        p = list(u0)
+        p[i] = p[i] + NM_STEP if p[i] + NM_STEP <= 1.0 else p[i] - NM_STEP
+        simplex.append(p)
+    scores = yield simplex
+    values = [cost(s) for s in scores]
+
+    def point(c, towards, k):
+        return [min(max(a + k * (b - a), 0.0), 1.0) for a, b in zip(c, towards)]
+
+    for _ in range(iterations):
+        order = sorted(range(n + 1), key=lambda i: values[i])
+        simplex = [simplex[i] for i in order]
+        values = [values[i] for i in order]
+        centre = [sum(s[i] for s in simplex[:n]) / n for i in range(n)]
+        worst = simplex[n]
+
+        xr = point(centre, worst, -NM_REFLECT)
+        fr = cost((yield [xr])[0])
+        if fr < values[0]:
+            xe = point(centre, worst, -NM_EXPAND)
+            fe = cost((yield [xe])[0])
+            simplex[n], values[n] = (xe, fe) if fe < fr else (xr, fr)
+        elif fr < values[n - 1]:
+            simplex[n], values[n] = xr, fr
+        else:
+            inside = fr >= values[n]
+            xc = point(centre, worst if inside else xr, NM_CONTRACT)
+            fc = cost((yield [xc])[0])
+            if fc < min(fr, values[n]):
+                simplex[n], values[n] = xc, fc
+            else:
+                simplex[1:] = [point(simplex[0], s, NM_SHRINK) for s in simplex[1:]]
+                scores = yield simplex[1:]
+                values[1:] = [cost(s) for s in scores]
+
+
+def weighted(weights, norm):
+    return lambda s: sum(w * x / n for w, x, n in zip(weights, s, norm))
+
+
+def search(archive, weights, starts, norm, iterations):
+    """Runs one Nelder-Mead search per weighting, all in lockstep."""
+    live = []
+    for w in weights:
+        cost = weighted(w, norm)
+        best = min(starts, key=lambda g: cost(archive.scores[g]))
+        gen = nelder_mead(to_unit(best), cost, iterations)
+        live.append([gen, next(gen)])
+    rounds = 0
+    while live:
+        rounds += 1
+        want = [to_gains(u) for _, request in live for u in request]
+        archive.evaluate(want)
+        still = []
+        for gen, request in live:
+            scores = [archive.scores[to_gains(u)] for u in request]
+            try:
+                still.append([gen, gen.send(scores)])
+            except StopIteration:
+                pass
+        live = still
+    return rounds
+
+
+def pareto(scores):
+    """The gain sets no other set beats on every objective."""
+    items = sorted(scores.items(), key=lambda kv: kv[1])
+    front = []
+    for g, s in items:
+        if not any(all(a <= b for a, b in zip(f, s)) for _, f in front):
+            front.append((g, s))
+    return front
+
+
+# ---------------------------------------------------------------------------
+# Output
+# ---------------------------------------------------------------------------
+
+def row(gains, scores, mark=""):
+    return "%s %7.2f %6.1f%% %7.2f %8.1f  %s" % (
+        " ".join("%9.3g" % g for g in gains), scores[0], scores[1], scores[2],
+        scores[3], mark)
+
+
+def tune(args, jobs):
+    """Runs the whole search on a pool of jobs workers. Returns the archive,
+    the current gains and their scores, the normalisation, the number of
+    rounds and the wall time."""
+    rng = random.Random(args.seed)
+    baseline = tuple(SINGLE_LOOP[name] for name in NAMES)
+    weights = weight_lattice(args.divisions)
+    t0 = time.time()
+    with Pool(max(1, jobs), initializer=worker_init,
+              initargs=(args.plant,)) as pool:
+        archive = Archive(pool)
+        base = archive.evaluate([baseline])[0]
+        norm = [x if x > 0.0 else 1.0 for x in base]
+        starts = [to_gains(u) for u in latin_hypercube(args.samples, rng)]
+        archive.evaluate(starts)
+        rounds = search(archive, weights, starts + [baseline], norm,
+                        args.iterations)
+    return archive, baseline, base, norm, rounds, time.time() - t0
+
+
+def scaling(args):
+    """Runs the same search once per job count and prints how the wall time
+    scales against the first. The archives must match: the result may not
+    depend on the number of workers."""
+    counts = [int(j) for j in args.scaling.split(",")]
+    try:
+        cores = len(os.sched_getaffinity(0))
+    except AttributeError:
+        cores = os.cpu_count() or 1
+    print("%d cores available; speedup cannot pass min(jobs, cores)\n" % cores)
+    print("%4s %8s %8s %8s %8s %10s %6s" % ("jobs", "wall s", "sims/s", "speedup",
+                                           "ideal", "efficiency", "busy"))
+    first = None
+    for jobs in counts:
+        archive, _, _, _, _, wall = tune(args, jobs)
+        if first is None:
+            first = (wall, archive.scores)
+        elif archive.scores != first[1]:
+            print("jobs %d found different gain sets from jobs %d" % (jobs, counts[0]))
+            return 1
+        speedup = first[0] / wall
+        ideal = min(jobs, cores) / min(counts[0], cores)
+        print("%4d %8.1f %8.0f %8.2f %8.2f %9.0f%% %5.0f%%" % (
+            jobs, wall, archive.sims / wall, speedup, ideal,
+            100.0 * speedup / ideal, 100.0 * archive.cpu / (wall * jobs)))
+    return 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                    help="worker processes (default: one per core)")
+    ap.add_argument("--samples", type=int, default=96,
+                    help="Latin hypercube gain sets to start from (default: 96)")
+    ap.add_argument("--divisions", type=int, default=2,
+                    help="weight lattice steps; 2, 3, 4 give 10, 20, 35 searches")
+    ap.add_argument("--iterations", type=int, default=40,
+                    help="Nelder-Mead iterations per search (default: 40)")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--plant", metavar="JSON",
+                    help="plant parameters fitted by tools/sysid.py")
+    ap.add_argument("--show", type=int, default=20,
+                    help="Pareto-optimal sets to print (default: 20)")
+    ap.add_argument("-o", "--output", metavar="CSV",
+                    help="write the whole Pareto set")
+    ap.add_argument("--scaling", metavar="JOBS",
+                    help="time the search at each comma-separated job count, "
+                         "e.g. 1,2,4,8, instead of printing gains")
+    args = ap.parse_args()
+    if args.plant:
+        load_plant(args.plant)
+
+    if args.scaling:
+        return scaling(args)
+
+    archive, baseline, base, norm, rounds, wall = tune(args, args.jobs)
+    print("%d gain sets, %d simulations in %.1f s on %d jobs: %.0f sims/s, "
+          "workers %.0f%% busy, %d search rounds" % (
+              len(archive.scores), archive.sims, wall, args.jobs,
+              archive.sims / wall, 100.0 * archive.cpu / (wall * args.jobs),
+              rounds))
+
+    front = pareto(archive.scores)
+    balance = weighted([1.0] * len(OBJECTIVES), norm)
+    front.sort(key=lambda gs: balance(gs[1]))
+    balanced = front[0]
+    print()
+    print("%s %7s %7s %7s %8s" % (" ".join("%9s" % short for short in SHORT_NAMES),
+                                  *OBJECTIVES))
+    print(row(baseline, base, "current"))
+    for gains, scores in front[:args.show]:
+        marks = []
+        if gains == balanced[0]:
+            marks.append("balanced")
+        if all(a <= b for a, b in zip(scores, base)) and scores != base:
+            marks.append("beats current")
+        print(row(gains, scores, ", ".join(marks)))
+    print("\n%d Pareto-optimal sets of %d, best %d by the equal-weight sum shown\n" % (
+        len(front), len(archive.scores), min(args.show, len(front))))
+
+    print("// balanced: rise %.2f s, overshoot %.1f%%, settle %.2f s, effort %.0f %%/s" %
+          balanced[1])
+    for name, g in zip(NAMES, balanced[0]):
+        print("#define %s %.3g" % (name, g))
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(",".join(NAMES + OBJECTIVES) + "\n")
+            for gains, scores in front:
+                f.write(",".join("%.3g" % x for x in gains) + "," +
+                        ",".join("%.4f" % x for x in scores) + "\n")
+        print("wrote %s" % args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
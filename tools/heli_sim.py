@@ -0,0 +1,542 @@
+#!/usr/bin/env python3
+"""
+heli_sim.py
+
+Closed-loop simulation of the helicopter rig against the controllers in
+control_task.c, for comparing them before they are flown.
+
+The plant is a rough model of the rig: each rotor's thrust follows its duty
+through a first-order motor lag, height and yaw are driven by the main and
+tail rotors with viscous damping, the main rotor's torque couples into yaw,
+and the rig's end stops limit the height. Height is measured as ADC counts
+above the ground through a 5-sample mean and yaw to the encoder's
+resolution, both sampled at the control rate. The parameters are estimates;
+--plant replaces them with those tools/sysid.py fits to a logged flight.
+
+Each controller is a line-for-line port of its C code, including the
+integer truncation of the single loop and the fixed-point gain product of
+the LQR and explicit MPC (whose tables come from tools/lqr_gains.py and
+tools/empc_gen.py), and is run on:
+  - a height step and a yaw step: rise time, overshoot, settling time
+  - a climb and turn large enough to saturate both duties: height
+    overshoot and settling time
+  - a step disturbance (a weight hung on the rig, a gust on the tail):
+    peak deviation and recovery time
+  - the height step again: peak yaw swing from the main rotor's torque
+  - small sinusoidal setpoints: -3 dB closed-loop bandwidth
+
+    python3 tools/heli_sim.py
+    python3 tools/heli_sim.py --controller cascade --plot step.csv
+    python3 tools/heli_sim.py --plant rig.json
+
+Group 9
+"""
+
+import argparse
+import json
+import math
+import random
+
+# ---------------------------------------------------------------------------
+# Plant
+# ---------------------------------------------------------------------------
+
+DT = 0.002              # Control period in seconds (CONTROL_PERIOD_MS)
+SUBSTEPS = 4            # Plant integration steps per control period
+
+PLANT = {
+    "height_max": 1000.0,   # Counts between the end stops
+    "hover_duty": 47.0,     # Main duty that holds any height
+    "height_gain": 120.0,   # Counts/s^2 per % duty above hover
+    "height_damping": 4.0,  # 1/s
+    "motor_tau": 0.08,      # Rotor speed time constant, s
+    "tail_trim": 38.0,      # Tail duty that cancels the main rotor's torque
+    "yaw_gain": 20.0,       # deg/s^2 per % tail duty off trim
+    "yaw_damping": 6.0,     # 1/s
+    "yaw_coupling": 0.8,    # Tail % needed per main % of torque
+    "adc_noise": 2.0,       # Counts, uniform +/-
+    "yaw_step": 360.0 / 448,  # Encoder resolution in degrees
+}
+
+
+def load_plant(path):
+    """Overrides PLANT in place from a parameter file written by
+    tools/sysid.py, so every tool importing PLANT sees the fitted rig."""
+    with open(path) as f:
+        fitted = json.load(f)["plant"]
+    unknown = sorted(set(fitted) - set(PLANT))
+    if unknown:
+        raise ValueError("%s: unknown plant parameters %s" % (path, ", ".join(unknown)))
+    PLANT.update(fitted)
+
+
+class Plant:
+    def __init__(self, p=PLANT, seed=1):
+        self.p = p
+        self.rng = random.Random(seed)
+        self.h = 0.0
+        self.v = 0.0
+        self.yaw = 0.0
+        self.w = 0.0
+        self.main = 0.0         # Effective (lagged) duties
+        self.tail = 0.0
+        self.height_load = 0.0  # Disturbance accelerations
+        self.yaw_load = 0.0
+        self.window = []
+
+    def step(self, main_duty, tail_duty):
+        p = self.p
+        dt = DT / SUBSTEPS
+        for _ in range(SUBSTEPS):
+            self.main += (main_duty - self.main) * dt / p["motor_tau"]
+            self.tail += (tail_duty - self.tail) * dt / p["motor_tau"]
+
+            # No lift below hover when resting on the ground stop.
+            a = (p["height_gain"] * (self.main - p["hover_duty"])
+                 - p["height_damping"] * self.v + self.height_load)
+            self.v += a * dt
+            self.h += self.v * dt
+            if self.h <= 0.0:
+                self.h, self.v = 0.0, max(self.v, 0.0)
+            elif self.h >= p["height_max"]:
+                self.h, self.v = p["height_max"], min(self.v, 0.0)
+
+            torque = (self.tail - p["tail_trim"]
+                      - p["yaw_coupling"] * (self.main - p["hover_duty"]))
+            # More tail thrust turns the rig towards negative yaw.
+            alpha = -p["yaw_gain"] * torque - p["yaw_damping"] * self.w + self.yaw_load
+            if self.h <= 0.0:
+                alpha = -20.0 * self.w      # Skids hold it on the ground
+            self.w += alpha * dt
+            self.yaw += self.w * dt
+
+    def measure(self):
+        """Height in counts above ground, yaw in whole degrees -180..179."""
+        p = self.p
+        raw = self.h + self.rng.uniform(-p["adc_noise"], p["adc_noise"])
+        self.window = (self.window + [raw])[-5:]
+        height = max(0, int(round(sum(self.window) / len(self.window))))
+        yaw = round(self.yaw / p["yaw_step"]) * p["yaw_step"]
+        yaw = int(math.floor(yaw + 180.0)) % 360 - 180
+        return height, yaw
+
+
+# ---------------------------------------------------------------------------
+# Controllers, ported from control_task.c
+# ---------------------------------------------------------------------------
+
+def trunc(x):
+    return int(x)       # C float to int32_t conversion
+
+
+def clamp_pwm(x):
+    return min(max(x, 0), 99)
+
+
+def wrap_yaw(err):
+    if err >= 180:
+        err -= 360
+    elif err < -180:
+        err += 360
+    return err
+
+
+# The CONTROL_MODE_SINGLE_LOOP gains, under their #define names in
+# control_task.c so tools/gain_tune.py can write them back.
+SINGLE_LOOP = {
+    "PROPORTIONAL_GAIN": 0.1, "DERIVATIVE_GAIN": 0.0, "INTERGRAL_GAIN": 0.01e-3,
+    "PROPORTIONAL_GAIN_YAW": 1.0, "DERIVATIVE_GAIN_YAW": 0.0,
+    "INTERGRAL_GAIN_YAW": 0.2e-3,
+}
+
+
+class SingleLoop:
+    """CONTROL_MODE_SINGLE_LOOP. Each term is truncated on its own, as the
+    calc_*_gain() functions return int32_t."""
+    name = "single"
+
+    def __init__(self, g=SINGLE_LOOP):
+        self.g = g
+        self.h_last = 0
+        self.h_int = 0
+        self.y_last = 0
+        self.y_int = 0
+
+    def update(self, height, yaw, targ_h, targ_y, dt):
+        g = self.g
+        time_step = 1       # (ticks * TIME_PER_TICK) truncates to 1 at 2 ms
+        error = targ_h - height
+        pwm = 50
+        if targ_h == 0 and error < 10:
+            pwm = 0
+        pwm += trunc(g["PROPORTIONAL_GAIN"] * error)
+        pwm += trunc(g["DERIVATIVE_GAIN"] * trunc((self.h_last - error) / time_step))
+        self.h_last = error
+        if abs(error) < 20:
+            self.h_int = 0
+        self.h_int += error * time_step
+        pwm += trunc(g["INTERGRAL_GAIN"] * self.h_int)
+        main = clamp_pwm(pwm)
+
+        y_error = -wrap_yaw(targ_y - yaw)
+        ypwm = 40
+        if targ_h == 0 and error < 10:
+            ypwm = 0
+        ypwm += trunc(g["PROPORTIONAL_GAIN_YAW"] * y_error)
+        ypwm += trunc(g["DERIVATIVE_GAIN_YAW"] * trunc((self.y_last - y_error) / time_step))
+        self.y_last = y_error
+        if abs(y_error) < 2:
+            self.y_int = 0
+        self.y_int += y_error * time_step
+        ypwm += trunc(g["INTERGRAL_GAIN_YAW"] * self.y_int)
+        tail = min(clamp_pwm(ypwm), 85)
+        return main, tail
+
+
+class PiLoop:
+    """pi_loop_t / pi_update()."""
+
+    def __init__(self, kp, ki, out_min, out_max):
+        self.kp, self.ki = kp, ki
+        self.out_min, self.out_max = out_min, out_max
+        self.integral = 0.0
+
+    def update(self, error, dt):
+        out = self.kp * error + self.integral
+        if out > self.out_max:
+            out = self.out_max
+            if error < 0:
+                self.integral += self.ki * error * dt
+        elif out < self.out_min:
+            out = self.out_min
+            if error > 0:
+                self.integral += self.ki * error * dt
+        else:
+            self.integral += self.ki * error * dt
+        self.integral = min(max(self.integral, self.out_min), self.out_max)
+        return out
+
+
+class RateEstimate:
+    """rate_est_t / rate_update()."""
+
+    def __init__(self, alpha, wrap=False):
+        self.alpha = alpha
+        self.wrap = wrap
+        self.prev = None
+        self.rate = 0.0
+
+    def update(self, value, dt):
+        if self.prev is not None and dt > 0:
+            diff = value - self.prev
+            if self.wrap:
+                diff = wrap_yaw(diff)
+            self.rate += self.alpha * (diff / dt - self.rate)
+        self.prev = value
+        return self.rate
+
+
+# Cascade gains, as in control_task.c.
+CASCADE = {
+    "outer_divider": 5,
+    "rate_alpha": 0.25,
+    "h_pos_kp": 4.0, "h_pos_ki": 0.3, "h_rate_max": 600.0,
+    "h_rate_kp": 0.08, "h_rate_ki": 0.3,
+    "y_pos_kp": 6.0, "y_pos_ki": 0.0, "y_rate_max": 360.0,
+    "y_rate_kp": 0.6, "y_rate_ki": 0.5,
+    "main_ff": 50.0, "tail_ff": 40.0, "tail_max": 85.0,
+}
+
+
+class Cascade:
+    """CONTROL_MODE_CASCADE."""
+    name = "cascade"
+
+    def __init__(self, g=CASCADE):
+        self.g = g
+        self.h_pos = PiLoop(g["h_pos_kp"], g["h_pos_ki"], -g["h_rate_max"], g["h_rate_max"])
+        self.h_rate = PiLoop(g["h_rate_kp"], g["h_rate_ki"], -g["main_ff"], 99 - g["main_ff"])
+        self.y_pos = PiLoop(g["y_pos_kp"], g["y_pos_ki"], -g["y_rate_max"], g["y_rate_max"])
+        self.y_rate = PiLoop(g["y_rate_kp"], g["y_rate_ki"], -g["tail_ff"], g["tail_max"] - g["tail_ff"])
+        self.h_est = RateEstimate(g["rate_alpha"])
+        self.y_est = RateEstimate(g["rate_alpha"], wrap=True)
+        self.cycle = 0
+        self.outer_dt = 0.0
+        self.h_cmd = 0.0
+        self.y_cmd = 0.0
+
+    def update(self, height, yaw, targ_h, targ_y, dt):
+        g = self.g
+        v = self.h_est.update(height, dt)
+        w = self.y_est.update(yaw, dt)
+
+        self.outer_dt += dt
+        self.cycle += 1
+        if self.cycle >= g["outer_divider"]:
+            self.h_cmd = self.h_pos.update(targ_h - height, self.outer_dt)
+            self.y_cmd = self.y_pos.update(wrap_yaw(targ_y - yaw), self.outer_dt)
+            self.cycle = 0
+            self.outer_dt = 0.0
+
+        error = targ_h - height
+        if targ_h == 0 and error < 10:
+            self.h_pos.integral = self.h_rate.integral = 0.0
+            self.y_pos.integral = self.y_rate.integral = 0.0
+            return 0, 0
+
+        main = trunc(g["main_ff"] + self.h_rate.update(self.h_cmd - v, dt))
+        # Positive yaw error needs less tail thrust on this rig.
+        tail = trunc(g["tail_ff"] - self.y_rate.update(self.y_cmd - w, dt))
+        return clamp_pwm(main), min(clamp_pwm(tail), trunc(g["tail_max"]))
+
+
+def clamp16(x):
+    return min(max(int(x), -32768), 32767)
+
+
+class Lqr:
+    """CONTROL_MODE_LQR, with the fixed-point gain table of lqr_gains.c."""
+    name = "lqr"
+
+    def __init__(self, rows=None, rate_alpha=CASCADE["rate_alpha"]):
+        if rows is None:
+            import lqr_gains
+            rows = lqr_gains.table()
+        self.rows = rows
+        self.h_est = RateEstimate(rate_alpha)
+        self.y_est = RateEstimate(rate_alpha, wrap=True)
+        self.h_int = 0.0
+        self.y_int = 0.0
+        self.main_lag = 0.0
+        self.tail_lag = 0.0
+        self.main_sat = False
+        self.tail_sat = False
+        self.row = rows[0]
+
+    def trims(self, targ_h):
+        """Rotor time constant in ms and the lag states' origin."""
+        self.row = self.rows[0]
+        for r in self.rows:
+            if targ_h >= r[0]:
+                self.row = r
+        _, tau_ms, main, tail = self.row
+        return tau_ms, main[0] / 2 ** main[1], tail[0] / 2 ** tail[1]
+
+    def duties(self, x):
+        return [(trim - sum(a * b for a, b in zip(k, x))) >> shift
+                for trim, shift, k in self.row[2:]]
+
+    def update(self, height, yaw, targ_h, targ_y, dt):
+        v = self.h_est.update(height, dt)
+        w = self.y_est.update(yaw, dt)
+        tau_ms, main_trim, tail_trim = self.trims(targ_h)
+
+        h_err = height - targ_h
+        y_err = wrap_yaw(yaw - targ_y)
+        if targ_h == 0 and -h_err < 10:
+            self.h_int = self.y_int = 0.0
+            self.main_lag = self.tail_lag = 0.0
+            return 0, 0
+
+        # Integrate only while the duty is free to act on the error.
+        if not self.main_sat:
+            self.h_int = min(max(self.h_int + h_err * dt, -2047.0), 2047.0)
+        if not self.tail_sat:
+            self.y_int = min(max(self.y_int + y_err * dt, -2047.0), 2047.0)
+
+        x = [clamp16(h_err), clamp16(v), clamp16(y_err), clamp16(w),
+             clamp16(self.h_int * 16), clamp16(self.y_int * 16),
+             clamp16((self.main_lag - main_trim) * 16),
+             clamp16((self.tail_lag - tail_trim) * 16)]
+        duty = self.duties(x)
+        main = clamp_pwm(duty[0])
+        tail = min(clamp_pwm(duty[1]), trunc(CASCADE["tail_max"]))
+        # At a limit, whether clamped to it here or put there by the law.
+        self.main_sat = duty[0] <= 0 or duty[0] >= 99
+        self.tail_sat = duty[1] <= 0 or duty[1] >= trunc(CASCADE["tail_max"])
+
+        # The rotors' response to the duties, for the lag states.
+        self.main_lag += (main - self.main_lag) * dt * 1000 / tau_ms
+        self.tail_lag += (tail - self.tail_lag) * dt * 1000 / tau_ms
+        return main, tail
+
+
+class Empc(Lqr):
+    """CONTROL_MODE_EMPC, with the region table of empc_regions.c."""
+    name = "empc"
+    table = None
+
+    def __init__(self):
+        import empc_gen
+        if Empc.table is None:
+            p, found = empc_gen.regions()
+            Empc.table = (p, empc_gen.quantised(p, found))
+        Lqr.__init__(self, rows=[None])
+        self.empc = empc_gen
+
+    def trims(self, targ_h):
+        p = self.table[0]
+        return p["motor_tau"] * 1000, p["hover_duty"], p["tail_trim"]
+
+    def duties(self, x):
+        return self.empc.evaluate(self.table[1], x)
+
+
+CONTROLLERS = {"single": SingleLoop, "cascade": Cascade, "lqr": Lqr,
+               "empc": Empc}
+
+
+# ---------------------------------------------------------------------------
+# Scenarios
+# ---------------------------------------------------------------------------
+
+def run(ctrl, seconds, targ_h, targ_y, disturb=None, start_h=None, log=None):
+    plant = Plant()
+    if start_h is not None:
+        plant.h = start_h
+        plant.main = plant.p["hover_duty"]
+        plant.tail = plant.p["tail_trim"]
+    trace = []
+    for n in range(int(seconds / DT)):
+        t = n * DT
+        if disturb:
+            disturb(plant, t)
+        height, yaw = plant.measure()
+        main, tail = ctrl.update(height, yaw, targ_h(t), targ_y(t), DT)
+        plant.step(main, tail)
+        trace.append((t, plant.h, plant.yaw, main, tail))
+        if log:
+            log.write("%.3f,%.2f,%.2f,%d,%d,%d,%d\n" %
+                      (t, plant.h, plant.yaw, main, tail, targ_h(t), targ_y(t)))
+    return trace
+
+
+def step_metrics(trace, idx, t0, start, final):
+    span = final - start
+    ts = [r[0] for r in trace if r[0] >= t0]
+    ys = [(r[idx] - start) / span for r in trace if r[0] >= t0]
+    t10 = next((t for t, y in zip(ts, ys) if y >= 0.1), None)
+    t90 = next((t for t, y in zip(ts, ys) if y >= 0.9), None)
+    rise = (t90 - t10) if t10 is not None and t90 is not None else float("inf")
+    overshoot = max(0.0, (max(ys) - 1.0) * 100.0)
+    settle = float("inf")
+    for i in range(len(ys) - 1, -1, -1):
+        if abs(ys[i] - 1.0) > 0.05:
+            settle = ts[i + 1] - t0 if i + 1 < len(ts) else float("inf")
+            break
+    else:
+        settle = 0.0
+    return rise, overshoot, settle
+
+
+def disturbance_metrics(trace, idx, t0, ref, tol):
+    after = [r for r in trace if r[0] >= t0]
+    dev = [abs(r[idx] - ref) for r in after]
+    peak = max(dev)
+    recover = float("inf")
+    for i in range(len(dev) - 1, -1, -1):
+        if dev[i] > tol:
+            recover = after[i + 1][0] - t0 if i + 1 < len(after) else float("inf")
+            break
+    else:
+        recover = 0.0
+    return peak, recover
+
+
+def bandwidth(make, idx, base_h, amp, freqs):
+    """Lowest frequency where the closed-loop amplitude falls below -3 dB."""
+    for f in freqs:
+        ctrl = make()
+        cycles = max(3, int(f * 4))
+        settle = 3.0
+        seconds = settle + cycles / f
+        if idx == 1:
+            targ_h = lambda t: int(base_h + amp * math.sin(2 * math.pi * f * t)) if t >= 0 else 0
+            targ_y = lambda t: 0
+        else:
+            targ_h = lambda t: int(base_h)
+            targ_y = lambda t: int(round(amp * math.sin(2 * math.pi * f * t)))
+        trace = run(ctrl, seconds, targ_h, targ_y, start_h=base_h)
+        ys = [r[idx] for r in trace if r[0] >= settle]
+        gain = (max(ys) - min(ys)) / (2 * amp)
+        if gain < 1 / math.sqrt(2):
+            return f
+    return float("inf")
+
+
+def evaluate(name):
+    make = CONTROLLERS[name]
+    res = {}
+
+    # Height step from hover at 300 to 500.
+    tr = run(make(), 6.0, lambda t: 300 if t < 1.0 else 500, lambda t: 0, start_h=300)
+    res["height_step"] = step_metrics(tr, 1, 1.0, 300.0, 500.0)
+    # The main rotor's torque swings the yaw during the climb.
+    res["coupling"] = max(abs(r[2]) for r in tr if r[0] >= 1.0)
+
+    # A climb and turn big enough to hold both duties at their limits.
+    tr = run(make(), 8.0, lambda t: 100 if t < 1.0 else 850,
+             lambda t: 0 if t < 1.0 else 170, start_h=100)
+    res["limit_step"] = step_metrics(tr, 1, 1.0, 100.0, 850.0)
+
+    # Yaw step of 60 degrees at hover.
+    tr = run(make(), 6.0, lambda t: 400, lambda t: 0 if t < 1.0 else 60, start_h=400)
+    res["yaw_step"] = step_metrics(tr, 2, 1.0, 0.0, 60.0)
+
+    # A weight hung on the rig, then a gust on the tail, at hover.
+    def load(plant, t):
+        plant.height_load = -250.0 if t >= 2.0 else 0.0
+        plant.yaw_load = 150.0 if 5.0 <= t < 5.5 else 0.0
+    tr = run(make(), 9.0, lambda t: 400, lambda t: 0, disturb=load, start_h=400)
+    res["height_load"] = disturbance_metrics([r for r in tr if r[0] < 5.0], 1, 2.0, 400.0, 10.0)
+    res["yaw_gust"] = disturbance_metrics(tr, 2, 5.0, 0.0, 3.0)
+
+    freqs = [0.1, 0.15, 0.2, 0.3, 0.5, 0.7, 1.0, 1.5, 2.0, 3.0, 5.0]
+    res["height_bw"] = bandwidth(make, 1, 400, 40, freqs)
+    res["yaw_bw"] = bandwidth(make, 2, 400, 10, freqs)
+    return res
+
+
+def fmt(x, unit):
+    return "   inf" if x == float("inf") else "%6.2f%s" % (x, unit)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("--controller", choices=sorted(CONTROLLERS), action="append",
+                    help="controller(s) to evaluate (default: all)")
+    ap.add_argument("--plot", metavar="CSV",
+                    help="write the height step trace of the first controller")
+    ap.add_argument("--plant", metavar="JSON",
+                    help="plant parameters fitted by tools/sysid.py")
+    args = ap.parse_args()
+    if args.plant:
+        load_plant(args.plant)
+    names = args.controller or list(CONTROLLERS)
+
+    if args.plot:
+        with open(args.plot, "w") as f:
+            f.write("t,height,yaw,main,tail,targ_height,targ_yaw\n")
+            run(CONTROLLERS[names[0]](), 6.0, lambda t: 300 if t < 1.0 else 500,
+                lambda t: 0, start_h=300, log=f)
+
+    print("%-10s %28s %28s %17s %22s %22s %9s %9s %9s" % (
+        "", "height step rise/os/settle", "yaw step rise/os/settle",
+        "at limits os/settle", "load peak/recover", "gust peak/recover",
+        "yaw swing", "h bw Hz", "y bw Hz"))
+    for name in names:
+        r = evaluate(name)
+        hs, ys = r["height_step"], r["yaw_step"]
+        print("%-10s %s %s %s  %s %s %s  %s %s  %s %s  %s %s   %s %9s %9s" % (
+            name,
+            fmt(hs[0], "s"), fmt(hs[1], "%"), fmt(hs[2], "s"),
+            fmt(ys[0], "s"), fmt(ys[1], "%"), fmt(ys[2], "s"),
+            fmt(r["limit_step"][1], "%"), fmt(r["limit_step"][2], "s"),
+            fmt(r["height_load"][0], " "), fmt(r["height_load"][1], "s"),
+            fmt(r["yaw_gust"][0], " "), fmt(r["yaw_gust"][1], "s"),
+            fmt(r["coupling"], " "),
+            fmt(r["height_bw"], ""), fmt(r["yaw_bw"], "")))
+
+
+if __name__ == "__main__":
+    main()
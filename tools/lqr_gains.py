@@ -0,0 +1,355 @@
+#!/usr/bin/env python3
+"""
+lqr_gains.py
+
+Computes the LQR state-feedback gains for CONTROL_MODE_LQR and writes them
+as the table in lqr_gains.c.
+
+The rig is linearised about hover at each operating point in
+OPERATING_POINTS, using the plant parameters of tools/heli_sim.py, or those fitted to a
+logged flight by tools/sysid.py with --plant, unless the point overrides
+them.
+The state is
+
+    x = [height error, vertical speed, yaw error, yaw rate,
+         integral of height error, integral of yaw error,
+         main rotor lag, tail rotor lag]
+
+and the inputs the main and tail duties about their trims. The two integral
+states make the loop reject a steady load without a separate integral
+term, and the two rotor lag states are modelled by the controller from its
+own outputs, so nothing here needs measuring beyond height and yaw. The
+main rotor's torque on the yaw axis is in the model, so each duty is
+computed from all of the states instead of from its own axis alone.
+
+The continuous model is discretised at the control period and the discrete
+Riccati equation solved by structured doubling, so only the standard
+library is needed. Each gain row is then scaled to int16 for
+DspMatVec() with the largest shift that cannot overflow its 32-bit sum.
+
+    python3 tools/lqr_gains.py                  # print the gains
+    python3 tools/lqr_gains.py -o lqr_gains.c   # regenerate the table
+    python3 tools/lqr_gains.py --plant rig.json -o lqr_gains.c
+
+Group 9
+"""
+
+import argparse
+import math
+
+from heli_sim import DT, PLANT, load_plant
+
+# Units of each state as it is fed to DspMatVec(): counts, counts/s, degrees,
+# deg/s, then count.s, deg.s and % duty for the rotor lags all in Q4. Keep in
+# step with LQR_STATE_Q in lqr_gains.h.
+STATE_NAMES = ["height", "speed", "yaw", "yaw_rate",
+               "height_int", "yaw_int", "main_lag", "tail_lag"]
+STATE_SCALE = [1.0, 1.0, 1.0, 1.0, 16.0, 16.0, 16.0, 16.0]
+
+# Bryson's rule: each weight is one over the square of the largest deviation
+# that is acceptable for that state or input.
+WEIGHTS = {
+    "height": 15.0, "speed": 150.0, "yaw": 3.0, "yaw_rate": 60.0,
+    "height_int": 25.0, "yaw_int": 4.0, "main_lag": 1e3, "tail_lag": 1e3,
+    "main": 20.0, "tail": 20.0,
+}
+
+# Gains are scheduled on the target height: each row is used from its
+# height up to the next. Near the ground the weights are relaxed so take
+# off is gentle. "model" overrides entries of heli_sim.PLANT for the point.
+# The model does not change with height, so a point needs its own weights
+# or model to be worth a row; table() refuses one that repeats the last.
+OPERATING_POINTS = [
+    {"height": 0, "weights": {"height": 30.0, "main": 30.0}, "model": {}},
+    {"height": 250, "weights": {}, "model": {}},
+]
+
+
+# ---------------------------------------------------------------------------
+# Small dense matrix helpers
+# ---------------------------------------------------------------------------
+
+def zeros(n, m):
+    return [[0.0] * m for _ in range(n)]
+
+
+def eye(n):
+    return [[1.0 if i == j else 0.0 for j in range(n)] for i in range(n)]
+
+
+def mul(a, b):
+    bt = list(zip(*b))
+    return [[sum(x * y for x, y in zip(row, col)) for col in bt] for row in a]
+
+
+def add(a, b):
+    return [[x + y for x, y in zip(ra, rb)] for ra, rb in zip(a, b)]
+
+
+def scale(a, k):
+    return [[x * k for x in row] for row in a]
+
+
+def tr(a):
+    return [list(r) for r in zip(*a)]
+
+
+def inv(a):
+    """Gauss-Jordan with partial pivoting."""
+    n = len(a)
+    m = [list(row) + e for row, e in zip(a, eye(n))]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        if abs(m[p][c]) < 1e-300:
+            raise ValueError("singular matrix")
+        m[c], m[p] = m[p], m[c]
+        pivot = m[c][c]
+        m[c] = [x / pivot for x in m[c]]
+        for r in range(n):
+            if r != c and m[r][c] != 0.0:
+                f = m[r][c]
+                m[r] = [x - f * y for x, y in zip(m[r], m[c])]
+    return [row[n:] for row in m]
+
+
+def expm(a):
+    """Scaling and squaring with a Taylor series."""
+    norm = max(sum(abs(x) for x in row) for row in a)
+    s = max(0, int(math.ceil(math.log2(norm))) + 1) if norm > 0 else 0
+    a = scale(a, 1.0 / 2 ** s)
+    result = eye(len(a))
+    term = eye(len(a))
+    for k in range(1, 20):
+        term = scale(mul(term, a), 1.0 / k)
+        result = add(result, term)
+    for _ in range(s):
+        result = mul(result, result)
+    return result
+
+
+# ---------------------------------------------------------------------------
+# Model and design
+# ---------------------------------------------------------------------------
+
+def linear_model(p):
+    """Continuous (A, B) about hover for the state and inputs above."""
+    hg, hd = p["height_gain"], p["height_damping"]
+    yg, yd = p["yaw_gain"], p["yaw_damping"]
+    c, tau = p["yaw_coupling"], p["motor_tau"]
+    a = zeros(8, 8)
+    b = zeros(8, 2)
+    a[0][1] = 1.0                       # d height / dt = speed
+    a[1][1] = -hd
+    a[1][6] = hg                        # lagged main duty lifts
+    a[2][3] = 1.0
+    a[3][3] = -yd
+    a[3][7] = -yg                       # more tail turns towards -yaw
+    a[3][6] = yg * c                    # main rotor torque turns towards +yaw
+    a[4][0] = 1.0
+    a[5][2] = 1.0
+    a[6][6] = -1.0 / tau
+    a[7][7] = -1.0 / tau
+    b[6][0] = 1.0 / tau
+    b[7][1] = 1.0 / tau
+    return a, b
+
+
+def discretise(a, b, dt):
+    """Zero-order hold, from the exponential of the augmented matrix."""
+    n, m = len(a), len(b[0])
+    big = zeros(n + m, n + m)
+    for i in range(n):
+        for j in range(n):
+            big[i][j] = a[i][j] * dt
+        for j in range(m):
+            big[i][n + j] = b[i][j] * dt
+    e = expm(big)
+    return [row[:n] for row in e[:n]], [row[n:] for row in e[:n]]
+
+
+def dare(a, b, q, r):
+    """Stabilising solution of the discrete Riccati equation (SDA)."""
+    n = len(a)
+    g = mul(mul(b, inv(r)), tr(b))
+    h = q
+    for _ in range(100):
+        w = inv(add(eye(n), mul(g, h)))
+        aw = mul(a, w)
+        a_next = mul(aw, a)
+        g_next = add(g, mul(mul(aw, g), tr(a)))
+        h_next = add(h, mul(mul(tr(a), h), mul(w, a)))
+        done = max(abs(x - y) for rx, ry in zip(h_next, h) for x, y in zip(rx, ry))
+        a, g, h = a_next, g_next, h_next
+        if done < 1e-9 * max(1.0, max(abs(x) for row in h for x in row)):
+            break
+    return h
+
+
+def lqr(ad, bd, q, r):
+    p = dare(ad, bd, q, r)
+    btp = mul(tr(bd), p)
+    return mul(inv(add(r, mul(btp, bd))), mul(btp, ad))
+
+
+def cost(point):
+    """State and input weight matrices for an operating point."""
+    w = dict(WEIGHTS)
+    w.update(point["weights"])
+    q = zeros(8, 8)
+    for i, name in enumerate(STATE_NAMES):
+        q[i][i] = 1.0 / w[name] ** 2
+    r = [[1.0 / w["main"] ** 2, 0.0], [0.0, 1.0 / w["tail"] ** 2]]
+    return q, r
+
+
+def plant(point):
+    p = dict(PLANT)
+    p.update(point["model"])
+    return p
+
+
+def design(point):
+    p = plant(point)
+    a, b = linear_model(p)
+    ad, bd = discretise(a, b, DT)
+    q, r = cost(point)
+    k = lqr(ad, bd, q, r)
+    return p, k, add(ad, scale(mul(bd, k), -1.0))
+
+
+def quantise(row, trim):
+    """(trim, shift, gains) for one duty: the gains in int16 for the scaled
+    states and the trim in the same Q format, so the duty is
+    (trim - gains . x) >> shift."""
+    g = [x / s for x, s in zip(row, STATE_SCALE)]
+    shift = 15
+    while shift > 0:
+        q = [int(round(x * 2 ** shift)) for x in g]
+        # Every state at the int16 limit, plus room for the trim.
+        worst = sum(abs(x) for x in q) * 32768
+        if max(abs(x) for x in q) <= 32767 and worst < 2 ** 31 - 2 ** 24:
+            break
+        shift -= 1
+    return int(round(trim * 2 ** shift)), shift, q
+
+
+def table():
+    """Rows of (height, rotor time constant in ms, main, tail), as in
+    lqrGain_t, each duty being a quantise() tuple."""
+    rows = []
+    for point in OPERATING_POINTS:
+        p, k, _ = design(point)
+        rows.append((point["height"], int(round(p["motor_tau"] * 1000)),
+                     quantise(k[0], p["hover_duty"]),
+                     quantise(k[1], p["tail_trim"])))
+        if len(rows) > 1 and rows[-1][1:] == rows[-2][1:]:
+            raise ValueError("operating point %d has the same gains as %d"
+                             % (rows[-1][0], rows[-2][0]))
+    return rows
+
+
+def spectral_radius(a, iters=200):
+    """Largest closed-loop pole magnitude, by power iteration on a^64."""
+    n = len(a)
+    v = [[1.0] for _ in range(n)]
+    m = a
+    for _ in range(6):
+        m = mul(m, m)           # a^64
+    for _ in range(iters):
+        v = mul(m, v)
+        norm = math.sqrt(sum(x[0] ** 2 for x in v))
+        if norm == 0:
+            return 0.0
+        v = [[x[0] / norm] for x in v]
+    return norm ** (1.0 / 64)
+
+
+# ---------------------------------------------------------------------------
+# Output
+# ---------------------------------------------------------------------------
+
+C_HEADER = """\
+/******************************************************************************
+ *
+ * lqr_gains.c
+ *
+ * Purpose:
+ * LQR gain table for CONTROL_MODE_LQR, one row per operating point. See
+ * lqr_gains.h.
+ *
+ * Generated by tools/lqr_gains.py from the model and weights there. Edit
+ * those and regenerate rather than editing this file.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include "config.h"          // CONTROL_PERIOD_MS
+#include "lqr_gains.h"       // LQR gain table
+#include "dsp_filter.h"      // DSP_MAT_PAIR
+
+#if CONTROL_PERIOD_MS != %d
+#error "lqr_gains.c was generated for another CONTROL_PERIOD_MS"
+#endif
+
+#if LQR_OPERATING_POINTS != %d
+#error "LQR_OPERATING_POINTS in lqr_gains.h does not match this table"
+#endif
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+const lqrGain_t g_psLqrGains[LQR_OPERATING_POINTS] =
+{
+"""
+
+
+def write_c(path, rows):
+    out = [C_HEADER % (int(round(DT * 1000)), len(rows))]
+    for n, (height, tau_ms, main, tail) in enumerate(rows):
+        out.append("    {\n        %d, %d,\n" % (height, tau_ms))
+        out.append("        { %d, %d },\n" % (main[0], tail[0]))
+        out.append("        { %d, %d },\n" % (main[1], tail[1]))
+        out.append("        {\n")
+        lines = []
+        for axis, (_, _, g) in (("main", main), ("tail", tail)):
+            pairs = ["DSP_MAT_PAIR(%d, %d)" % (g[i], g[i + 1])
+                     for i in range(0, len(g), 2)]
+            lines.append((", ".join(pairs[:2]), ""))
+            lines.append((", ".join(pairs[2:]), "   // " + axis))
+        for i, (text, comment) in enumerate(lines):
+            out.append("            %s%s%s\n" %
+                       (text, "," if i < len(lines) - 1 else "", comment))
+        out.append("        }\n    }%s\n" % ("," if n < len(rows) - 1 else ""))
+    out.append("};\n")
+    with open(path, "w") as f:
+        f.write("".join(out))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("-o", "--output", metavar="C_FILE",
+                    help="write the gain table, e.g. lqr_gains.c")
+    ap.add_argument("--plant", metavar="JSON",
+                    help="plant parameters fitted by tools/sysid.py")
+    args = ap.parse_args()
+    if args.plant:
+        load_plant(args.plant)
+
+    for point in OPERATING_POINTS:
+        _, k, acl = design(point)
+        print("operating point %d counts, closed-loop spectral radius %.5f" %
+              (point["height"], spectral_radius(acl)))
+        print("  %-6s %s" % ("", " ".join("%10s" % n for n in STATE_NAMES)))
+        for axis, row in zip(("main", "tail"), k):
+            print("  %-6s %s" % (axis, " ".join("%10.4g" % x for x in row)))
+
+    if args.output:
+        write_c(args.output, table())
+        print("wrote %s" % args.output)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+"""
+plant_id_check.py
+
+Checks the online plant identification of plant_id.c against simulated rigs
+whose parameters are known, before it is trusted on a real one.
+
+PlantId below is a line-for-line port of plant_id.c: the same three-pole
+state-variable filters, duty delay, settling and airborne gating, and the
+same recursive least squares with bounded forgetting, updating one axis
+every PLANT_ID_DIVIDER cycles. It runs in double precision where the target
+uses float; the scaling in plant_id.c keeps the difference well below the
+tolerances here.
+
+Each rig in RIGS overrides some of tools/heli_sim.py's plant parameters. It
+is flown from the ground by one of heli_sim's controllers through a random
+sequence of height and yaw targets, as in normal flight, with the duties
+and readings fed to PlantId each cycle exactly as the control task does.
+The fitted hover duty, tail trim, coupling and rotor lag are compared with
+the rig's, along with how long each took to settle within its tolerance.
+The exit status is non-zero if any is out of tolerance at the end.
+
+    python3 tools/plant_id_check.py
+    python3 tools/plant_id_check.py --controller lqr --seconds 300
+    python3 tools/plant_id_check.py --rig slow --trace fit.csv
+
+Group 9
+"""
+
+import argparse
+import math
+import random
+import sys
+
+from heli_sim import CONTROLLERS, DT, PLANT, Plant, wrap_yaw
+
+# ---------------------------------------------------------------------------
+# plant_id.h / plant_id.c constants
+# ---------------------------------------------------------------------------
+
+PLANT_ID_DIVIDER = 10
+PLANT_ID_FILTER_RATE = 3.0
+PLANT_ID_FORGETTING = 0.998
+PLANT_ID_INITIAL_P = 1000.0
+PLANT_ID_TRACE_MAX = 10000.0
+PLANT_ID_SETTLE_MS = 5000
+PLANT_ID_SETTLE_CYCLES = round(PLANT_ID_SETTLE_MS * 1e-3 / DT)
+PLANT_ID_INPUT_DELAY = 3
+
+PLANT_ID_RATE_SCALE = 0.01
+PLANT_ID_DUTY_SCALE = 0.1
+PLANT_ID_MAIN_CENTRE = 50
+PLANT_ID_TAIL_CENTRE = 40
+PLANT_ID_RESIDUAL_ALPHA = 0.005
+
+A1, A0, BM, C, BT = range(5)
+HEIGHT, YAW = 0, 1
+
+# control_task.c
+AIRBORNE_ENTER_HEIGHT = 20
+AIRBORNE_EXIT_HEIGHT = 10
+
+# Simulated rigs: overrides of heli_sim.PLANT.
+RIGS = {
+    "nominal": {},
+    "heavy": {"hover_duty": 52.0, "tail_trim": 44.0, "yaw_coupling": 1.0,
+              "motor_tau": 0.05},
+    "light": {"hover_duty": 42.0, "tail_trim": 33.0, "yaw_coupling": 0.6,
+              "motor_tau": 0.12},
+    "slow": {"hover_duty": 45.0, "tail_trim": 36.0, "yaw_coupling": 0.7,
+             "motor_tau": 0.10, "height_damping": 3.0},
+}
+
+# Largest acceptable error in each fitted figure: absolute for the duties,
+# relative for the rest.
+TOLERANCE = {
+    "hover_duty": (0.5, "%"),
+    "tail_trim": (0.5, "%"),
+    "yaw_coupling": (0.05, "rel"),
+    "motor_tau": (0.10, "rel"),
+}
+
+
+# ---------------------------------------------------------------------------
+# Port of plant_id.c
+# ---------------------------------------------------------------------------
+
+def physical(h, y):
+    """heli_sim.PLANT figures from the unscaled height and yaw parameters,
+    as PlantIdGet() derives them."""
+    est = {"hover_duty": 0.0, "tail_trim": 0.0, "yaw_coupling": 0.0,
+           "motor_tau": 0.0, "height_gain": 0.0, "height_damping": 0.0,
+           "yaw_gain": 0.0, "yaw_damping": 0.0}
+    if h[BM] != 0.0:
+        est["hover_duty"] = PLANT_ID_MAIN_CENTRE - h[C] / h[BM]
+    if y[BT] != 0.0:
+        est["yaw_coupling"] = -y[BM] / y[BT]
+        est["tail_trim"] = PLANT_ID_TAIL_CENTRE - (
+            y[C] + y[BM] * (est["hover_duty"] - PLANT_ID_MAIN_CENTRE)) / y[BT]
+    root = h[A1] * h[A1] + 4.0 * h[A0]
+    if root > 0.0:
+        root = math.sqrt(root)
+        fast, slow = 0.5 * (root - h[A1]), 0.5 * (-root - h[A1])
+        if slow > 0.0:
+            est["motor_tau"] = 1.0 / fast
+            est["height_damping"] = slow
+            est["height_gain"] = h[BM] / fast
+            est["yaw_damping"] = -y[A0] / fast
+            est["yaw_gain"] = -y[BT] / fast
+    return est
+
+
+class Rls:
+    """plantIdRls_t, PlantIdRlsReset() and PlantIdRlsUpdate()."""
+
+    def __init__(self, n):
+        self.n = n
+        self.theta = [0.0] * n
+        self.p = [[PLANT_ID_INITIAL_P if i == j else 0.0 for j in range(n)]
+                  for i in range(n)]
+        self.error_sq = 0.0
+        self.output_sq = 0.0
+        self.updates = 0
+
+    def update(self, phi, output):
+        n, p = self.n, self.p
+        pphi = [sum(p[i][j] * phi[j] for j in range(n)) for i in range(n)]
+        denom = PLANT_ID_FORGETTING + sum(phi[i] * pphi[i] for i in range(n))
+        error = output - sum(t * x for t, x in zip(self.theta, phi))
+        gain = [x / denom for x in pphi]
+        self.theta = [t + g * error for t, g in zip(self.theta, gain)]
+        trace = sum(p[i][i] - gain[i] * pphi[i] for i in range(n))
+        scale = 1.0 / PLANT_ID_FORGETTING if trace < PLANT_ID_TRACE_MAX else 1.0
+        for i in range(n):
+            for j in range(i, n):
+                p[i][j] = (p[i][j] - gain[i] * pphi[j]) * scale
+                p[j][i] = p[i][j]
+        self.error_sq += PLANT_ID_RESIDUAL_ALPHA * (error * error - self.error_sq)
+        self.output_sq += PLANT_ID_RESIDUAL_ALPHA * (output * output - self.output_sq)
+        self.updates += 1
+
+
+def filter_step(f, x, gain):
+    f[0] += gain * (x - f[0])
+    f[1] += gain * (f[0] - f[1])
+    f[2] += gain * (f[1] - f[2])
+
+
+def filter_derivatives(f, x):
+    r = PLANT_ID_FILTER_RATE
+    d1a, d1b, d1c = r * (x - f[0]), r * (f[0] - f[1]), r * (f[1] - f[2])
+    d2b, d2c = r * (d1a - d1b), r * (d1b - d1c)
+    return f[2], d1c, d2c, r * (d2b - d2c)
+
+
+class PlantId:
+    """The module's state and PlantIdUpdate() / PlantIdGet()."""
+
+    def __init__(self):
+        self.rls = [Rls(4), Rls(5)]
+        self.started = False
+
+    def prime(self, height, yaw, main, tail):
+        self.yaw = float(yaw)
+        self.last_yaw = yaw
+        self.filters = [[float(height)] * 3, [self.yaw] * 3,
+                        [float(main)] * 3, [float(tail)] * 3]
+        self.main = [main] * PLANT_ID_INPUT_DELAY
+        self.tail = [tail] * PLANT_ID_INPUT_DELAY
+        self.index = 0
+        self.settle = PLANT_ID_SETTLE_CYCLES
+
+    def update(self, height, yaw, main, tail, dt, airborne):
+        if not self.started:
+            self.cycle = 0
+            self.prime(height, yaw, main, tail)
+            self.started = True
+        if not airborne:
+            self.prime(height, yaw, main, tail)
+            return
+        gain = min(PLANT_ID_FILTER_RATE * dt, 1.0)
+
+        self.last_yaw, diff = yaw, wrap_yaw(yaw - self.last_yaw)
+        self.yaw += diff
+        if self.yaw >= 180.0 or self.yaw < -180.0:
+            shift = -360.0 if self.yaw >= 180.0 else 360.0
+            self.yaw += shift
+            self.filters[YAW] = [x + shift for x in self.filters[YAW]]
+
+        m, t = self.main[self.index], self.tail[self.index]
+        self.main[self.index], self.tail[self.index] = main, tail
+        self.index = (self.index + 1) % PLANT_ID_INPUT_DELAY
+
+        for f, x in zip(self.filters, (height, self.yaw, m, t)):
+            filter_step(f, float(x), gain)
+
+        if self.settle > 0:
+            self.settle -= 1
+            return
+
+        self.cycle = (self.cycle + 1) % PLANT_ID_DIVIDER
+        main_phi = PLANT_ID_DUTY_SCALE * (self.filters[2][2] - PLANT_ID_MAIN_CENTRE)
+        if self.cycle == 0:
+            _, d1, d2, d3 = filter_derivatives(self.filters[HEIGHT], height)
+            self.rls[HEIGHT].update(
+                [PLANT_ID_RATE_SCALE * d2, PLANT_ID_RATE_SCALE * d1, main_phi, 1.0],
+                PLANT_ID_RATE_SCALE * d3)
+        elif self.cycle == PLANT_ID_DIVIDER // 2:
+            _, d1, d2, d3 = filter_derivatives(self.filters[YAW], self.yaw)
+            tail_phi = PLANT_ID_DUTY_SCALE * (self.filters[3][2] - PLANT_ID_TAIL_CENTRE)
+            self.rls[YAW].update(
+                [PLANT_ID_RATE_SCALE * d2, PLANT_ID_RATE_SCALE * d1, main_phi, 1.0,
+                 tail_phi],
+                PLANT_ID_RATE_SCALE * d3)
+
+    def get(self):
+        """The estimate as a dict of heli_sim.PLANT names, plus the fit."""
+        unscale = [1.0, 1.0, PLANT_ID_DUTY_SCALE / PLANT_ID_RATE_SCALE,
+                   1.0 / PLANT_ID_RATE_SCALE, PLANT_ID_DUTY_SCALE / PLANT_ID_RATE_SCALE]
+        est = physical([x * u for x, u in zip(self.rls[HEIGHT].theta, unscale)],
+                       [x * u for x, u in zip(self.rls[YAW].theta, unscale)])
+        fit = []
+        for r in self.rls:
+            residual = (math.sqrt(r.error_sq / r.output_sq)
+                        if r.output_sq > 0.0 else 1.0)
+            fit.append((residual, sum(r.p[i][i] for i in range(r.n)), r.updates))
+        return est, fit
+
+
+# ---------------------------------------------------------------------------
+# Check
+# ---------------------------------------------------------------------------
+
+def error(name, est, true):
+    limit, kind = TOLERANCE[name]
+    err = est[name] - true[name]
+    if kind == "rel":
+        err /= true[name]
+    return err, abs(err) <= limit
+
+
+def fly(rig, controller, seconds, seed, trace=None):
+    """Flies a rig through random targets; returns (estimate, fit, settled
+    time per checked figure)."""
+    true = dict(PLANT)
+    true.update(RIGS[rig])
+    plant = Plant(true, seed)
+    ctrl = CONTROLLERS[controller]()
+    ident = PlantId()
+    rng = random.Random(seed)
+    airborne = False
+    targ_h, targ_y = 0, 0
+    settled = {name: None for name in TOLERANCE}
+
+    for n in range(int(seconds / DT)):
+        t = n * DT
+        if n % int(3.0 / DT) == 0:
+            targ_h, targ_y = rng.randint(150, 700), rng.randint(-120, 120)
+        height, yaw = plant.measure()
+        main, tail = ctrl.update(height, yaw, targ_h, targ_y, DT)
+        plant.step(main, tail)
+
+        if not airborne and height >= AIRBORNE_ENTER_HEIGHT:
+            airborne = True
+        elif airborne and height < AIRBORNE_EXIT_HEIGHT:
+            airborne = False
+        ident.update(height, yaw, main, tail, DT, airborne)
+
+        if n % 50 == 0:
+            est, fit = ident.get()
+            for name in TOLERANCE:
+                if error(name, est, true)[1]:
+                    if settled[name] is None:
+                        settled[name] = t
+                else:
+                    settled[name] = None
+            if trace:
+                trace.write("%.2f,%s,%.4f,%.4f\n" % (
+                    t, ",".join("%.4f" % est[name] for name in TOLERANCE),
+                    fit[HEIGHT][0], fit[YAW][0]))
+
+    est, fit = ident.get()
+    return true, est, fit, settled
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("--rig", choices=sorted(RIGS), action="append",
+                    help="rig(s) to fly (default: all)")
+    ap.add_argument("--controller", choices=sorted(CONTROLLERS), default="single",
+                    help="controller flying the rig (default: single)")
+    ap.add_argument("--seconds", type=float, default=120.0,
+                    help="flight length (default: 120)")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--trace", metavar="CSV",
+                    help="write the estimates every 0.1 s for the first rig")
+    args = ap.parse_args()
+    rigs = args.rig or list(RIGS)
+
+    failed = False
+    print("%-8s %-13s %8s %8s %8s %10s %9s" % (
+        "rig", "figure", "true", "fitted", "error", "settled", ""))
+    for i, rig in enumerate(rigs):
+        trace = None
+        if args.trace and i == 0:
+            trace = open(args.trace, "w")
+            trace.write("t,%s,height_residual,yaw_residual\n" % ",".join(TOLERANCE))
+        true, est, fit, settled = fly(rig, args.controller, args.seconds,
+                                      args.seed, trace)
+        if trace:
+            trace.close()
+        for name in TOLERANCE:
+            err, ok = error(name, est, true)
+            failed |= not ok
+            unit = "%" if TOLERANCE[name][1] == "rel" else ""
+            print("%-8s %-13s %8.3f %8.3f %7.2f%s %9s %9s" % (
+                rig, name, true[name], est[name],
+                err * 100 if unit else err, unit or " ",
+                "%.1fs" % settled[name] if settled[name] is not None else "-",
+                "ok" if ok else "OUT"))
+        for axis, (residual, trace_p, updates) in zip(("height", "yaw"), fit):
+            print("%-8s %-13s residual %.1f%%, covariance trace %.4f, %d updates" % (
+                rig, axis + " fit", residual * 100, trace_p, updates))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
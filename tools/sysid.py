@@ -0,0 +1,460 @@
+#!/usr/bin/env python3
+"""
+sysid.py
+
+Fits the plant model of tools/heli_sim.py to logged flights and writes the
+fitted parameters as a file that heli_sim.py, lqr_gains.py and empc_gen.py
+load with --plant.
+
+The log is the control loop's telemetry (telemetry.h, TELEMETRY_ENABLE):
+either a raw UART capture or the CSV telemetry_decode.py writes from one.
+Each record has the tick, the height ADC reading, yaw, both duties and the
+targets. Height is taken as the ADC drop below the ground reading, which is
+the measured height for a rig with a linear altitude table; the ground is
+the reading before the motors first start unless --ground gives it.
+
+The model and regression are those of plant_id.c (see plant_id.h), so the
+offline and in-flight fits can be compared figure for figure: each axis is
+a third-order linear equation in the readings and the duties, whose
+derivatives come from the same three-pole state-variable filter run over
+both. Here the fit is batch least squares over the whole log, one airborne
+sample per PLANT_ID_DIVIDER cycles, with no forgetting, which gives each
+parameter's standard error as well. Motor lag, hover duty, height and yaw
+drag, gains, tail trim and the main-to-tail coupling are derived from the
+parameters as PlantIdGet() does. The yaw gain and drag come out a few
+percent high, as the encoder's steps still reach the yaw derivatives.
+
+A log of several hours is tens of megabytes. It is memory-mapped rather
+than read, and cut into chunks at record boundaries: keyframes for a
+capture, line ends for CSV. Each chunk is fitted by its own process into
+sums of the normal equations, which add, so the result is the same as a
+single pass and the time falls with the number of cores: each fits about an
+hour of flight in 10 s. Every chunk starts its filters some 20 s of log
+early so nothing is lost at the cuts.
+
+    python3 tools/sysid.py capture.bin -o rig.json
+    python3 tools/sysid.py records.csv --ground 2480 -o rig.json
+    python3 tools/sysid.py --simulate 600 --rig heavy sim.bin
+    python3 tools/heli_sim.py --plant rig.json
+
+--simulate first writes a capture of the named rig from tools/plant_id_check.py
+flying random targets, then fits it and compares the result with the rig.
+
+Group 9
+"""
+
+import argparse
+import json
+import math
+import mmap
+import os
+import random
+import sys
+import time
+from concurrent.futures import ProcessPoolExecutor
+
+from heli_sim import CONTROLLERS, DT, PLANT, Plant
+from plant_id_check import (AIRBORNE_ENTER_HEIGHT, AIRBORNE_EXIT_HEIGHT,
+                            PLANT_ID_DIVIDER, PLANT_ID_FILTER_RATE,
+                            PLANT_ID_INPUT_DELAY, PLANT_ID_MAIN_CENTRE,
+                            PLANT_ID_SETTLE_CYCLES, PLANT_ID_TAIL_CENTRE, RIGS,
+                            TOLERANCE, error, physical)
+from telemetry_decode import CHANNELS, Decoder, encode
+
+HEIGHT_ADC, YAW, MAIN_DUTY, TAIL_DUTY = (1 + CHANNELS.index(c) for c in (
+    "height_adc", "yaw", "main_duty", "tail_duty"))
+
+# Ticks are 1 ms. A longer gap than this between records (a dropped record
+# or a resync) restarts the filters as a landing would.
+TICK_S = 0.001
+MAX_GAP_TICKS = 10
+SAMPLE_TICKS = round(PLANT_ID_DIVIDER * DT / TICK_S)
+
+# Each chunk starts its filters this many records early, well past the
+# settling time; bytes per record are upper bounds for each format.
+WARM_UP_RECORDS = 4 * PLANT_ID_SETTLE_CYCLES
+CAPTURE_RECORD_BYTES = 8
+CSV_RECORD_BYTES = 40
+
+CHUNKS_PER_JOB = 4
+
+HEIGHT_NAMES = ["a1", "a0", "bm", "c"]
+YAW_NAMES = ["a1", "a0", "bm", "c", "bt"]
+
+# Figures written to the parameter file, as named in heli_sim.PLANT.
+FITTED = ["hover_duty", "height_gain", "height_damping", "motor_tau",
+          "tail_trim", "yaw_gain", "yaw_damping", "yaw_coupling"]
+
+
+# ---------------------------------------------------------------------------
+# Log access
+# ---------------------------------------------------------------------------
+
+def is_csv(mm):
+    return mm[:5] == b"tick,"
+
+
+def csv_records(mm, warm, start, end):
+    """(counted, record) for each line from warm on, counting those that
+    start in [start, end)."""
+    pos = mm.find(b"\n", max(warm - 1, 0)) + 1
+    size = len(mm)
+    while 0 < pos < min(size, end):
+        nl = mm.find(b"\n", pos)
+        if nl < 0:
+            nl = size
+        fields = mm[pos:nl].split(b",")
+        if len(fields) == 1 + len(CHANNELS) and fields[0] != b"tick":
+            yield pos >= start, [int(x) for x in fields]
+        pos = nl + 1
+
+
+def capture_records(mm, warm, start, end):
+    """(counted, record) for each telemetry record from warm on, counting
+    those from the first keyframe at or after start up to the first at or
+    after end. Decoding from warm, mid-record or not, puts the decoder on
+    the same record boundaries as the previous chunk's by start, so the
+    chunks meet at the same keyframe."""
+    dec = Decoder()
+    keyframes = 0
+    counted = False
+    for rec in dec.decode(mm, warm):
+        if dec.keyframes != keyframes:
+            keyframes = dec.keyframes
+            if dec.record_start >= end:
+                return
+            counted = counted or dec.record_start >= start
+        yield counted, rec
+
+
+def find_ground(mm):
+    """Median height ADC reading before the main motor first runs."""
+    read = csv_records if is_csv(mm) else capture_records
+    readings = []
+    for _, rec in read(mm, 0, 0, len(mm)):
+        if rec[MAIN_DUTY] > 0 or len(readings) >= 2000:
+            break
+        readings.append(rec[HEIGHT_ADC])
+    if not readings:
+        return None
+    readings.sort()
+    return readings[len(readings) // 2]
+
+
+# ---------------------------------------------------------------------------
+# Fit
+# ---------------------------------------------------------------------------
+
+def fit_chunk(job):
+    """Normal equation sums for the samples whose records start in
+    [start, end). Runs in a worker process."""
+    path, start, end, ground = job
+    with open(path, "rb") as f:
+        mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    if is_csv(mm):
+        read, warm = csv_records, start - WARM_UP_RECORDS * CSV_RECORD_BYTES
+    else:
+        read, warm = capture_records, start - WARM_UP_RECORDS * CAPTURE_RECORD_BYTES
+    warm = max(0, warm)
+
+    r = PLANT_ID_FILTER_RATE
+    xtx = [[[0.0] * n for _ in range(n)] for n in (4, 5)]
+    xty = [[0.0] * n for n in (4, 5)]
+    yty = [0.0, 0.0]
+    samples = 0
+    records_seen = 0
+    airborne_ticks = 0
+
+    # Filter states: three poles each for height, unwrapped yaw and the
+    # delayed duties. Locals, not lists, as this loop is the tool's cost.
+    airborne = False
+    settle = 0
+    last_tick = None
+    h0 = h1 = h2 = y0 = y1 = y2 = m0 = m1 = m2 = t0 = t1 = t2 = 0.0
+    unw = 0.0
+    last_yaw = 0
+    delay = []
+    for counted, rec in read(mm, warm, start, end):
+        records_seen += counted
+        tick = rec[0]
+        height = ground - rec[HEIGHT_ADC]
+        if height < 0:
+            height = 0
+        yaw = rec[YAW]
+
+        if not airborne and height >= AIRBORNE_ENTER_HEIGHT:
+            airborne = True
+        elif airborne and height < AIRBORNE_EXIT_HEIGHT:
+            airborne = False
+
+        elapsed = 0 if last_tick is None else tick - last_tick
+        last_tick = tick
+        if not airborne or not 0 < elapsed <= MAX_GAP_TICKS:
+            # As PlantIdPrime(): start again from the present.
+            h0 = h1 = h2 = float(height)
+            y0 = y1 = y2 = unw = float(yaw)
+            m0 = m1 = m2 = float(rec[MAIN_DUTY])
+            t0 = t1 = t2 = float(rec[TAIL_DUTY])
+            last_yaw = yaw
+            delay = [(rec[MAIN_DUTY], rec[TAIL_DUTY])] * PLANT_ID_INPUT_DELAY
+            settle = PLANT_ID_SETTLE_CYCLES
+            continue
+
+        airborne_ticks += elapsed if counted else 0
+        step = r * elapsed * TICK_S
+        if step > 1.0:
+            step = 1.0
+        diff = yaw - last_yaw
+        if diff >= 180:
+            diff -= 360
+        elif diff < -180:
+            diff += 360
+        last_yaw = yaw
+        unw += diff
+        if unw >= 180.0 or unw < -180.0:
+            shift = -360.0 if unw >= 180.0 else 360.0
+            unw += shift
+            y0 += shift
+            y1 += shift
+            y2 += shift
+
+        delay.append((rec[MAIN_DUTY], rec[TAIL_DUTY]))
+        main, tail = delay.pop(0)
+        h0 += step * (height - h0)
+        h1 += step * (h0 - h1)
+        h2 += step * (h1 - h2)
+        y0 += step * (unw - y0)
+        y1 += step * (y0 - y1)
+        y2 += step * (y1 - y2)
+        m0 += step * (main - m0)
+        m1 += step * (m0 - m1)
+        m2 += step * (m1 - m2)
+        t0 += step * (tail - t0)
+        t1 += step * (t0 - t1)
+        t2 += step * (t1 - t2)
+        if settle > 0:
+            settle -= 1
+            continue
+        # Neighbouring samples at the control rate add almost nothing to
+        # the fit behind a 3 rad/s filter, so take one per divider period,
+        # by tick so that where the chunks fall makes no difference.
+        if tick % SAMPLE_TICKS >= elapsed or not counted:
+            continue
+
+        main_x = m2 - PLANT_ID_MAIN_CENTRE
+        tail_x = t2 - PLANT_ID_TAIL_CENTRE
+        for axis, x, f0, f1, f2 in ((0, height, h0, h1, h2), (1, unw, y0, y1, y2)):
+            d1a, d1b, d1c = r * (x - f0), r * (f0 - f1), r * (f1 - f2)
+            d2b, d2c = r * (d1a - d1b), r * (d1b - d1c)
+            out = r * (d2b - d2c)
+            phi = (d2c, d1c, main_x, 1.0, tail_x) if axis else (d2c, d1c, main_x, 1.0)
+            a, b = xtx[axis], xty[axis]
+            for i, pi in enumerate(phi):
+                b[i] += pi * out
+                row = a[i]
+                for j in range(i, len(phi)):
+                    row[j] += pi * phi[j]
+            yty[axis] += out * out
+        samples += 1
+
+    mm.close()
+    return xtx, xty, yty, samples, records_seen, airborne_ticks
+
+
+def solve(xtx, xty):
+    """theta and inverse of the normal matrix, by Gauss-Jordan on the
+    mirrored upper triangle."""
+    n = len(xty)
+    a = [[xtx[min(i, j)][max(i, j)] for j in range(n)] + [1.0 if i == k else 0.0
+         for k in range(n)] for i in range(n)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda i: abs(a[i][c]))
+        if abs(a[p][c]) < 1e-300:
+            raise ValueError("the log does not excite every parameter")
+        a[c], a[p] = a[p], a[c]
+        pivot = a[c][c]
+        a[c] = [x / pivot for x in a[c]]
+        for i in range(n):
+            if i != c and a[i][c] != 0.0:
+                f = a[i][c]
+                a[i] = [x - f * y for x, y in zip(a[i], a[c])]
+    inv = [row[n:] for row in a]
+    theta = [sum(inv[i][j] * xty[j] for j in range(n)) for i in range(n)]
+    return theta, inv
+
+
+def fit(path, jobs, ground=None):
+    """Fits the log at path on jobs processes; returns the parameters, their
+    standard errors and residuals per axis and the heli_sim.PLANT figures."""
+    with open(path, "rb") as f:
+        size = os.fstat(f.fileno()).st_size
+        mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        record_bytes = CSV_RECORD_BYTES if is_csv(mm) else CAPTURE_RECORD_BYTES
+        if ground is None:
+            ground = find_ground(mm)
+            if ground is None:
+                raise ValueError("no records with the motors off; give --ground")
+        mm.close()
+
+    # Chunks much shorter than their warm-up would mostly repeat work.
+    chunks = max(1, min(jobs * CHUNKS_PER_JOB,
+                        size // (4 * WARM_UP_RECORDS * record_bytes)))
+    cuts = [size * i // chunks for i in range(chunks + 1)]
+    work = [(path, cuts[i], cuts[i + 1], ground) for i in range(chunks)]
+    with ProcessPoolExecutor(max_workers=jobs) as pool:
+        parts = list(pool.map(fit_chunk, work))
+
+    result = {"ground": ground, "bytes": size, "axes": []}
+    result["records"] = sum(p[4] for p in parts)
+    result["samples"] = sum(p[3] for p in parts)
+    result["airborne_s"] = sum(p[5] for p in parts) * TICK_S
+    for axis, names in enumerate((HEIGHT_NAMES, YAW_NAMES)):
+        n = len(names)
+        xtx = [[sum(p[0][axis][i][j] for p in parts) for j in range(n)]
+               for i in range(n)]
+        xty = [sum(p[1][axis][i] for p in parts) for i in range(n)]
+        yty = sum(p[2][axis] for p in parts)
+        theta, inv = solve(xtx, xty)
+        samples = result["samples"]
+        # Residual sum of squares from the sums alone.
+        rss = yty - sum(t * b for t, b in zip(theta, xty))
+        sigma2 = max(rss, 0.0) / max(samples - n, 1)
+        result["axes"].append({
+            "theta": theta,
+            "stderr": [math.sqrt(max(inv[i][i], 0.0) * sigma2) for i in range(n)],
+            "residual": math.sqrt(max(rss, 0.0) / yty) if yty > 0 else 1.0,
+        })
+    h, y = (ax["theta"] for ax in result["axes"])
+    result["plant"] = physical(h, y + [0.0] * (5 - len(y)))
+    return result
+
+
+# ---------------------------------------------------------------------------
+# Synthetic logs
+# ---------------------------------------------------------------------------
+
+def simulate(path, rig, seconds, controller, seed, ground=2500):
+    """Writes a raw capture of a simulated flight; returns the rig's plant."""
+    true = dict(PLANT)
+    true.update(RIGS[rig])
+    plant = Plant(true, seed)
+    ctrl = CONTROLLERS[controller]()
+    rng = random.Random(seed)
+
+    def records():
+        # A second on the ground with the motors off, as after a reset.
+        for n in range(int(1.0 / DT)):
+            height, yaw = plant.measure()
+            yield (n * 2, [ground - height, yaw, 0, 0, 0, 0])
+        targ_h, targ_y = 0, 0
+        for n in range(int(1.0 / DT), int(seconds / DT)):
+            if n % int(3.0 / DT) == 0:
+                # Land now and then, as a real session would.
+                targ_h = 0 if rng.random() < 0.1 else rng.randint(150, 700)
+                targ_y = rng.randint(-120, 120)
+            height, yaw = plant.measure()
+            main, tail = ctrl.update(height, yaw, targ_h, targ_y, DT)
+            plant.step(main, tail)
+            yield (n * 2, [ground - height, yaw, main, tail, targ_h, targ_y])
+
+    with open(path, "wb") as f:
+        batch = []
+        for rec in records():
+            batch.append(rec)
+            if len(batch) == 64 * 256:
+                f.write(encode(batch))
+                batch = []
+        f.write(encode(batch))
+    return true
+
+
+# ---------------------------------------------------------------------------
+# Output
+# ---------------------------------------------------------------------------
+
+def write_plant(path, result, source):
+    data = {
+        "plant": {name: round(result["plant"][name], 6) for name in FITTED},
+        "fit": {
+            "source": os.path.basename(source),
+            "ground_adc": result["ground"],
+            "records": result["records"],
+            "samples": result["samples"],
+            "airborne_s": round(result["airborne_s"], 1),
+            "height_residual": round(result["axes"][0]["residual"], 4),
+            "yaw_residual": round(result["axes"][1]["residual"], 4),
+        },
+    }
+    with open(path, "w") as f:
+        json.dump(data, f, indent=2)
+        f.write("\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("log", help="raw telemetry capture or decoded CSV")
+    ap.add_argument("-o", "--output", metavar="JSON",
+                    help="write the fitted plant parameters")
+    ap.add_argument("--ground", type=int, metavar="ADC",
+                    help="ground reading (default: from the log)")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                    help="worker processes (default: one per core)")
+    ap.add_argument("--simulate", type=float, metavar="SECONDS",
+                    help="first write a simulated flight of this length to LOG")
+    ap.add_argument("--rig", choices=sorted(RIGS), default="nominal",
+                    help="rig to simulate (default: nominal)")
+    ap.add_argument("--controller", choices=sorted(CONTROLLERS), default="single",
+                    help="controller flying the simulated rig (default: single)")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    true = None
+    if args.simulate:
+        t0 = time.time()
+        true = simulate(args.log, args.rig, args.simulate, args.controller,
+                        args.seed)
+        print("simulated %.0f s of %s flight in %.1f s" %
+              (args.simulate, args.rig, time.time() - t0))
+
+    t0 = time.time()
+    result = fit(args.log, max(1, args.jobs), args.ground)
+    wall = time.time() - t0
+    print("%s: %d records, %d fitted samples (%.1f min airborne), "
+          "%.1f MB in %.2f s on %d jobs (%.0f records/s)" % (
+              args.log, result["records"], result["samples"],
+              result["airborne_s"] / 60, result["bytes"] / 1e6, wall,
+              args.jobs, result["records"] / wall if wall > 0 else 0))
+    print("ground ADC %d" % result["ground"])
+
+    for axis, names in (("height", HEIGHT_NAMES), ("yaw", YAW_NAMES)):
+        ax = result["axes"][axis == "yaw"]
+        print("%-6s residual %.1f%%  %s" % (axis, ax["residual"] * 100, "  ".join(
+            "%s %.4g+-%.2g" % (n, t, e)
+            for n, t, e in zip(names, ax["theta"], ax["stderr"]))))
+
+    print("%-15s %10s%s" % ("", "fitted", "       rig     error" if true else ""))
+    failed = False
+    for name in FITTED:
+        line = "%-15s %10.4f" % (name, result["plant"][name])
+        if true:
+            # The figures plant_id_check.py holds plant_id.c to; the rest
+            # are shown but only as good as the yaw encoder allows.
+            if name in TOLERANCE:
+                err, ok = error(name, result["plant"], true)
+                failed |= not ok
+                rel = TOLERANCE[name][1] == "rel"
+            else:
+                err, ok, rel = (result["plant"][name] - true[name]) / true[name], None, True
+            line += " %9.4f %8.2f%s %s" % (true[name], err * 100 if rel else err,
+                                          "%" if rel else " ",
+                                          {True: "ok", False: "OUT", None: ""}[ok])
+        print(line.rstrip())
+
+    if args.output:
+        write_plant(args.output, result, args.log)
+        print("wrote %s" % args.output)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
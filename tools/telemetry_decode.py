@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""
+telemetry_decode.py
+
+Host decoder for the binary telemetry stream produced by telemetry.c.
+
+Reads a raw UART capture (text log lines and telemetry records interleaved),
+writes the decoded records as CSV and prints stream statistics, including
+the compression ratio against fixed 32-bit records and the fraction of the
+115200 baud link the stream uses.
+
+    python3 tools/telemetry_decode.py capture.bin > records.csv
+    python3 tools/telemetry_decode.py --simulate 20000    # synthetic trace
+
+Group 9
+"""
+
+import argparse
+import math
+import random
+import sys
+
+KEYFRAME_TAG = 0xA5
+KEYFRAME_BYTE = bytes([KEYFRAME_TAG])
+DELTA_TAG = 0xC0
+KEYFRAME_INTERVAL = 64
+CHANNELS = ["height_adc", "yaw", "main_duty", "tail_duty",
+            "targ_height", "targ_yaw"]
+RAW_RECORD_BYTES = 4 * (len(CHANNELS) + 1)
+LINK_BYTES_PER_S = 115200 / 10
+
+
+class Truncated(Exception):
+    pass
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def zigzag(v):
+    return ((v << 1) ^ (v >> 31)) & 0xFFFFFFFF
+
+
+def read_varint(buf, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(buf):
+            raise Truncated()
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+        if shift > 28:
+            raise ValueError("varint too long")
+
+
+def put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+class Decoder:
+    def __init__(self):
+        self.synced = False
+        self.tick = 0
+        self.values = [0] * len(CHANNELS)
+        self.records = 0
+        self.keyframes = 0
+        self.resyncs = 0
+        self.record_bytes = 0
+        self.text_lines = []
+        self.record_start = 0
+
+    def decode(self, buf, pos=0):
+        """Yields [tick] + values per record in buf from pos on; after each,
+        record_start is the record's offset in buf."""
+        while pos < len(buf):
+            tag = buf[pos]
+            self.record_start = pos
+            try:
+                if tag < 0x80:
+                    end = buf.find(b"\n", pos)
+                    end = len(buf) if end < 0 else end + 1
+                    key = buf.find(KEYFRAME_BYTE, pos, end)
+                    if key >= 0:
+                        # Record bytes, not a log line: hunt from the keyframe.
+                        if self.synced:
+                            self.resyncs += 1
+                        self.synced = False
+                        pos = key
+                        continue
+                    self.text_lines.append(buf[pos:end].decode("ascii", "replace").rstrip())
+                    pos = end
+                elif tag == KEYFRAME_TAG:
+                    rec, pos = self._keyframe(buf, pos)
+                    if rec is not None:
+                        yield rec
+                elif tag & 0xC0 == DELTA_TAG and self.synced:
+                    rec, pos = self._delta(buf, pos)
+                    yield rec
+                else:
+                    # Not at a record boundary: hunt for the next keyframe.
+                    if self.synced:
+                        self.resyncs += 1
+                    self.synced = False
+                    pos += 1
+            except (Truncated, ValueError):
+                self.synced = False
+                pos += 1
+
+    def _keyframe(self, buf, start):
+        pos = start + 1
+        if pos >= len(buf):
+            raise Truncated()
+        pos += 1  # sequence number
+        tick, pos = read_varint(buf, pos)
+        values = []
+        for _ in CHANNELS:
+            v, pos = read_varint(buf, pos)
+            values.append(unzigzag(v))
+        if pos >= len(buf):
+            raise Truncated()
+        if sum(buf[start + 1:pos]) & 0xFF != buf[pos]:
+            self.synced = False
+            return None, start + 1
+        pos += 1
+        self.synced = True
+        self.tick, self.values = tick, values
+        self.keyframes += 1
+        return self._emit(pos - start), pos
+
+    def _delta(self, buf, start):
+        mask = buf[start] & 0x3F
+        dt, pos = read_varint(buf, start + 1)
+        values = list(self.values)
+        for i in range(len(CHANNELS)):
+            if mask & (1 << i):
+                d, pos = read_varint(buf, pos)
+                values[i] = (values[i] + unzigzag(d) + 2**31) % 2**32 - 2**31
+        self.tick = (self.tick + dt) & 0xFFFFFFFF
+        self.values = values
+        return self._emit(pos - start), pos
+
+    def _emit(self, nbytes):
+        self.records += 1
+        self.record_bytes += nbytes
+        return [self.tick] + list(self.values)
+
+
+def encode(records):
+    """Reference encoder matching TelemetryEncode() in telemetry.c."""
+    out = bytearray()
+    prev_tick, prev = 0, [0] * len(CHANNELS)
+    since_key, seq = KEYFRAME_INTERVAL, 0
+    for tick, values in records:
+        if since_key >= KEYFRAME_INTERVAL:
+            out.append(KEYFRAME_TAG)
+            body = bytearray([seq])
+            put_varint(body, tick)
+            for v in values:
+                put_varint(body, zigzag(v))
+            out += body
+            out.append(sum(body) & 0xFF)
+            since_key = 0
+        else:
+            body = bytearray()
+            put_varint(body, (tick - prev_tick) & 0xFFFFFFFF)
+            mask = 0
+            for i, v in enumerate(values):
+                if v != prev[i]:
+                    mask |= 1 << i
+                    put_varint(body, zigzag(v - prev[i]))
+            out.append(DELTA_TAG | mask)
+            out += body
+            since_key += 1
+        prev_tick, prev = tick, list(values)
+        seq = (seq + 1) & 0xFF
+    return bytes(out)
+
+
+def simulate(n, seed=1):
+    """A hover-and-step trace shaped like the real control loop output."""
+    rng = random.Random(seed)
+    tick, ground, targ_h, targ_y = 0, 2500, 0, 0
+    height, yaw = 0.0, 0.0
+    for k in range(n):
+        tick += 2
+        if k % 2000 == 0:
+            targ_h = rng.randint(0, 10)
+            targ_y = rng.randint(0, 23)
+        height += 0.01 * (targ_h * 100 - height)
+        yaw += 0.02 * (((targ_y * 15 + 180) % 360 - 180) - yaw)
+        adc = int(ground - height + rng.gauss(0, 1.5))
+        main = max(0, min(99, int(50 + 0.1 * (targ_h * 100 - height))))
+        tail = max(0, min(85, int(40 + (yaw - targ_y * 15))))
+        yield tick, [adc, int(yaw), main, tail, targ_h, targ_y]
+
+
+def report(dec, rate_hz, out=sys.stderr):
+    if dec.records == 0:
+        print("no telemetry records found", file=out)
+        return
+    per_rec = dec.record_bytes / dec.records
+    print("records:          %d (%d keyframes, %d resyncs)"
+          % (dec.records, dec.keyframes, dec.resyncs), file=out)
+    print("bytes/record:     %.2f (raw %d, ratio %.2fx)"
+          % (per_rec, RAW_RECORD_BYTES, RAW_RECORD_BYTES / per_rec), file=out)
+    print("link use @%d Hz: %.1f%% (raw %.1f%%)"
+          % (rate_hz, 100 * per_rec * rate_hz / LINK_BYTES_PER_S,
+             100 * RAW_RECORD_BYTES * rate_hz / LINK_BYTES_PER_S), file=out)
+    print("max rate on link: %d records/s"
+          % math.floor(LINK_BYTES_PER_S / per_rec), file=out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("capture", nargs="?", help="raw UART capture ('-' for stdin)")
+    ap.add_argument("--simulate", type=int, metavar="N",
+                    help="encode and decode N synthetic records instead")
+    ap.add_argument("--rate", type=int, default=500,
+                    help="control loop rate used for link usage (Hz)")
+    ap.add_argument("--text", action="store_true",
+                    help="echo interleaved log lines to stderr")
+    args = ap.parse_args()
+
+    if args.simulate:
+        data = encode(simulate(args.simulate))
+        out = None
+    elif args.capture:
+        stream = sys.stdin.buffer if args.capture == "-" else open(args.capture, "rb")
+        data = stream.read()
+        out = sys.stdout
+    else:
+        ap.error("give a capture file or --simulate N")
+
+    dec = Decoder()
+    if out:
+        out.write("tick," + ",".join(CHANNELS) + "\n")
+    for rec in dec.decode(data):
+        if out:
+            out.write(",".join(str(v) for v in rec) + "\n")
+    if args.text:
+        for line in dec.text_lines:
+            print(line, file=sys.stderr)
+    report(dec, args.rate)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+trace_to_perfetto.py
+
+Host converter for the kernel event trace recorded by trace_recorder.c.
+
+Reads a raw binary memory dump that contains g_sTraceBuffer (save just that
+symbol from the debugger, or all of SRAM from 0x20000000) and writes Chrome
+trace-event JSON, which ui.perfetto.dev and chrome://tracing open directly.
+Each task and each instrumented ISR gets its own track, queue operations are
+instant events on the track that performed them and every queue's fill level
+is plotted as a counter.
+
+    python3 tools/trace_to_perfetto.py sram.bin > trace.json
+    python3 tools/trace_to_perfetto.py --text sram.bin     # event listing
+    python3 tools/trace_to_perfetto.py --demo demo.bin     # write a sample dump
+
+Group 9
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# Mirrors trace_recorder.h (format version 1).
+MAGIC = b"FRTR"
+VERSION = 1
+HEADER = struct.Struct("<IHHIIII")
+MAX_TASKS = 16
+NAME_LEN = 12
+
+SWITCH_IN, SWITCH_OUT, QUEUE_SEND, QUEUE_RECEIVE, QUEUE_SEND_ISR, \
+    QUEUE_RECEIVE_ISR, BLOCK_SEND, BLOCK_RECEIVE, ISR_ENTER, ISR_EXIT = range(1, 11)
+EVENT_NAMES = {
+    SWITCH_IN: "switch_in", SWITCH_OUT: "switch_out",
+    QUEUE_SEND: "queue_send", QUEUE_RECEIVE: "queue_receive",
+    QUEUE_SEND_ISR: "queue_send_isr", QUEUE_RECEIVE_ISR: "queue_receive_isr",
+    BLOCK_SEND: "block_send", BLOCK_RECEIVE: "block_receive",
+    ISR_ENTER: "isr_enter", ISR_EXIT: "isr_exit",
+}
+ISR_NAMES = ["YawPhaseISR", "YawRefISR"]     # traceIsrId_t
+ISR_TID_BASE = 100
+
+
+class Dump:
+    def __init__(self, hz, names, events, head, stopped):
+        self.hz = hz
+        self.names = names
+        self.events = events            # [(time, type, id, arg)], oldest first
+        self.head = head
+        self.stopped = stopped
+
+
+def parse(buf):
+    pos = buf.find(MAGIC)
+    while pos >= 0:
+        if pos + HEADER.size <= len(buf):
+            magic, ver, esize, cap, hz, head, stopped = \
+                HEADER.unpack_from(buf, pos)
+            if ver == VERSION and esize == 8 and cap and cap & (cap - 1) == 0:
+                break
+        pos = buf.find(MAGIC, pos + 1)
+    if pos < 0:
+        raise ValueError("no trace buffer (magic %r) in dump" % MAGIC)
+
+    p = pos + HEADER.size
+    names = {}
+    for i in range(MAX_TASKS):
+        raw = buf[p + i * NAME_LEN:p + (i + 1) * NAME_LEN].split(b"\0")[0]
+        if raw:
+            names[i] = raw.decode("ascii", "replace")
+    p += MAX_TASKS * NAME_LEN
+    if p + cap * 8 > len(buf):
+        raise ValueError("dump truncated inside the event ring")
+
+    count = min(head, cap)
+    first = head - count
+    events = []
+    for n in range(first, head):
+        t, info = struct.unpack_from("<II", buf, p + (n % cap) * 8)
+        events.append((t, info & 0xFF, (info >> 8) & 0xFF, info >> 16))
+    return Dump(hz, names, events, head, stopped)
+
+
+def unwrap(events):
+    """Extends the 32-bit timestamps so they keep increasing."""
+    out = []
+    base = 0
+    prev = None
+    for t, kind, ident, arg in events:
+        if prev is not None and t < prev:
+            base += 1 << 32
+        prev = t
+        out.append((base + t, kind, ident, arg))
+    return out
+
+
+def to_chrome(dump):
+    events = unwrap(dump.events)
+    if not events:
+        return {"traceEvents": []}
+    t0 = events[0][0]
+    us = lambda t: (t - t0) * 1e6 / dump.hz
+
+    out = [{"ph": "M", "pid": 1, "name": "process_name",
+            "args": {"name": "FreeRTOS"}}]
+    tids = set()
+
+    def track(tid, name):
+        if tid not in tids:
+            tids.add(tid)
+            out.append({"ph": "M", "pid": 1, "tid": tid, "name": "thread_name",
+                        "args": {"name": name}})
+
+    running = None          # (task, start time)
+    isr_stack = []          # [(isr id, start time)]
+
+    def current_tid():
+        if isr_stack:
+            return ISR_TID_BASE + isr_stack[-1][0]
+        return running[0] if running else 0
+
+    for t, kind, ident, arg in events:
+        if kind == SWITCH_IN:
+            running = (ident, t)
+        elif kind == SWITCH_OUT:
+            # The first switch out may have no matching switch in.
+            start = running[1] if running and running[0] == ident else t0
+            name = dump.names.get(ident, "task%d" % ident)
+            track(ident, name)
+            out.append({"ph": "X", "pid": 1, "tid": ident, "name": name,
+                        "ts": us(start), "dur": us(t) - us(start)})
+            running = None
+        elif kind == ISR_ENTER:
+            isr_stack.append((ident, t))
+        elif kind == ISR_EXIT:
+            if isr_stack and isr_stack[-1][0] == ident:
+                start = isr_stack.pop()[1]
+            else:
+                start = t
+            name = ISR_NAMES[ident] if ident < len(ISR_NAMES) else "isr%d" % ident
+            track(ISR_TID_BASE + ident, name)
+            out.append({"ph": "X", "pid": 1, "tid": ISR_TID_BASE + ident,
+                        "name": name, "ts": us(start), "dur": us(t) - us(start)})
+        elif kind in EVENT_NAMES:
+            tid = current_tid()
+            track(tid, dump.names.get(tid, "task%d" % tid))
+            out.append({"ph": "i", "s": "t", "pid": 1, "tid": tid,
+                        "name": "%s q%d" % (EVENT_NAMES[kind], ident),
+                        "ts": us(t), "args": {"items": arg}})
+            out.append({"ph": "C", "pid": 1, "name": "queue %d" % ident,
+                        "ts": us(t), "args": {"items": arg}})
+
+    # Close whatever was still running when the dump was taken.
+    t_end = events[-1][0]
+    if running:
+        name = dump.names.get(running[0], "task%d" % running[0])
+        track(running[0], name)
+        out.append({"ph": "X", "pid": 1, "tid": running[0], "name": name,
+                    "ts": us(running[1]), "dur": us(t_end) - us(running[1])})
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def build_dump(names, events, capacity=256, hz=50000000, stopped=0):
+    """Builds a dump image exactly as the target lays it out."""
+    buf = bytearray(HEADER.pack(0x52545246, VERSION, 8, capacity, hz,
+                                len(events), stopped))
+    for i in range(MAX_TASKS):
+        buf += names.get(i, "").encode()[:NAME_LEN - 1].ljust(NAME_LEN, b"\0")
+    ring = [(0, 0)] * capacity
+    for n, (t, kind, ident, arg) in enumerate(events):
+        ring[n % capacity] = (t & 0xFFFFFFFF,
+                              kind | (ident << 8) | (arg << 16))
+    for t, info in ring:
+        buf += struct.pack("<II", t, info)
+    return bytes(buf)
+
+
+def demo():
+    """Two tasks sharing a queue with a yaw ISR, across a timer wrap."""
+    names = {1: "Control", 2: "Height", 3: "IDLE"}
+    events = []
+    t = 0xFFFF0000
+    for cycle in range(100):
+        events += [(t, SWITCH_IN, 2, 0), (t + 2000, QUEUE_SEND, 1, 1),
+                   (t + 2100, SWITCH_OUT, 2, 0), (t + 2100, SWITCH_IN, 1, 0),
+                   (t + 3000, QUEUE_RECEIVE, 1, 1),
+                   (t + 5000, ISR_ENTER, 0, 0), (t + 5300, ISR_EXIT, 0, 0),
+                   (t + 9000, BLOCK_RECEIVE, 1, 0),
+                   (t + 9100, SWITCH_OUT, 1, 0), (t + 9100, SWITCH_IN, 3, 0),
+                   (t + 50000, SWITCH_OUT, 3, 0)]
+        t += 50000
+    return build_dump(names, events)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    ap.add_argument("dump", help="raw binary memory dump")
+    ap.add_argument("--text", action="store_true",
+                    help="print the decoded events instead of JSON")
+    ap.add_argument("--demo", action="store_true",
+                    help="write a synthetic dump to DUMP and exit")
+    args = ap.parse_args()
+
+    if args.demo:
+        with open(args.dump, "wb") as f:
+            f.write(demo())
+        return
+
+    with open(args.dump, "rb") as f:
+        dump = parse(f.read())
+
+    print("%d events (%d lost to wrap), %s" %
+          (len(dump.events), dump.head - len(dump.events),
+           "stopped" if dump.stopped else "running"), file=sys.stderr)
+
+    if args.text:
+        for t, kind, ident, arg in unwrap(dump.events):
+            print("%14.3f us  %-18s id=%-3d arg=%d" %
+                  (t * 1e6 / dump.hz, EVENT_NAMES.get(kind, kind), ident, arg))
+    else:
+        json.dump(to_chrome(dump), sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+/******************************************************************************
+ *
+ * trace_recorder.c
+ *
+ * Purpose:
+ * RAM ring for the kernel event trace recorder. See trace_recorder.h for the
+ * hooks and tools/trace_to_perfetto.py for the host converter.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+
+// INCLUDES
+// ----------------------------------------------------------------------------
+
+#include <string.h>
+#include "FreeRTOS.h"        // Core FreeRTOS functionalities (and the hooks)
+#include "task.h"            // FreeRTOS task functionalities
+#include "trace_recorder.h"  // Trace recorder
+
+// GLOBAL VARIABLES------------------------------------------------------------
+
+traceBuffer_t g_sTraceBuffer = {
+    TRACE_RECORDER_MAGIC,
+    TRACE_RECORDER_VERSION,
+    sizeof(traceEvent_t),
+    TRACE_RECORDER_EVENTS,
+    TRACE_TIMESTAMP_HZ,
+};
+
+/** @brief Set once the scheduler (and so the timestamp timer) is running. */
+static volatile uint32_t g_ui32TraceStarted = 0;
+
+static uint32_t g_ui32TraceQueueNumber = 0;
+
+
+// FUNCTIONS-------------------------------------------------------------------
+
+void
+TraceRecord(traceEventType_t eType, uint32_t ui32Id, uint32_t ui32Arg)
+{
+    UBaseType_t uxSaved;
+    traceEvent_t *psEvent;
+
+    if (!g_ui32TraceStarted)
+    {
+        // Queues are used (mutex creation gives the mutex) before the
+        // timestamp timer is clocked; reading it then would fault.
+        if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+        {
+            return;
+        }
+        g_ui32TraceStarted = 1;
+    }
+
+    if (g_sTraceBuffer.ui32Stopped)
+    {
+        return;
+    }
+
+    // Masking up to configMAX_SYSCALL_INTERRUPT_PRIORITY makes this safe to
+    // nest: hooks run from tasks, from kernel critical sections and from ISRs.
+    uxSaved = portSET_INTERRUPT_MASK_FROM_ISR();
+    psEvent = &g_sTraceBuffer.psEvents[g_sTraceBuffer.ui32Head &
+                                       (TRACE_RECORDER_EVENTS - 1)];
+    psEvent->ui32Time = TRACE_TIMESTAMP();
+    psEvent->ui32Info = (eType & 0xFF) | ((ui32Id & 0xFF) << 8) |
+                        (ui32Arg << 16);
+    g_sTraceBuffer.ui32Head++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(uxSaved);
+}
+
+
+void
+TraceTaskName(uint32_t ui32Number, const char *pcName)
+{
+    if (ui32Number < TRACE_RECORDER_MAX_TASKS)
+    {
+        strncpy(g_sTraceBuffer.ppcTaskNames[ui32Number], pcName,
+                TRACE_RECORDER_NAME_LEN - 1);
+    }
+}
+
+
+uint32_t
+TraceNextQueueNumber(void)
+{
+    // Queues are only created from main() before the scheduler starts, so
+    // this needs no locking. Number 0 is left meaning "unnumbered".
+    return ++g_ui32TraceQueueNumber;
+}
+
+
+void
+TraceStop(void)
+{
+    g_sTraceBuffer.ui32Stopped = 1;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ * trace_recorder.h
+ *
+ * Purpose:
+ * Kernel event trace recorder built on the FreeRTOS trace hooks.
+ *
+ * Context switches, queue traffic, queue blocking and application ISRs are
+ * written as 8-byte timestamped events into a RAM ring that always holds the
+ * most recent TRACE_RECORDER_EVENTS events. The whole g_sTraceBuffer
+ * structure is self-describing: save it from the debugger (or save all of
+ * SRAM) as a raw binary and convert it with tools/trace_to_perfetto.py.
+ *
+ * Like runtime_stats.h this is included at the end of FreeRTOSConfig.h and
+ * must not include any FreeRTOS header. Only the timestamp is target
+ * specific; a host port can define TRACE_TIMESTAMP() and TRACE_TIMESTAMP_HZ
+ * in its own FreeRTOSConfig.h to run the recorder unchanged.
+ *
+ * Group 9
+ *
+*******************************************************************************/
+#ifndef __TRACE_RECORDER_H__
+#define __TRACE_RECORDER_H__
+
+#include <stdint.h>
+#include "runtime_stats.h"
+#include "stack_monitor.h"
+
+/** @brief Number of events kept in the ring. Must be a power of two. */
+#define TRACE_RECORDER_EVENTS       256
+
+/** @brief Highest task number whose name is kept for the host converter. */
+#define TRACE_RECORDER_MAX_TASKS    16
+#define TRACE_RECORDER_NAME_LEN     12
+
+#define TRACE_RECORDER_MAGIC        0x52545246  /* "FRTR" in memory */
+#define TRACE_RECORDER_VERSION      1
+
+#ifndef TRACE_TIMESTAMP
+#define TRACE_TIMESTAMP()           portGET_RUN_TIME_COUNTER_VALUE()
+#define TRACE_TIMESTAMP_HZ          configCPU_CLOCK_HZ
+#endif
+
+/** @brief Event types. The host converter mirrors this list. */
+typedef enum {
+    TRACE_EVT_SWITCH_IN = 1,    // id: task number
+    TRACE_EVT_SWITCH_OUT,       // id: task number
+    TRACE_EVT_QUEUE_SEND,       // id: queue number, arg: items after the send
+    TRACE_EVT_QUEUE_RECEIVE,    // id: queue number, arg: items before the read
+    TRACE_EVT_QUEUE_SEND_ISR,
+    TRACE_EVT_QUEUE_RECEIVE_ISR,
+    TRACE_EVT_BLOCK_SEND,       // id: queue number, arg: items in the queue
+    TRACE_EVT_BLOCK_RECEIVE,
+    TRACE_EVT_ISR_ENTER,        // id: traceIsrId_t
+    TRACE_EVT_ISR_EXIT
+} traceEventType_t;
+
+/** @brief Application ISRs that are instrumented with TRACE_ISR_ENTER/EXIT. */
+typedef enum {
+    TRACE_ISR_YAW_PHASE = 0,
+    TRACE_ISR_YAW_REF
+} traceIsrId_t;
+
+/**
+ * @brief One event. ui32Info packs type (bits 0-7), id (bits 8-15) and
+ * arg (bits 16-31) so the record is two words with no padding.
+ */
+typedef struct {
+    uint32_t ui32Time;
+    uint32_t ui32Info;
+} traceEvent_t;
+
+/** @brief The dump image. Field order is part of the host file format. */
+typedef struct {
+    uint32_t ui32Magic;
+    uint16_t ui16Version;
+    uint16_t ui16EventSize;
+    uint32_t ui32Capacity;
+    uint32_t ui32TimestampHz;
+    volatile uint32_t ui32Head;         // Total events written
+    volatile uint32_t ui32Stopped;      // Non-zero once TraceStop() is called
+    char ppcTaskNames[TRACE_RECORDER_MAX_TASKS][TRACE_RECORDER_NAME_LEN];
+    traceEvent_t psEvents[TRACE_RECORDER_EVENTS];
+} traceBuffer_t;
+
+extern traceBuffer_t g_sTraceBuffer;
+
+/** @brief Appends one event. Safe from tasks, ISRs and kernel hooks. */
+void TraceRecord(traceEventType_t eType, uint32_t ui32Id, uint32_t ui32Arg);
+
+/** @brief Stores a task's name against its task number (no event). */
+void TraceTaskName(uint32_t ui32Number, const char *pcName);
+
+/** @brief Returns a number for a new queue, used as its event id. */
+uint32_t TraceNextQueueNumber(void);
+
+/** @brief Freezes the ring so a later dump shows the lead-up to a fault. */
+void TraceStop(void);
+
+#if configUSE_TRACE_RECORDER
+
+// Kernel hooks. The task hooks are expanded inside tasks.c and the queue
+// hooks inside queue.c, where the TCB and queue structures are visible.
+#define traceTASK_CREATE(pxNewTCB)                                          \
+    do {                                                                    \
+        stackMonitorTASK_CREATE(pxNewTCB);                                  \
+        TraceTaskName((pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName);     \
+    } while (0)
+#define traceTASK_SWITCHED_IN()                                             \
+    do {                                                                    \
+        runtimeStatsTASK_SWITCHED_IN();                                     \
+        TraceRecord(TRACE_EVT_SWITCH_IN, pxCurrentTCB->uxTCBNumber, 0);     \
+    } while (0)
+#define traceTASK_SWITCHED_OUT()                                            \
+    TraceRecord(TRACE_EVT_SWITCH_OUT, pxCurrentTCB->uxTCBNumber, 0)
+#define traceQUEUE_CREATE(pxNewQueue)                                       \
+    ((pxNewQueue)->uxQueueNumber = TraceNextQueueNumber())
+#define traceQUEUE_SEND(pxQueue)                                            \
+    TraceRecord(TRACE_EVT_QUEUE_SEND, (pxQueue)->uxQueueNumber,             \
+                (pxQueue)->uxMessagesWaiting + 1)
+#define traceQUEUE_RECEIVE(pxQueue)                                         \
+    TraceRecord(TRACE_EVT_QUEUE_RECEIVE, (pxQueue)->uxQueueNumber,          \
+                (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)                                   \
+    TraceRecord(TRACE_EVT_QUEUE_SEND_ISR, (pxQueue)->uxQueueNumber,         \
+                (pxQueue)->uxMessagesWaiting + 1)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)                                \
+    TraceRecord(TRACE_EVT_QUEUE_RECEIVE_ISR, (pxQueue)->uxQueueNumber,      \
+                (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)                                \
+    TraceRecord(TRACE_EVT_BLOCK_SEND, (pxQueue)->uxQueueNumber,             \
+                (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)                             \
+    TraceRecord(TRACE_EVT_BLOCK_RECEIVE, (pxQueue)->uxQueueNumber,          \
+                (pxQueue)->uxMessagesWaiting)
+
+// FreeRTOS has no generic ISR hooks; instrumented ISRs call these directly.
+#define TRACE_ISR_ENTER(id)     TraceRecord(TRACE_EVT_ISR_ENTER, (id), 0)
+#define TRACE_ISR_EXIT(id)      TraceRecord(TRACE_EVT_ISR_EXIT, (id), 0)
+
+#else
+
+#define traceTASK_CREATE(pxNewTCB)  stackMonitorTASK_CREATE(pxNewTCB)
+#define traceTASK_SWITCHED_IN() runtimeStatsTASK_SWITCHED_IN()
+#define TRACE_ISR_ENTER(id)
+#define TRACE_ISR_EXIT(id)
+
+#endif /* configUSE_TRACE_RECORDER */
+
+#endif /* __TRACE_RECORDER_H__ */
@@ -14,7 +14,8 @@
 
 // Project specific includes
 #include "config.h"
-#include "circBufT.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
 #include "priorities.h"
 
 // FreeRTOS includes
@@ -26,17 +27,22 @@
 // Yaw task specific includes
 #include "yaw_task.h"
 #include "display_task.h"
+#include "log_task.h"
+#include "trace_recorder.h"
+#include "system_state.h"
 
 // CONSTANTS ------------------------------------------------------------------
 #define RIGTASKSTACKSIZE        128     // Stack size for the tasks (in words)
 
 // Yaw task specific constants and configurations
 
+// Both yaw GPIO interrupts record trace events, which are only safe from
+// interrupts the kernel can mask: no more urgent than the syscall level.
+#define YAW_INT_PRIORITY configMAX_SYSCALL_INTERRUPT_PRIORITY
+
 #define FIRST_BIT 0b00000001    // Bit mask for the first bit
 #define SECOND_BIT 0b00000010   // Bit mask for the second bit
 
-// External semaphore for UART operations
-extern xSemaphoreHandle g_pUARTSemaphore;
 extern QueueHandle_t g_MeasYawControlQueue;
 extern QueueHandle_t g_MeasYawDisplayQueue;
 
@@ -53,6 +59,10 @@ const float yaw_angle_ratio = 360.0 / 448.0;
 static int32_t yaw_counter = 0;
 static int32_t yaw_degree = 0;
 
+// Statically allocated TCB and stack for the yaw task
+static StaticTask_t yawTask_TCB;
+static StackType_t yawTask_Stack[RIGTASKSTACKSIZE];
+
 // LOCAL FUNCTION PROTOTYPES ---------------------------------------------------
 
 
@@ -72,16 +82,9 @@ void ISR_FOUND_REF(void);
 /**
  * @brief FreeRTOS Task for monitoring and handling the yaw orientation.
  *
- * This task continuously prints the yaw direction (or yaw status) to UART. 
- * A mutual exclusion semaphore (g_pUARTSemaphore) is used to ensure exclusive 
- * access to the UART resource, thus avoiding any potential contention issues.
- * After printing to UART, the task sleeps (delays) for 100 milliseconds before 
- * the next iteration.
- *
- * @note The UARTprintf() function is assumed to output text data via UART.
- *
- * @warning Ensure the g_pUARTSemaphore has been initialized before this task 
- * is started. Otherwise, it will lead to undefined behavior.
+ * This task converts the yaw counter to degrees and passes the result to
+ * the display task, then sleeps (delays) for 100 milliseconds before the
+ * next iteration. Errors are reported through the deferred log (log_task.h).
  *
  * @param pvParameters Parameters for the task (not used in this context).
  *
@@ -92,10 +95,7 @@ static void yawTask(void *pvParameters)
     while(1)
     {
         convert_to_degree();
-        
-        // Release the UART semaphore after use
-        xSemaphoreGive(g_pUARTSemaphore);
-        
+
 
         // Pass the value of the new yaw to the display task.
         if(xQueueSend(g_MeasYawDisplayQueue, &yaw_degree, portMAX_DELAY) != pdPASS)
@@ -103,10 +103,8 @@ static void yawTask(void *pvParameters)
         //
         // Error. The queue should never be full. If so print the
         // error message on UART and wait for ever.
-          UARTprintf("\nQueue full. This should never happen.\n");
-          while(1)
-          {
-          }
+          LOG1(LOG_QUEUE_FULL, "Yaw");
+          SystemStateFatal();
         }
 
         // Delay the task for 100 milliseconds before the next iteration
@@ -119,7 +117,8 @@ static void yawTask(void *pvParameters)
  * @brief Initializes the Yaw Task for execution.
  *
  * This function creates a new FreeRTOS task for yaw monitoring and handling.
- * The task is created using xTaskCreate(), which is part of the FreeRTOS API.
+ * The task is created using xTaskCreateStatic(), which is part of the FreeRTOS
+ * API, so its TCB and stack are fixed at link time.
  *
  * @note The task is created with a specified stack size (RIGTASKSTACKSIZE) and 
  * priority level (PRIORITY_YAW_TASK above the idle task priority).
@@ -132,9 +131,10 @@ static void yawTask(void *pvParameters)
  */
 uint32_t YAWTaskInit(void)
 {
-    // Create the Yaw task using FreeRTOS's xTaskCreate API
-    if (xTaskCreate(yawTask, (const portCHAR *)"Yaw", RIGTASKSTACKSIZE, NULL,
-                    tskIDLE_PRIORITY + PRIORITY_YAW_TASK, NULL) != pdTRUE) {
+    // Create the Yaw task using FreeRTOS's xTaskCreateStatic API
+    if (xTaskCreateStatic(yawTask, (const portCHAR *)"Yaw", RIGTASKSTACKSIZE, NULL,
+                          tskIDLE_PRIORITY + PRIORITY_YAW_TASK,
+                          yawTask_Stack, &yawTask_TCB) == NULL) {
         // Task creation failed
         return(1);
     }
@@ -149,12 +149,16 @@ uint32_t YAWTaskInit(void)
 // Interrupt Service Routine for direction detection
 void ISR_GET_DIRECTION() 
 {
+    TRACE_ISR_ENTER(TRACE_ISR_YAW_PHASE);
+
     // Check the current direction based on the GPIO pins state
     updateDirection();  // Determine the direction of rotation based on GPIO inputs
     counterYaw();       // Increment or decrement yaw counter based on orientation
 
     // Clear the interrupt flags for the GPIO pins
     GPIOIntClear(GPIO_PORTB_BASE, PHASE_A | PHASE_B);
+
+    TRACE_ISR_EXIT(TRACE_ISR_YAW_PHASE);
 }
 
 
@@ -178,6 +182,7 @@ void initialiseYaw(void) {
     // Register the port-level interrupt handler
     // This handler is the primary interrupt handler for all pin interrupts
     GPIOIntRegister(PHASE_PORT, ISR_GET_DIRECTION);
+    IntPrioritySet(INT_GPIOB, YAW_INT_PRIORITY);
 
     // Configure GPIO pin settings
     // Set pin 0 and 1 as input
@@ -272,6 +277,7 @@ void initYawRef(void) {
 
     // Register the ISR (Interrupt Service Routine) for the yaw reference pin
     GPIOIntRegister(YAW_REF_PORT, ISR_FOUND_REF);
+    IntPrioritySet(INT_GPIOC, YAW_INT_PRIORITY);
 
     // Enable interrupts for the yaw reference pin
     GPIOIntEnable(YAW_REF_PORT, YAW_REF_PIN);
@@ -281,10 +287,14 @@ void initYawRef(void) {
 // TO-DO fond the orientation
 void ISR_FOUND_REF(void)
 {
+    TRACE_ISR_ENTER(TRACE_ISR_YAW_REF);
+
     //UARTprintf("Found the pin,    The Pin is: %d\n");
     GPIOIntDisable(YAW_REF_PORT, YAW_REF_PIN);
     GPIOIntClear(YAW_REF_PORT, YAW_REF_PIN);
 
+    TRACE_ISR_EXIT(TRACE_ISR_YAW_REF);
+
 }
 
 